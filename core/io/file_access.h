@@ -110,6 +110,7 @@ public:
 	virtual real_t get_real() const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_view(uint64_t p_length) const { return nullptr; } ///< get the next bytes in place if the file is backed by memory (does not move the position), nullptr otherwise
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -146,6 +147,8 @@ public:
 
 	virtual bool file_exists(const String &p_name) = 0; ///< return true if a file exists
 
+	virtual const uint8_t *map_memory(uint64_t *r_length) { return nullptr; } ///< map the whole file read-only until it's closed, nullptr if not supported
+
 	virtual Error reopen(const String &p_path, int p_mode_flags); ///< does not change the AccessType
 
 	static FileAccess *create(AccessType p_access); /// Create a file access (for the current platform) this is the only portable way of accessing files.
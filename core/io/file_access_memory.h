@@ -59,6 +59,7 @@ public:
 	virtual uint8_t get_8() const; ///< get a byte
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_view(uint64_t p_length) const;
 
 	virtual Error get_error() const; ///< get last error
 
@@ -238,13 +238,48 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 
 	f->close();
 	memdelete(f);
+
+	_map_pack(p_path);
 	return true;
 }
 
+void PackedSourcePCK::_map_pack(const String &p_path) {
+	if (mapped_packs.has(p_path)) {
+		return;
+	}
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
+	if (!f) {
+		return;
+	}
+
+	MappedPack pack;
+	pack.data = f->map_memory(&pack.length);
+	if (!pack.data) {
+		// Not supported by the platform or the file system, read through a FileAccess instead.
+		memdelete(f);
+		return;
+	}
+	pack.file = f;
+	mapped_packs[p_path] = pack;
+}
+
 FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
+	if (!p_file->encrypted) {
+		Map<String, MappedPack>::Element *E = mapped_packs.find(p_file->pack);
+		if (E && p_file->offset <= E->get().length && p_file->size <= E->get().length - p_file->offset) {
+			return memnew(FileAccessPack(p_path, *p_file, E->get().data));
+		}
+	}
 	return memnew(FileAccessPack(p_path, *p_file));
 }
 
+PackedSourcePCK::~PackedSourcePCK() {
+	for (Map<String, MappedPack>::Element *E = mapped_packs.front(); E; E = E->next()) {
+		memdelete(E->get().file);
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
@@ -253,21 +288,35 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 }
 
 void FileAccessPack::close() {
-	f->close();
+	if (mapped) {
+		// f is not used when mapped, so reads fail from now on.
+		mapped = nullptr;
+		return;
+	}
+	if (f) {
+		f->close();
+	}
 }
 
 bool FileAccessPack::is_open() const {
-	return f->is_open();
+	if (mapped) {
+		return true;
+	}
+	return f && f->is_open();
 }
 
 void FileAccessPack::seek(uint64_t p_position) {
+	ERR_FAIL_COND_MSG(!mapped && !f, "File must be opened before use.");
+
 	if (p_position > pf.size) {
 		eof = true;
 	} else {
 		eof = false;
 	}
 
-	f->seek(off + p_position);
+	if (!mapped) {
+		f->seek(off + p_position);
+	}
 	pos = p_position;
 }
 
@@ -288,17 +337,24 @@ bool FileAccessPack::eof_reached() const {
 }
 
 uint8_t FileAccessPack::get_8() const {
+	ERR_FAIL_COND_V_MSG(!mapped && !f, 0, "File must be opened before use.");
+
 	if (pos >= pf.size) {
 		eof = true;
 		return 0;
 	}
 
+	if (mapped) {
+		return mapped[off + pos++];
+	}
+
 	pos++;
 	return f->get_8();
 }
 
 uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
+	ERR_FAIL_COND_V_MSG(!mapped && !f, -1, "File must be opened before use.");
 
 	if (eof) {
 		return 0;
@@ -310,19 +366,34 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 		to_read = (int64_t)pf.size - (int64_t)pos;
 	}
 
+	uint64_t from = off + pos;
 	pos += p_length;
 
 	if (to_read <= 0) {
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
+
+	if (mapped) {
+		memcpy(p_dst, mapped + from, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_view(uint64_t p_length) const {
+	if (!mapped || eof || pos > pf.size || p_length > pf.size - pos) {
+		return nullptr;
+	}
+	return mapped + off + pos;
+}
+
 void FileAccessPack::set_big_endian(bool p_big_endian) {
 	FileAccess::set_big_endian(p_big_endian);
-	f->set_big_endian(p_big_endian);
+	if (f) {
+		f->set_big_endian(p_big_endian);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -348,13 +419,22 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
-		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_mapped) :
+		pf(p_file) {
+	pos = 0;
+	eof = false;
+	off = pf.offset;
+
+	if (p_mapped) {
+		// Reads come straight from the mapped pack, encrypted files never get here.
+		mapped = p_mapped;
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	ERR_FAIL_COND_MSG(!f, "Can't open pack-referenced file '" + String(pf.pack) + "'.");
 
 	f->seek(pf.offset);
-	off = pf.offset;
 
 	if (pf.encrypted) {
 		FileAccessEncrypted *fae = memnew(FileAccessEncrypted);
@@ -376,8 +456,6 @@ FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFil
 		f = fae;
 		off = 0;
 	}
-	pos = 0;
-	eof = false;
 }
 
 FileAccessPack::~FileAccessPack() {
@@ -138,9 +138,23 @@ public:
 };
 
 class PackedSourcePCK : public PackSource {
+	// Packs mapped in memory. Files in them are read straight from the
+	// mapping, without opening the pack again for each of them.
+	struct MappedPack {
+		FileAccess *file = nullptr;
+		const uint8_t *data = nullptr;
+		uint64_t length = 0;
+	};
+
+	Map<String, MappedPack> mapped_packs;
+
+	void _map_pack(const String &p_path);
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -150,7 +164,8 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 	uint64_t off;
 
-	FileAccess *f;
+	FileAccess *f = nullptr;
+	const uint8_t *mapped = nullptr; // Start of the pack when it's mapped in memory, f is not used then.
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 	virtual uint32_t _get_unix_permissions(const String &p_file) { return 0; }
@@ -170,6 +185,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const;
+	virtual const uint8_t *get_view(uint64_t p_length) const;
 
 	virtual void set_big_endian(bool p_big_endian);
 
@@ -182,7 +198,7 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_mapped = nullptr);
 	~FileAccessPack();
 };
 
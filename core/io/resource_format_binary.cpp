@@ -105,12 +105,19 @@ StringName ResourceLoaderBinary::_get_string() {
 	uint32_t id = f->get_32();
 	if (id & 0x80000000) {
 		uint32_t len = id & 0x7FFFFFFF;
-		if ((int)len > str_buf.size()) {
-			str_buf.resize(len);
-		}
 		if (len == 0) {
 			return StringName();
 		}
+		const uint8_t *view = f->get_view(len);
+		if (view) {
+			String s;
+			s.parse_utf8((const char *)view, len);
+			f->seek(f->get_position() + len);
+			return s;
+		}
+		if ((int)len > str_buf.size()) {
+			str_buf.resize(len);
+		}
 		f->get_buffer((uint8_t *)&str_buf[0], len);
 		String s;
 		s.parse_utf8(&str_buf[0]);
@@ -793,6 +800,13 @@ static void save_ustring(FileAccess *f, const String &p_string) {
 
 static String get_ustring(FileAccess *f) {
 	int len = f->get_32();
+	const uint8_t *view = len > 0 ? f->get_view(len) : nullptr;
+	if (view) {
+		String s;
+		s.parse_utf8((const char *)view, len);
+		f->seek(f->get_position() + len);
+		return s;
+	}
 	Vector<char> str_buf;
 	str_buf.resize(len);
 	f->get_buffer((uint8_t *)&str_buf[0], len);
@@ -803,12 +817,20 @@ static String get_ustring(FileAccess *f) {
 
 String ResourceLoaderBinary::get_unicode_string() {
 	int len = f->get_32();
-	if (len > str_buf.size()) {
-		str_buf.resize(len);
-	}
 	if (len == 0) {
 		return String();
 	}
+	// When the file is mapped in memory (e.g. in a pack), parse the string in place.
+	const uint8_t *view = len > 0 ? f->get_view(len) : nullptr;
+	if (view) {
+		String s;
+		s.parse_utf8((const char *)view, len);
+		f->seek(f->get_position() + len);
+		return s;
+	}
+	if (len > str_buf.size()) {
+		str_buf.resize(len);
+	}
 	f->get_buffer((uint8_t *)&str_buf[0], len);
 	String s;
 	s.parse_utf8(&str_buf[0]);
@@ -34,6 +34,7 @@
 #include "core/io/file_access.h"
 #include "core/io/resource_importer.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/string/print_string.h"
 #include "core/string/translation.h"
 #include "core/variant/variant_parser.h"
@@ -213,16 +214,132 @@ RES ResourceLoader::_load(const String &p_path, const String &p_original_path, c
 	ERR_FAIL_V_MSG(RES(), "No loader found for resource: " + p_path + ".");
 }
 
+static String _validate_local_path(const String &p_path) {
+	ResourceUID::ID uid = ResourceUID::get_singleton()->text_to_id(p_path);
+	if (uid != ResourceUID::INVALID_ID) {
+		return ResourceUID::get_singleton()->get_id_path(uid);
+	} else if (p_path.is_relative_path()) {
+		return "res://" + p_path;
+	} else {
+		return ProjectSettings::get_singleton()->localize_path(p_path);
+	}
+}
+
+void ResourceLoader::_scan_dependencies(void *p_userdata, uint32_t p_index) {
+	DependencyScan *scan = (DependencyScan *)p_userdata;
+	const String &path = scan->paths[p_index];
+	// Only headers are read here, the actual decoding happens in the load threads.
+	if (exists(path)) {
+		scan->exists.write[p_index] = true;
+		get_dependencies(path, &scan->dependencies.write[p_index], true);
+	}
+}
+
+void ResourceLoader::_request_dependencies(const ThreadLoadTask &p_load_task, Vector<String> &r_requested) {
+	// Walk the dependency graph one level at a time, reading the dependency
+	// lists of each level in parallel. Resources already seen are not visited
+	// again, which also breaks cycles, and neither are cached ones unless the
+	// cache mode asks to load them again.
+	bool reuse_cached = p_load_task.cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE;
+	Set<String> visited;
+	visited.insert(p_load_task.local_path);
+
+	Vector<String> level;
+	level.push_back(p_load_task.local_path);
+	Vector<String> types;
+	types.push_back(p_load_task.type_hint);
+
+	Vector<String> found_paths;
+	Vector<String> found_types;
+
+	while (!level.is_empty()) {
+		DependencyScan scan;
+		scan.paths = level;
+		scan.dependencies.resize(level.size());
+		scan.exists.resize(level.size());
+		scan.exists.fill(false);
+
+		if (level.size() == 1) {
+			_scan_dependencies(&scan, 0);
+		} else {
+			WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(&_scan_dependencies, &scan, level.size(), MIN(thread_load_io_max, level.size()));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+		}
+
+		Vector<String> next_level;
+		Vector<String> next_types;
+		for (int i = 0; i < level.size(); i++) {
+			if (!scan.exists[i]) {
+				continue;
+			}
+			if (level[i] != p_load_task.local_path) {
+				found_paths.push_back(level[i]);
+				found_types.push_back(types[i]);
+			}
+			for (const String &E : scan.dependencies[i]) {
+				String path = E.get_slice("::", 0);
+				String type = E.get_slice("::", 1);
+				if (path.is_relative_path()) {
+					path = level[i].get_base_dir().plus_file(path);
+				}
+				path = _validate_local_path(path);
+				if (visited.has(path) || (reuse_cached && ResourceCache::has(path))) {
+					continue;
+				}
+				visited.insert(path);
+				next_level.push_back(path);
+				next_types.push_back(type);
+			}
+		}
+
+		level = next_level;
+		types = next_types;
+	}
+
+	// Request the deepest dependencies first, so they are queued in the pool
+	// before the resources using them. Requests for resources already in
+	// flight are merged with the existing task.
+	for (int i = found_paths.size() - 1; i >= 0; i--) {
+		Error err = _load_threaded_request(found_paths[i], found_types[i], true, p_load_task.cache_mode, String(), true);
+		if (err == OK) {
+			r_requested.push_back(found_paths[i]);
+		}
+	}
+}
+
 void ResourceLoader::_thread_load_function(void *p_userdata) {
 	ThreadLoadTask &load_task = *(ThreadLoadTask *)p_userdata;
+
+	thread_load_mutex->lock();
+	if (load_task.started) {
+		// Already loaded by a thread that needed it before a worker got to it.
+		thread_load_mutex->unlock();
+		return;
+	}
+	load_task.started = true;
+	thread_load_mutex->unlock();
+
+	_run_load_task(&load_task);
+}
+
+void ResourceLoader::_run_load_task(void *p_userdata) {
+	ThreadLoadTask &load_task = *(ThreadLoadTask *)p_userdata;
 	load_task.loader_id = Thread::get_caller_id();
 
-	if (load_task.semaphore) {
-		//this is an actual thread, so wait for Ok from semaphore
-		thread_load_semaphore->wait(); //wait until its ok to start loading
+	// Start loading the whole dependency graph right away instead of waiting
+	// for each loader to reach its external resources.
+	Vector<String> requested_dependencies;
+	if (load_task.semaphore && load_task.use_sub_threads && !load_task.dependencies_requested && thread_load_io_max > 0) {
+		_request_dependencies(load_task, requested_dependencies);
 	}
+
 	load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, load_task.cache_mode, &load_task.error, load_task.use_sub_threads, &load_task.progress);
 
+	// The loader took its own references to the dependencies it used, release the ones from the scan.
+	for (int i = 0; i < requested_dependencies.size(); i++) {
+		load_threaded_get(requested_dependencies[i]);
+	}
+
 	load_task.progress = 1.0; //it was fully loaded at this point, so force progress to 1.0
 
 	thread_load_mutex->lock();
@@ -232,15 +349,7 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 		load_task.status = THREAD_LOAD_LOADED;
 	}
 	if (load_task.semaphore) {
-		if (load_task.start_next && thread_waiting_count > 0) {
-			thread_waiting_count--;
-			//thread loading count remains constant, this ends but another one begins
-			thread_load_semaphore->post();
-		} else {
-			thread_loading_count--; //no threads waiting, just reduce loading count
-		}
-
-		print_lt("END: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+		print_lt("END: " + load_task.local_path + " / poll requests: " + itos(load_task.poll_requests));
 
 		for (int i = 0; i < load_task.poll_requests; i++) {
 			load_task.semaphore->post();
@@ -274,17 +383,11 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 	thread_load_mutex->unlock();
 }
 
-static String _validate_local_path(const String &p_path) {
-	ResourceUID::ID uid = ResourceUID::get_singleton()->text_to_id(p_path);
-	if (uid != ResourceUID::INVALID_ID) {
-		return ResourceUID::get_singleton()->get_id_path(uid);
-	} else if (p_path.is_relative_path()) {
-		return "res://" + p_path;
-	} else {
-		return ProjectSettings::get_singleton()->localize_path(p_path);
-	}
-}
 Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource) {
+	return _load_threaded_request(p_path, p_type_hint, p_use_sub_threads, p_cache_mode, p_source_resource, false);
+}
+
+Error ResourceLoader::_load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource, bool p_dependencies_requested) {
 	String local_path = _validate_local_path(p_path);
 
 	thread_load_mutex->lock();
@@ -328,6 +431,7 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 		load_task.type_hint = p_type_hint;
 		load_task.cache_mode = p_cache_mode;
 		load_task.use_sub_threads = p_use_sub_threads;
+		load_task.dependencies_requested = p_dependencies_requested;
 
 		{ //must check if resource is already loaded before attempting to load it in a thread
 
@@ -366,18 +470,12 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 	if (load_task.resource.is_null()) { //needs to be loaded in thread
 
 		load_task.semaphore = memnew(Semaphore);
-		if (thread_loading_count < thread_load_max) {
-			thread_loading_count++;
-			thread_load_semaphore->post(); //we have free threads, so allow one
-		} else {
-			thread_waiting_count++;
-		}
 
-		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+		print_lt("REQUEST: " + local_path);
 
-		load_task.thread = memnew(Thread);
-		load_task.thread->start(_thread_load_function, &thread_load_tasks[local_path]);
-		load_task.loader_id = load_task.thread->get_id();
+		// The pool bounds how many resources are decoded at the same time. The
+		// task data lives in thread_load_tasks until the pool task is waited for.
+		load_task.task_id = WorkerThreadPool::get_singleton()->add_native_task(&ResourceLoader::_thread_load_function, &load_task);
 	}
 
 	thread_load_mutex->unlock();
@@ -407,6 +505,12 @@ float ResourceLoader::_dependency_get_progress(const String &p_path) {
 	}
 }
 
+void ResourceLoader::set_thread_load_io_max(int p_io_tasks) {
+	thread_load_mutex->lock();
+	thread_load_io_max = MAX(p_io_tasks, 0);
+	thread_load_mutex->unlock();
+}
+
 ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const String &p_path, float *r_progress) {
 	String local_path = _validate_local_path(p_path);
 
@@ -441,40 +545,29 @@ RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 
 	ThreadLoadTask &load_task = thread_load_tasks[local_path];
 
-	//semaphore still exists, meaning it's still loading, request poll
+	//semaphore still exists, meaning it's still loading
 	Semaphore *semaphore = load_task.semaphore;
 	if (semaphore) {
-		load_task.poll_requests++;
-
-		{
-			// As we got a semaphore, this means we are going to have to wait
-			// until the sub-resource is done loading
-			//
-			// As this thread will become 'blocked' we should "exchange" its
-			// active status with a waiting one, to ensure load continues.
-			//
-			// This ensures loading is never blocked and that is also within
-			// the maximum number of active threads.
-
-			if (thread_waiting_count > 0) {
-				thread_waiting_count--;
-				thread_loading_count++;
-				thread_load_semaphore->post();
-
-				load_task.start_next = false; //do not start next since we are doing it here
-			}
+		if (!load_task.started) {
+			// No worker got to it yet, so load it on this thread instead of
+			// blocking. Loaders waiting for their dependencies this way never
+			// wait for work queued behind them, whatever the pool size.
+			load_task.started = true;
+			print_lt("GET: loading " + local_path + " on the waiting thread");
 
-			thread_suspended_count++;
+			thread_load_mutex->unlock();
+			_run_load_task(&load_task);
+			thread_load_mutex->lock();
+		} else {
+			// Being loaded by another thread, wait for it to finish.
+			load_task.poll_requests++;
+			print_lt("GET: waiting for " + local_path);
 
-			print_lt("GET: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+			thread_load_mutex->unlock();
+			semaphore->wait();
+			thread_load_mutex->lock();
 		}
 
-		thread_load_mutex->unlock();
-		semaphore->wait();
-		thread_load_mutex->lock();
-
-		thread_suspended_count--;
-
 		if (!thread_load_tasks.has(local_path)) { //may have been erased during unlock and this was always an invalid call
 			thread_load_mutex->unlock();
 			if (r_error) {
@@ -492,11 +585,20 @@ RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 	load_task.requests--;
 
 	if (load_task.requests == 0) {
-		if (load_task.thread) { //thread may not have been used
-			load_task.thread->wait_to_finish();
-			memdelete(load_task.thread);
+		WorkerThreadPool::TaskID task_id = load_task.task_id;
+		if (task_id != WorkerThreadPool::INVALID_TASK_ID) {
+			// The pool task still points to the task data, and may still be queued
+			// if the load ran on a waiting thread. Release it before erasing.
+			load_task.task_id = WorkerThreadPool::INVALID_TASK_ID;
+			thread_load_mutex->unlock();
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
+			thread_load_mutex->lock();
+		}
+		// It may have been requested again while unlocked.
+		ThreadLoadTask *task = thread_load_tasks.getptr(local_path);
+		if (task && task->requests == 0) {
+			thread_load_tasks.erase(local_path);
 		}
-		thread_load_tasks.erase(local_path);
 	}
 
 	thread_load_mutex->unlock();
@@ -1051,16 +1153,11 @@ void ResourceLoader::remove_custom_loaders() {
 
 void ResourceLoader::initialize() {
 	thread_load_mutex = memnew(Mutex);
-	thread_load_max = OS::get_singleton()->get_processor_count();
-	thread_loading_count = 0;
-	thread_waiting_count = 0;
-	thread_suspended_count = 0;
-	thread_load_semaphore = memnew(Semaphore);
+	thread_load_io_max = 2;
 }
 
 void ResourceLoader::finalize() {
 	memdelete(thread_load_mutex);
-	memdelete(thread_load_semaphore);
 }
 
 ResourceLoadErrorNotify ResourceLoader::err_notify = nullptr;
@@ -1074,12 +1171,8 @@ bool ResourceLoader::timestamp_on_load = false;
 
 Mutex *ResourceLoader::thread_load_mutex = nullptr;
 HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
-Semaphore *ResourceLoader::thread_load_semaphore = nullptr;
 
-int ResourceLoader::thread_loading_count = 0;
-int ResourceLoader::thread_waiting_count = 0;
-int ResourceLoader::thread_suspended_count = 0;
-int ResourceLoader::thread_load_max = 0;
+int ResourceLoader::thread_load_io_max = 0;
 
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String>> ResourceLoader::translation_remaps;
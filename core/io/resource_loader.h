@@ -36,6 +36,7 @@
 #include "core/object/script_language.h"
 #include "core/os/semaphore.h"
 #include "core/os/thread.h"
+#include "core/os/worker_thread_pool.h"
 
 class ResourceFormatLoader : public RefCounted {
 	GDCLASS(ResourceFormatLoader, RefCounted);
@@ -128,7 +129,7 @@ private:
 	static Ref<ResourceFormatLoader> _find_custom_resource_format_loader(String path);
 
 	struct ThreadLoadTask {
-		Thread *thread = nullptr;
+		WorkerThreadPool::TaskID task_id = WorkerThreadPool::INVALID_TASK_ID;
 		Thread::ID loader_id = 0;
 		Semaphore *semaphore = nullptr;
 		String local_path;
@@ -141,20 +142,27 @@ private:
 		RES resource;
 		bool xl_remapped = false;
 		bool use_sub_threads = false;
-		bool start_next = true;
+		bool dependencies_requested = false; // Already requested by the dependency scan of another task.
+		bool started = false; // Set once a worker or a waiting thread begins loading it.
 		int requests = 0;
 		int poll_requests = 0;
 		Set<String> sub_tasks;
 	};
 
+	struct DependencyScan {
+		Vector<String> paths;
+		Vector<List<String>> dependencies;
+		Vector<bool> exists;
+	};
+
 	static void _thread_load_function(void *p_userdata);
+	static void _run_load_task(void *p_userdata);
+	static void _scan_dependencies(void *p_userdata, uint32_t p_index);
+	static void _request_dependencies(const ThreadLoadTask &p_load_task, Vector<String> &r_requested);
+	static Error _load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource, bool p_dependencies_requested);
 	static Mutex *thread_load_mutex;
 	static HashMap<String, ThreadLoadTask> thread_load_tasks;
-	static Semaphore *thread_load_semaphore;
-	static int thread_waiting_count;
-	static int thread_loading_count;
-	static int thread_suspended_count;
-	static int thread_load_max;
+	static int thread_load_io_max;
 
 	static float _dependency_get_progress(const String &p_path);
 
@@ -162,6 +170,8 @@ public:
 	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false, ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, const String &p_source_resource = String());
 	static ThreadLoadStatus load_threaded_get_status(const String &p_path, float *r_progress = nullptr);
 	static RES load_threaded_get(const String &p_path, Error *r_error = nullptr);
+	// Maximum number of worker tasks reading dependency lists ahead of a threaded load (zero disables it).
+	static void set_thread_load_io_max(int p_io_tasks);
 
 	static RES load(const String &p_path, const String &p_type_hint = "", ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, Error *r_error = nullptr);
 	static bool exists(const String &p_path, const String &p_type_hint = "");
@@ -32,6 +32,7 @@
 
 #include "core/math/geometry_3d.h"
 #include "core/object/script_language.h"
+#include "core/os/worker_thread_pool.h"
 #include "scene/scene_string_names.h"
 
 int AStar::get_available_point_id() const {
@@ -58,14 +59,24 @@ void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
 		pt->id = p_id;
 		pt->pos = p_pos;
 		pt->weight_scale = p_weight_scale;
-		pt->prev_point = nullptr;
-		pt->open_pass = 0;
-		pt->closed_pass = 0;
 		pt->enabled = true;
+		if (free_slots.is_empty()) {
+			pt->slot = slot_count++;
+		} else {
+			pt->slot = free_slots[free_slots.size() - 1];
+			free_slots.resize(free_slots.size() - 1);
+		}
 		points.set(p_id, pt);
+		_index_add_point(pt);
+		_cluster_add_point(pt);
 	} else {
+		_index_remove_point(found_pt);
+		_cluster_set_dirty(found_pt, true);
+		_cluster_remove_point(found_pt);
 		found_pt->pos = p_pos;
 		found_pt->weight_scale = p_weight_scale;
+		_index_add_point(found_pt);
+		_cluster_add_point(found_pt);
 	}
 }
 
@@ -82,7 +93,12 @@ void AStar::set_point_position(int p_id, const Vector3 &p_pos) {
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND(!p_exists);
 
+	_index_remove_point(p);
+	_cluster_set_dirty(p, true);
+	_cluster_remove_point(p);
 	p->pos = p_pos;
+	_index_add_point(p);
+	_cluster_add_point(p);
 }
 
 real_t AStar::get_point_weight_scale(int p_id) const {
@@ -100,6 +116,7 @@ void AStar::set_point_weight_scale(int p_id, real_t p_weight_scale) {
 	ERR_FAIL_COND(p_weight_scale < 1);
 
 	p->weight_scale = p_weight_scale;
+	_cluster_set_dirty(p, true);
 }
 
 void AStar::remove_point(int p_id) {
@@ -107,6 +124,10 @@ void AStar::remove_point(int p_id) {
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND(!p_exists);
 
+	_index_remove_point(p);
+	_cluster_set_dirty(p, true);
+	_cluster_remove_point(p);
+
 	for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
 		Segment s(p_id, (*it.key));
 		segments.erase(s);
@@ -123,6 +144,7 @@ void AStar::remove_point(int p_id) {
 		(*it.value)->unlinked_neighbours.remove(p->id);
 	}
 
+	free_slots.push_back(p->slot);
 	memdelete(p);
 	points.remove(p_id);
 	last_free_id = p_id;
@@ -139,6 +161,9 @@ void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
 	bool to_exists = points.lookup(p_with_id, b);
 	ERR_FAIL_COND(!to_exists);
 
+	_cluster_set_dirty(a);
+	_cluster_set_dirty(b);
+
 	a->neighbours.set(b->id, b);
 
 	if (bidirectional) {
@@ -175,6 +200,9 @@ void AStar::disconnect_points(int p_id, int p_with_id, bool bidirectional) {
 	bool b_exists = points.lookup(p_with_id, b);
 	ERR_FAIL_COND(!b_exists);
 
+	_cluster_set_dirty(a);
+	_cluster_set_dirty(b);
+
 	Segment s(p_id, p_with_id);
 	int remove_direction = bidirectional ? (int)Segment::BIDIRECTIONAL : s.direction;
 
@@ -249,6 +277,10 @@ void AStar::clear() {
 	}
 	segments.clear();
 	points.clear();
+	index_cells.clear();
+	clusters.clear();
+	slot_count = 0;
+	free_slots.clear();
 }
 
 int AStar::get_point_count() const {
@@ -267,6 +299,10 @@ void AStar::reserve_space(int p_num_nodes) {
 
 int AStar::get_closest_point(const Vector3 &p_point, bool p_include_disabled) const {
 	int closest_id = -1;
+	if (spatial_index_cell_size > 0 && _index_get_closest_point(p_point, p_include_disabled, closest_id)) {
+		return closest_id;
+	}
+
 	real_t closest_dist = 1e20;
 
 	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
@@ -319,8 +355,16 @@ Vector3 AStar::get_closest_position_in_segment(const Vector3 &p_point) const {
 	return closest_point;
 }
 
-bool AStar::_solve(Point *begin_point, Point *end_point) {
-	pass++;
+void AStar::_begin_search(SearchState &r_state) const {
+	r_state.pass++;
+	if (r_state.points.size() < slot_count) {
+		r_state.points.resize(slot_count);
+	}
+}
+
+bool AStar::_solve(Point *begin_point, Point *end_point, SearchState &r_state) {
+	_begin_search(r_state);
+	const uint64_t pass = r_state.pass;
 
 	if (!end_point->enabled) {
 		return false;
@@ -330,13 +374,15 @@ bool AStar::_solve(Point *begin_point, Point *end_point) {
 
 	Vector<Point *> open_list;
 	SortArray<Point *, SortPoints> sorter;
+	sorter.compare.state = &r_state;
 
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
+	r_state[begin_point].g_score = 0;
+	r_state[begin_point].f_score = _get_estimate_cost(begin_point, end_point);
 	open_list.push_back(begin_point);
 
 	while (!open_list.is_empty()) {
 		Point *p = open_list[0]; // The currently processed point
+		SearchState::PointData &p_data = r_state[p];
 
 		if (p == end_point) {
 			found_route = true;
@@ -345,30 +391,31 @@ bool AStar::_solve(Point *begin_point, Point *end_point) {
 
 		sorter.pop_heap(0, open_list.size(), open_list.ptrw()); // Remove the current point from the open list
 		open_list.remove(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed
+		p_data.closed_pass = pass; // Mark the point as closed
 
 		for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
 			Point *e = *(it.value); // The neighbour point
+			SearchState::PointData &e_data = r_state[e];
 
-			if (!e->enabled || e->closed_pass == pass) {
+			if (!e->enabled || e_data.closed_pass == pass) {
 				continue;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
+			real_t tentative_g_score = p_data.g_score + _get_compute_cost(p, e) * e->weight_scale;
 
 			bool new_point = false;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
+			if (e_data.open_pass != pass) { // The point wasn't inside the open list.
+				e_data.open_pass = pass;
 				open_list.push_back(e);
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= e_data.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
+			e_data.prev_point = p;
+			e_data.g_score = tentative_g_score;
+			e_data.f_score = e_data.g_score + _get_estimate_cost(e, end_point);
 
 			if (new_point) { // The position of the new points is already known.
 				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptrw());
@@ -415,56 +462,555 @@ real_t AStar::_compute_cost(int p_from_id, int p_to_id) {
 	return from_point->pos.distance_to(to_point->pos);
 }
 
-Vector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
-	Point *a;
-	bool from_exists = points.lookup(p_from_id, a);
-	ERR_FAIL_COND_V(!from_exists, Vector<Vector3>());
+Vector3i AStar::_get_cell(const Vector3 &p_pos, real_t p_cell_size) {
+	return Vector3i(Math::floor(p_pos.x / p_cell_size), Math::floor(p_pos.y / p_cell_size), Math::floor(p_pos.z / p_cell_size));
+}
 
-	Point *b;
-	bool to_exists = points.lookup(p_to_id, b);
-	ERR_FAIL_COND_V(!to_exists, Vector<Vector3>());
+uint64_t AStar::_get_cell_key(const Vector3i &p_cell) {
+	// 21 bits per axis.
+	return (uint64_t(p_cell.x) & 0x1FFFFF) | ((uint64_t(p_cell.y) & 0x1FFFFF) << 21) | ((uint64_t(p_cell.z) & 0x1FFFFF) << 42);
+}
 
-	if (a == b) {
-		Vector<Vector3> ret;
-		ret.push_back(a->pos);
-		return ret;
+void AStar::_index_add_point(Point *p_point) {
+	if (spatial_index_cell_size <= 0) {
+		return;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
+	const Vector3i cell = _get_cell(p_point->pos, spatial_index_cell_size);
+	p_point->index_cell = _get_cell_key(cell);
 
-	bool found_route = _solve(begin_point, end_point);
-	if (!found_route) {
-		return Vector<Vector3>();
+	// The bounds are only grown, they limit how far the closest point is searched.
+	if (index_cells.is_empty()) {
+		index_cells_begin = cell;
+		index_cells_end = cell;
+	} else {
+		for (int i = 0; i < 3; i++) {
+			index_cells_begin[i] = MIN(index_cells_begin[i], cell[i]);
+			index_cells_end[i] = MAX(index_cells_end[i], cell[i]);
+		}
+	}
+
+	index_cells[p_point->index_cell].push_back(p_point);
+}
+
+void AStar::_index_remove_point(Point *p_point) {
+	if (spatial_index_cell_size <= 0) {
+		return;
 	}
 
-	Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<Point *> *cell_points = index_cells.getptr(p_point->index_cell);
+	ERR_FAIL_NULL(cell_points);
+	cell_points->erase(p_point);
+	if (cell_points->is_empty()) {
+		index_cells.erase(p_point->index_cell);
 	}
+}
 
-	Vector<Vector3> path;
-	path.resize(pc);
+bool AStar::_index_get_closest_point(const Vector3 &p_point, bool p_include_disabled, int &r_id) const {
+	if (index_cells.is_empty()) {
+		r_id = -1;
+		return true;
+	}
+
+	const Vector3i center = _get_cell(p_point, spatial_index_cell_size);
+	int max_ring = 0;
+	for (int i = 0; i < 3; i++) {
+		max_ring = MAX(max_ring, MAX(center[i] - index_cells_begin[i], index_cells_end[i] - center[i]));
+	}
+
+	int closest_id = -1;
+	real_t closest_dist = 1e20;
+	uint32_t probed_cells = 0;
+
+	// Visit the cells in rings of growing distance around the one of the
+	// point, until the next ring is farther than the closest point found.
+	for (int ring = 0; ring <= max_ring; ring++) {
+		if (closest_id != -1 && ring > 0) {
+			const real_t ring_dist = (ring - 1) * spatial_index_cell_size;
+			if (ring_dist * ring_dist > closest_dist) {
+				break;
+			}
+		}
+
+		const Vector3i from = Vector3i(MAX(center.x - ring, index_cells_begin.x), MAX(center.y - ring, index_cells_begin.y), MAX(center.z - ring, index_cells_begin.z));
+		const Vector3i to = Vector3i(MIN(center.x + ring, index_cells_end.x), MIN(center.y + ring, index_cells_end.y), MIN(center.z + ring, index_cells_end.z));
+
+		for (int x = from.x; x <= to.x; x++) {
+			for (int y = from.y; y <= to.y; y++) {
+				// Inside the ring only the cells on its two z faces are new.
+				const bool on_side = ABS(x - center.x) == ring || ABS(y - center.y) == ring;
+				const int z_step = on_side ? 1 : MAX(2 * ring, 1);
+				for (int z = center.z - ring; z <= center.z + ring; z += z_step) {
+					if (z < from.z || z > to.z) {
+						continue;
+					}
+
+					// Testing each point would be cheaper than probing more cells.
+					probed_cells++;
+					if (probed_cells > (uint32_t)points.get_num_elements()) {
+						return false;
+					}
+
+					const LocalVector<Point *> *cell_points = index_cells.getptr(_get_cell_key(Vector3i(x, y, z)));
+					if (!cell_points) {
+						continue;
+					}
+
+					for (uint32_t i = 0; i < cell_points->size(); i++) {
+						const Point *point = (*cell_points)[i];
+						if (!p_include_disabled && !point->enabled) {
+							continue; // Disabled points should not be considered.
+						}
+
+						// Keep the closest point's ID, and in case of multiple closest IDs,
+						// the smallest one (makes it deterministic).
+						real_t d = p_point.distance_squared_to(point->pos);
+						if (d <= closest_dist) {
+							if (d == closest_dist && point->id > closest_id) { // Keep lowest ID.
+								continue;
+							}
+							closest_dist = d;
+							closest_id = point->id;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	r_id = closest_id;
+	return true;
+}
+
+void AStar::set_spatial_index_cell_size(real_t p_cell_size) {
+	ERR_FAIL_COND(p_cell_size < 0);
+
+	spatial_index_cell_size = p_cell_size;
+	index_cells.clear();
+	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		_index_add_point(*it.value);
+	}
+}
+
+real_t AStar::get_spatial_index_cell_size() const {
+	return spatial_index_cell_size;
+}
+
+void AStar::_cluster_add_point(Point *p_point) {
+	if (cluster_size <= 0) {
+		return;
+	}
+
+	p_point->cluster = _get_cell_key(_get_cell(p_point->pos, cluster_size));
+	p_point->entrance = -1;
+	Cluster &cluster = clusters[p_point->cluster];
+	cluster.points.push_back(p_point);
+	cluster.dirty = true;
+}
+
+void AStar::_cluster_remove_point(Point *p_point) {
+	if (cluster_size <= 0) {
+		return;
+	}
+
+	Cluster *cluster = clusters.getptr(p_point->cluster);
+	ERR_FAIL_NULL(cluster);
+	cluster->points.erase(p_point);
+	if (cluster->points.is_empty()) {
+		clusters.erase(p_point->cluster);
+	} else {
+		cluster->dirty = true;
+	}
+}
+
+void AStar::_cluster_set_dirty(Point *p_point, bool p_neighbours) {
+	if (cluster_size <= 0) {
+		return;
+	}
+
+	Cluster *cluster = clusters.getptr(p_point->cluster);
+	if (cluster) {
+		cluster->dirty = true;
+	}
+
+	// The entrances of the clusters of the neighbours depend on this point too.
+	if (p_neighbours) {
+		for (OAHashMap<int, Point *>::Iterator it = p_point->neighbours.iter(); it.valid; it = p_point->neighbours.next_iter(it)) {
+			_cluster_set_dirty(*it.value);
+		}
+		for (OAHashMap<int, Point *>::Iterator it = p_point->unlinked_neighbours.iter(); it.valid; it = p_point->unlinked_neighbours.next_iter(it)) {
+			_cluster_set_dirty(*it.value);
+		}
+	}
+}
+
+void AStar::set_cluster_size(real_t p_cluster_size) {
+	ERR_FAIL_COND(p_cluster_size < 0);
+
+	cluster_size = p_cluster_size;
+	clusters.clear();
+	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		_cluster_add_point(*it.value);
+	}
+}
+
+real_t AStar::get_cluster_size() const {
+	return cluster_size;
+}
+
+real_t AStar::_get_estimate_cost(Point *p_from, Point *p_to) {
+	return cost_owner ? cost_owner->_estimate_cost(p_from->id, p_to->id) : _estimate_cost(p_from->id, p_to->id);
+}
+
+real_t AStar::_get_compute_cost(Point *p_from, Point *p_to) {
+	return cost_owner ? cost_owner->_compute_cost(p_from->id, p_to->id) : _compute_cost(p_from->id, p_to->id);
+}
+
+AStar::Cluster *AStar::_get_updated_cluster(uint64_t p_key, SearchState &r_state) {
+	Cluster *cluster = clusters.getptr(p_key);
+	ERR_FAIL_NULL_V(cluster, nullptr);
+	if (!cluster->dirty) {
+		return cluster;
+	}
+
+	// The entrances are the enabled points linked to another cluster, in either direction.
+	cluster->entrances.clear();
+	for (uint32_t i = 0; i < cluster->points.size(); i++) {
+		Point *p = cluster->points[i];
+		p->entrance = -1;
+		if (!p->enabled) {
+			continue;
+		}
+
+		bool entrance = false;
+		for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid && !entrance; it = p->neighbours.next_iter(it)) {
+			entrance = (*it.value)->cluster != p_key;
+		}
+		for (OAHashMap<int, Point *>::Iterator it = p->unlinked_neighbours.iter(); it.valid && !entrance; it = p->unlinked_neighbours.next_iter(it)) {
+			entrance = (*it.value)->cluster != p_key;
+		}
+
+		if (entrance) {
+			p->entrance = cluster->entrances.size();
+			cluster->entrances.push_back(p);
+		}
+	}
+
+	const uint32_t entrance_count = cluster->entrances.size();
+	cluster->entrance_costs.resize(entrance_count * entrance_count);
+	for (uint32_t i = 0; i < entrance_count; i++) {
+		_solve_in_cluster(cluster->entrances[i], nullptr, false, r_state);
+		for (uint32_t j = 0; j < entrance_count; j++) {
+			const SearchState::PointData &to = r_state[cluster->entrances[j]];
+			cluster->entrance_costs[i * entrance_count + j] = to.closed_pass == r_state.pass ? to.g_score : INFINITY;
+		}
+	}
+
+	cluster->dirty = false;
+	return cluster;
+}
+
+bool AStar::_solve_in_cluster(Point *p_begin_point, Point *p_end_point, bool p_backwards, SearchState &r_state) {
+	// Searches the paths from the begin point that stay inside its cluster, up
+	// to the end point if any, or to all the points of the cluster otherwise.
+	// Going backwards follows the connections to the points instead, and gives
+	// the cost from each point to the begin point.
+	_begin_search(r_state);
+	const uint64_t pass = r_state.pass;
+
+	const uint64_t cluster = p_begin_point->cluster;
+
+	Vector<Point *> open_list;
+	SortArray<Point *, SortPoints> sorter;
+	sorter.compare.state = &r_state;
+
+	SearchState::PointData &begin_data = r_state[p_begin_point];
+	begin_data.g_score = 0;
+	begin_data.f_score = p_end_point ? _get_estimate_cost(p_begin_point, p_end_point) : 0;
+	begin_data.open_pass = pass;
+	open_list.push_back(p_begin_point);
+
+	while (!open_list.is_empty()) {
+		Point *p = open_list[0]; // The currently processed point
+		SearchState::PointData &p_data = r_state[p];
+
+		sorter.pop_heap(0, open_list.size(), open_list.ptrw()); // Remove the current point from the open list
+		open_list.remove(open_list.size() - 1);
+		p_data.closed_pass = pass; // Mark the point as closed
+
+		if (p == p_end_point) {
+			return true;
+		}
+
+		for (int side = 0; side < 2; side++) {
+			OAHashMap<int, Point *> &neighbours = side == 0 ? p->neighbours : p->unlinked_neighbours;
+			if (side == 1 && !p_backwards) {
+				break;
+			}
+
+			for (OAHashMap<int, Point *>::Iterator it = neighbours.iter(); it.valid; it = neighbours.next_iter(it)) {
+				Point *e = *(it.value); // The neighbour point
+				SearchState::PointData &e_data = r_state[e];
+
+				if (!e->enabled || e_data.closed_pass == pass || e->cluster != cluster) {
+					continue;
+				}
+				// Backwards, only the neighbours connected to this point can be used.
+				if (p_backwards && side == 0 && !e->neighbours.has(p->id)) {
+					continue;
+				}
+
+				real_t tentative_g_score = p_data.g_score + (p_backwards ? _get_compute_cost(e, p) * p->weight_scale : _get_compute_cost(p, e) * e->weight_scale);
+
+				bool new_point = false;
+
+				if (e_data.open_pass != pass) { // The point wasn't inside the open list.
+					e_data.open_pass = pass;
+					open_list.push_back(e);
+					new_point = true;
+				} else if (tentative_g_score >= e_data.g_score) { // The new path is worse than the previous.
+					continue;
+				}
+
+				e_data.prev_point = p;
+				e_data.g_score = tentative_g_score;
+				e_data.f_score = e_data.g_score + (p_end_point ? _get_estimate_cost(e, p_end_point) : 0);
+
+				if (new_point) { // The position of the new points is already known.
+					sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptrw());
+				} else {
+					sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptrw());
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+bool AStar::_solve_hierarchical(Point *p_begin_point, Point *p_end_point, SearchState &r_state, LocalVector<Point *> &r_path) {
+	if (!p_end_point->enabled) {
+		return false;
+	}
+
+	Cluster *begin_cluster = _get_updated_cluster(p_begin_point->cluster, r_state);
+	Cluster *end_cluster = _get_updated_cluster(p_end_point->cluster, r_state);
+	ERR_FAIL_COND_V(!begin_cluster || !end_cluster, false);
+
+	// Costs from the begin point to the entrances of its cluster, and from the
+	// entrances of the cluster of the end point to it.
+	LocalVector<real_t> begin_costs;
+	begin_costs.resize(begin_cluster->entrances.size());
+	_solve_in_cluster(p_begin_point, nullptr, false, r_state);
+	for (uint32_t i = 0; i < begin_costs.size(); i++) {
+		const SearchState::PointData &to = r_state[begin_cluster->entrances[i]];
+		begin_costs[i] = to.closed_pass == r_state.pass ? to.g_score : INFINITY;
+	}
+
+	LocalVector<real_t> end_costs;
+	end_costs.resize(end_cluster->entrances.size());
+	_solve_in_cluster(p_end_point, nullptr, true, r_state);
+	for (uint32_t i = 0; i < end_costs.size(); i++) {
+		const SearchState::PointData &from = r_state[end_cluster->entrances[i]];
+		end_costs[i] = from.closed_pass == r_state.pass ? from.g_score : INFINITY;
+	}
+
+	// A* over the entrances. The first node is the begin point, the second
+	// one the end point, and the next ones the entrances reached so far.
+	struct Node {
+		Point *point = nullptr;
+		real_t g_score = INFINITY;
+		int prev = -1;
+		bool closed = false;
+	};
+	LocalVector<Node> nodes;
+	HashMap<int, uint32_t> entrance_nodes;
+	LocalVector<Pair<real_t, uint32_t>> open_list;
+	SortArray<Pair<real_t, uint32_t>, SortClusterSearch> sorter;
+
+	nodes.resize(2);
+	nodes[0].point = p_begin_point;
+	nodes[0].g_score = 0;
+	nodes[1].point = p_end_point;
+	open_list.push_back(Pair<real_t, uint32_t>(_get_estimate_cost(p_begin_point, p_end_point), 0));
+
+	bool found_route = false;
+	while (!open_list.is_empty()) {
+		const uint32_t node_id = open_list[0].second;
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.resize(open_list.size() - 1);
+
+		if (nodes[node_id].closed) {
+			continue; // Already reached with a lower cost.
+		}
+		nodes[node_id].closed = true;
+
+		if (node_id == 1) {
+			found_route = true;
+			break;
+		}
+
+		Point *p = nodes[node_id].point;
+		const real_t g_score = nodes[node_id].g_score;
+
+		// Collect the entrances reachable from this node, and the cost to reach them.
+		LocalVector<Pair<Point *, real_t>> links;
+		Cluster *cluster = nullptr;
+		if (node_id == 0) {
+			for (uint32_t i = 0; i < begin_costs.size(); i++) {
+				if (begin_costs[i] != INFINITY) {
+					links.push_back(Pair<Point *, real_t>(begin_cluster->entrances[i], begin_costs[i]));
+				}
+			}
+		} else {
+			cluster = _get_updated_cluster(p->cluster, r_state);
+			ERR_CONTINUE(!cluster || p->entrance < 0);
+			const uint32_t entrance_count = cluster->entrances.size();
+			for (uint32_t i = 0; i < entrance_count; i++) {
+				const real_t cost = cluster->entrance_costs[p->entrance * entrance_count + i];
+				if (cost != INFINITY && i != (uint32_t)p->entrance) {
+					links.push_back(Pair<Point *, real_t>(cluster->entrances[i], cost));
+				}
+			}
+		}
+
+		// The begin point can leave its cluster even when disabled, and thus not an entrance.
+		for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
+			Point *e = *(it.value);
+			if (e->enabled && e->cluster != p->cluster) {
+				links.push_back(Pair<Point *, real_t>(e, _get_compute_cost(p, e) * e->weight_scale));
+			}
+		}
+
+		// The entrances of the cluster of the end point lead to it.
+		if (cluster == end_cluster && end_costs[p->entrance] != INFINITY) {
+			const real_t tentative_g_score = g_score + end_costs[p->entrance];
+			if (tentative_g_score < nodes[1].g_score) {
+				nodes[1].g_score = tentative_g_score;
+				nodes[1].prev = node_id;
+				open_list.push_back(Pair<real_t, uint32_t>(tentative_g_score, 1));
+				sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+			}
+		}
+
+		for (uint32_t i = 0; i < links.size(); i++) {
+			Point *e = links[i].first;
+			uint32_t link_id;
+			uint32_t *existing_id = entrance_nodes.getptr(e->id);
+			if (existing_id) {
+				link_id = *existing_id;
+			} else {
+				link_id = nodes.size();
+				nodes.push_back(Node());
+				nodes[link_id].point = e;
+				entrance_nodes.set(e->id, link_id);
+			}
+
+			const real_t tentative_g_score = g_score + links[i].second;
+			if (nodes[link_id].closed || tentative_g_score >= nodes[link_id].g_score) {
+				continue;
+			}
+			nodes[link_id].g_score = tentative_g_score;
+			nodes[link_id].prev = node_id;
+			open_list.push_back(Pair<real_t, uint32_t>(tentative_g_score + _get_estimate_cost(e, p_end_point), link_id));
+			sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+		}
+	}
 
-	{
-		Vector3 *w = path.ptrw();
+	if (!found_route) {
+		return false;
+	}
 
-		Point *p2 = end_point;
-		int idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = p2->pos;
-			p2 = p2->prev_point;
+	LocalVector<Point *> route;
+	for (int node_id = 1; node_id != -1; node_id = nodes[node_id].prev) {
+		route.push_back(nodes[node_id].point);
+	}
+	route.invert();
+
+	// Refine each step between two entrances of the same cluster with the
+	// path inside of it, the other steps are connections between clusters.
+	r_path.clear();
+	r_path.push_back(p_begin_point);
+	for (uint32_t i = 1; i < route.size(); i++) {
+		Point *from = route[i - 1];
+		Point *to = route[i];
+		if (from == to) {
+			continue;
+		}
+		if (from->cluster != to->cluster) {
+			r_path.push_back(to);
+			continue;
 		}
 
-		w[0] = p2->pos; // Assign first
+		bool found = _solve_in_cluster(from, to, false, r_state);
+		ERR_FAIL_COND_V(!found, false);
+
+		const uint32_t from_index = r_path.size();
+		for (Point *p = to; p != from; p = r_state[p].prev_point) {
+			r_path.push_back(p);
+		}
+		// The points were added from the end, put them back in order.
+		for (uint32_t j = 0; j < (r_path.size() - from_index) / 2; j++) {
+			SWAP(r_path[from_index + j], r_path[r_path.size() - 1 - j]);
+		}
+	}
+
+	return true;
+}
+
+bool AStar::_get_path(Point *p_begin_point, Point *p_end_point, SearchState &r_state, LocalVector<Point *> &r_path) {
+	r_path.clear();
+
+	if (p_begin_point == p_end_point) {
+		r_path.push_back(p_begin_point);
+		return true;
+	}
+
+	if (cluster_size > 0 && p_begin_point->cluster != p_end_point->cluster) {
+		return _solve_hierarchical(p_begin_point, p_end_point, r_state, r_path);
+	}
+
+	bool found_route = _solve(p_begin_point, p_end_point, r_state);
+	if (!found_route) {
+		return false;
+	}
+
+	Point *p = p_end_point;
+	while (p != p_begin_point) {
+		r_path.push_back(p);
+		p = r_state[p].prev_point;
+	}
+	r_path.push_back(p_begin_point);
+	r_path.invert();
+
+	return true;
+}
+
+Vector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
+	Point *a;
+	bool from_exists = points.lookup(p_from_id, a);
+	ERR_FAIL_COND_V(!from_exists, Vector<Vector3>());
+
+	Point *b;
+	bool to_exists = points.lookup(p_to_id, b);
+	ERR_FAIL_COND_V(!to_exists, Vector<Vector3>());
+
+	LocalVector<Point *> route;
+	if (!_get_path(a, b, search_state, route)) {
+		return Vector<Vector3>();
+	}
+
+	Vector<Vector3> path;
+	path.resize(route.size());
+	Vector3 *w = path.ptrw();
+	for (uint32_t i = 0; i < route.size(); i++) {
+		w[i] = route[i]->pos;
 	}
 
 	return path;
 }
 
-Vector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
+Vector<int> AStar::_get_id_path(int p_from_id, int p_to_id, SearchState &r_state) {
 	Point *a;
 	bool from_exists = points.lookup(p_from_id, a);
 	ERR_FAIL_COND_V(!from_exists, Vector<int>());
@@ -473,44 +1019,70 @@ Vector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
 	bool to_exists = points.lookup(p_to_id, b);
 	ERR_FAIL_COND_V(!to_exists, Vector<int>());
 
-	if (a == b) {
-		Vector<int> ret;
-		ret.push_back(a->id);
-		return ret;
+	LocalVector<Point *> route;
+	if (!_get_path(a, b, r_state, route)) {
+		return Vector<int>();
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
-	if (!found_route) {
-		return Vector<int>();
+	Vector<int> path;
+	path.resize(route.size());
+	int *w = path.ptrw();
+	for (uint32_t i = 0; i < route.size(); i++) {
+		w[i] = route[i]->id;
 	}
 
-	Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	return path;
+}
+
+Vector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
+	return _get_id_path(p_from_id, p_to_id, search_state);
+}
+
+void AStar::_get_id_path_batch(uint32_t p_index, IdPathBatch *p_batch) {
+	SearchState &state = p_batch->states[WorkerThreadPool::get_singleton()->get_thread_index() + 1];
+	p_batch->paths[p_index] = _get_id_path(p_batch->from_ids[p_index], p_batch->to_ids[p_index], state);
+}
+
+bool AStar::_is_cost_overridden() const {
+	if (cost_owner) {
+		return GDVIRTUAL_IS_OVERRIDDEN_PTR(cost_owner, _estimate_cost) || GDVIRTUAL_IS_OVERRIDDEN_PTR(cost_owner, _compute_cost);
 	}
+	return GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost) || GDVIRTUAL_IS_OVERRIDDEN(_compute_cost);
+}
 
-	Vector<int> path;
-	path.resize(pc);
+Array AStar::get_id_paths(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids) {
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), Array(), "The number of begin and end points must be the same.");
 
-	{
-		int *w = path.ptrw();
+	IdPathBatch batch;
+	batch.from_ids = p_from_ids.ptr();
+	batch.to_ids = p_to_ids.ptr();
+	batch.paths.resize(p_from_ids.size());
 
-		p = end_point;
-		int idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
+	if (_is_cost_overridden()) {
+		// Scripts can't be called from several threads at once.
+		for (int i = 0; i < p_from_ids.size(); i++) {
+			batch.paths[i] = _get_id_path(batch.from_ids[i], batch.to_ids[i], search_state);
+		}
+	} else {
+		// Update the clusters first, so the searches only read the graph.
+		if (cluster_size > 0) {
+			const uint64_t *key = nullptr;
+			while ((key = clusters.next(key))) {
+				_get_updated_cluster(*key, search_state);
+			}
 		}
 
-		w[0] = p->id; // Assign first
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		batch.states.resize(pool->get_thread_count() + 1);
+		pool->do_work(p_from_ids.size(), this, &AStar::_get_id_path_batch, &batch);
 	}
 
-	return path;
+	Array paths;
+	paths.resize(batch.paths.size());
+	for (uint32_t i = 0; i < batch.paths.size(); i++) {
+		paths[i] = batch.paths[i];
+	}
+	return paths;
 }
 
 void AStar::set_point_disabled(int p_id, bool p_disabled) {
@@ -518,6 +1090,9 @@ void AStar::set_point_disabled(int p_id, bool p_disabled) {
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND(!p_exists);
 
+	if (p->enabled == p_disabled) {
+		_cluster_set_dirty(p, true);
+	}
 	p->enabled = !p_disabled;
 }
 
@@ -553,11 +1128,17 @@ void AStar::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("reserve_space", "num_nodes"), &AStar::reserve_space);
 	ClassDB::bind_method(D_METHOD("clear"), &AStar::clear);
 
+	ClassDB::bind_method(D_METHOD("set_spatial_index_cell_size", "cell_size"), &AStar::set_spatial_index_cell_size);
+	ClassDB::bind_method(D_METHOD("get_spatial_index_cell_size"), &AStar::get_spatial_index_cell_size);
+	ClassDB::bind_method(D_METHOD("set_cluster_size", "cluster_size"), &AStar::set_cluster_size);
+	ClassDB::bind_method(D_METHOD("get_cluster_size"), &AStar::get_cluster_size);
+
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_position", "include_disabled"), &AStar::get_closest_point, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_closest_position_in_segment", "to_position"), &AStar::get_closest_position_in_segment);
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStar::get_point_path);
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStar::get_id_path);
+	ClassDB::bind_method(D_METHOD("get_id_paths", "from_ids", "to_ids"), &AStar::get_id_paths);
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "to_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
@@ -646,6 +1227,22 @@ void AStar2D::reserve_space(int p_num_nodes) {
 	astar.reserve_space(p_num_nodes);
 }
 
+void AStar2D::set_spatial_index_cell_size(real_t p_cell_size) {
+	astar.set_spatial_index_cell_size(p_cell_size);
+}
+
+real_t AStar2D::get_spatial_index_cell_size() const {
+	return astar.get_spatial_index_cell_size();
+}
+
+void AStar2D::set_cluster_size(real_t p_cluster_size) {
+	astar.set_cluster_size(p_cluster_size);
+}
+
+real_t AStar2D::get_cluster_size() const {
+	return astar.get_cluster_size();
+}
+
 int AStar2D::get_closest_point(const Vector2 &p_point, bool p_include_disabled) const {
 	return astar.get_closest_point(Vector3(p_point.x, p_point.y, 0), p_include_disabled);
 }
@@ -698,155 +1295,27 @@ Vector<Vector2> AStar2D::get_point_path(int p_from_id, int p_to_id) {
 	bool to_exists = astar.points.lookup(p_to_id, b);
 	ERR_FAIL_COND_V(!to_exists, Vector<Vector2>());
 
-	if (a == b) {
-		Vector<Vector2> ret;
-		ret.push_back(Vector2(a->pos.x, a->pos.y));
-		return ret;
-	}
-
-	AStar::Point *begin_point = a;
-	AStar::Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
-	if (!found_route) {
+	LocalVector<AStar::Point *> route;
+	if (!astar._get_path(a, b, astar.search_state, route)) {
 		return Vector<Vector2>();
 	}
 
-	AStar::Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
-
 	Vector<Vector2> path;
-	path.resize(pc);
-
-	{
-		Vector2 *w = path.ptrw();
-
-		AStar::Point *p2 = end_point;
-		int idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = Vector2(p2->pos.x, p2->pos.y);
-			p2 = p2->prev_point;
-		}
-
-		w[0] = Vector2(p2->pos.x, p2->pos.y); // Assign first
+	path.resize(route.size());
+	Vector2 *w = path.ptrw();
+	for (uint32_t i = 0; i < route.size(); i++) {
+		w[i] = Vector2(route[i]->pos.x, route[i]->pos.y);
 	}
 
 	return path;
 }
 
 Vector<int> AStar2D::get_id_path(int p_from_id, int p_to_id) {
-	AStar::Point *a;
-	bool from_exists = astar.points.lookup(p_from_id, a);
-	ERR_FAIL_COND_V(!from_exists, Vector<int>());
-
-	AStar::Point *b;
-	bool to_exists = astar.points.lookup(p_to_id, b);
-	ERR_FAIL_COND_V(!to_exists, Vector<int>());
-
-	if (a == b) {
-		Vector<int> ret;
-		ret.push_back(a->id);
-		return ret;
-	}
-
-	AStar::Point *begin_point = a;
-	AStar::Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
-	if (!found_route) {
-		return Vector<int>();
-	}
-
-	AStar::Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
-
-	Vector<int> path;
-	path.resize(pc);
-
-	{
-		int *w = path.ptrw();
-
-		p = end_point;
-		int idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
-		}
-
-		w[0] = p->id; // Assign first
-	}
-
-	return path;
+	return astar.get_id_path(p_from_id, p_to_id);
 }
 
-bool AStar2D::_solve(AStar::Point *begin_point, AStar::Point *end_point) {
-	astar.pass++;
-
-	if (!end_point->enabled) {
-		return false;
-	}
-
-	bool found_route = false;
-
-	Vector<AStar::Point *> open_list;
-	SortArray<AStar::Point *, AStar::SortPoints> sorter;
-
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
-
-	while (!open_list.is_empty()) {
-		AStar::Point *p = open_list[0]; // The currently processed point
-
-		if (p == end_point) {
-			found_route = true;
-			break;
-		}
-
-		sorter.pop_heap(0, open_list.size(), open_list.ptrw()); // Remove the current point from the open list
-		open_list.remove(open_list.size() - 1);
-		p->closed_pass = astar.pass; // Mark the point as closed
-
-		for (OAHashMap<int, AStar::Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
-			AStar::Point *e = *(it.value); // The neighbour point
-
-			if (!e->enabled || e->closed_pass == astar.pass) {
-				continue;
-			}
-
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
-
-			bool new_point = false;
-
-			if (e->open_pass != astar.pass) { // The point wasn't inside the open list.
-				e->open_pass = astar.pass;
-				open_list.push_back(e);
-				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
-				continue;
-			}
-
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
-
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptrw());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptrw());
-			}
-		}
-	}
-
-	return found_route;
+Array AStar2D::get_id_paths(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids) {
+	return astar.get_id_paths(p_from_ids, p_to_ids);
 }
 
 void AStar2D::_bind_methods() {
@@ -873,11 +1342,17 @@ void AStar2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("reserve_space", "num_nodes"), &AStar2D::reserve_space);
 	ClassDB::bind_method(D_METHOD("clear"), &AStar2D::clear);
 
+	ClassDB::bind_method(D_METHOD("set_spatial_index_cell_size", "cell_size"), &AStar2D::set_spatial_index_cell_size);
+	ClassDB::bind_method(D_METHOD("get_spatial_index_cell_size"), &AStar2D::get_spatial_index_cell_size);
+	ClassDB::bind_method(D_METHOD("set_cluster_size", "cluster_size"), &AStar2D::set_cluster_size);
+	ClassDB::bind_method(D_METHOD("get_cluster_size"), &AStar2D::get_cluster_size);
+
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_position", "include_disabled"), &AStar2D::get_closest_point, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_closest_position_in_segment", "to_position"), &AStar2D::get_closest_position_in_segment);
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStar2D::get_point_path);
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStar2D::get_id_path);
+	ClassDB::bind_method(D_METHOD("get_id_paths", "from_ids", "to_ids"), &AStar2D::get_id_paths);
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "to_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
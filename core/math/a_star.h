@@ -34,7 +34,10 @@
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
+#include "core/templates/pair.h"
 
 /**
 	A* pathfinding algorithm
@@ -42,6 +45,8 @@
 	@author Juan Linietsky <reduzio@gmail.com>
 */
 
+class AStar2D;
+
 class AStar : public RefCounted {
 	GDCLASS(AStar, RefCounted);
 	friend class AStar2D;
@@ -57,22 +62,45 @@ class AStar : public RefCounted {
 		OAHashMap<int, Point *> neighbours = 4u;
 		OAHashMap<int, Point *> unlinked_neighbours = 4u;
 
-		// Used for pathfinding.
-		Point *prev_point = nullptr;
-		real_t g_score = 0;
-		real_t f_score = 0;
-		uint64_t open_pass = 0;
-		uint64_t closed_pass = 0;
+		// Index of the pathfinding data of this point in a SearchState.
+		uint32_t slot = 0;
+
+		// Cells of the spatial index and of the hierarchical search holding this point.
+		uint64_t index_cell = 0;
+		uint64_t cluster = 0;
+		// Index in the entrances of the cluster, -1 when it's not one.
+		int entrance = -1;
+	};
+
+	// Data used by a path search. It's kept apart from the points so that
+	// several searches can run on the same graph at once, each with its own.
+	struct SearchState {
+		struct PointData {
+			Point *prev_point = nullptr;
+			real_t g_score = 0;
+			real_t f_score = 0;
+			uint64_t open_pass = 0;
+			uint64_t closed_pass = 0;
+		};
+
+		LocalVector<PointData> points;
+		uint64_t pass = 1;
+
+		_FORCE_INLINE_ PointData &operator[](const Point *p_point) { return points[p_point->slot]; }
+		_FORCE_INLINE_ const PointData &operator[](const Point *p_point) const { return points[p_point->slot]; }
 	};
 
 	struct SortPoints {
+		const SearchState *state = nullptr;
 		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
+			const SearchState::PointData &a = (*state)[A];
+			const SearchState::PointData &b = (*state)[B];
+			if (a.f_score > b.f_score) {
 				return true;
-			} else if (A->f_score < B->f_score) {
+			} else if (a.f_score < b.f_score) {
 				return false;
 			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+				return a.g_score < b.g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
 			}
 		}
 	};
@@ -111,12 +139,77 @@ class AStar : public RefCounted {
 	};
 
 	int last_free_id = 0;
-	uint64_t pass = 1;
 
 	OAHashMap<int, Point *> points;
 	Set<Segment> segments;
 
-	bool _solve(Point *begin_point, Point *end_point);
+	// Slots of the points in the search states, reused when points are removed.
+	uint32_t slot_count = 0;
+	LocalVector<uint32_t> free_slots;
+
+	// State of the searches done through get_point_path() and get_id_path().
+	SearchState search_state;
+
+	struct IdPathBatch {
+		const int *from_ids = nullptr;
+		const int *to_ids = nullptr;
+		LocalVector<Vector<int>> paths;
+		// One per worker thread, plus one for the calling thread.
+		LocalVector<SearchState> states;
+	};
+
+	// Grid of the points, to find the closest one without testing all of them.
+	real_t spatial_index_cell_size = 0;
+	HashMap<uint64_t, LocalVector<Point *>> index_cells;
+	Vector3i index_cells_begin;
+	Vector3i index_cells_end;
+
+	// Hierarchical search: the points are grouped by clusters, and the paths
+	// are first searched between the points linked to other clusters (the
+	// entrances), using the costs between the entrances of each cluster.
+	struct Cluster {
+		LocalVector<Point *> points;
+		LocalVector<Point *> entrances;
+		// Cost of the path between each pair of entrances staying inside the
+		// cluster, INFINITY when there is none.
+		LocalVector<real_t> entrance_costs;
+		bool dirty = true;
+	};
+
+	struct SortClusterSearch {
+		_FORCE_INLINE_ bool operator()(const Pair<real_t, uint32_t> &A, const Pair<real_t, uint32_t> &B) const {
+			return A.first > B.first;
+		}
+	};
+
+	real_t cluster_size = 0;
+	HashMap<uint64_t, Cluster> clusters;
+
+	// The costs are computed by the AStar2D which wraps this instance, if any.
+	AStar2D *cost_owner = nullptr;
+
+	void _begin_search(SearchState &r_state) const;
+	bool _solve(Point *begin_point, Point *end_point, SearchState &r_state);
+	bool _get_path(Point *p_begin_point, Point *p_end_point, SearchState &r_state, LocalVector<Point *> &r_path);
+	Vector<int> _get_id_path(int p_from_id, int p_to_id, SearchState &r_state);
+	void _get_id_path_batch(uint32_t p_index, IdPathBatch *p_batch);
+	bool _is_cost_overridden() const;
+
+	static Vector3i _get_cell(const Vector3 &p_pos, real_t p_cell_size);
+	static uint64_t _get_cell_key(const Vector3i &p_cell);
+
+	void _index_add_point(Point *p_point);
+	void _index_remove_point(Point *p_point);
+	bool _index_get_closest_point(const Vector3 &p_point, bool p_include_disabled, int &r_id) const;
+
+	void _cluster_add_point(Point *p_point);
+	void _cluster_remove_point(Point *p_point);
+	void _cluster_set_dirty(Point *p_point, bool p_neighbours = false);
+	Cluster *_get_updated_cluster(uint64_t p_key, SearchState &r_state);
+	bool _solve_in_cluster(Point *p_begin_point, Point *p_end_point, bool p_backwards, SearchState &r_state);
+	bool _solve_hierarchical(Point *p_begin_point, Point *p_end_point, SearchState &r_state, LocalVector<Point *> &r_path);
+	real_t _get_estimate_cost(Point *p_from, Point *p_to);
+	real_t _get_compute_cost(Point *p_from, Point *p_to);
 
 protected:
 	static void _bind_methods();
@@ -152,11 +245,18 @@ public:
 	void reserve_space(int p_num_nodes);
 	void clear();
 
+	void set_spatial_index_cell_size(real_t p_cell_size);
+	real_t get_spatial_index_cell_size() const;
+
+	void set_cluster_size(real_t p_cluster_size);
+	real_t get_cluster_size() const;
+
 	int get_closest_point(const Vector3 &p_point, bool p_include_disabled = false) const;
 	Vector3 get_closest_position_in_segment(const Vector3 &p_point) const;
 
 	Vector<Vector3> get_point_path(int p_from_id, int p_to_id);
 	Vector<int> get_id_path(int p_from_id, int p_to_id);
+	Array get_id_paths(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids);
 
 	AStar() {}
 	~AStar();
@@ -164,10 +264,9 @@ public:
 
 class AStar2D : public RefCounted {
 	GDCLASS(AStar2D, RefCounted);
+	friend class AStar;
 	AStar astar;
 
-	bool _solve(AStar::Point *begin_point, AStar::Point *end_point);
-
 protected:
 	static void _bind_methods();
 
@@ -202,13 +301,20 @@ public:
 	void reserve_space(int p_num_nodes);
 	void clear();
 
+	void set_spatial_index_cell_size(real_t p_cell_size);
+	real_t get_spatial_index_cell_size() const;
+
+	void set_cluster_size(real_t p_cluster_size);
+	real_t get_cluster_size() const;
+
 	int get_closest_point(const Vector2 &p_point, bool p_include_disabled = false) const;
 	Vector2 get_closest_position_in_segment(const Vector2 &p_point) const;
 
 	Vector<Vector2> get_point_path(int p_from_id, int p_to_id);
 	Vector<int> get_id_path(int p_from_id, int p_to_id);
+	Array get_id_paths(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids);
 
-	AStar2D() {}
+	AStar2D() { astar.cost_owner = this; }
 	~AStar2D() {}
 };
 
@@ -358,6 +358,49 @@ public:
 		return params.result_count_overall;
 	}
 
+	typedef typename BVHTREE_CLASS::CullPacketHit CullPacketHit;
+
+	// cull a packet of up to BVHCommon::CULL_PACKET_MAX segments at once, the hits are appended to r_hits.
+	// unlike the other culls, this can be called from several threads at the same time.
+	void cull_segments(const Point *p_from, const Point *p_to, int p_count, int p_result_max, LocalVector<CullPacketHit> &r_hits, uint32_t p_mask = 0xFFFFFFFF) const {
+		typename BVHTREE_CLASS::CullPacketParams params;
+		typename BVHABB_CLASS::Segment segments[BVHCommon::CULL_PACKET_MAX];
+
+		ERR_FAIL_COND(p_count > BVHCommon::CULL_PACKET_MAX);
+		for (int n = 0; n < p_count; n++) {
+			segments[n].from = p_from[n];
+			segments[n].to = p_to[n];
+		}
+
+		params.count = p_count;
+		params.segments = segments;
+		params.result_max = p_result_max;
+		params.mask = p_mask;
+		params.hits = &r_hits;
+
+		tree.cull_packet(params);
+	}
+
+	// cull a packet of up to BVHCommon::CULL_PACKET_MAX AABBs at once, the hits are appended to r_hits.
+	// unlike the other culls, this can be called from several threads at the same time.
+	void cull_aabbs(const Bounds *p_aabbs, int p_count, int p_result_max, LocalVector<CullPacketHit> &r_hits, uint32_t p_mask = 0xFFFFFFFF) const {
+		typename BVHTREE_CLASS::CullPacketParams params;
+		BVHABB_CLASS abbs[BVHCommon::CULL_PACKET_MAX];
+
+		ERR_FAIL_COND(p_count > BVHCommon::CULL_PACKET_MAX);
+		for (int n = 0; n < p_count; n++) {
+			abbs[n].from(p_aabbs[n]);
+		}
+
+		params.count = p_count;
+		params.abbs = abbs;
+		params.result_max = p_result_max;
+		params.mask = p_mask;
+		params.hits = &r_hits;
+
+		tree.cull_packet(params);
+	}
+
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) {
 		if (!p_convex.size()) {
 			return 0;
@@ -80,6 +80,9 @@ struct BVHCommon {
 	// or use zero for invalid and +1 based indices.
 	static const uint32_t INVALID = (0xffffffff);
 	static const uint32_t INACTIVE = (0xfffffffe);
+
+	// the most queries culled together in a packet, one bit each.
+	static const int CULL_PACKET_MAX = 32;
 };
 
 // really a handle, can be anything
@@ -101,6 +104,14 @@ struct BVHHandle {
 	bool operator!=(const BVHHandle &p_h) const { return (*this == p_h) == false; }
 };
 
+// a hit of a packet cull, for the query of the packet at the given index
+template <class T>
+struct BVH_PacketHit {
+	T *userdata;
+	int subindex;
+	uint32_t query;
+};
+
 // helper class to make iterative versions of recursive functions
 template <class T>
 class BVH_IterativeInfo {
@@ -386,6 +386,40 @@ bool DynamicBVH::update(const ID &p_id, const AABB &p_box) {
 	return true;
 }
 
+void DynamicBVH::refit(const ID *p_ids, const AABB *p_boxes, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		ERR_CONTINUE(!p_ids[i].is_valid());
+		Node *leaf = p_ids[i].node;
+
+		Volume volume;
+		volume.min = p_boxes[i].position;
+		volume.max = p_boxes[i].position + p_boxes[i].size;
+
+		if (leaf->volume.min.is_equal_approx(volume.min) && leaf->volume.max.is_equal_approx(volume.max)) {
+			continue;
+		}
+
+		// Growing the ancestors in place would let a leaf drift away from its siblings
+		// and inflate every volume above it, so a leaf leaving its parent is reinserted.
+		if (leaf->parent && !leaf->parent->volume.contains(volume)) {
+			update(p_ids[i], p_boxes[i]);
+			continue;
+		}
+		leaf->volume = volume;
+
+		// The ancestors can only shrink, stop as soon as one doesn't change.
+		Node *node = leaf->parent;
+		while (node) {
+			const Volume merged = node->childs[0]->volume.merge(node->childs[1]->volume);
+			if (!merged.is_not_equal_to(node->volume)) {
+				break;
+			}
+			node->volume = merged;
+			node = node->parent;
+		}
+	}
+}
+
 void DynamicBVH::remove(const ID &p_id) {
 	ERR_FAIL_COND(!p_id.is_valid());
 	Node *leaf = p_id.node;
@@ -434,6 +468,13 @@ int DynamicBVH::get_max_depth() const {
 	}
 }
 
+AABB DynamicBVH::get_root_aabb() const {
+	if (!bvh_root) {
+		return AABB();
+	}
+	return AABB(bvh_root->volume.min, bvh_root->volume.max - bvh_root->volume.min);
+}
+
 DynamicBVH::~DynamicBVH() {
 	clear();
 }
@@ -293,11 +293,16 @@ public:
 	void optimize_incremental(int passes);
 	ID insert(const AABB &p_box, void *p_userdata);
 	bool update(const ID &p_id, const AABB &p_box);
+	// Updates many leaves at once. Leaves that stay inside their parent's volume keep their
+	// place and only their ancestors are refitted, the others are reinserted.
+	void refit(const ID *p_ids, const AABB *p_boxes, uint32_t p_count);
 	void remove(const ID &p_id);
 	void get_elements(List<ID> *r_elements);
 
 	int get_leaf_count() const;
 	int get_max_depth() const;
+	// Volume of the root node, which contains every leaf. Empty if there are no leaves.
+	AABB get_root_aabb() const;
 
 	/* Discouraged, but works as a reference on how it must be used */
 	struct DefaultQueryResult {
@@ -1217,6 +1217,36 @@ bool ClassDB::set_property(Object *p_object, const StringName &p_property, const
 	return false;
 }
 
+// Returns the bound setter set_property() would call for objects of this class,
+// so callers setting the same properties many times can skip the lookups.
+// Extension classes and properties without a bound setter return nullptr.
+MethodBind *ClassDB::get_property_setter_bind(const StringName &p_class, const StringName &p_property, int *r_index) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *type = classes.getptr(p_class);
+	if (!type || type->native_extension) {
+		return nullptr;
+	}
+
+	ClassInfo *check = type;
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			if (!psg->setter || !psg->_setptr) {
+				return nullptr;
+			}
+			if (r_index) {
+				*r_index = psg->index;
+			}
+			return psg->_setptr;
+		}
+
+		check = check->inherits_ptr;
+	}
+
+	return nullptr;
+}
+
 bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
 	ERR_FAIL_NULL_V(p_object, false);
 
@@ -35,11 +35,21 @@
 #include "core/object/script_language.h"
 
 MessageQueue *MessageQueue::singleton = nullptr;
+thread_local MessageQueue *MessageQueue::thread_singleton = nullptr;
 
 MessageQueue *MessageQueue::get_singleton() {
+	if (thread_singleton) {
+		return thread_singleton;
+	}
 	return singleton;
 }
 
+MessageQueue *MessageQueue::set_thread_singleton_override(MessageQueue *p_queue) {
+	MessageQueue *prev = thread_singleton;
+	thread_singleton = p_queue;
+	return prev;
+}
+
 Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callable(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
@@ -349,6 +359,11 @@ MessageQueue::MessageQueue() {
 	buffer = memnew_arr(uint8_t, buffer_size);
 }
 
+MessageQueue::MessageQueue(uint32_t p_size_kb) {
+	buffer_size = p_size_kb * 1024;
+	buffer = memnew_arr(uint8_t, buffer_size);
+}
+
 MessageQueue::~MessageQueue() {
 	uint32_t read_pos = 0;
 
@@ -369,6 +384,8 @@ MessageQueue::~MessageQueue() {
 		}
 	}
 
-	singleton = nullptr;
+	if (singleton == this) {
+		singleton = nullptr;
+	}
 	memdelete_arr(buffer);
 }
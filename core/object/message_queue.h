@@ -67,11 +67,15 @@ class MessageQueue {
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
+	static thread_local MessageQueue *thread_singleton;
 
 	bool flushing = false;
 
 public:
 	static MessageQueue *get_singleton();
+	// Redirects get_singleton() on the calling thread to p_queue (nullptr restores the global queue).
+	// Returns the previous override so nested scopes can restore it.
+	static MessageQueue *set_thread_singleton_override(MessageQueue *p_queue);
 
 	Error push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error = false);
 	Error push_call(ObjectID p_id, const StringName &p_method, VARIANT_ARG_LIST);
@@ -92,6 +96,8 @@ public:
 	int get_max_buffer_usage() const;
 
 	MessageQueue();
+	// Creates a standalone queue that does not register itself as the singleton.
+	MessageQueue(uint32_t p_size_kb);
 	~MessageQueue();
 };
 
@@ -0,0 +1,560 @@
+/*************************************************************************/
+/*  worker_thread_pool.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "worker_thread_pool.h"
+
+#include "core/os/os.h"
+
+WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
+thread_local WorkerThreadPool::ThreadData *WorkerThreadPool::current_thread = nullptr;
+
+void WorkerThreadPool::TaskQueue::push_back(Task *p_task) {
+	lock.lock();
+	uint32_t capacity = tasks.size();
+	if (count == capacity) {
+		// Grow and unwrap the ring so the new slots come after the last task.
+		uint32_t new_capacity = capacity ? capacity * 2 : 16;
+		LocalVector<Task *> new_tasks;
+		new_tasks.resize(new_capacity);
+		for (uint32_t i = 0; i < count; i++) {
+			new_tasks[i] = tasks[(head + i) & (capacity - 1)];
+		}
+		tasks = new_tasks;
+		head = 0;
+		capacity = new_capacity;
+	}
+	tasks[(head + count) & (capacity - 1)] = p_task;
+	count++;
+	lock.unlock();
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::TaskQueue::pop_back() {
+	Task *task = nullptr;
+	lock.lock();
+	if (count) {
+		count--;
+		task = tasks[(head + count) & (tasks.size() - 1)];
+	}
+	lock.unlock();
+	return task;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::TaskQueue::pop_front() {
+	Task *task = nullptr;
+	lock.lock();
+	if (count) {
+		task = tasks[head];
+		head = (head + 1) & (tasks.size() - 1);
+		count--;
+	}
+	lock.unlock();
+	return task;
+}
+
+void WorkerThreadPool::_thread_function(void *p_user) {
+	ThreadData *thread = static_cast<ThreadData *>(p_user);
+	WorkerThreadPool *pool = thread->pool;
+	current_thread = thread;
+
+	while (!pool->exit_threads.load()) {
+		Task *task = pool->_pop_task(thread);
+		if (!task) {
+			task = pool->_sleep(thread, &thread->sleeper, true, nullptr);
+		}
+		if (task) {
+			pool->_process_task(task);
+		}
+	}
+
+	current_thread = nullptr;
+}
+
+void WorkerThreadPool::_enqueue_task(Task *p_task) {
+	ThreadData *thread = _get_current_thread();
+	if (thread) {
+		thread->queue.push_back(p_task);
+	} else {
+		global_queue.push_back(p_task);
+	}
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::_pop_task(ThreadData *p_thread) {
+	Task *task = nullptr;
+	if (p_thread) {
+		// Newest first, it is the most likely to still be in cache.
+		task = p_thread->queue.pop_back();
+		if (task) {
+			return task;
+		}
+	}
+
+	task = global_queue.pop_front();
+	if (task) {
+		return task;
+	}
+
+	// Steal the oldest task of another worker, starting from a different one each time.
+	uint32_t offset = p_thread ? p_thread->steal_offset++ : 0;
+	for (uint32_t i = 0; i < thread_count; i++) {
+		ThreadData *victim = &threads[(offset + i) % thread_count];
+		if (victim == p_thread) {
+			continue;
+		}
+		task = victim->queue.pop_front();
+		if (task) {
+			return task;
+		}
+	}
+
+	return nullptr;
+}
+
+void WorkerThreadPool::_process_task(Task *p_task) {
+	if (p_task->group) {
+		Group *group = p_task->group;
+		task_allocator.free(p_task);
+		_process_group(group);
+		_unreference_group(group);
+		return;
+	}
+
+	if (p_task->native_func) {
+		p_task->native_func(p_task->native_func_userdata);
+	} else {
+		p_task->template_userdata->callback();
+	}
+	_complete_item(p_task);
+}
+
+void WorkerThreadPool::_process_group(Group *p_group) {
+	while (true) {
+		uint32_t index = p_group->index.postincrement();
+		if (index >= p_group->max) {
+			break;
+		}
+		if (p_group->native_func) {
+			p_group->native_func(p_group->native_func_userdata, index);
+		} else {
+			p_group->template_userdata->callback_indexed(index);
+		}
+		if (p_group->completed_index.increment() == p_group->max) {
+			_complete_item(p_group);
+		}
+	}
+}
+
+void WorkerThreadPool::_complete_item(Item *p_item) {
+	LocalVector<Task *> ready;
+
+	task_mutex.lock();
+	for (uint32_t i = 0; i < p_item->dependents.size(); i++) {
+		Task *dependent = p_item->dependents[i];
+		dependent->pending_dependencies--;
+		if (dependent->pending_dependencies == 0) {
+			ready.push_back(dependent);
+		}
+	}
+	p_item->dependents.clear();
+	// Once this is set and the mutex released, the waiter may free the item.
+	p_item->completed.store(true);
+	task_mutex.unlock();
+
+	for (uint32_t i = 0; i < ready.size(); i++) {
+		_enqueue_task(ready[i]);
+	}
+	if (ready.size()) {
+		_wake_for_work(ready.size());
+	}
+
+	_wake_for_completion();
+}
+
+void WorkerThreadPool::_unreference_group(Group *p_group) {
+	if (p_group->references.decrement() == 0) {
+		if (p_group->template_userdata) {
+			memdelete(p_group->template_userdata);
+		}
+		group_allocator.free(p_group);
+	}
+}
+
+void WorkerThreadPool::_remove_sleeper_locked(uint32_t p_index) {
+	Sleeper *sleeper = sleepers[p_index];
+	if (sleeper->wants_work) {
+		work_sleepers.fetch_sub(1);
+	}
+	if (sleeper->wants_completion) {
+		completion_sleepers.fetch_sub(1);
+	}
+	sleepers.remove_unordered(p_index);
+}
+
+void WorkerThreadPool::_wake_for_work(uint32_t p_count) {
+	// Pairs with the fence in _sleep(): either the sleeper is seen here, or it sees the new tasks.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (work_sleepers.load() == 0) {
+		return;
+	}
+
+	MutexLock lock(sleep_mutex);
+	uint32_t i = 0;
+	while (i < sleepers.size() && p_count > 0) {
+		Sleeper *sleeper = sleepers[i];
+		if (sleeper->wants_work) {
+			_remove_sleeper_locked(i);
+			sleeper->semaphore.post();
+			p_count--;
+		} else {
+			i++;
+		}
+	}
+}
+
+void WorkerThreadPool::_wake_for_completion() {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (completion_sleepers.load() == 0) {
+		return;
+	}
+
+	// Waiters don't register what they wait for, so all of them check again.
+	MutexLock lock(sleep_mutex);
+	uint32_t i = 0;
+	while (i < sleepers.size()) {
+		Sleeper *sleeper = sleepers[i];
+		if (sleeper->wants_completion) {
+			_remove_sleeper_locked(i);
+			sleeper->semaphore.post();
+		} else {
+			i++;
+		}
+	}
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::_sleep(ThreadData *p_thread, Sleeper *p_sleeper, bool p_wants_work, const Item *p_waiting_for) {
+	p_sleeper->wants_work = p_wants_work;
+	p_sleeper->wants_completion = p_waiting_for != nullptr;
+
+	sleep_mutex.lock();
+	sleepers.push_back(p_sleeper);
+	if (p_wants_work) {
+		work_sleepers.fetch_add(1);
+	}
+	if (p_waiting_for) {
+		completion_sleepers.fetch_add(1);
+	}
+	sleep_mutex.unlock();
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	// Check again now that wakers can see this sleeper, so no wake up is lost.
+	Task *task = p_wants_work ? _pop_task(p_thread) : nullptr;
+	if (task || exit_threads.load() || (p_waiting_for && p_waiting_for->completed.load())) {
+		sleep_mutex.lock();
+		int64_t index = sleepers.find(p_sleeper);
+		if (index >= 0) {
+			_remove_sleeper_locked(index);
+		}
+		sleep_mutex.unlock();
+		if (index >= 0) {
+			return task;
+		}
+		// A waker removed this sleeper already, consume its post below.
+	}
+
+	p_sleeper->semaphore.wait();
+	return task;
+}
+
+void WorkerThreadPool::_wait_for_item(Item *p_item, Group *p_group) {
+	ThreadData *thread = _get_current_thread();
+
+	if (p_group) {
+		// Whoever waits for a group takes part in it.
+		_process_group(p_group);
+	}
+
+	// Workers run other tasks while waiting, so nested tasks always make progress.
+	// Other threads only do so if there are no workers to run them.
+	bool help = thread != nullptr || thread_count == 0;
+
+	Sleeper local_sleeper;
+	Sleeper *sleeper = thread ? &thread->sleeper : &local_sleeper;
+
+	while (!p_item->completed.load()) {
+		Task *task = help ? _pop_task(thread) : nullptr;
+		if (!task) {
+			task = _sleep(thread, sleeper, help, p_item);
+		}
+		if (task) {
+			_process_task(task);
+		}
+	}
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task(Task *p_task, const Vector<TaskID> &p_dependencies) {
+	task_mutex.lock();
+	TaskID id = last_id++;
+	p_task->id = id;
+	tasks[id] = p_task;
+
+	for (int i = 0; i < p_dependencies.size(); i++) {
+		Item *dependency = nullptr;
+		Task **task = tasks.getptr(p_dependencies[i]);
+		if (task) {
+			dependency = *task;
+		} else {
+			Group **group = groups.getptr(p_dependencies[i]);
+			if (group) {
+				dependency = *group;
+			}
+		}
+		// IDs no longer known were already waited for, hence complete.
+		if (dependency && dependency != p_task && !dependency->completed.load()) {
+			dependency->dependents.push_back(p_task);
+			p_task->pending_dependencies++;
+		}
+	}
+
+	bool ready = p_task->pending_dependencies == 0;
+	task_mutex.unlock();
+
+	if (ready) {
+		_enqueue_task(p_task);
+		_wake_for_work(1);
+	}
+
+	return id;
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies) {
+	Task *task = task_allocator.alloc();
+	task->native_func = p_func;
+	task->native_func_userdata = p_userdata;
+	return _add_task(task, p_dependencies);
+}
+
+bool WorkerThreadPool::is_task_completed(TaskID p_task_id) const {
+	MutexLock lock(task_mutex);
+	Task *const *task = tasks.getptr(p_task_id);
+	ERR_FAIL_COND_V_MSG(!task, false, "Invalid Task ID.");
+	return (*task)->completed.load();
+}
+
+void WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
+	task_mutex.lock();
+	Task **taskp = tasks.getptr(p_task_id);
+	if (!taskp) {
+		task_mutex.unlock();
+		ERR_FAIL_MSG("Invalid Task ID.");
+	}
+	Task *task = *taskp;
+	if (task->waited) {
+		task_mutex.unlock();
+		ERR_FAIL_MSG("Task is already being waited for.");
+	}
+	task->waited = true;
+	task_mutex.unlock();
+
+	_wait_for_item(task, nullptr);
+
+	task_mutex.lock();
+	tasks.erase(p_task_id);
+	task_mutex.unlock();
+
+	if (task->template_userdata) {
+		memdelete(task->template_userdata);
+	}
+	task_allocator.free(task);
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(Group *p_group, int p_tasks) {
+	task_mutex.lock();
+	GroupID id = last_id++;
+	p_group->id = id;
+	groups[id] = p_group;
+	task_mutex.unlock();
+
+	if (p_group->max == 0) {
+		p_group->references.set(1);
+		_complete_item(p_group);
+		return id;
+	}
+
+	if (thread_count == 0) {
+		// Without workers the waiter runs the whole group by itself.
+		p_tasks = 0;
+	} else if (p_tasks < 0) {
+		p_tasks = thread_count;
+	}
+	p_tasks = CLAMP(p_tasks, 0, (int)p_group->max);
+	p_group->references.set(p_tasks + 1);
+
+	for (int i = 0; i < p_tasks; i++) {
+		Task *task = task_allocator.alloc();
+		task->group = p_group;
+		_enqueue_task(task);
+	}
+	if (p_tasks) {
+		_wake_for_work(p_tasks);
+	}
+
+	return id;
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks) {
+	ERR_FAIL_COND_V(p_elements < 0, INVALID_TASK_ID);
+	Group *group = group_allocator.alloc();
+	group->native_func = p_func;
+	group->native_func_userdata = p_userdata;
+	group->max = p_elements;
+	return _add_group_task(group, p_tasks);
+}
+
+uint32_t WorkerThreadPool::get_group_processed_element_count(GroupID p_group) const {
+	MutexLock lock(task_mutex);
+	Group *const *group = groups.getptr(p_group);
+	ERR_FAIL_COND_V_MSG(!group, 0, "Invalid Group ID.");
+	return (*group)->completed_index.get();
+}
+
+bool WorkerThreadPool::is_group_task_completed(GroupID p_group) const {
+	MutexLock lock(task_mutex);
+	Group *const *group = groups.getptr(p_group);
+	ERR_FAIL_COND_V_MSG(!group, false, "Invalid Group ID.");
+	return (*group)->completed.load();
+}
+
+void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
+	task_mutex.lock();
+	Group **groupp = groups.getptr(p_group);
+	if (!groupp) {
+		task_mutex.unlock();
+		ERR_FAIL_MSG("Invalid Group ID.");
+	}
+	Group *group = *groupp;
+	if (group->waited) {
+		task_mutex.unlock();
+		ERR_FAIL_MSG("Group is already being waited for.");
+	}
+	group->waited = true;
+	task_mutex.unlock();
+
+	_wait_for_item(group, group);
+
+	task_mutex.lock();
+	groups.erase(p_group);
+	task_mutex.unlock();
+
+	_unreference_group(group);
+}
+
+int WorkerThreadPool::get_thread_index() const {
+	ThreadData *thread = _get_current_thread();
+	return thread ? (int)thread->index : -1;
+}
+
+void WorkerThreadPool::init(int p_thread_count) {
+	ERR_FAIL_COND(threads != nullptr);
+
+#ifdef NO_THREADS
+	p_thread_count = 0;
+#else
+	if (p_thread_count <= 0) {
+		p_thread_count = OS::get_singleton()->get_processor_count();
+	}
+#endif
+
+	thread_count = p_thread_count;
+	if (thread_count == 0) {
+		return;
+	}
+
+	exit_threads.store(false);
+	threads = memnew_arr(ThreadData, thread_count);
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].pool = this;
+		threads[i].index = i;
+		threads[i].steal_offset = i + 1;
+		threads[i].thread.start(&WorkerThreadPool::_thread_function, &threads[i]);
+	}
+}
+
+void WorkerThreadPool::finish() {
+	if (threads == nullptr) {
+		return;
+	}
+
+	exit_threads.store(true);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	sleep_mutex.lock();
+	while (sleepers.size()) {
+		Sleeper *sleeper = sleepers[0];
+		_remove_sleeper_locked(0);
+		sleeper->semaphore.post();
+	}
+	sleep_mutex.unlock();
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].thread.wait_to_finish();
+	}
+
+	// Tasks of groups whose elements were all processed by their waiter may still be queued.
+	Task *task = _pop_task(nullptr);
+	while (task) {
+		_process_task(task);
+		task = _pop_task(nullptr);
+	}
+
+	if (tasks.size() || groups.size()) {
+		WARN_PRINT("WorkerThreadPool finished with tasks that were never waited for.");
+	}
+
+	memdelete_arr(threads);
+	threads = nullptr;
+	thread_count = 0;
+}
+
+WorkerThreadPool::WorkerThreadPool() {
+	exit_threads.store(false);
+	work_sleepers.store(0);
+	completion_sleepers.store(0);
+	if (!singleton) {
+		singleton = this;
+	}
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+	finish();
+	if (singleton == this) {
+		singleton = nullptr;
+	}
+}
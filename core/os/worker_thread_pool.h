@@ -0,0 +1,254 @@
+/*************************************************************************/
+/*  worker_thread_pool.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef WORKER_THREAD_POOL_H
+#define WORKER_THREAD_POOL_H
+
+#include "core/os/memory.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/spin_lock.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/paged_allocator.h"
+#include "core/templates/safe_refcount.h"
+#include "core/templates/vector.h"
+
+#include <atomic>
+
+// Engine-wide pool of worker threads, shared by every subsystem that needs to
+// spread work across cores (physics, rendering, navigation, editor...).
+//
+// Each worker owns a task deque. Tasks added from a worker are pushed to and
+// popped from the back of its own deque, while idle workers steal from the
+// front of the others. Tasks added from threads outside the pool go to a
+// shared queue.
+//
+// Every task and group task must be waited for exactly once, which is also
+// when its resources are released. A worker waiting for a task keeps running
+// other pending tasks in the meantime, so tasks can add and wait for nested
+// tasks (e.g. a parallel for inside a parallel for) without deadlocking.
+
+class WorkerThreadPool {
+public:
+	typedef int64_t TaskID;
+	typedef int64_t GroupID;
+
+	enum {
+		INVALID_TASK_ID = -1
+	};
+
+private:
+	struct BaseTemplateUserdata {
+		virtual void callback() {}
+		virtual void callback_indexed(uint32_t p_index) {}
+		virtual ~BaseTemplateUserdata() {}
+	};
+
+	template <class C, class M, class U>
+	struct TaskUserdata : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback() override {
+			(instance->*method)(userdata);
+		}
+	};
+
+	template <class C, class M, class U>
+	struct GroupUserdata : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback_indexed(uint32_t p_index) override {
+			(instance->*method)(p_index, userdata);
+		}
+	};
+
+	struct Task;
+
+	// Completion state shared by tasks and groups, so both can be waited for
+	// and used as dependencies of other tasks.
+	struct Item {
+		int64_t id = INVALID_TASK_ID;
+		std::atomic<bool> completed;
+		bool waited = false; // Protected by task_mutex.
+		LocalVector<Task *> dependents; // Protected by task_mutex.
+		Item() {
+			completed.store(false);
+		}
+	};
+
+	struct Group : public Item {
+		void (*native_func)(void *, uint32_t) = nullptr;
+		void *native_func_userdata = nullptr;
+		BaseTemplateUserdata *template_userdata = nullptr;
+		uint32_t max = 0;
+		SafeNumeric<uint32_t> index;
+		SafeNumeric<uint32_t> completed_index;
+		SafeNumeric<uint32_t> references; // One per queued task, plus one for the waiter.
+	};
+
+	struct Task : public Item {
+		void (*native_func)(void *) = nullptr;
+		void *native_func_userdata = nullptr;
+		BaseTemplateUserdata *template_userdata = nullptr;
+		Group *group = nullptr; // Tasks created to run a group are not waitable on their own.
+		uint32_t pending_dependencies = 0; // Protected by task_mutex.
+	};
+
+	// Ring buffer deque. The owner works on the back, thieves on the front.
+	struct TaskQueue {
+		SpinLock lock;
+		LocalVector<Task *> tasks;
+		uint32_t head = 0;
+		uint32_t count = 0;
+
+		void push_back(Task *p_task);
+		Task *pop_back();
+		Task *pop_front();
+	};
+
+	struct Sleeper {
+		Semaphore semaphore;
+		bool wants_work = false;
+		bool wants_completion = false;
+	};
+
+	struct ThreadData {
+		WorkerThreadPool *pool = nullptr;
+		uint32_t index = 0;
+		uint32_t steal_offset = 0;
+		Thread thread;
+		TaskQueue queue;
+		Sleeper sleeper;
+	};
+
+	static WorkerThreadPool *singleton;
+	static thread_local ThreadData *current_thread;
+
+	ThreadData *threads = nullptr;
+	uint32_t thread_count = 0;
+	std::atomic<bool> exit_threads;
+
+	TaskQueue global_queue;
+
+	BinaryMutex task_mutex;
+	TaskID last_id = 0;
+	HashMap<TaskID, Task *> tasks;
+	HashMap<GroupID, Group *> groups;
+	PagedAllocator<Task, true> task_allocator;
+	PagedAllocator<Group, true> group_allocator;
+
+	BinaryMutex sleep_mutex;
+	LocalVector<Sleeper *> sleepers;
+	std::atomic<uint32_t> work_sleepers;
+	std::atomic<uint32_t> completion_sleepers;
+
+	static void _thread_function(void *p_user);
+
+	_FORCE_INLINE_ ThreadData *_get_current_thread() const {
+		return (current_thread && current_thread->pool == this) ? current_thread : nullptr;
+	}
+
+	TaskID _add_task(Task *p_task, const Vector<TaskID> &p_dependencies);
+	GroupID _add_group_task(Group *p_group, int p_tasks);
+
+	void _enqueue_task(Task *p_task);
+	Task *_pop_task(ThreadData *p_thread);
+	void _process_task(Task *p_task);
+	void _process_group(Group *p_group);
+	void _complete_item(Item *p_item);
+	void _unreference_group(Group *p_group);
+
+	void _remove_sleeper_locked(uint32_t p_index);
+	void _wake_for_work(uint32_t p_count);
+	void _wake_for_completion();
+	Task *_sleep(ThreadData *p_thread, Sleeper *p_sleeper, bool p_wants_work, const Item *p_waiting_for);
+	void _wait_for_item(Item *p_item, Group *p_group);
+
+public:
+	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+	template <class C, class M, class U>
+	TaskID add_template_task(C *p_instance, M p_method, U p_userdata, const Vector<TaskID> &p_dependencies = Vector<TaskID>()) {
+		TaskUserdata<C, M, U> *ud = memnew((TaskUserdata<C, M, U>));
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+
+		Task *task = task_allocator.alloc();
+		task->template_userdata = ud;
+		return _add_task(task, p_dependencies);
+	}
+	bool is_task_completed(TaskID p_task_id) const;
+	void wait_for_task_completion(TaskID p_task_id);
+
+	// Calls the function once for every index in [0, p_elements), spread over
+	// at most p_tasks workers (-1 means one per thread).
+	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks = -1);
+	template <class C, class M, class U>
+	GroupID add_template_group_task(C *p_instance, M p_method, U p_userdata, int p_elements, int p_tasks = -1) {
+		GroupUserdata<C, M, U> *ud = memnew((GroupUserdata<C, M, U>));
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+
+		Group *group = group_allocator.alloc();
+		group->template_userdata = ud;
+		group->max = p_elements;
+		return _add_group_task(group, p_tasks);
+	}
+	uint32_t get_group_processed_element_count(GroupID p_group) const;
+	bool is_group_task_completed(GroupID p_group) const;
+	void wait_for_group_task_completion(GroupID p_group);
+
+	// Convenience for the common "run this array in parallel and wait" case.
+	template <class C, class M, class U>
+	void do_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
+		wait_for_group_task_completion(add_template_group_task(p_instance, p_method, p_userdata, p_elements));
+	}
+
+	// Never less than one. Without worker threads whoever waits for a group runs it,
+	// so work split in one element per thread still runs.
+	_FORCE_INLINE_ int get_thread_count() const { return MAX(thread_count, 1u); }
+	// Index of the calling worker thread in this pool, or -1 if called from outside the pool.
+	int get_thread_index() const;
+
+	static WorkerThreadPool *get_singleton() { return singleton; }
+	// Zero or less means one thread per logical core.
+	void init(int p_thread_count = -1);
+	void finish();
+
+	WorkerThreadPool();
+	~WorkerThreadPool();
+};
+
+#endif // WORKER_THREAD_POOL_H
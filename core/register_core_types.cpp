@@ -74,6 +74,7 @@
 #include "core/object/undo_redo.h"
 #include "core/os/main_loop.h"
 #include "core/os/time.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/string/optimized_translation.h"
 #include "core/string/translation.h"
 
@@ -108,12 +109,16 @@ extern void unregister_global_constants();
 
 static ResourceUID *resource_uid = nullptr;
 
+static WorkerThreadPool *worker_thread_pool = nullptr;
+
 void register_core_types() {
 	//consistency check
 	static_assert(sizeof(Callable) <= 16);
 
 	ObjectDB::setup();
 
+	worker_thread_pool = memnew(WorkerThreadPool);
+
 	StringName::setup();
 	ResourceLoader::initialize();
 
@@ -266,6 +271,10 @@ void register_core_settings() {
 
 	GLOBAL_DEF("network/ssl/certificate_bundle_override", "");
 	ProjectSettings::get_singleton()->set_custom_property_info("network/ssl/certificate_bundle_override", PropertyInfo(Variant::STRING, "network/ssl/certificate_bundle_override", PROPERTY_HINT_FILE, "*.crt"));
+
+	GLOBAL_DEF_RST("threading/resource_loader/max_io_tasks", 2);
+	ProjectSettings::get_singleton()->set_custom_property_info("threading/resource_loader/max_io_tasks", PropertyInfo(Variant::INT, "threading/resource_loader/max_io_tasks", PROPERTY_HINT_RANGE, "0,64,1,or_greater"));
+	ResourceLoader::set_thread_load_io_max(GLOBAL_GET("threading/resource_loader/max_io_tasks"));
 }
 
 void register_core_singletons() {
@@ -317,6 +326,8 @@ void unregister_core_types() {
 
 	memdelete(native_extension_manager);
 
+	memdelete(worker_thread_pool);
+
 	memdelete(resource_uid);
 	memdelete(_resource_loader);
 	memdelete(_resource_saver);
@@ -39,14 +39,13 @@ StaticCString StaticCString::create(const char *p_ptr) {
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+StringName::_Shard StringName::_shards[STRING_TABLE_SHARDS];
 
 StringName _scs_create(const char *p_chr, bool p_static) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr), p_static) : StringName());
 }
 
 bool StringName::configured = false;
-Mutex StringName::mutex;
 
 #ifdef DEBUG_ENABLED
 bool StringName::debug_stringname = false;
@@ -54,60 +53,193 @@ bool StringName::debug_stringname = false;
 
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		_table[i] = nullptr;
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+		_Shard &shard = _shards[i];
+		shard.table = memnew_arr(_Data *, STRING_TABLE_SHARD_INITIAL_LEN);
+		for (int j = 0; j < STRING_TABLE_SHARD_INITIAL_LEN; j++) {
+			shard.table[j] = nullptr;
+		}
+		shard.mask = STRING_TABLE_SHARD_INITIAL_LEN - 1;
+		shard.count = 0;
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
-	MutexLock lock(mutex);
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+		_shards[i].lock.write_lock();
+	}
 
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
 		Vector<_Data *> data;
-		for (int i = 0; i < STRING_TABLE_LEN; i++) {
-			_Data *d = _table[i];
-			while (d) {
-				data.push_back(d);
-				d = d->next;
+		for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+			const _Shard &shard = _shards[i];
+			for (uint32_t j = 0; j <= shard.mask; j++) {
+				_Data *d = shard.table[j];
+				while (d) {
+					data.push_back(d);
+					d = d->next;
+				}
 			}
 		}
 		print_line("\nStringName Reference Ranking:\n");
 		data.sort_custom<DebugSortReferences>();
 		for (int i = 0; i < MIN(100, data.size()); i++) {
-			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references));
+			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references.get()));
 		}
 	}
 #endif
 	int lost_strings = 0;
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		while (_table[i]) {
-			_Data *d = _table[i];
-			lost_strings++;
-			if (d->static_count.get() != d->refcount.get() && OS::get_singleton()->is_stdout_verbose()) {
-				if (d->cname) {
-					print_line("Orphan StringName: " + String(d->cname));
-				} else {
-					print_line("Orphan StringName: " + String(d->name));
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+		_Shard &shard = _shards[i];
+		for (uint32_t j = 0; j <= shard.mask; j++) {
+			while (shard.table[j]) {
+				_Data *d = shard.table[j];
+				lost_strings++;
+				if (d->static_count.get() != d->refcount.get() && OS::get_singleton()->is_stdout_verbose()) {
+					if (d->cname) {
+						print_line("Orphan StringName: " + String(d->cname));
+					} else {
+						print_line("Orphan StringName: " + String(d->name));
+					}
 				}
-			}
 
-			_table[i] = _table[i]->next;
-			memdelete(d);
+				shard.table[j] = shard.table[j]->next;
+				memdelete(d);
+			}
 		}
+		memdelete_arr(shard.table);
+		shard.table = nullptr;
+		shard.mask = 0;
+		shard.count = 0;
 	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
 	configured = false;
+
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+		_shards[i].lock.write_unlock();
+	}
+}
+
+template <class T>
+StringName::_Data *StringName::_find_and_ref(const _Shard &p_shard, uint32_t p_hash, const T &p_name) {
+	_Data *d = p_shard.table[p_hash & p_shard.mask];
+
+	while (d) {
+		// Compare hash first. An entry whose last reference is being released can't be referenced
+		// again, skip it; it will be removed as soon as the releasing thread gets the write lock.
+		if (d->hash == p_hash && d->get_name() == p_name && d->refcount.ref()) {
+#ifdef DEBUG_ENABLED
+			if (unlikely(debug_stringname)) {
+				d->debug_references.increment();
+			}
+#endif
+			return d;
+		}
+		d = d->next;
+	}
+
+	return nullptr;
+}
+
+template <class T>
+StringName::_Data *StringName::_intern(uint32_t p_hash, const T &p_name, const char *p_cname, bool p_static) {
+	_Shard &shard = _get_shard(p_hash);
+
+	// Fast path, the name is usually interned already.
+	shard.lock.read_lock();
+	_Data *d = _find_and_ref(shard, p_hash, p_name);
+	shard.lock.read_unlock();
+
+	if (d) {
+		if (p_static) {
+			d->static_count.increment();
+		}
+		return d;
+	}
+
+	RWLockWrite lock(shard.lock);
+
+	// Another thread may have added it between both locks.
+	d = _find_and_ref(shard, p_hash, p_name);
+	if (d) {
+		if (p_static) {
+			d->static_count.increment();
+		}
+		return d;
+	}
+
+	d = memnew(_Data);
+	if (p_cname) {
+		d->cname = p_cname;
+	} else {
+		d->name = p_name;
+	}
+	d->refcount.init();
+	d->static_count.set(p_static ? 1 : 0);
+	d->hash = p_hash;
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		// Keep in memory, force static.
+		d->refcount.ref();
+		d->static_count.increment();
+	}
+#endif
+
+	uint32_t idx = p_hash & shard.mask;
+	d->next = shard.table[idx];
+	d->prev = nullptr;
+	if (shard.table[idx]) {
+		shard.table[idx]->prev = d;
+	}
+	shard.table[idx] = d;
+
+	shard.count++;
+	if (shard.count > shard.mask + 1) {
+		_grow_shard(shard);
+	}
+
+	return d;
+}
+
+void StringName::_grow_shard(_Shard &p_shard) {
+	// Called with the shard write lock held.
+	uint32_t old_len = p_shard.mask + 1;
+	uint32_t new_len = old_len << 1;
+	_Data **new_table = memnew_arr(_Data *, new_len);
+	for (uint32_t i = 0; i < new_len; i++) {
+		new_table[i] = nullptr;
+	}
+
+	for (uint32_t i = 0; i < old_len; i++) {
+		_Data *d = p_shard.table[i];
+		while (d) {
+			_Data *next = d->next;
+			uint32_t idx = d->hash & (new_len - 1);
+			d->prev = nullptr;
+			d->next = new_table[idx];
+			if (new_table[idx]) {
+				new_table[idx]->prev = d;
+			}
+			new_table[idx] = d;
+			d = next;
+		}
+	}
+
+	memdelete_arr(p_shard.table);
+	p_shard.table = new_table;
+	p_shard.mask = new_len - 1;
 }
 
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		_Shard &shard = _get_shard(_data->hash);
+		RWLockWrite lock(shard.lock);
 
 		if (_data->static_count.get() > 0) {
 			if (_data->cname) {
@@ -119,15 +251,17 @@ void StringName::unref() {
 		if (_data->prev) {
 			_data->prev->next = _data->next;
 		} else {
-			if (_table[_data->idx] != _data) {
+			uint32_t idx = _data->hash & shard.mask;
+			if (shard.table[idx] != _data) {
 				ERR_PRINT("BUG!");
 			}
-			_table[_data->idx] = _data->next;
+			shard.table[idx] = _data->next;
 		}
 
 		if (_data->next) {
 			_data->next->prev = _data->prev;
 		}
+		shard.count--;
 		memdelete(_data);
 	}
 
@@ -191,58 +325,7 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
-		}
-
-		return;
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(String::hash(p_name), p_name, nullptr, p_static);
 }
 
 StringName::StringName(const StaticCString &p_static_string, bool p_static) {
@@ -252,57 +335,7 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_static_string.ptr);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(String::hash(p_static_string.ptr), p_static_string.ptr, p_static_string.ptr, p_static);
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -314,56 +347,7 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(p_name.hash(), p_name, nullptr, p_static);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -374,29 +358,13 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
+	_Shard &shard = _get_shard(hash);
+	RWLockRead lock(shard.lock);
 
-		return StringName(_data);
+	_Data *d = _find_and_ref(shard, hash, p_name);
+	if (d) {
+		return StringName(d);
 	}
 
 	return StringName(); //does not exist
@@ -410,24 +378,13 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
+	_Shard &shard = _get_shard(hash);
+	RWLockRead lock(shard.lock);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	_Data *d = _find_and_ref(shard, hash, p_name);
+	if (d) {
+		return StringName(d);
 	}
 
 	return StringName(); //does not exist
@@ -436,29 +393,13 @@ StringName StringName::search(const char32_t *p_name) {
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
+	_Shard &shard = _get_shard(hash);
+	RWLockRead lock(shard.lock);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return StringName(_data);
+	_Data *d = _find_and_ref(shard, hash, p_name);
+	if (d) {
+		return StringName(d);
 	}
 
 	return StringName(); //does not exist
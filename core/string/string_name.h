@@ -32,6 +32,7 @@
 #define STRING_NAME_H
 
 #include "core/os/mutex.h"
+#include "core/os/rw_lock.h"
 #include "core/string/ustring.h"
 #include "core/templates/safe_refcount.h"
 
@@ -44,9 +45,9 @@ struct StaticCString {
 
 class StringName {
 	enum {
-		STRING_TABLE_BITS = 16,
-		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARDS = 1 << STRING_TABLE_SHARD_BITS,
+		STRING_TABLE_SHARD_INITIAL_LEN = 256,
 	};
 
 	struct _Data {
@@ -55,17 +56,25 @@ class StringName {
 		const char *cname = nullptr;
 		String name;
 #ifdef DEBUG_ENABLED
-		uint32_t debug_references = 0;
+		SafeNumeric<uint32_t> debug_references;
 #endif
 		String get_name() const { return cname ? String(cname) : name; }
-		int idx = 0;
 		uint32_t hash = 0;
 		_Data *prev = nullptr;
 		_Data *next = nullptr;
 		_Data() {}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	// The intern table is split in shards, each one with its own lock and growable bucket array,
+	// so lookups of existing names from different threads rarely touch the same lock.
+	struct _Shard {
+		RWLock lock;
+		_Data **table = nullptr;
+		uint32_t mask = 0;
+		uint32_t count = 0;
+	};
+
+	static _Shard _shards[STRING_TABLE_SHARDS];
 
 	_Data *_data = nullptr;
 
@@ -74,18 +83,28 @@ class StringName {
 		uint32_t hash;
 	};
 
+	_FORCE_INLINE_ static _Shard &_get_shard(uint32_t p_hash) {
+		// Short names have hashes with empty upper bits, scramble before picking the shard.
+		return _shards[(p_hash * 0x9E3779B1) >> (32 - STRING_TABLE_SHARD_BITS)];
+	}
+
+	template <class T>
+	static _Data *_find_and_ref(const _Shard &p_shard, uint32_t p_hash, const T &p_name);
+	template <class T>
+	static _Data *_intern(uint32_t p_hash, const T &p_name, const char *p_cname, bool p_static);
+	static void _grow_shard(_Shard &p_shard);
+
 	void unref();
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static Mutex mutex;
 	static void setup();
 	static void cleanup();
 	static bool configured;
 #ifdef DEBUG_ENABLED
 	struct DebugSortReferences {
 		bool operator()(const _Data *p_left, const _Data *p_right) const {
-			return p_left->debug_references > p_right->debug_references;
+			return p_left->debug_references.get() > p_right->debug_references.get();
 		}
 	};
 
@@ -33,6 +33,8 @@
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
 
+#include <thread>
+
 void CommandQueueMT::lock() {
 	mutex.lock();
 }
@@ -50,15 +52,13 @@ CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 	int idx = -1;
 
 	while (true) {
-		lock();
 		for (int i = 0; i < SYNC_SEMAPHORES; i++) {
-			if (!sync_sems[i].in_use) {
-				sync_sems[i].in_use = true;
+			bool expected = false;
+			if (sync_sems[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
 				idx = i;
 				break;
 			}
 		}
-		unlock();
 
 		if (idx == -1) {
 			wait_for_flush();
@@ -70,7 +70,72 @@ CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 	return &sync_sems[idx];
 }
 
+void CommandQueueMT::_spin_wait() {
+	std::this_thread::yield();
+}
+
+CommandQueueMT::Block *CommandQueueMT::_alloc_block() {
+	Block *block = nullptr;
+
+	lock();
+	if (free_blocks) {
+		block = free_blocks;
+		free_blocks = block->next_free;
+	}
+	unlock();
+
+	if (!block) {
+		block = memnew_placement(memalloc(BLOCK_HEADER_SIZE + block_size), Block);
+	}
+
+	// Clear the command states before opening the block for reservations.
+	memset(block->get_data(), 0, block_size);
+	block->next_free = nullptr;
+	block->next.store(nullptr, std::memory_order_relaxed);
+	block->reserved.store(0, std::memory_order_release);
+	return block;
+}
+
+void CommandQueueMT::_free_block(Block *p_block) {
+	// Keep the reservation offset past the end, so producers still holding
+	// a stale pointer to this block wait for the current one instead.
+	p_block->reserved.store(block_size + 1, std::memory_order_release);
+
+	lock();
+	p_block->next_free = free_blocks;
+	free_blocks = p_block;
+	unlock();
+}
+
+void CommandQueueMT::_link_next_block(Block *p_block, uint32_t p_offset) {
+	if (p_offset + sizeof(CommandHeader) <= block_size) {
+		CommandHeader *header = reinterpret_cast<CommandHeader *>(p_block->get_data() + p_offset);
+		header->state.store(COMMAND_STATE_BLOCK_END, std::memory_order_release);
+	}
+
+	Block *next = _alloc_block();
+	p_block->next.store(next, std::memory_order_release);
+	write_block.store(next, std::memory_order_release);
+}
+
+void CommandQueueMT::_advance_read_block() {
+	Block *block = read_block;
+	read_block = block->next.load(std::memory_order_acquire);
+	read_offset = 0;
+	_free_block(block);
+}
+
 CommandQueueMT::CommandQueueMT(bool p_sync) {
+	uint32_t size_kb = DEFAULT_COMMAND_MEM_SIZE_KB;
+	if (ProjectSettings::get_singleton()) {
+		size_kb = GLOBAL_DEF_RST("memory/limits/command_queue/multithreading_queue_size_kb", DEFAULT_COMMAND_MEM_SIZE_KB);
+		ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/command_queue/multithreading_queue_size_kb", PropertyInfo(Variant::INT, "memory/limits/command_queue/multithreading_queue_size_kb", PROPERTY_HINT_RANGE, "1,4096,1,or_greater"));
+	}
+	block_size = MAX(size_kb, 1u) * 1024;
+
+	read_block = _alloc_block();
+	write_block.store(read_block, std::memory_order_release);
+
 	if (p_sync) {
 		sync = memnew(Semaphore);
 	}
@@ -80,4 +145,16 @@ CommandQueueMT::~CommandQueueMT() {
 	if (sync) {
 		memdelete(sync);
 	}
+
+	Block *block = read_block;
+	while (block) {
+		Block *next = block->next.load(std::memory_order_acquire);
+		memfree(block);
+		block = next;
+	}
+	while (free_blocks) {
+		Block *next = free_blocks->next_free;
+		memfree(free_blocks);
+		free_blocks = next;
+	}
 }
@@ -35,10 +35,11 @@
 #include "core/os/mutex.h"
 #include "core/os/semaphore.h"
 #include "core/string/print_string.h"
-#include "core/templates/local_vector.h"
 #include "core/templates/simple_type.h"
 #include "core/typedefs.h"
 
+#include <atomic>
+
 #define COMMA(N) _COMMA_##N
 #define _COMMA_0
 #define _COMMA_1 ,
@@ -250,11 +251,11 @@
 #define DECL_PUSH(N)                                                         \
 	template <class T, class M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>       \
 	void push(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
-		CMD_TYPE(N) *cmd = allocate_and_lock<CMD_TYPE(N)>();                 \
+		CMD_TYPE(N) *cmd = allocate<CMD_TYPE(N)>();                          \
 		cmd->instance = p_instance;                                          \
 		cmd->method = p_method;                                              \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                 \
-		unlock();                                                            \
+		commit(cmd);                                                         \
 		if (sync)                                                            \
 			sync->post();                                                    \
 	}
@@ -265,17 +266,17 @@
 	template <class T, class M, COMMA_SEP_LIST(TYPE_PARAM, N) COMMA(N) class R>                \
 	void push_and_ret(T *p_instance, M p_method, COMMA_SEP_LIST(PARAM, N) COMMA(N) R *r_ret) { \
 		SyncSemaphore *ss = _alloc_sync_sem();                                                 \
-		CMD_RET_TYPE(N) *cmd = allocate_and_lock<CMD_RET_TYPE(N)>();                           \
+		CMD_RET_TYPE(N) *cmd = allocate<CMD_RET_TYPE(N)>();                                    \
 		cmd->instance = p_instance;                                                            \
 		cmd->method = p_method;                                                                \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
 		cmd->ret = r_ret;                                                                      \
 		cmd->sync_sem = ss;                                                                    \
-		unlock();                                                                              \
+		commit(cmd);                                                                           \
 		if (sync)                                                                              \
 			sync->post();                                                                      \
 		ss->sem.wait();                                                                        \
-		ss->in_use = false;                                                                    \
+		ss->in_use.store(false, std::memory_order_release);                                    \
 	}
 
 #define CMD_SYNC_TYPE(N) CommandSync##N<T, M COMMA(N) COMMA_SEP_LIST(TYPE_ARG, N)>
@@ -284,16 +285,16 @@
 	template <class T, class M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>                \
 	void push_and_sync(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
 		SyncSemaphore *ss = _alloc_sync_sem();                                        \
-		CMD_SYNC_TYPE(N) *cmd = allocate_and_lock<CMD_SYNC_TYPE(N)>();                \
+		CMD_SYNC_TYPE(N) *cmd = allocate<CMD_SYNC_TYPE(N)>();                         \
 		cmd->instance = p_instance;                                                   \
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
 		cmd->sync_sem = ss;                                                           \
-		unlock();                                                                     \
+		commit(cmd);                                                                  \
 		if (sync)                                                                     \
 			sync->post();                                                             \
 		ss->sem.wait();                                                               \
-		ss->in_use = false;                                                           \
+		ss->in_use.store(false, std::memory_order_release);                           \
 	}
 
 #define MAX_CMD_PARAMS 15
@@ -301,7 +302,7 @@
 class CommandQueueMT {
 	struct SyncSemaphore {
 		Semaphore sem;
-		bool in_use = false;
+		std::atomic<bool> in_use = { false };
 	};
 
 	struct CommandBase {
@@ -336,49 +337,140 @@ class CommandQueueMT {
 		SYNC_SEMAPHORES = 8
 	};
 
-	LocalVector<uint8_t> command_mem;
+	// Commands are written into a chain of fixed size blocks. Producers reserve
+	// space with an atomic add on the current block and publish the command by
+	// setting the state of its header, so pushing never takes a lock. Only the
+	// thread whose reservation overflows a block links in the next one. The
+	// consumer executes commands in reservation order and recycles the blocks
+	// it has finished with.
+
+	enum {
+		COMMAND_STATE_EMPTY,
+		COMMAND_STATE_READY,
+		COMMAND_STATE_BLOCK_END,
+	};
+
+	struct CommandHeader {
+		std::atomic<uint32_t> state;
+		uint32_t size; // Size of the command following the header.
+	};
+
+	struct Block {
+		std::atomic<uint32_t> reserved;
+		std::atomic<Block *> next;
+		Block *next_free = nullptr;
+
+		_FORCE_INLINE_ uint8_t *get_data() {
+			return reinterpret_cast<uint8_t *>(this) + BLOCK_HEADER_SIZE;
+		}
+	};
+
+	static const uint32_t BLOCK_HEADER_SIZE = (sizeof(Block) + 15) & ~15;
+
+	uint32_t block_size = 0;
+	std::atomic<Block *> write_block;
+	Block *read_block = nullptr;
+	uint32_t read_offset = 0;
+	Block *free_blocks = nullptr;
+
 	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
 	Mutex mutex;
+	Mutex flush_mutex;
 	Semaphore *sync = nullptr;
 
+	Block *_alloc_block();
+	void _free_block(Block *p_block);
+	void _link_next_block(Block *p_block, uint32_t p_offset);
+	static void _spin_wait();
+
 	template <class T>
 	T *allocate() {
-		// alloc size is size+T+safeguard
-		uint32_t alloc_size = ((sizeof(T) + 8 - 1) & ~(8 - 1));
-		uint64_t size = command_mem.size();
-		command_mem.resize(size + alloc_size + 8);
-		*(uint64_t *)&command_mem[size] = alloc_size;
-		T *cmd = memnew_placement(&command_mem[size + 8], T);
-		return cmd;
+		const uint32_t alloc_size = sizeof(CommandHeader) + ((sizeof(T) + 8 - 1) & ~(8 - 1));
+		CRASH_COND_MSG(alloc_size > block_size, "Command does not fit in a command queue block.");
+
+		while (true) {
+			Block *block = write_block.load(std::memory_order_acquire);
+			const uint32_t offset = block->reserved.fetch_add(alloc_size, std::memory_order_acq_rel);
+			if (likely(offset + alloc_size <= block_size)) {
+				CommandHeader *header = reinterpret_cast<CommandHeader *>(block->get_data() + offset);
+				header->size = alloc_size - sizeof(CommandHeader);
+				return memnew_placement(header + 1, T);
+			}
+
+			if (offset <= block_size) {
+				// This reservation is the first one past the end of the block.
+				_link_next_block(block, offset);
+			} else {
+				// Another producer is linking the next block. Stop waiting as well if
+				// the block was recycled and reopened in the meantime.
+				while (write_block.load(std::memory_order_acquire) == block && block->next.load(std::memory_order_acquire) == nullptr && block->reserved.load(std::memory_order_acquire) > block_size) {
+					_spin_wait();
+				}
+			}
+		}
 	}
 
 	template <class T>
-	T *allocate_and_lock() {
-		lock();
-		T *ret = allocate<T>();
-		return ret;
+	_FORCE_INLINE_ void commit(T *p_cmd) {
+		CommandHeader *header = reinterpret_cast<CommandHeader *>(p_cmd) - 1;
+		header->state.store(COMMAND_STATE_READY, std::memory_order_release);
 	}
 
-	void _flush() {
-		lock();
+	bool _has_pending() {
+		if (read_offset + sizeof(CommandHeader) > block_size) {
+			return read_block->next.load(std::memory_order_acquire) != nullptr;
+		}
+		const CommandHeader *header = reinterpret_cast<const CommandHeader *>(read_block->get_data() + read_offset);
+		return header->state.load(std::memory_order_acquire) != COMMAND_STATE_EMPTY;
+	}
 
-		uint64_t read_ptr = 0;
-		uint64_t limit = command_mem.size();
+	void _advance_read_block();
 
-		while (read_ptr < limit) {
-			uint64_t size = *(uint64_t *)&command_mem[read_ptr];
-			read_ptr += 8;
-			CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[read_ptr]);
+	void _flush() {
+		MutexLock flush_lock(flush_mutex);
+
+		while (true) {
+			if (read_offset + sizeof(CommandHeader) > block_size) {
+				// No command can start past this point, move on once the next block is linked.
+				if (read_block->reserved.load(std::memory_order_acquire) <= read_offset) {
+					break;
+				}
+				if (read_block->next.load(std::memory_order_acquire) == nullptr) {
+					_spin_wait();
+					continue;
+				}
+				_advance_read_block();
+				continue;
+			}
+
+			CommandHeader *header = reinterpret_cast<CommandHeader *>(read_block->get_data() + read_offset);
+			const uint32_t state = header->state.load(std::memory_order_acquire);
+
+			if (state == COMMAND_STATE_EMPTY) {
+				if (read_block->reserved.load(std::memory_order_acquire) <= read_offset) {
+					break; // Nothing else was pushed.
+				}
+				// A producer reserved this slot and is still writing its command.
+				_spin_wait();
+				continue;
+			}
+
+			if (state == COMMAND_STATE_BLOCK_END) {
+				if (read_block->next.load(std::memory_order_acquire) == nullptr) {
+					_spin_wait();
+					continue;
+				}
+				_advance_read_block();
+				continue;
+			}
+
+			read_offset += sizeof(CommandHeader) + header->size;
+			CommandBase *cmd = reinterpret_cast<CommandBase *>(header + 1);
 
 			cmd->call(); //execute the function
 			cmd->post(); //release in case it needs sync/ret
 			cmd->~CommandBase(); //should be done, so erase the command
-
-			read_ptr += size;
 		}
-
-		command_mem.clear();
-		unlock();
 	}
 
 	void lock();
@@ -400,7 +492,7 @@ public:
 	SPACE_SEP_LIST(DECL_PUSH_AND_SYNC, 15)
 
 	_FORCE_INLINE_ void flush_if_pending() {
-		if (unlikely(command_mem.size() > 0)) {
+		if (unlikely(_has_pending())) {
 			_flush();
 		}
 	}
@@ -41,6 +41,7 @@
 #include <errno.h>
 
 #if defined(UNIX_ENABLED)
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -70,7 +71,18 @@ void FileAccessUnix::check_errors() const {
 	}
 }
 
+void FileAccessUnix::_unmap() {
+#if defined(UNIX_ENABLED)
+	if (mapped) {
+		munmap(mapped, mapped_length);
+		mapped = nullptr;
+		mapped_length = 0;
+	}
+#endif
+}
+
 Error FileAccessUnix::_open(const String &p_path, int p_mode_flags) {
+	_unmap();
 	if (f) {
 		fclose(f);
 	}
@@ -153,6 +165,7 @@ void FileAccessUnix::close() {
 		return;
 	}
 
+	_unmap();
 	fclose(f);
 	f = nullptr;
 
@@ -340,6 +353,31 @@ FileAccess *FileAccessUnix::create_libc() {
 
 CloseNotificationFunc FileAccessUnix::close_notification_func = nullptr;
 
+const uint8_t *FileAccessUnix::map_memory(uint64_t *r_length) {
+	ERR_FAIL_COND_V_MSG(!f, nullptr, "File must be opened before use.");
+
+#if defined(UNIX_ENABLED)
+	if (!mapped) {
+		ERR_FAIL_COND_V_MSG(flags != READ, nullptr, "Only files opened for reading can be mapped.");
+		uint64_t length = get_length();
+		if (length == 0) {
+			return nullptr;
+		}
+		void *data = mmap(nullptr, length, PROT_READ, MAP_SHARED, fileno(f), 0);
+		if (data == MAP_FAILED) {
+			return nullptr;
+		}
+		mapped = data;
+		mapped_length = length;
+	}
+
+	*r_length = mapped_length;
+	return (const uint8_t *)mapped;
+#else
+	return nullptr;
+#endif
+}
+
 FileAccessUnix::~FileAccessUnix() {
 	close();
 }
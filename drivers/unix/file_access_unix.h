@@ -43,7 +43,10 @@ typedef void (*CloseNotificationFunc)(const String &p_file, int p_flags);
 class FileAccessUnix : public FileAccess {
 	FILE *f = nullptr;
 	int flags = 0;
+	void *mapped = nullptr;
+	uint64_t mapped_length = 0;
 	void check_errors() const;
+	void _unmap();
 	mutable Error last_error = OK;
 	String save_path;
 	String path;
@@ -79,6 +82,8 @@ public:
 
 	virtual bool file_exists(const String &p_path); ///< return true if a file exists
 
+	virtual const uint8_t *map_memory(uint64_t *r_length);
+
 	virtual uint64_t _get_modified_time(const String &p_file);
 	virtual uint32_t _get_unix_permissions(const String &p_file);
 	virtual Error _set_unix_permissions(const String &p_file, uint32_t p_permissions);
@@ -47,6 +47,7 @@
 #include "core/object/message_queue.h"
 #include "core/os/os.h"
 #include "core/os/time.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/register_core_types.h"
 #include "core/string/translation.h"
 #include "core/version.h"
@@ -397,6 +398,8 @@ Error Main::test_setup() {
 	register_core_types();
 	register_core_driver_types();
 
+	WorkerThreadPool::get_singleton()->init();
+
 	packed_data = memnew(PackedData);
 
 	globals = memnew(ProjectSettings);
@@ -1088,6 +1091,14 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 
 	ResourceUID::get_singleton()->load_from_cache(); // load UUIDs from cache.
 
+	GLOBAL_DEF("threading/worker_pool/max_threads", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("threading/worker_pool/max_threads",
+			PropertyInfo(Variant::INT,
+					"threading/worker_pool/max_threads",
+					PROPERTY_HINT_RANGE,
+					"-1,256,1"));
+	WorkerThreadPool::get_singleton()->init(GLOBAL_GET("threading/worker_pool/max_threads"));
+
 	GLOBAL_DEF("memory/limits/multithreaded_server/rid_pool_prealloc", 60);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/multithreaded_server/rid_pool_prealloc",
 			PropertyInfo(Variant::INT,
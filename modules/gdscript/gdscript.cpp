@@ -2155,6 +2155,7 @@ GDScriptLanguage::GDScriptLanguage() {
 	_debug_call_stack_pos = 0;
 	int dmcs = GLOBAL_DEF("debug/settings/gdscript/max_call_stack", 1024);
 	ProjectSettings::get_singleton()->set_custom_property_info("debug/settings/gdscript/max_call_stack", PropertyInfo(Variant::INT, "debug/settings/gdscript/max_call_stack", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater")); //minimum is 1024
+	register_tier_enabled = GLOBAL_DEF_RST("debug/settings/gdscript/register_tier", true);
 
 	if (EngineDebugger::is_active()) {
 		//debugging enabled!
@@ -342,6 +342,7 @@ class GDScriptLanguage : public ScriptLanguage {
 
 	SelfList<GDScriptFunction>::List function_list;
 	bool profiling;
+	bool register_tier_enabled = true;
 	uint64_t script_frame_time;
 
 	Map<String, ObjectID> orphan_subclasses;
@@ -425,6 +426,7 @@ public:
 	_FORCE_INLINE_ Variant *get_global_array() { return _global_array; }
 	_FORCE_INLINE_ const Map<StringName, int> &get_global_map() const { return globals; }
 	_FORCE_INLINE_ const Map<StringName, Variant> &get_named_globals_map() const { return named_globals; }
+	_FORCE_INLINE_ bool is_register_tier_enabled() const { return register_tier_enabled; }
 
 	_FORCE_INLINE_ static GDScriptLanguage *get_singleton() { return singleton; }
 
@@ -32,6 +32,7 @@
 
 #include "core/debugger/engine_debugger.h"
 #include "gdscript.h"
+#include "gdscript_register_function.h"
 
 uint32_t GDScriptByteCodeGenerator::add_parameter(const StringName &p_name, bool p_is_optional, const GDScriptDataType &p_type) {
 #ifdef TOOLS_ENABLED
@@ -400,6 +401,10 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 	function->_instruction_args_size = instr_args_max;
 	function->_ptrcall_args_size = ptrcall_max;
 
+	if (!debug_stack && GDScriptLanguage::get_singleton()->is_register_tier_enabled()) {
+		function->register_function = GDScriptRegisterFunction::compile(function);
+	}
+
 	ended = true;
 	return function;
 }
@@ -531,6 +536,81 @@ void GDScriptByteCodeGenerator::write_type_adjust(const Address &p_target, Varia
 	append(p_target);
 }
 
+static GDScriptFunction::Opcode _get_typed_operator_opcode(Variant::Operator p_operator, Variant::Type p_left, Variant::Type p_right) {
+	if (p_left == Variant::INT && p_right == Variant::INT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_OPERATOR_ADD_INT;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT;
+			case Variant::OP_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_EQUAL_INT;
+			case Variant::OP_NOT_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT;
+			case Variant::OP_LESS:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_INT;
+			case Variant::OP_LESS_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT;
+			case Variant::OP_GREATER:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_INT;
+			case Variant::OP_GREATER_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT;
+			default:
+				break;
+		}
+	} else if (p_left == Variant::FLOAT && p_right == Variant::FLOAT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_OPERATOR_ADD_FLOAT;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT;
+			case Variant::OP_DIVIDE:
+				return GDScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT;
+			case Variant::OP_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT;
+			case Variant::OP_NOT_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT;
+			case Variant::OP_LESS:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_FLOAT;
+			case Variant::OP_LESS_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT;
+			case Variant::OP_GREATER:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT;
+			case Variant::OP_GREATER_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT;
+			default:
+				break;
+		}
+	} else if ((p_left == Variant::VECTOR2 || p_left == Variant::VECTOR3) && p_right == p_left) {
+		bool is_2d = p_left == Variant::VECTOR2;
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return is_2d ? GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR2 : GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR3;
+			case Variant::OP_SUBTRACT:
+				return is_2d ? GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR2 : GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR3;
+			default:
+				break;
+		}
+	} else if ((p_left == Variant::VECTOR2 || p_left == Variant::VECTOR3) && p_right == Variant::FLOAT) {
+		bool is_2d = p_left == Variant::VECTOR2;
+		switch (p_operator) {
+			case Variant::OP_MULTIPLY:
+				return is_2d ? GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT : GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT;
+			case Variant::OP_DIVIDE:
+				return is_2d ? GDScriptFunction::OPCODE_OPERATOR_DIVIDE_VECTOR2_FLOAT : GDScriptFunction::OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT;
+			default:
+				break;
+		}
+	}
+
+	// No specialized opcode, use the validated operator.
+	return GDScriptFunction::OPCODE_OPERATOR_VALIDATED;
+}
+
 void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand) {
 	if (HAS_BUILTIN_TYPE(p_left_operand)) {
 		// Gather specific operator.
@@ -562,6 +642,16 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 			}
 		}
 
+		// Common operators on numbers and vectors have their own opcode working on the raw values.
+		GDScriptFunction::Opcode typed_opcode = _get_typed_operator_opcode(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
+		if (typed_opcode != GDScriptFunction::OPCODE_OPERATOR_VALIDATED) {
+			append(typed_opcode, 3);
+			append(p_left_operand);
+			append(p_right_operand);
+			append(p_target);
+			return;
+		}
+
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
@@ -794,6 +884,11 @@ void GDScriptByteCodeGenerator::write_assign_with_conversion(const Address &p_ta
 				append(GDScriptFunction::OPCODE_ASSIGN_TYPED_ARRAY, 2);
 				append(p_target);
 				append(p_source);
+			} else if (IS_BUILTIN_TYPE(p_source, p_target.type.builtin_type) && (p_target.type.builtin_type == Variant::INT || p_target.type.builtin_type == Variant::FLOAT)) {
+				// Same type, no conversion can happen.
+				append(p_target.type.builtin_type == Variant::INT ? GDScriptFunction::OPCODE_ASSIGN_INT : GDScriptFunction::OPCODE_ASSIGN_FLOAT, 2);
+				append(p_target);
+				append(p_source);
 			} else {
 				append(GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN, 2);
 				append(p_target);
@@ -842,6 +937,14 @@ void GDScriptByteCodeGenerator::write_assign(const Address &p_target, const Addr
 		append(p_target);
 		append(p_source);
 		append(p_target.type.builtin_type);
+	} else if (IS_BUILTIN_TYPE(p_target, Variant::INT) && IS_BUILTIN_TYPE(p_source, Variant::INT)) {
+		append(GDScriptFunction::OPCODE_ASSIGN_INT, 2);
+		append(p_target);
+		append(p_source);
+	} else if (IS_BUILTIN_TYPE(p_target, Variant::FLOAT) && IS_BUILTIN_TYPE(p_source, Variant::FLOAT)) {
+		append(GDScriptFunction::OPCODE_ASSIGN_FLOAT, 2);
+		append(p_target);
+		append(p_source);
 	} else {
 		append(GDScriptFunction::OPCODE_ASSIGN, 2);
 		append(p_target);
@@ -1379,6 +1482,16 @@ void GDScriptByteCodeGenerator::write_for() {
 				case Variant::ARRAY:
 					begin_opcode = GDScriptFunction::OPCODE_ITERATE_BEGIN_ARRAY;
 					iterate_opcode = GDScriptFunction::OPCODE_ITERATE_ARRAY;
+					if (container.type.has_container_element_type()) {
+						GDScriptDataType element_type = container.type.get_container_element_type();
+						if (element_type.kind == GDScriptDataType::BUILTIN && element_type.builtin_type == Variant::INT) {
+							begin_opcode = GDScriptFunction::OPCODE_ITERATE_BEGIN_ARRAY_INT;
+							iterate_opcode = GDScriptFunction::OPCODE_ITERATE_ARRAY_INT;
+						} else if (element_type.kind == GDScriptDataType::BUILTIN && element_type.builtin_type == Variant::FLOAT) {
+							begin_opcode = GDScriptFunction::OPCODE_ITERATE_BEGIN_ARRAY_FLOAT;
+							iterate_opcode = GDScriptFunction::OPCODE_ITERATE_ARRAY_FLOAT;
+						}
+					}
 					break;
 				case Variant::PACKED_BYTE_ARRAY:
 					begin_opcode = GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_BYTE_ARRAY;
@@ -0,0 +1,1368 @@
+/*************************************************************************/
+/*  gdscript_register_function.cpp                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_register_function.h"
+
+#include "core/object/class_db.h"
+#include "core/variant/variant_internal.h"
+#include "gdscript_function.h"
+
+// Stack slots below this one hold self, the class and nil.
+static const int FIRST_LOCAL = GDScriptFunction::ADDR_STACK_NIL + 1;
+
+// Utility functions the register tier runs natively, they must match variant_utility.cpp exactly.
+
+struct FloatUtility {
+	const char *name;
+	int argument_count;
+	double (*function_1)(double);
+	double (*function_2)(double, double);
+	double (*function_3)(double, double, double);
+};
+
+static const FloatUtility float_utilities[] = {
+	{ "sin", 1, [](double p_x) -> double { return Math::sin(p_x); }, nullptr, nullptr },
+	{ "cos", 1, [](double p_x) -> double { return Math::cos(p_x); }, nullptr, nullptr },
+	{ "tan", 1, [](double p_x) -> double { return Math::tan(p_x); }, nullptr, nullptr },
+	{ "asin", 1, [](double p_x) -> double { return Math::asin(p_x); }, nullptr, nullptr },
+	{ "acos", 1, [](double p_x) -> double { return Math::acos(p_x); }, nullptr, nullptr },
+	{ "atan", 1, [](double p_x) -> double { return Math::atan(p_x); }, nullptr, nullptr },
+	{ "sqrt", 1, [](double p_x) -> double { return Math::sqrt(p_x); }, nullptr, nullptr },
+	{ "floor", 1, [](double p_x) -> double { return Math::floor(p_x); }, nullptr, nullptr },
+	{ "ceil", 1, [](double p_x) -> double { return Math::ceil(p_x); }, nullptr, nullptr },
+	{ "round", 1, [](double p_x) -> double { return Math::round(p_x); }, nullptr, nullptr },
+	{ "absf", 1, [](double p_x) -> double { return Math::absd(p_x); }, nullptr, nullptr },
+	{ "signf", 1, [](double p_x) -> double { return SGN(p_x); }, nullptr, nullptr },
+	{ "exp", 1, [](double p_x) -> double { return Math::exp(p_x); }, nullptr, nullptr },
+	{ "log", 1, [](double p_x) -> double { return Math::log(p_x); }, nullptr, nullptr },
+	{ "deg2rad", 1, [](double p_x) -> double { return Math::deg2rad(p_x); }, nullptr, nullptr },
+	{ "rad2deg", 1, [](double p_x) -> double { return Math::rad2deg(p_x); }, nullptr, nullptr },
+	{ "atan2", 2, nullptr, [](double p_y, double p_x) -> double { return Math::atan2(p_y, p_x); }, nullptr },
+	{ "pow", 2, nullptr, [](double p_x, double p_y) -> double { return Math::pow(p_x, p_y); }, nullptr },
+	{ "fmod", 2, nullptr, [](double p_x, double p_y) -> double { return Math::fmod(p_x, p_y); }, nullptr },
+	{ "fposmod", 2, nullptr, [](double p_x, double p_y) -> double { return Math::fposmod(p_x, p_y); }, nullptr },
+	{ "snapped", 2, nullptr, [](double p_x, double p_y) -> double { return Math::snapped(p_x, p_y); }, nullptr },
+	{ "minf", 2, nullptr, [](double p_x, double p_y) -> double { return MIN(p_x, p_y); }, nullptr },
+	{ "maxf", 2, nullptr, [](double p_x, double p_y) -> double { return MAX(p_x, p_y); }, nullptr },
+	{ "lerp", 3, nullptr, nullptr, [](double p_from, double p_to, double p_weight) -> double { return Math::lerp(p_from, p_to, p_weight); } },
+	{ "inverse_lerp", 3, nullptr, nullptr, [](double p_from, double p_to, double p_weight) -> double { return Math::inverse_lerp(p_from, p_to, p_weight); } },
+	{ "smoothstep", 3, nullptr, nullptr, [](double p_from, double p_to, double p_x) -> double { return Math::smoothstep(p_from, p_to, p_x); } },
+	{ "move_toward", 3, nullptr, nullptr, [](double p_from, double p_to, double p_delta) -> double { return Math::move_toward(p_from, p_to, p_delta); } },
+	{ "clampf", 3, nullptr, nullptr, [](double p_x, double p_min, double p_max) -> double { return CLAMP(p_x, p_min, p_max); } },
+	{ "wrapf", 3, nullptr, nullptr, [](double p_x, double p_min, double p_max) -> double { return Math::wrapf(p_x, p_min, p_max); } },
+};
+
+struct IntUtility {
+	const char *name;
+	int argument_count;
+	int64_t (*function_1)(int64_t);
+	int64_t (*function_2)(int64_t, int64_t);
+	int64_t (*function_3)(int64_t, int64_t, int64_t);
+};
+
+static const IntUtility int_utilities[] = {
+	{ "absi", 1, [](int64_t p_x) -> int64_t { return ABS(p_x); }, nullptr, nullptr },
+	{ "signi", 1, [](int64_t p_x) -> int64_t { return SGN(p_x); }, nullptr, nullptr },
+	{ "mini", 2, nullptr, [](int64_t p_x, int64_t p_y) -> int64_t { return MIN(p_x, p_y); }, nullptr },
+	{ "maxi", 2, nullptr, [](int64_t p_x, int64_t p_y) -> int64_t { return MAX(p_x, p_y); }, nullptr },
+	{ "clampi", 3, nullptr, nullptr, [](int64_t p_x, int64_t p_min, int64_t p_max) -> int64_t { return CLAMP(p_x, p_min, p_max); } },
+	{ "wrapi", 3, nullptr, nullptr, [](int64_t p_x, int64_t p_min, int64_t p_max) -> int64_t { return Math::wrapi(p_x, p_min, p_max); } },
+};
+
+struct VectorMethod {
+	Variant::Type type;
+	const char *name;
+	int op;
+};
+
+static const char *lane_names[3] = { "x", "y", "z" };
+
+static bool _is_supported_type(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::BOOL:
+		case Variant::INT:
+		case Variant::FLOAT:
+		case Variant::VECTOR2:
+		case Variant::VECTOR3:
+			return true;
+		default:
+			return false;
+	}
+}
+
+static bool _is_vector(Variant::Type p_type) {
+	return p_type == Variant::VECTOR2 || p_type == Variant::VECTOR3;
+}
+
+static bool _is_number(Variant::Type p_type) {
+	return p_type == Variant::INT || p_type == Variant::FLOAT;
+}
+
+static int _get_lane_count(Variant::Type p_type) {
+	return p_type == Variant::VECTOR2 ? 2 : 3;
+}
+
+GDScriptRegisterFunction::Register GDScriptRegisterFunction::_unbox(const Variant &p_value, Variant::Type p_type) {
+	Register r;
+	r.v[0] = 0;
+	r.v[1] = 0;
+	r.v[2] = 0;
+	switch (p_type) {
+		case Variant::BOOL:
+			r.i = 0;
+			r.b = *VariantInternal::get_bool(&p_value);
+			break;
+		case Variant::INT:
+			r.i = *VariantInternal::get_int(&p_value);
+			break;
+		case Variant::FLOAT:
+			r.f = *VariantInternal::get_float(&p_value);
+			break;
+		case Variant::VECTOR2: {
+			const Vector2 *v = VariantInternal::get_vector2(&p_value);
+			r.v[0] = v->x;
+			r.v[1] = v->y;
+		} break;
+		case Variant::VECTOR3: {
+			const Vector3 *v = VariantInternal::get_vector3(&p_value);
+			r.v[0] = v->x;
+			r.v[1] = v->y;
+			r.v[2] = v->z;
+		} break;
+		default:
+			break;
+	}
+	return r;
+}
+
+Variant GDScriptRegisterFunction::_box(const Register &p_value, Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::BOOL:
+			return p_value.b;
+		case Variant::INT:
+			return p_value.i;
+		case Variant::FLOAT:
+			return p_value.f;
+		case Variant::VECTOR2:
+			return Vector2(p_value.v[0], p_value.v[1]);
+		case Variant::VECTOR3:
+			return Vector3(p_value.v[0], p_value.v[1], p_value.v[2]);
+		default:
+			return Variant();
+	}
+}
+
+// Translates the bytecode of a function. Register types are inferred by running the translation
+// without emitting until no new type is found, then once more emitting the program. A slot only
+// ever holds one type, functions reusing a slot for different types are rejected.
+struct GDScriptRegisterFunction::Builder {
+	struct JumpFixup {
+		uint32_t instruction = 0;
+		int Instruction::*field = nullptr;
+		int target = 0;
+	};
+
+	const GDScriptFunction *function = nullptr;
+	GDScriptRegisterFunction *result = nullptr;
+	LocalVector<Variant::Type> types;
+	LocalVector<int> ip_map;
+	LocalVector<JumpFixup> jump_fixups;
+	int stack_size = 0;
+	bool emit = false;
+	bool changed = false;
+	bool failed = false;
+
+	int reg(int p_address) {
+		int index = p_address & GDScriptFunction::ADDR_MASK;
+		switch ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+			case GDScriptFunction::ADDR_TYPE_STACK: {
+				if (index >= FIRST_LOCAL && index < stack_size) {
+					return index;
+				}
+			} break;
+			case GDScriptFunction::ADDR_TYPE_CONSTANT: {
+				if (index >= 0 && index < function->_constant_count) {
+					return stack_size + index;
+				}
+			} break;
+			default:
+				break;
+		}
+		// Self, class, members and nil are never registers.
+		failed = true;
+		return 0;
+	}
+
+	bool known(int p_reg) {
+		if (types[p_reg] != Variant::NIL) {
+			return true;
+		}
+		// Everything read has a type once inference is done.
+		if (emit) {
+			failed = true;
+		}
+		return false;
+	}
+
+	void write(int p_reg, Variant::Type p_type) {
+		if (p_reg >= stack_size || !_is_supported_type(p_type)) {
+			failed = true;
+			return;
+		}
+		if (types[p_reg] == Variant::NIL) {
+			types[p_reg] = p_type;
+			changed = true;
+		} else if (types[p_reg] != p_type) {
+			failed = true;
+		}
+	}
+
+	void push(Opcode p_op, int p_a = 0, int p_b = 0, int p_c = 0, int p_d = 0, int p_function = 0) {
+		if (!emit || failed) {
+			return;
+		}
+		Instruction instruction;
+		instruction.op = p_op;
+		instruction.a = p_a;
+		instruction.b = p_b;
+		instruction.c = p_c;
+		instruction.d = p_d;
+		instruction.function = p_function;
+		result->code.push_back(instruction);
+	}
+
+	void jump_to(int Instruction::*p_field, int p_target) {
+		if (!emit || failed) {
+			return;
+		}
+		JumpFixup fixup;
+		fixup.instruction = result->code.size() - 1;
+		fixup.field = p_field;
+		fixup.target = p_target;
+		jump_fixups.push_back(fixup);
+	}
+
+	int to_float(int p_reg) {
+		if (types[p_reg] == Variant::FLOAT) {
+			return p_reg;
+		}
+		if (types[p_reg] != Variant::INT) {
+			failed = true;
+			return p_reg;
+		}
+		if (!emit || failed) {
+			return p_reg;
+		}
+		int scratch = types.size();
+		types.push_back(Variant::FLOAT);
+		push(OP_INT_TO_FLOAT, scratch, p_reg);
+		return scratch;
+	}
+
+	void translate_operator(int p_a, int p_b, int p_dst, Variant::ValidatedOperatorEvaluator p_func) {
+		bool unary = p_b == GDScriptFunction::ADDR_NIL;
+		int a = reg(p_a);
+		int b = unary ? 0 : reg(p_b);
+		int dst = reg(p_dst);
+		if (failed || !known(a) || (!unary && !known(b))) {
+			return;
+		}
+
+		Variant::Type ta = types[a];
+		Variant::Type tb = unary ? Variant::NIL : types[b];
+		int op = 0;
+		while (op < Variant::OP_MAX && Variant::get_validated_operator_evaluator((Variant::Operator)op, ta, tb) != p_func) {
+			op++;
+		}
+		if (op == Variant::OP_MAX) {
+			// Inferred types disagree with what the code generator saw.
+			failed = true;
+			return;
+		}
+		emit_operator((Variant::Operator)op, a, b, dst, ta, tb);
+	}
+
+	void translate_typed_operator(int p_a, int p_b, int p_dst, Variant::Operator p_op, Variant::Type p_left, Variant::Type p_right) {
+		int a = reg(p_a);
+		int b = reg(p_b);
+		int dst = reg(p_dst);
+		if (failed || !known(a) || !known(b)) {
+			return;
+		}
+		if (types[a] != p_left || types[b] != p_right) {
+			failed = true;
+			return;
+		}
+		emit_operator(p_op, a, b, dst, p_left, p_right);
+	}
+
+	void emit_operator(Variant::Operator p_op, int p_a, int p_b, int p_dst, Variant::Type p_left, Variant::Type p_right) {
+		Variant::Operator op = p_op;
+		Variant::Type ta = p_left;
+		Variant::Type tb = p_right;
+		int a = p_a;
+		int b = p_b;
+		int dst = p_dst;
+		write(dst, Variant::get_operator_return_type(op, ta, tb));
+		if (!emit || failed) {
+			return;
+		}
+
+		switch (op) {
+			case Variant::OP_ADD:
+			case Variant::OP_SUBTRACT:
+			case Variant::OP_MULTIPLY:
+			case Variant::OP_DIVIDE:
+			case Variant::OP_MODULE: {
+				int index = op - Variant::OP_ADD;
+				static const Opcode int_ops[] = { OP_ADD_INT, OP_SUB_INT, OP_MUL_INT, OP_DIV_INT, OP_MOD_INT };
+				static const Opcode float_ops[] = { OP_ADD_FLOAT, OP_SUB_FLOAT, OP_MUL_FLOAT, OP_DIV_FLOAT };
+				static const Opcode vector_ops[] = { OP_ADD_VECTOR, OP_SUB_VECTOR, OP_MUL_VECTOR, OP_DIV_VECTOR };
+				if (ta == Variant::INT && tb == Variant::INT) {
+					push(int_ops[index], dst, a, b);
+				} else if (op == Variant::OP_MODULE) {
+					failed = true;
+				} else if (_is_number(ta) && _is_number(tb)) {
+					a = to_float(a);
+					b = to_float(b);
+					push(float_ops[index], dst, a, b);
+				} else if (_is_vector(ta) && ta == tb) {
+					push(vector_ops[index], dst, a, b, _get_lane_count(ta));
+				} else if (_is_vector(ta) && _is_number(tb) && (op == Variant::OP_MULTIPLY || op == Variant::OP_DIVIDE)) {
+					b = to_float(b);
+					push(op == Variant::OP_MULTIPLY ? OP_MUL_VECTOR_SCALAR : OP_DIV_VECTOR_SCALAR, dst, a, b, _get_lane_count(ta));
+				} else if (_is_number(ta) && _is_vector(tb) && op == Variant::OP_MULTIPLY) {
+					a = to_float(a);
+					push(OP_MUL_VECTOR_SCALAR, dst, b, a, _get_lane_count(tb));
+				} else {
+					failed = true;
+				}
+			} break;
+			case Variant::OP_EQUAL:
+			case Variant::OP_NOT_EQUAL: {
+				bool equal = op == Variant::OP_EQUAL;
+				if (ta == Variant::INT && tb == Variant::INT) {
+					push(equal ? OP_EQUAL_INT : OP_NOT_EQUAL_INT, dst, a, b);
+				} else if (_is_number(ta) && _is_number(tb)) {
+					a = to_float(a);
+					b = to_float(b);
+					push(equal ? OP_EQUAL_FLOAT : OP_NOT_EQUAL_FLOAT, dst, a, b);
+				} else if (ta == Variant::BOOL && tb == Variant::BOOL) {
+					push(equal ? OP_EQUAL_BOOL : OP_NOT_EQUAL_BOOL, dst, a, b);
+				} else if (_is_vector(ta) && ta == tb) {
+					push(equal ? OP_EQUAL_VECTOR : OP_NOT_EQUAL_VECTOR, dst, a, b, _get_lane_count(ta));
+				} else {
+					failed = true;
+				}
+			} break;
+			case Variant::OP_LESS:
+			case Variant::OP_LESS_EQUAL:
+			case Variant::OP_GREATER:
+			case Variant::OP_GREATER_EQUAL: {
+				if (!_is_number(ta) || !_is_number(tb)) {
+					failed = true;
+					break;
+				}
+				// a > b is b < a, also for NaN.
+				if (op == Variant::OP_GREATER || op == Variant::OP_GREATER_EQUAL) {
+					SWAP(a, b);
+				}
+				bool or_equal = op == Variant::OP_LESS_EQUAL || op == Variant::OP_GREATER_EQUAL;
+				if (ta == Variant::INT && tb == Variant::INT) {
+					push(or_equal ? OP_LESS_EQUAL_INT : OP_LESS_INT, dst, a, b);
+				} else {
+					a = to_float(a);
+					b = to_float(b);
+					push(or_equal ? OP_LESS_EQUAL_FLOAT : OP_LESS_FLOAT, dst, a, b);
+				}
+			} break;
+			case Variant::OP_NEGATE: {
+				if (ta == Variant::INT) {
+					push(OP_NEGATE_INT, dst, a);
+				} else if (ta == Variant::FLOAT) {
+					push(OP_NEGATE_FLOAT, dst, a);
+				} else if (_is_vector(ta)) {
+					push(OP_NEGATE_VECTOR, dst, a, 0, _get_lane_count(ta));
+				} else {
+					failed = true;
+				}
+			} break;
+			case Variant::OP_POSITIVE: {
+				push(OP_MOVE, dst, a);
+			} break;
+			case Variant::OP_NOT: {
+				if (ta == Variant::BOOL) {
+					push(OP_NOT_BOOL, dst, a);
+				} else if (ta == Variant::INT) {
+					push(OP_NOT_INT, dst, a);
+				} else if (ta == Variant::FLOAT) {
+					push(OP_NOT_FLOAT, dst, a);
+				} else {
+					failed = true;
+				}
+			} break;
+			case Variant::OP_BIT_AND:
+			case Variant::OP_BIT_OR:
+			case Variant::OP_BIT_XOR: {
+				if (ta != Variant::INT || tb != Variant::INT) {
+					failed = true;
+					break;
+				}
+				push(op == Variant::OP_BIT_AND ? OP_BIT_AND : (op == Variant::OP_BIT_OR ? OP_BIT_OR : OP_BIT_XOR), dst, a, b);
+			} break;
+			case Variant::OP_BIT_NEGATE: {
+				if (ta != Variant::INT) {
+					failed = true;
+					break;
+				}
+				push(OP_BIT_NEGATE, dst, a);
+			} break;
+			default: {
+				failed = true;
+			} break;
+		}
+	}
+
+	void translate_construct(const int *p_args, int p_argcount, int p_dst, Variant::ValidatedConstructor p_func) {
+		static const Variant::Type candidates[] = { Variant::BOOL, Variant::INT, Variant::FLOAT, Variant::VECTOR2, Variant::VECTOR3 };
+		Variant::Type type = Variant::NIL;
+		int constructor = -1;
+		for (int i = 0; i < 5 && constructor < 0; i++) {
+			for (int j = 0; j < Variant::get_constructor_count(candidates[i]); j++) {
+				if (Variant::get_validated_constructor(candidates[i], j) == p_func) {
+					type = candidates[i];
+					constructor = j;
+					break;
+				}
+			}
+		}
+		if (constructor < 0 || p_argcount > 3 || Variant::get_constructor_argument_count(type, constructor) != p_argcount) {
+			failed = true;
+			return;
+		}
+
+		int args[3] = { -1, -1, -1 };
+		for (int i = 0; i < p_argcount; i++) {
+			args[i] = reg(p_args[i]);
+			if (failed || !known(args[i])) {
+				return;
+			}
+			if (types[args[i]] != Variant::get_constructor_argument_type(type, constructor, i)) {
+				failed = true;
+				return;
+			}
+		}
+		int dst = reg(p_dst);
+		write(dst, type);
+
+		if (p_argcount == 0) {
+			push(OP_LOAD_ZERO, dst);
+		} else if (p_argcount == 1 && types[args[0]] == type) {
+			push(OP_MOVE, dst, args[0]);
+		} else if (p_argcount == 1 && type == Variant::FLOAT && types[args[0]] == Variant::INT) {
+			push(OP_INT_TO_FLOAT, dst, args[0]);
+		} else if (p_argcount == 1 && type == Variant::INT && types[args[0]] == Variant::FLOAT) {
+			push(OP_FLOAT_TO_INT, dst, args[0]);
+		} else if (_is_vector(type) && p_argcount == _get_lane_count(type) && types[args[0]] == Variant::FLOAT) {
+			push(OP_CONSTRUCT_VECTOR, dst, args[0], args[1], args[2]);
+		} else {
+			failed = true;
+		}
+	}
+
+	int find_lane(Variant::Type p_type, bool p_setter, const void *p_func) {
+		if (!_is_vector(p_type)) {
+			return -1;
+		}
+		for (int i = 0; i < _get_lane_count(p_type); i++) {
+			StringName name = lane_names[i];
+			const void *func = p_setter ? (const void *)Variant::get_member_validated_setter(p_type, name) : (const void *)Variant::get_member_validated_getter(p_type, name);
+			if (func == p_func) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	void translate_utility(const int *p_args, int p_argcount, int p_dst, Variant::ValidatedUtilityFunction p_func) {
+		Variant::Type arg_type = Variant::NIL;
+		int index = -1;
+		for (uint32_t i = 0; i < sizeof(float_utilities) / sizeof(FloatUtility); i++) {
+			if (float_utilities[i].argument_count == p_argcount && Variant::get_validated_utility_function(float_utilities[i].name) == p_func) {
+				arg_type = Variant::FLOAT;
+				index = i;
+				break;
+			}
+		}
+		for (uint32_t i = 0; i < sizeof(int_utilities) / sizeof(IntUtility) && index < 0; i++) {
+			if (int_utilities[i].argument_count == p_argcount && Variant::get_validated_utility_function(int_utilities[i].name) == p_func) {
+				arg_type = Variant::INT;
+				index = i;
+			}
+		}
+		if (index < 0) {
+			failed = true;
+			return;
+		}
+
+		int args[3] = { 0, 0, 0 };
+		for (int i = 0; i < p_argcount; i++) {
+			args[i] = reg(p_args[i]);
+			if (failed || !known(args[i])) {
+				return;
+			}
+			if (types[args[i]] != arg_type) {
+				failed = true;
+				return;
+			}
+		}
+		if (p_dst == GDScriptFunction::ADDR_NIL) {
+			return; // Result unused and the function has no side effects.
+		}
+		int dst = reg(p_dst);
+		write(dst, arg_type);
+
+		static const Opcode float_ops[] = { OP_CALL_FLOAT_1, OP_CALL_FLOAT_2, OP_CALL_FLOAT_3 };
+		static const Opcode int_ops[] = { OP_CALL_INT_1, OP_CALL_INT_2, OP_CALL_INT_3 };
+		push((arg_type == Variant::FLOAT ? float_ops : int_ops)[p_argcount - 1], dst, args[0], args[1], args[2], index);
+	}
+
+	void translate_builtin_method(const int *p_args, int p_argcount, int p_base, int p_dst, Variant::ValidatedBuiltInMethod p_func) {
+		static const VectorMethod methods[] = {
+			{ Variant::VECTOR2, "length", OP_VECTOR2_LENGTH },
+			{ Variant::VECTOR2, "length_squared", OP_VECTOR2_LENGTH_SQUARED },
+			{ Variant::VECTOR2, "dot", OP_VECTOR2_DOT },
+			{ Variant::VECTOR2, "cross", OP_VECTOR2_CROSS },
+			{ Variant::VECTOR2, "normalized", OP_VECTOR2_NORMALIZED },
+			{ Variant::VECTOR2, "distance_to", OP_VECTOR2_DISTANCE_TO },
+			{ Variant::VECTOR3, "length", OP_VECTOR3_LENGTH },
+			{ Variant::VECTOR3, "length_squared", OP_VECTOR3_LENGTH_SQUARED },
+			{ Variant::VECTOR3, "dot", OP_VECTOR3_DOT },
+			{ Variant::VECTOR3, "cross", OP_VECTOR3_CROSS },
+			{ Variant::VECTOR3, "normalized", OP_VECTOR3_NORMALIZED },
+			{ Variant::VECTOR3, "distance_to", OP_VECTOR3_DISTANCE_TO },
+		};
+
+		int base = reg(p_base);
+		if (failed || !known(base)) {
+			return;
+		}
+		Variant::Type type = types[base];
+		const VectorMethod *method = nullptr;
+		for (uint32_t i = 0; i < sizeof(methods) / sizeof(VectorMethod); i++) {
+			if (methods[i].type == type && Variant::get_validated_builtin_method(type, methods[i].name) == p_func) {
+				method = &methods[i];
+				break;
+			}
+		}
+		if (!method || p_argcount > 1 || Variant::get_builtin_method_argument_count(type, method->name) != p_argcount) {
+			failed = true;
+			return;
+		}
+
+		int arg = 0;
+		if (p_argcount == 1) {
+			arg = reg(p_args[0]);
+			if (failed || !known(arg)) {
+				return;
+			}
+			if (types[arg] != Variant::get_builtin_method_argument_type(type, method->name, 0)) {
+				failed = true;
+				return;
+			}
+		}
+		if (p_dst == GDScriptFunction::ADDR_NIL) {
+			return; // Result unused and the method has no side effects.
+		}
+		int dst = reg(p_dst);
+		write(dst, Variant::get_builtin_method_return_type(type, method->name));
+		push((Opcode)method->op, dst, base, arg);
+	}
+
+	void translate() {
+		const int *code = function->_code_ptr;
+		int ip = 0;
+		while (ip < function->_code_size && !failed) {
+			if (emit) {
+				ip_map[ip] = result->code.size();
+			}
+
+			int opcode = code[ip] & GDScriptFunction::INSTR_MASK;
+			int instr_arg_count = code[ip] >> GDScriptFunction::INSTR_BITS;
+			switch (opcode) {
+				case GDScriptFunction::OPCODE_OPERATOR_ADD_INT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_ADD, Variant::INT, Variant::INT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_SUBTRACT, Variant::INT, Variant::INT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_MULTIPLY, Variant::INT, Variant::INT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_EQUAL_INT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_EQUAL, Variant::INT, Variant::INT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_NOT_EQUAL, Variant::INT, Variant::INT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_LESS_INT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_LESS, Variant::INT, Variant::INT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_LESS_EQUAL, Variant::INT, Variant::INT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_GREATER_INT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_GREATER, Variant::INT, Variant::INT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_GREATER_EQUAL, Variant::INT, Variant::INT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_ADD_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_ADD, Variant::FLOAT, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_SUBTRACT, Variant::FLOAT, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_MULTIPLY, Variant::FLOAT, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_DIVIDE, Variant::FLOAT, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_EQUAL, Variant::FLOAT, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_NOT_EQUAL, Variant::FLOAT, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_LESS_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_LESS, Variant::FLOAT, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_LESS_EQUAL, Variant::FLOAT, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_GREATER, Variant::FLOAT, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_GREATER_EQUAL, Variant::FLOAT, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR2: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_ADD, Variant::VECTOR2, Variant::VECTOR2);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR2: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_SUBTRACT, Variant::VECTOR2, Variant::VECTOR2);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_MULTIPLY, Variant::VECTOR2, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_DIVIDE_VECTOR2_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_DIVIDE, Variant::VECTOR2, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR3: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_ADD, Variant::VECTOR3, Variant::VECTOR3);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR3: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_SUBTRACT, Variant::VECTOR3, Variant::VECTOR3);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_MULTIPLY, Variant::VECTOR3, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT: {
+					translate_typed_operator(code[ip + 1], code[ip + 2], code[ip + 3], Variant::OP_DIVIDE, Variant::VECTOR3, Variant::FLOAT);
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+					int index = code[ip + 4];
+					if (index < 0 || index >= function->_operator_funcs_count) {
+						failed = true;
+						break;
+					}
+					translate_operator(code[ip + 1], code[ip + 2], code[ip + 3], function->_operator_funcs_ptr[index]);
+					ip += 5;
+				} break;
+				case GDScriptFunction::OPCODE_ASSIGN: {
+					int dst = reg(code[ip + 1]);
+					int src = reg(code[ip + 2]);
+					if (!failed && known(src)) {
+						write(dst, types[src]);
+						push(OP_MOVE, dst, src);
+					}
+					ip += 3;
+				} break;
+				case GDScriptFunction::OPCODE_ASSIGN_INT:
+				case GDScriptFunction::OPCODE_ASSIGN_FLOAT: {
+					int dst = reg(code[ip + 1]);
+					int src = reg(code[ip + 2]);
+					Variant::Type type = opcode == GDScriptFunction::OPCODE_ASSIGN_INT ? Variant::INT : Variant::FLOAT;
+					write(dst, type);
+					if (!failed && known(src)) {
+						if (types[src] != type) {
+							failed = true;
+							break;
+						}
+						push(OP_MOVE, dst, src);
+					}
+					ip += 3;
+				} break;
+				case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+				case GDScriptFunction::OPCODE_ASSIGN_FALSE: {
+					int dst = reg(code[ip + 1]);
+					write(dst, Variant::BOOL);
+					push(OP_LOAD_BOOL, dst, opcode == GDScriptFunction::OPCODE_ASSIGN_TRUE);
+					ip += 2;
+				} break;
+				case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
+					int dst = reg(code[ip + 1]);
+					int src = reg(code[ip + 2]);
+					Variant::Type type = (Variant::Type)code[ip + 3];
+					write(dst, type);
+					if (!failed && known(src)) {
+						if (types[src] == type) {
+							push(OP_MOVE, dst, src);
+						} else if (types[src] == Variant::INT && type == Variant::FLOAT) {
+							push(OP_INT_TO_FLOAT, dst, src);
+						} else {
+							failed = true;
+						}
+					}
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_CONSTRUCT_VALIDATED: {
+					int argc = code[ip + instr_arg_count + 1];
+					int index = code[ip + instr_arg_count + 2];
+					if (argc != instr_arg_count - 1 || index < 0 || index >= function->_constructors_count) {
+						failed = true;
+						break;
+					}
+					translate_construct(&code[ip + 1], argc, code[ip + 1 + argc], function->_constructors_ptr[index]);
+					ip += 3 + instr_arg_count;
+				} break;
+				case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED: {
+					int src = reg(code[ip + 1]);
+					int dst = reg(code[ip + 2]);
+					int index = code[ip + 3];
+					if (failed || index < 0 || index >= function->_getters_count) {
+						failed = true;
+						break;
+					}
+					if (known(src)) {
+						int lane = find_lane(types[src], false, (const void *)function->_getters_ptr[index]);
+						if (lane < 0) {
+							failed = true;
+							break;
+						}
+						write(dst, Variant::FLOAT);
+						push(OP_GET_LANE, dst, src, lane);
+					}
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED: {
+					int dst = reg(code[ip + 1]);
+					int value = reg(code[ip + 2]);
+					int index = code[ip + 3];
+					if (failed || index < 0 || index >= function->_setters_count) {
+						failed = true;
+						break;
+					}
+					if (known(dst) && known(value)) {
+						int lane = find_lane(types[dst], true, (const void *)function->_setters_ptr[index]);
+						if (lane < 0 || types[value] != Variant::FLOAT || dst >= stack_size) {
+							failed = true;
+							break;
+						}
+						push(OP_SET_LANE, dst, value, lane);
+					}
+					ip += 4;
+				} break;
+				case GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED: {
+					int argc = code[ip + instr_arg_count + 1];
+					int index = code[ip + instr_arg_count + 2];
+					if (argc < 1 || argc > 3 || argc != instr_arg_count - 1 || index < 0 || index >= function->_utilities_count) {
+						failed = true;
+						break;
+					}
+					translate_utility(&code[ip + 1], argc, code[ip + 1 + argc], function->_utilities_ptr[index]);
+					ip += 3 + instr_arg_count;
+				} break;
+				case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED: {
+					int argc = code[ip + instr_arg_count + 1];
+					int index = code[ip + instr_arg_count + 2];
+					if (argc != instr_arg_count - 2 || index < 0 || index >= function->_builtin_methods_count) {
+						failed = true;
+						break;
+					}
+					translate_builtin_method(&code[ip + 1], argc, code[ip + 1 + argc], code[ip + 2 + argc], function->_builtin_methods_ptr[index]);
+					ip += 3 + instr_arg_count;
+				} break;
+				case GDScriptFunction::OPCODE_JUMP: {
+					push(OP_JUMP);
+					jump_to(&Instruction::a, code[ip + 1]);
+					ip += 2;
+				} break;
+				case GDScriptFunction::OPCODE_JUMP_IF:
+				case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+					int condition = reg(code[ip + 1]);
+					if (!failed && known(condition)) {
+						bool negate = opcode == GDScriptFunction::OPCODE_JUMP_IF_NOT;
+						switch (types[condition]) {
+							case Variant::BOOL:
+								push(negate ? OP_JUMP_IF_NOT_BOOL : OP_JUMP_IF_BOOL, condition);
+								break;
+							case Variant::INT:
+								push(negate ? OP_JUMP_IF_NOT_INT : OP_JUMP_IF_INT, condition);
+								break;
+							case Variant::FLOAT:
+								push(negate ? OP_JUMP_IF_NOT_FLOAT : OP_JUMP_IF_FLOAT, condition);
+								break;
+							default:
+								failed = true;
+								break;
+						}
+						jump_to(&Instruction::b, code[ip + 2]);
+					}
+					ip += 3;
+				} break;
+				case GDScriptFunction::OPCODE_RETURN: {
+					if (code[ip + 1] == GDScriptFunction::ADDR_NIL) {
+						push(OP_RETURN_NIL);
+					} else {
+						int value = reg(code[ip + 1]);
+						if (!failed && known(value)) {
+							push(OP_RETURN, value, types[value]);
+						}
+					}
+					ip += 2;
+				} break;
+				case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN: {
+					int value = reg(code[ip + 1]);
+					Variant::Type type = (Variant::Type)code[ip + 2];
+					if (!failed && known(value)) {
+						if (types[value] == type) {
+							push(OP_RETURN, value, type);
+						} else if (types[value] == Variant::INT && type == Variant::FLOAT) {
+							push(OP_RETURN, to_float(value), type);
+						} else {
+							failed = true;
+						}
+					}
+					ip += 3;
+				} break;
+				case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+				case GDScriptFunction::OPCODE_ITERATE_INT: {
+					int counter = reg(code[ip + 1]);
+					int container = reg(code[ip + 2]);
+					int iterator = reg(code[ip + 3]);
+					write(counter, Variant::INT);
+					write(iterator, Variant::INT);
+					if (!failed && known(container)) {
+						if (types[container] != Variant::INT) {
+							failed = true;
+							break;
+						}
+						push(opcode == GDScriptFunction::OPCODE_ITERATE_BEGIN_INT ? OP_ITERATE_BEGIN_INT : OP_ITERATE_INT, counter, container, iterator);
+						jump_to(&Instruction::d, code[ip + 4]);
+					}
+					ip += 5;
+				} break;
+				case GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL:
+				case GDScriptFunction::OPCODE_TYPE_ADJUST_INT:
+				case GDScriptFunction::OPCODE_TYPE_ADJUST_FLOAT:
+				case GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR2:
+				case GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR3: {
+					static const Variant::Type adjust_types[] = { Variant::BOOL, Variant::INT, Variant::FLOAT, Variant::VECTOR2, Variant::VECTOR3 };
+					static const int adjust_opcodes[] = { GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL, GDScriptFunction::OPCODE_TYPE_ADJUST_INT, GDScriptFunction::OPCODE_TYPE_ADJUST_FLOAT, GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR2, GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR3 };
+					// A slot only has one type here, so adjusting it to that type leaves the value alone.
+					for (int i = 0; i < 5; i++) {
+						if (adjust_opcodes[i] == opcode) {
+							write(reg(code[ip + 1]), adjust_types[i]);
+						}
+					}
+					ip += 2;
+				} break;
+				case GDScriptFunction::OPCODE_LINE: {
+					ip += 2;
+				} break;
+				case GDScriptFunction::OPCODE_END: {
+					push(OP_RETURN_NIL);
+					ip += 1;
+				} break;
+				default: {
+					// Anything else may have side effects or work on types kept in Variants.
+					failed = true;
+				} break;
+			}
+		}
+	}
+};
+
+GDScriptRegisterFunction *GDScriptRegisterFunction::compile(const GDScriptFunction *p_function) {
+	if (!p_function->_code_ptr || p_function->_default_arg_count > 0) {
+		return nullptr;
+	}
+
+	Builder builder;
+	builder.function = p_function;
+	builder.stack_size = p_function->_stack_size;
+	builder.types.resize(p_function->_stack_size + p_function->_constant_count);
+	for (uint32_t i = 0; i < builder.types.size(); i++) {
+		builder.types[i] = Variant::NIL;
+	}
+
+	// Arguments are unboxed on entry, so they need a known type.
+	for (int i = 0; i < p_function->_argument_count; i++) {
+		const GDScriptDataType &type = p_function->argument_types[i];
+		if (!type.has_type || type.kind != GDScriptDataType::BUILTIN || !_is_supported_type(type.builtin_type)) {
+			return nullptr;
+		}
+		builder.types[FIRST_LOCAL + i] = type.builtin_type;
+	}
+	for (const Map<int, Variant::Type>::Element *E = p_function->temporary_slots.front(); E; E = E->next()) {
+		if (_is_supported_type(E->get())) {
+			builder.types[E->key()] = E->get();
+		}
+	}
+	for (int i = 0; i < p_function->_constant_count; i++) {
+		if (_is_supported_type(p_function->_constants_ptr[i].get_type())) {
+			builder.types[p_function->_stack_size + i] = p_function->_constants_ptr[i].get_type();
+		}
+	}
+
+	do {
+		builder.changed = false;
+		builder.translate();
+		if (builder.failed) {
+			return nullptr;
+		}
+	} while (builder.changed);
+
+	GDScriptRegisterFunction *result = memnew(GDScriptRegisterFunction);
+	builder.result = result;
+	builder.emit = true;
+	builder.ip_map.resize(p_function->_code_size);
+	for (uint32_t i = 0; i < builder.ip_map.size(); i++) {
+		builder.ip_map[i] = -1;
+	}
+	builder.translate();
+
+	// The code generator always ends with OPCODE_END, this only keeps the program from running off.
+	builder.push(OP_RETURN_NIL);
+
+	for (uint32_t i = 0; i < builder.jump_fixups.size() && !builder.failed; i++) {
+		const Builder::JumpFixup &fixup = builder.jump_fixups[i];
+		if (fixup.target < 0 || fixup.target >= p_function->_code_size || builder.ip_map[fixup.target] < 0) {
+			builder.failed = true;
+			break;
+		}
+		result->code[fixup.instruction].*fixup.field = builder.ip_map[fixup.target];
+	}
+
+	if (builder.failed) {
+		memdelete(result);
+		return nullptr;
+	}
+
+	result->stack_size = p_function->_stack_size;
+	result->argument_count = p_function->_argument_count;
+	result->register_types = builder.types;
+	result->register_count = builder.types.size();
+	result->constants.resize(p_function->_constant_count);
+	for (int i = 0; i < p_function->_constant_count; i++) {
+		result->constants[i] = _unbox(p_function->_constants_ptr[i], builder.types[p_function->_stack_size + i]);
+	}
+	return result;
+}
+
+bool GDScriptRegisterFunction::call(const Variant **p_args, int p_argcount, Variant &r_ret) const {
+	if (p_argcount != argument_count) {
+		return false;
+	}
+	for (int i = 0; i < p_argcount; i++) {
+		if (p_args[i]->get_type() != register_types[FIRST_LOCAL + i]) {
+			return false;
+		}
+	}
+
+	Register *r = (Register *)alloca(sizeof(Register) * register_count);
+	memset(r, 0, sizeof(Register) * stack_size);
+	if (constants.size()) {
+		memcpy(&r[stack_size], constants.ptr(), sizeof(Register) * constants.size());
+	}
+	for (int i = 0; i < p_argcount; i++) {
+		r[FIRST_LOCAL + i] = _unbox(*p_args[i], register_types[FIRST_LOCAL + i]);
+	}
+
+	const Instruction *instructions = code.ptr();
+	uint32_t ip = 0;
+	while (true) {
+		const Instruction &in = instructions[ip];
+		switch (in.op) {
+			case OP_MOVE: {
+				r[in.a] = r[in.b];
+			} break;
+			case OP_LOAD_BOOL: {
+				r[in.a].i = 0;
+				r[in.a].b = in.b;
+			} break;
+			case OP_LOAD_ZERO: {
+				memset(&r[in.a], 0, sizeof(Register));
+			} break;
+			case OP_INT_TO_FLOAT: {
+				r[in.a].f = r[in.b].i;
+			} break;
+			case OP_FLOAT_TO_INT: {
+				r[in.a].i = r[in.b].f;
+			} break;
+
+			case OP_ADD_INT: {
+				r[in.a].i = r[in.b].i + r[in.c].i;
+			} break;
+			case OP_SUB_INT: {
+				r[in.a].i = r[in.b].i - r[in.c].i;
+			} break;
+			case OP_MUL_INT: {
+				r[in.a].i = r[in.b].i * r[in.c].i;
+			} break;
+			case OP_DIV_INT: {
+				if (unlikely(r[in.c].i == 0)) {
+					return false; // Let the interpreter report the division by zero.
+				}
+				r[in.a].i = r[in.b].i / r[in.c].i;
+			} break;
+			case OP_MOD_INT: {
+				if (unlikely(r[in.c].i == 0)) {
+					return false;
+				}
+				r[in.a].i = r[in.b].i % r[in.c].i;
+			} break;
+			case OP_NEGATE_INT: {
+				r[in.a].i = -r[in.b].i;
+			} break;
+			case OP_BIT_AND: {
+				r[in.a].i = r[in.b].i & r[in.c].i;
+			} break;
+			case OP_BIT_OR: {
+				r[in.a].i = r[in.b].i | r[in.c].i;
+			} break;
+			case OP_BIT_XOR: {
+				r[in.a].i = r[in.b].i ^ r[in.c].i;
+			} break;
+			case OP_BIT_NEGATE: {
+				r[in.a].i = ~r[in.b].i;
+			} break;
+			case OP_EQUAL_INT: {
+				bool value = r[in.b].i == r[in.c].i;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+			case OP_NOT_EQUAL_INT: {
+				bool value = r[in.b].i != r[in.c].i;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+			case OP_LESS_INT: {
+				bool value = r[in.b].i < r[in.c].i;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+			case OP_LESS_EQUAL_INT: {
+				bool value = r[in.b].i <= r[in.c].i;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+			case OP_NOT_INT: {
+				bool value = !r[in.b].i;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+
+			case OP_ADD_FLOAT: {
+				r[in.a].f = r[in.b].f + r[in.c].f;
+			} break;
+			case OP_SUB_FLOAT: {
+				r[in.a].f = r[in.b].f - r[in.c].f;
+			} break;
+			case OP_MUL_FLOAT: {
+				r[in.a].f = r[in.b].f * r[in.c].f;
+			} break;
+			case OP_DIV_FLOAT: {
+				r[in.a].f = r[in.b].f / r[in.c].f;
+			} break;
+			case OP_NEGATE_FLOAT: {
+				r[in.a].f = -r[in.b].f;
+			} break;
+			case OP_EQUAL_FLOAT: {
+				bool value = r[in.b].f == r[in.c].f;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+			case OP_NOT_EQUAL_FLOAT: {
+				bool value = r[in.b].f != r[in.c].f;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+			case OP_LESS_FLOAT: {
+				bool value = r[in.b].f < r[in.c].f;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+			case OP_LESS_EQUAL_FLOAT: {
+				bool value = r[in.b].f <= r[in.c].f;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+			case OP_NOT_FLOAT: {
+				bool value = !r[in.b].f;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+
+			case OP_EQUAL_BOOL: {
+				bool value = r[in.b].b == r[in.c].b;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+			case OP_NOT_EQUAL_BOOL: {
+				bool value = r[in.b].b != r[in.c].b;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+			case OP_NOT_BOOL: {
+				bool value = !r[in.b].b;
+				r[in.a].i = 0;
+				r[in.a].b = value;
+			} break;
+
+			case OP_ADD_VECTOR: {
+				for (int i = 0; i < in.d; i++) {
+					r[in.a].v[i] = r[in.b].v[i] + r[in.c].v[i];
+				}
+			} break;
+			case OP_SUB_VECTOR: {
+				for (int i = 0; i < in.d; i++) {
+					r[in.a].v[i] = r[in.b].v[i] - r[in.c].v[i];
+				}
+			} break;
+			case OP_MUL_VECTOR: {
+				for (int i = 0; i < in.d; i++) {
+					r[in.a].v[i] = r[in.b].v[i] * r[in.c].v[i];
+				}
+			} break;
+			case OP_DIV_VECTOR: {
+				for (int i = 0; i < in.d; i++) {
+					r[in.a].v[i] = r[in.b].v[i] / r[in.c].v[i];
+				}
+			} break;
+			case OP_MUL_VECTOR_SCALAR: {
+				real_t scalar = r[in.c].f;
+				for (int i = 0; i < in.d; i++) {
+					r[in.a].v[i] = r[in.b].v[i] * scalar;
+				}
+			} break;
+			case OP_DIV_VECTOR_SCALAR: {
+				real_t scalar = r[in.c].f;
+				for (int i = 0; i < in.d; i++) {
+					r[in.a].v[i] = r[in.b].v[i] / scalar;
+				}
+			} break;
+			case OP_NEGATE_VECTOR: {
+				for (int i = 0; i < in.d; i++) {
+					r[in.a].v[i] = -r[in.b].v[i];
+				}
+			} break;
+			case OP_EQUAL_VECTOR:
+			case OP_NOT_EQUAL_VECTOR: {
+				bool value = true;
+				for (int i = 0; i < in.d; i++) {
+					value = value && r[in.b].v[i] == r[in.c].v[i];
+				}
+				r[in.a].i = 0;
+				r[in.a].b = in.op == OP_EQUAL_VECTOR ? value : !value;
+			} break;
+			case OP_CONSTRUCT_VECTOR: {
+				real_t x = r[in.b].f;
+				real_t y = r[in.c].f;
+				real_t z = in.d >= 0 ? r[in.d].f : 0;
+				r[in.a].v[0] = x;
+				r[in.a].v[1] = y;
+				r[in.a].v[2] = z;
+			} break;
+			case OP_GET_LANE: {
+				r[in.a].f = r[in.b].v[in.c];
+			} break;
+			case OP_SET_LANE: {
+				r[in.a].v[in.c] = r[in.b].f;
+			} break;
+
+			case OP_VECTOR2_LENGTH: {
+				r[in.a].f = Vector2(r[in.b].v[0], r[in.b].v[1]).length();
+			} break;
+			case OP_VECTOR2_LENGTH_SQUARED: {
+				r[in.a].f = Vector2(r[in.b].v[0], r[in.b].v[1]).length_squared();
+			} break;
+			case OP_VECTOR2_DOT: {
+				r[in.a].f = Vector2(r[in.b].v[0], r[in.b].v[1]).dot(Vector2(r[in.c].v[0], r[in.c].v[1]));
+			} break;
+			case OP_VECTOR2_CROSS: {
+				r[in.a].f = Vector2(r[in.b].v[0], r[in.b].v[1]).cross(Vector2(r[in.c].v[0], r[in.c].v[1]));
+			} break;
+			case OP_VECTOR2_NORMALIZED: {
+				Vector2 value = Vector2(r[in.b].v[0], r[in.b].v[1]).normalized();
+				r[in.a].v[0] = value.x;
+				r[in.a].v[1] = value.y;
+				r[in.a].v[2] = 0;
+			} break;
+			case OP_VECTOR2_DISTANCE_TO: {
+				r[in.a].f = Vector2(r[in.b].v[0], r[in.b].v[1]).distance_to(Vector2(r[in.c].v[0], r[in.c].v[1]));
+			} break;
+			case OP_VECTOR3_LENGTH: {
+				r[in.a].f = Vector3(r[in.b].v[0], r[in.b].v[1], r[in.b].v[2]).length();
+			} break;
+			case OP_VECTOR3_LENGTH_SQUARED: {
+				r[in.a].f = Vector3(r[in.b].v[0], r[in.b].v[1], r[in.b].v[2]).length_squared();
+			} break;
+			case OP_VECTOR3_DOT: {
+				r[in.a].f = Vector3(r[in.b].v[0], r[in.b].v[1], r[in.b].v[2]).dot(Vector3(r[in.c].v[0], r[in.c].v[1], r[in.c].v[2]));
+			} break;
+			case OP_VECTOR3_CROSS: {
+				Vector3 value = Vector3(r[in.b].v[0], r[in.b].v[1], r[in.b].v[2]).cross(Vector3(r[in.c].v[0], r[in.c].v[1], r[in.c].v[2]));
+				r[in.a].v[0] = value.x;
+				r[in.a].v[1] = value.y;
+				r[in.a].v[2] = value.z;
+			} break;
+			case OP_VECTOR3_NORMALIZED: {
+				Vector3 value = Vector3(r[in.b].v[0], r[in.b].v[1], r[in.b].v[2]).normalized();
+				r[in.a].v[0] = value.x;
+				r[in.a].v[1] = value.y;
+				r[in.a].v[2] = value.z;
+			} break;
+			case OP_VECTOR3_DISTANCE_TO: {
+				r[in.a].f = Vector3(r[in.b].v[0], r[in.b].v[1], r[in.b].v[2]).distance_to(Vector3(r[in.c].v[0], r[in.c].v[1], r[in.c].v[2]));
+			} break;
+
+			case OP_CALL_FLOAT_1: {
+				r[in.a].f = float_utilities[in.function].function_1(r[in.b].f);
+			} break;
+			case OP_CALL_FLOAT_2: {
+				r[in.a].f = float_utilities[in.function].function_2(r[in.b].f, r[in.c].f);
+			} break;
+			case OP_CALL_FLOAT_3: {
+				r[in.a].f = float_utilities[in.function].function_3(r[in.b].f, r[in.c].f, r[in.d].f);
+			} break;
+			case OP_CALL_INT_1: {
+				r[in.a].i = int_utilities[in.function].function_1(r[in.b].i);
+			} break;
+			case OP_CALL_INT_2: {
+				r[in.a].i = int_utilities[in.function].function_2(r[in.b].i, r[in.c].i);
+			} break;
+			case OP_CALL_INT_3: {
+				r[in.a].i = int_utilities[in.function].function_3(r[in.b].i, r[in.c].i, r[in.d].i);
+			} break;
+
+			case OP_JUMP: {
+				ip = in.a;
+				continue;
+			}
+			case OP_JUMP_IF_BOOL:
+			case OP_JUMP_IF_NOT_BOOL: {
+				if (r[in.a].b == (in.op == OP_JUMP_IF_BOOL)) {
+					ip = in.b;
+					continue;
+				}
+			} break;
+			case OP_JUMP_IF_INT:
+			case OP_JUMP_IF_NOT_INT: {
+				if ((r[in.a].i != 0) == (in.op == OP_JUMP_IF_INT)) {
+					ip = in.b;
+					continue;
+				}
+			} break;
+			case OP_JUMP_IF_FLOAT:
+			case OP_JUMP_IF_NOT_FLOAT: {
+				if ((r[in.a].f != 0.0) == (in.op == OP_JUMP_IF_FLOAT)) {
+					ip = in.b;
+					continue;
+				}
+			} break;
+			case OP_ITERATE_BEGIN_INT: {
+				r[in.a].i = 0;
+				if (r[in.b].i > 0) {
+					r[in.c].i = 0;
+				} else {
+					ip = in.d;
+					continue;
+				}
+			} break;
+			case OP_ITERATE_INT: {
+				int64_t count = ++r[in.a].i;
+				if (count >= r[in.b].i) {
+					ip = in.d;
+					continue;
+				}
+				r[in.c].i = count;
+			} break;
+			case OP_RETURN: {
+				r_ret = _box(r[in.a], (Variant::Type)in.b);
+				return true;
+			}
+			case OP_RETURN_NIL: {
+				r_ret = Variant();
+				return true;
+			}
+		}
+		ip++;
+	}
+}
@@ -0,0 +1,169 @@
+/*************************************************************************/
+/*  gdscript_register_function.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_REGISTER_FUNCTION_H
+#define GDSCRIPT_REGISTER_FUNCTION_H
+
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+class GDScriptFunction;
+
+// Second execution tier for GDScript functions doing statically typed math.
+//
+// Functions whose bytecode only touches locals, arguments and constants of type bool, int,
+// float, Vector2 and Vector3 through validated instructions are translated at load time to a
+// register program that works on the raw values, so no Variant is constructed, checked or
+// destroyed while running them. Such functions have no side effects, which lets the register
+// program give up at any point (type guard failure, integer division by zero) and have the
+// interpreter run the whole call again from the start, reporting errors exactly as before.
+class GDScriptRegisterFunction {
+	enum Opcode {
+		OP_MOVE,
+		OP_LOAD_BOOL,
+		OP_LOAD_ZERO,
+		OP_INT_TO_FLOAT,
+		OP_FLOAT_TO_INT,
+
+		OP_ADD_INT,
+		OP_SUB_INT,
+		OP_MUL_INT,
+		OP_DIV_INT,
+		OP_MOD_INT,
+		OP_NEGATE_INT,
+		OP_BIT_AND,
+		OP_BIT_OR,
+		OP_BIT_XOR,
+		OP_BIT_NEGATE,
+		OP_EQUAL_INT,
+		OP_NOT_EQUAL_INT,
+		OP_LESS_INT,
+		OP_LESS_EQUAL_INT,
+		OP_NOT_INT,
+
+		OP_ADD_FLOAT,
+		OP_SUB_FLOAT,
+		OP_MUL_FLOAT,
+		OP_DIV_FLOAT,
+		OP_NEGATE_FLOAT,
+		OP_EQUAL_FLOAT,
+		OP_NOT_EQUAL_FLOAT,
+		OP_LESS_FLOAT,
+		OP_LESS_EQUAL_FLOAT,
+		OP_NOT_FLOAT,
+
+		OP_EQUAL_BOOL,
+		OP_NOT_EQUAL_BOOL,
+		OP_NOT_BOOL,
+
+		// Vector opcodes work on the first `d` lanes, so they serve both Vector2 and Vector3.
+		OP_ADD_VECTOR,
+		OP_SUB_VECTOR,
+		OP_MUL_VECTOR,
+		OP_DIV_VECTOR,
+		OP_MUL_VECTOR_SCALAR,
+		OP_DIV_VECTOR_SCALAR,
+		OP_NEGATE_VECTOR,
+		OP_EQUAL_VECTOR,
+		OP_NOT_EQUAL_VECTOR,
+		OP_CONSTRUCT_VECTOR,
+		OP_GET_LANE,
+		OP_SET_LANE,
+
+		OP_VECTOR2_LENGTH,
+		OP_VECTOR2_LENGTH_SQUARED,
+		OP_VECTOR2_DOT,
+		OP_VECTOR2_CROSS,
+		OP_VECTOR2_NORMALIZED,
+		OP_VECTOR2_DISTANCE_TO,
+		OP_VECTOR3_LENGTH,
+		OP_VECTOR3_LENGTH_SQUARED,
+		OP_VECTOR3_DOT,
+		OP_VECTOR3_CROSS,
+		OP_VECTOR3_NORMALIZED,
+		OP_VECTOR3_DISTANCE_TO,
+
+		OP_CALL_FLOAT_1,
+		OP_CALL_FLOAT_2,
+		OP_CALL_FLOAT_3,
+		OP_CALL_INT_1,
+		OP_CALL_INT_2,
+		OP_CALL_INT_3,
+
+		OP_JUMP,
+		OP_JUMP_IF_BOOL,
+		OP_JUMP_IF_NOT_BOOL,
+		OP_JUMP_IF_INT,
+		OP_JUMP_IF_NOT_INT,
+		OP_JUMP_IF_FLOAT,
+		OP_JUMP_IF_NOT_FLOAT,
+		OP_ITERATE_BEGIN_INT,
+		OP_ITERATE_INT,
+		OP_RETURN,
+		OP_RETURN_NIL,
+	};
+
+	union Register {
+		bool b;
+		int64_t i;
+		double f;
+		real_t v[3];
+	};
+
+	struct Instruction {
+		Opcode op;
+		int a = 0;
+		int b = 0;
+		int c = 0;
+		int d = 0;
+		int function = 0; // Index in the utility function tables.
+	};
+
+	struct Builder;
+
+	LocalVector<Instruction> code;
+	LocalVector<Register> constants;
+	LocalVector<Variant::Type> register_types;
+	uint32_t stack_size = 0;
+	uint32_t register_count = 0;
+	int argument_count = 0;
+
+	static Register _unbox(const Variant &p_value, Variant::Type p_type);
+	static Variant _box(const Register &p_value, Variant::Type p_type);
+
+public:
+	// Returns nullptr when the function uses anything the register tier does not support.
+	static GDScriptRegisterFunction *compile(const GDScriptFunction *p_function);
+
+	// Returns false when the interpreter must run the call instead, r_ret is left untouched then.
+	bool call(const Variant **p_args, int p_argcount, Variant &r_ret) const;
+};
+
+#endif // GDSCRIPT_REGISTER_FUNCTION_H
@@ -34,6 +34,7 @@
 #include "core/os/os.h"
 #include "gdscript.h"
 #include "gdscript_lambda_callable.h"
+#include "gdscript_register_function.h"
 
 Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_instance, Variant *p_stack, String &r_error) const {
 	int address = p_address & ADDR_MASK;
@@ -195,6 +196,33 @@ void (*type_init_function_table[])(Variant *) = {
 	static const void *switch_table_ops[] = {        \
 		&&OPCODE_OPERATOR,                           \
 		&&OPCODE_OPERATOR_VALIDATED,                 \
+		&&OPCODE_OPERATOR_ADD_INT,                   \
+		&&OPCODE_OPERATOR_SUBTRACT_INT,              \
+		&&OPCODE_OPERATOR_MULTIPLY_INT,              \
+		&&OPCODE_OPERATOR_EQUAL_INT,                 \
+		&&OPCODE_OPERATOR_NOT_EQUAL_INT,             \
+		&&OPCODE_OPERATOR_LESS_INT,                  \
+		&&OPCODE_OPERATOR_LESS_EQUAL_INT,            \
+		&&OPCODE_OPERATOR_GREATER_INT,               \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_INT,         \
+		&&OPCODE_OPERATOR_ADD_FLOAT,                 \
+		&&OPCODE_OPERATOR_SUBTRACT_FLOAT,            \
+		&&OPCODE_OPERATOR_MULTIPLY_FLOAT,            \
+		&&OPCODE_OPERATOR_DIVIDE_FLOAT,              \
+		&&OPCODE_OPERATOR_EQUAL_FLOAT,               \
+		&&OPCODE_OPERATOR_NOT_EQUAL_FLOAT,           \
+		&&OPCODE_OPERATOR_LESS_FLOAT,                \
+		&&OPCODE_OPERATOR_LESS_EQUAL_FLOAT,          \
+		&&OPCODE_OPERATOR_GREATER_FLOAT,             \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,       \
+		&&OPCODE_OPERATOR_ADD_VECTOR2,               \
+		&&OPCODE_OPERATOR_SUBTRACT_VECTOR2,          \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT,    \
+		&&OPCODE_OPERATOR_DIVIDE_VECTOR2_FLOAT,      \
+		&&OPCODE_OPERATOR_ADD_VECTOR3,               \
+		&&OPCODE_OPERATOR_SUBTRACT_VECTOR3,          \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT,    \
+		&&OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT,      \
 		&&OPCODE_EXTENDS_TEST,                       \
 		&&OPCODE_IS_BUILTIN,                         \
 		&&OPCODE_SET_KEYED,                          \
@@ -212,6 +240,8 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_ASSIGN,                             \
 		&&OPCODE_ASSIGN_TRUE,                        \
 		&&OPCODE_ASSIGN_FALSE,                       \
+		&&OPCODE_ASSIGN_INT,                         \
+		&&OPCODE_ASSIGN_FLOAT,                       \
 		&&OPCODE_ASSIGN_TYPED_BUILTIN,               \
 		&&OPCODE_ASSIGN_TYPED_ARRAY,                 \
 		&&OPCODE_ASSIGN_TYPED_NATIVE,                \
@@ -292,6 +322,8 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_ITERATE_BEGIN_STRING,               \
 		&&OPCODE_ITERATE_BEGIN_DICTIONARY,           \
 		&&OPCODE_ITERATE_BEGIN_ARRAY,                \
+		&&OPCODE_ITERATE_BEGIN_ARRAY_INT,            \
+		&&OPCODE_ITERATE_BEGIN_ARRAY_FLOAT,          \
 		&&OPCODE_ITERATE_BEGIN_PACKED_BYTE_ARRAY,    \
 		&&OPCODE_ITERATE_BEGIN_PACKED_INT32_ARRAY,   \
 		&&OPCODE_ITERATE_BEGIN_PACKED_INT64_ARRAY,   \
@@ -312,6 +344,8 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_ITERATE_STRING,                     \
 		&&OPCODE_ITERATE_DICTIONARY,                 \
 		&&OPCODE_ITERATE_ARRAY,                      \
+		&&OPCODE_ITERATE_ARRAY_INT,                  \
+		&&OPCODE_ITERATE_ARRAY_FLOAT,                \
 		&&OPCODE_ITERATE_PACKED_BYTE_ARRAY,          \
 		&&OPCODE_ITERATE_PACKED_INT32_ARRAY,         \
 		&&OPCODE_ITERATE_PACKED_INT64_ARRAY,         \
@@ -432,6 +466,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	r_err.error = Callable::CallError::CALL_OK;
 
+	if (register_function && !p_state && !EngineDebugger::is_active()) {
+		// Falls through to the interpreter when the arguments don't have the expected types.
+		Variant ret;
+		if (register_function->call(p_args, p_argcount, ret)) {
+			return ret;
+		}
+	}
+
 	Variant retvalue;
 	Variant *stack = nullptr;
 	Variant **instruction_args = nullptr;
@@ -652,6 +694,66 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			// Operators on statically typed operands, working on the values directly.
+			// The destination already has the result type unless its stack slot was used for something else before.
+#define OPCODE_OPERATOR_TYPED(m_name, m_get_a, m_get_b, m_op, m_ret_type, m_ret_c_type, m_ret_get) \
+	OPCODE(OPCODE_OPERATOR_##m_name) {                                                            \
+		CHECK_SPACE(4);                                                                           \
+		GET_INSTRUCTION_ARG(a, 0);                                                                \
+		GET_INSTRUCTION_ARG(b, 1);                                                                \
+		GET_INSTRUCTION_ARG(dst, 2);                                                              \
+		m_ret_c_type result = *VariantInternal::m_get_a(a) m_op *VariantInternal::m_get_b(b);     \
+		if (unlikely(dst->get_type() != Variant::m_ret_type)) {                                   \
+			VariantInternal::initialize(dst, Variant::m_ret_type);                                \
+		}                                                                                         \
+		*VariantInternal::m_ret_get(dst) = result;                                                \
+		ip += 4;                                                                                  \
+	}                                                                                             \
+	DISPATCH_OPCODE
+
+#define OPCODE_OPERATOR_TYPED_SCALAR(m_name, m_get_a, m_op, m_ret_type, m_ret_c_type, m_ret_get)     \
+	OPCODE(OPCODE_OPERATOR_##m_name) {                                                            \
+		CHECK_SPACE(4);                                                                           \
+		GET_INSTRUCTION_ARG(a, 0);                                                                \
+		GET_INSTRUCTION_ARG(b, 1);                                                                \
+		GET_INSTRUCTION_ARG(dst, 2);                                                              \
+		m_ret_c_type result = *VariantInternal::m_get_a(a) m_op(real_t) * VariantInternal::get_float(b); \
+		if (unlikely(dst->get_type() != Variant::m_ret_type)) {                                   \
+			VariantInternal::initialize(dst, Variant::m_ret_type);                                \
+		}                                                                                         \
+		*VariantInternal::m_ret_get(dst) = result;                                                \
+		ip += 4;                                                                                  \
+	}                                                                                             \
+	DISPATCH_OPCODE
+
+			OPCODE_OPERATOR_TYPED(ADD_INT, get_int, get_int, +, INT, int64_t, get_int);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_INT, get_int, get_int, -, INT, int64_t, get_int);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_INT, get_int, get_int, *, INT, int64_t, get_int);
+			OPCODE_OPERATOR_TYPED(EQUAL_INT, get_int, get_int, ==, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(NOT_EQUAL_INT, get_int, get_int, !=, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(LESS_INT, get_int, get_int, <, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL_INT, get_int, get_int, <=, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(GREATER_INT, get_int, get_int, >, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(GREATER_EQUAL_INT, get_int, get_int, >=, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(ADD_FLOAT, get_float, get_float, +, FLOAT, double, get_float);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_FLOAT, get_float, get_float, -, FLOAT, double, get_float);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_FLOAT, get_float, get_float, *, FLOAT, double, get_float);
+			OPCODE_OPERATOR_TYPED(DIVIDE_FLOAT, get_float, get_float, /, FLOAT, double, get_float);
+			OPCODE_OPERATOR_TYPED(EQUAL_FLOAT, get_float, get_float, ==, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(NOT_EQUAL_FLOAT, get_float, get_float, !=, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(LESS_FLOAT, get_float, get_float, <, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL_FLOAT, get_float, get_float, <=, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(GREATER_FLOAT, get_float, get_float, >, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(GREATER_EQUAL_FLOAT, get_float, get_float, >=, BOOL, bool, get_bool);
+			OPCODE_OPERATOR_TYPED(ADD_VECTOR2, get_vector2, get_vector2, +, VECTOR2, Vector2, get_vector2);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_VECTOR2, get_vector2, get_vector2, -, VECTOR2, Vector2, get_vector2);
+			OPCODE_OPERATOR_TYPED_SCALAR(MULTIPLY_VECTOR2_FLOAT, get_vector2, *, VECTOR2, Vector2, get_vector2);
+			OPCODE_OPERATOR_TYPED_SCALAR(DIVIDE_VECTOR2_FLOAT, get_vector2, /, VECTOR2, Vector2, get_vector2);
+			OPCODE_OPERATOR_TYPED(ADD_VECTOR3, get_vector3, get_vector3, +, VECTOR3, Vector3, get_vector3);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_VECTOR3, get_vector3, get_vector3, -, VECTOR3, Vector3, get_vector3);
+			OPCODE_OPERATOR_TYPED_SCALAR(MULTIPLY_VECTOR3_FLOAT, get_vector3, *, VECTOR3, Vector3, get_vector3);
+			OPCODE_OPERATOR_TYPED_SCALAR(DIVIDE_VECTOR3_FLOAT, get_vector3, /, VECTOR3, Vector3, get_vector3);
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 				CHECK_SPACE(4);
 
@@ -1092,6 +1194,23 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+#define OPCODE_ASSIGN_TYPED(m_type, m_c_type, m_get)         \
+	OPCODE(OPCODE_ASSIGN_##m_type) {                         \
+		CHECK_SPACE(3);                                      \
+		GET_INSTRUCTION_ARG(dst, 0);                         \
+		GET_INSTRUCTION_ARG(src, 1);                         \
+		m_c_type value = *VariantInternal::m_get(src);       \
+		if (unlikely(dst->get_type() != Variant::m_type)) {  \
+			VariantInternal::initialize(dst, Variant::m_type); \
+		}                                                    \
+		*VariantInternal::m_get(dst) = value;                \
+		ip += 3;                                             \
+	}                                                        \
+	DISPATCH_OPCODE
+
+			OPCODE_ASSIGN_TYPED(INT, int64_t, get_int);
+			OPCODE_ASSIGN_TYPED(FLOAT, double, get_float);
+
 			OPCODE(OPCODE_ASSIGN_TYPED_BUILTIN) {
 				CHECK_SPACE(4);
 				GET_INSTRUCTION_ARG(dst, 0);
@@ -2697,6 +2816,35 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+#define OPCODE_ITERATE_BEGIN_TYPED_ARRAY(m_type, m_c_type, m_get)                  \
+	OPCODE(OPCODE_ITERATE_BEGIN_ARRAY_##m_type) {                                 \
+		CHECK_SPACE(8);                                                           \
+		GET_INSTRUCTION_ARG(counter, 0);                                          \
+		GET_INSTRUCTION_ARG(container, 1);                                        \
+		const Array *array = VariantInternal::get_array((const Variant *)container); \
+		VariantInternal::initialize(counter, Variant::INT);                       \
+		*VariantInternal::get_int(counter) = 0;                                   \
+		if (!array->is_empty()) {                                                 \
+			GET_INSTRUCTION_ARG(iterator, 2);                                     \
+			const Variant &element = (*array)[0];                                 \
+			if (likely(element.get_type() == Variant::m_type)) {                  \
+				VariantInternal::initialize(iterator, Variant::m_type);           \
+				*VariantInternal::m_get(iterator) = *VariantInternal::m_get(&element); \
+			} else {                                                              \
+				*iterator = element;                                              \
+			}                                                                     \
+			ip += 5;                                                              \
+		} else {                                                                  \
+			int jumpto = _code_ptr[ip + 4];                                       \
+			GD_ERR_BREAK(jumpto<0 || jumpto> _code_size);                         \
+			ip = jumpto;                                                          \
+		}                                                                         \
+	}                                                                             \
+	DISPATCH_OPCODE
+
+			OPCODE_ITERATE_BEGIN_TYPED_ARRAY(INT, int64_t, get_int);
+			OPCODE_ITERATE_BEGIN_TYPED_ARRAY(FLOAT, double, get_float);
+
 #define OPCODE_ITERATE_BEGIN_PACKED_ARRAY(m_var_type, m_elem_type, m_get_func, m_var_ret_type, m_ret_type, m_ret_get_func) \
 	OPCODE(OPCODE_ITERATE_BEGIN_PACKED_##m_var_type##_ARRAY) {                                                             \
 		CHECK_SPACE(8);                                                                                                    \
@@ -3030,6 +3178,34 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+#define OPCODE_ITERATE_TYPED_ARRAY(m_type, m_c_type, m_get)                       \
+	OPCODE(OPCODE_ITERATE_ARRAY_##m_type) {                                       \
+		CHECK_SPACE(4);                                                           \
+		GET_INSTRUCTION_ARG(counter, 0);                                          \
+		GET_INSTRUCTION_ARG(container, 1);                                        \
+		const Array *array = VariantInternal::get_array((const Variant *)container); \
+		int64_t *idx = VariantInternal::get_int(counter);                         \
+		(*idx)++;                                                                 \
+		if (*idx >= array->size()) {                                              \
+			int jumpto = _code_ptr[ip + 4];                                       \
+			GD_ERR_BREAK(jumpto<0 || jumpto> _code_size);                         \
+			ip = jumpto;                                                          \
+		} else {                                                                  \
+			GET_INSTRUCTION_ARG(iterator, 2);                                     \
+			const Variant &element = (*array)[*idx];                              \
+			if (likely(element.get_type() == Variant::m_type && iterator->get_type() == Variant::m_type)) { \
+				*VariantInternal::m_get(iterator) = *VariantInternal::m_get(&element); \
+			} else {                                                              \
+				*iterator = element;                                              \
+			}                                                                     \
+			ip += 5;                                                              \
+		}                                                                         \
+	}                                                                             \
+	DISPATCH_OPCODE
+
+			OPCODE_ITERATE_TYPED_ARRAY(INT, int64_t, get_int);
+			OPCODE_ITERATE_TYPED_ARRAY(FLOAT, double, get_float);
+
 #define OPCODE_ITERATE_PACKED_ARRAY(m_var_type, m_elem_type, m_get_func, m_ret_get_func)            \
 	OPCODE(OPCODE_ITERATE_PACKED_##m_var_type##_ARRAY) {                                            \
 		CHECK_SPACE(4);                                                                             \
@@ -0,0 +1,36 @@
+const COUNT = 1000000
+
+var typed_values: Array[float] = []
+var untyped_values := []
+var packed_values := PackedFloat32Array()
+
+
+func _init():
+	typed_values.resize(COUNT)
+	untyped_values.resize(COUNT)
+	packed_values.resize(COUNT)
+	for i in COUNT:
+		typed_values[i] = i * 0.5
+		untyped_values[i] = i * 0.5
+		packed_values[i] = i * 0.5
+
+
+func benchmark_array_sum_typed():
+	var sum: float = 0.0
+	for value in typed_values:
+		sum = sum + value
+	return sum
+
+
+func benchmark_array_sum_untyped():
+	var sum = 0.0
+	for value in untyped_values:
+		sum = sum + value
+	return sum
+
+
+func benchmark_array_sum_packed_float32():
+	var sum: float = 0.0
+	for value in packed_values:
+		sum = sum + value
+	return sum
@@ -0,0 +1,19 @@
+const COUNT = 1000000
+
+
+func benchmark_float_accumulate_typed():
+	var acc: float = 0.0
+	var x: float = 0.5
+	for _i in COUNT:
+		acc = acc + x * 1.0001 - 0.25
+		x = x / 1.0001
+	return acc
+
+
+func benchmark_float_accumulate_untyped():
+	var acc = 0.0
+	var x = 0.5
+	for _i in COUNT:
+		acc = acc + x * 1.0001 - 0.25
+		x = x / 1.0001
+	return acc
@@ -0,0 +1,19 @@
+const COUNT = 1000000
+
+
+func benchmark_int_sum_typed():
+	var sum: int = 0
+	var i: int = 0
+	while i < COUNT:
+		sum = sum + i * 3 - 1
+		i = i + 1
+	return sum
+
+
+func benchmark_int_sum_untyped():
+	var sum = 0
+	var i = 0
+	while i < COUNT:
+		sum = sum + i * 3 - 1
+		i = i + 1
+	return sum
@@ -0,0 +1,23 @@
+const COUNT = 500000
+
+
+func benchmark_vector3_integrate_typed():
+	var position: Vector3 = Vector3.ZERO
+	var velocity: Vector3 = Vector3(1.0, 2.0, 3.0)
+	var gravity: Vector3 = Vector3(0.0, -9.8, 0.0)
+	var delta: float = 1.0 / 60.0
+	for _i in COUNT:
+		velocity = velocity + gravity * delta
+		position = position + velocity * delta
+	return position
+
+
+func benchmark_vector3_integrate_untyped():
+	var position = Vector3.ZERO
+	var velocity = Vector3(1.0, 2.0, 3.0)
+	var gravity = Vector3(0.0, -9.8, 0.0)
+	var delta = 1.0 / 60.0
+	for _i in COUNT:
+		velocity = velocity + gravity * delta
+		position = position + velocity * delta
+	return position
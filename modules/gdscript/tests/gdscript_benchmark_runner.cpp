@@ -0,0 +1,166 @@
+/*************************************************************************/
+/*  gdscript_benchmark_runner.cpp                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_benchmark_runner.h"
+
+#include "gdscript_test_runner.h"
+
+#include "../gdscript.h"
+
+#include "core/io/dir_access.h"
+#include "core/os/os.h"
+
+namespace GDScriptTests {
+
+const char *GDScriptBenchmarkRunner::benchmark_prefix = "benchmark_";
+
+GDScriptBenchmarkRunner::GDScriptBenchmarkRunner(const String &p_source_dir, int p_iterations) {
+	source_dir = p_source_dir;
+	if (!source_dir.ends_with("/")) {
+		source_dir += "/";
+	}
+	iterations = MAX(p_iterations, 1);
+
+	init_language(source_dir);
+}
+
+GDScriptBenchmarkRunner::~GDScriptBenchmarkRunner() {
+	finish_language();
+}
+
+bool GDScriptBenchmarkRunner::find_scripts(const String &p_dir) {
+	Error err = OK;
+	DirAccessRef dir(DirAccess::open(p_dir, &err));
+	if (err != OK) {
+		return false;
+	}
+
+	String current_dir = dir->get_current_dir();
+
+	dir->list_dir_begin();
+	String next = dir->get_next();
+
+	while (!next.is_empty()) {
+		if (dir->current_is_dir()) {
+			if (next != "." && next != ".." && !find_scripts(current_dir.plus_file(next))) {
+				return false;
+			}
+		} else if (next.get_extension().to_lower() == "gd") {
+			scripts.push_back(current_dir.plus_file(next));
+		}
+		next = dir->get_next();
+	}
+
+	dir->list_dir_end();
+
+	return true;
+}
+
+bool GDScriptBenchmarkRunner::run_script(const String &p_path) {
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_path(p_path);
+	script->set_script_path(p_path);
+	Error err = script->load_source_code(p_path);
+	ERR_FAIL_COND_V_MSG(err != OK, false, "Could not load source code for: '" + p_path + "'.");
+	err = script->reload();
+	ERR_FAIL_COND_V_MSG(err != OK, false, "Could not compile: '" + p_path + "'.");
+
+	// Sort the benchmarks so the typed and untyped variants print next to each other.
+	Vector<StringName> benchmarks;
+	for (const KeyValue<StringName, GDScriptFunction *> &E : script->get_member_functions()) {
+		if (String(E.key).begins_with(benchmark_prefix)) {
+			benchmarks.push_back(E.key);
+		}
+	}
+	benchmarks.sort_custom<StringName::AlphCompare>();
+	if (benchmarks.is_empty()) {
+		return true;
+	}
+
+	Object *obj = ClassDB::instantiate(script->get_native()->get_name());
+	Ref<RefCounted> obj_ref;
+	if (obj->is_ref_counted()) {
+		obj_ref = Ref<RefCounted>(Object::cast_to<RefCounted>(obj));
+	}
+	obj->set_script(script);
+	GDScriptInstance *instance = static_cast<GDScriptInstance *>(obj->get_script_instance());
+
+	print_line(p_path.replace_first(source_dir, ""));
+
+	bool ok = true;
+	for (int i = 0; i < benchmarks.size(); i++) {
+		uint64_t best = UINT64_MAX;
+		for (int j = 0; j < iterations; j++) {
+			Callable::CallError call_err;
+			uint64_t start = OS::get_singleton()->get_ticks_usec();
+			instance->call(benchmarks[i], nullptr, 0, call_err);
+			uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - start;
+			if (call_err.error != Callable::CallError::CALL_OK) {
+				ERR_PRINT("Could not call benchmark function '" + String(benchmarks[i]) + "' on: '" + p_path + "'.");
+				ok = false;
+				break;
+			}
+			best = MIN(best, elapsed);
+		}
+		if (best != UINT64_MAX) {
+			print_line(vformat("    %-40s %10d usec", String(benchmarks[i]), (int64_t)best));
+		}
+	}
+
+	if (obj_ref.is_null()) {
+		memdelete(obj);
+	}
+
+	return ok;
+}
+
+int GDScriptBenchmarkRunner::run_benchmarks() {
+	Error err = OK;
+	DirAccessRef dir(DirAccess::open(source_dir, &err));
+	ERR_FAIL_COND_V_MSG(err != OK, -1, "Could not open specified benchmark directory.");
+	source_dir = dir->get_current_dir() + "/"; // Make it absolute path.
+
+	if (!find_scripts(dir->get_current_dir())) {
+		ERR_PRINT("An error occurred while looking for benchmark scripts.");
+		return -1;
+	}
+	scripts.sort();
+
+	int failed = 0;
+	for (int i = 0; i < scripts.size(); i++) {
+		if (!run_script(scripts[i])) {
+			failed++;
+		}
+	}
+	return failed;
+}
+
+} // namespace GDScriptTests
@@ -1,5 +1,5 @@
 /*************************************************************************/
-/*  renderer_thread_pool.h                                               */
+/*  gdscript_benchmark_runner.h                                          */
 /*************************************************************************/
 /*                       This file is part of:                           */
 /*                           GODOT ENGINE                                */
@@ -28,18 +28,35 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
 
-#ifndef RENDERERTHREADPOOL_H
-#define RENDERERTHREADPOOL_H
 
-#include "core/templates/thread_work_pool.h"
+#ifndef GDSCRIPT_BENCHMARK_RUNNER_H
+#define GDSCRIPT_BENCHMARK_RUNNER_H
+
+#include "core/string/ustring.h"
+#include "core/templates/vector.h"
+
+namespace GDScriptTests {
+
+// Runs every `benchmark_*` function of the scripts in a folder and prints the
+// best time out of several runs. Meant to compare VM changes, not to validate
+// output, so the results are not checked against anything.
+class GDScriptBenchmarkRunner {
+	String source_dir;
+	Vector<String> scripts;
+	int iterations = 5;
+
+	bool find_scripts(const String &p_dir);
+	bool run_script(const String &p_path);
 
-class RendererThreadPool {
 public:
-	ThreadWorkPool thread_work_pool;
+	static const char *benchmark_prefix;
+
+	int run_benchmarks();
 
-	static RendererThreadPool *singleton;
-	RendererThreadPool();
-	~RendererThreadPool();
+	GDScriptBenchmarkRunner(const String &p_source_dir, int p_iterations = 5);
+	~GDScriptBenchmarkRunner();
 };
 
-#endif // RENDERERTHREADPOOL_H
+} // namespace GDScriptTests
+
+#endif // GDSCRIPT_BENCHMARK_RUNNER_H
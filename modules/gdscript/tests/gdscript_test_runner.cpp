@@ -34,6 +34,7 @@
 #include "../gdscript_analyzer.h"
 #include "../gdscript_compiler.h"
 #include "../gdscript_parser.h"
+#include "gdscript_benchmark_runner.h"
 
 #include "core/config/project_settings.h"
 #include "core/core_string_names.h"
@@ -294,9 +295,19 @@ void GDScriptTestRunner::handle_cmdline() {
 	// Currently requires to startup the whole engine, which is slow.
 	String test_cmd = "--gdscript-test";
 	String gen_cmd = "--gdscript-generate-tests";
+	String benchmark_cmd = "--gdscript-benchmark";
 
 	for (List<String>::Element *E = cmdline_args.front(); E; E = E->next()) {
 		String &cmd = E->get();
+		if (cmd == benchmark_cmd) {
+			if (E->next() == nullptr) {
+				ERR_PRINT("Needed a path for the benchmark files.");
+				exit(-1);
+			}
+
+			GDScriptBenchmarkRunner runner(E->next()->get());
+			exit(runner.run_benchmarks());
+		}
 		if (cmd == test_cmd || cmd == gen_cmd) {
 			if (E->next() == nullptr) {
 				ERR_PRINT("Needed a path for the test files.");
@@ -0,0 +1,44 @@
+# Functions doing only typed math run unboxed, results must match the interpreter.
+
+func sum_to(n: int) -> int:
+	var total := 0
+	for i in n:
+		total += i
+	return total
+
+
+func lerp_steps(from: float, to: float, steps: int) -> float:
+	var value := from
+	for _i in steps:
+		value = lerp(value, to, 0.5)
+	return value
+
+
+func length_of(v: Vector3) -> float:
+	return v.length()
+
+
+func mixed(a: int, b: float) -> float:
+	var result := a * b
+	if a > b:
+		result = -result
+	return result
+
+
+func halve(v: Vector2, times: int) -> Vector2:
+	var result := v
+	while times > 0:
+		result = result / 2.0
+		times -= 1
+	return result
+
+
+func test():
+	print(sum_to(100))
+	print(lerp_steps(0.0, 8.0, 3))
+	print(length_of(Vector3(2, 3, 6)))
+	print(mixed(3, 1.5))
+	print(mixed(1, 2.5))
+	print(halve(Vector2(8, 4), 2))
+	# An int passed for a float argument goes through the interpreter, which converts it.
+	print(mixed(3, 2))
@@ -0,0 +1,45 @@
+# Operators on untyped values, or on types without a specialized opcode, go through the
+# generic operators and must give the same results as the typed ones.
+
+func untyped_operators(a, b) -> Array:
+	return [a + b, a - b, a * b, a == b, a != b, a < b, a <= b, a > b, a >= b]
+
+
+func mixed_operators(a: int, b: float) -> Array:
+	return [a + b, a - b, a * b, a / b, a < b]
+
+
+func sum_untyped(values: Array):
+	var total = 0
+	for value in values:
+		total += value
+	return total
+
+
+func to_typed_float(value) -> float:
+	var f: float = value
+	return f
+
+
+func test():
+	print(untyped_operators(7, 3))
+	print(untyped_operators(1.5, 0.5))
+	print(untyped_operators(Vector3(1, 2, 3), Vector3(4, 5, 6)))
+	# A Variant holding an int mixed with a float.
+	print(untyped_operators(2, 0.5))
+	print(mixed_operators(3, 1.5))
+	print(sum_untyped([1, 2.5, 3]))
+	print(sum_untyped([]))
+	print(to_typed_float(2))
+	print(typeof(to_typed_float(2)) == TYPE_FLOAT)
+
+	# A typed int assigned to a typed float needs a conversion.
+	var i: int = 5
+	var f: float = i
+	f /= 2.0
+	print(f)
+
+	var v = Vector2(3, 4)
+	var s = 2
+	print(v * s)
+	print(v / s)
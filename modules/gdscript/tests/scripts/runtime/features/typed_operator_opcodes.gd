@@ -0,0 +1,65 @@
+# Operators on typed int, float, Vector2 and Vector3 values use opcodes working on the raw values.
+
+func int_operators(a: int, b: int) -> Array:
+	return [a + b, a - b, a * b, a == b, a != b, a < b, a <= b, a > b, a >= b]
+
+
+func float_operators(a: float, b: float) -> Array:
+	return [a + b, a - b, a * b, a / b, a == b, a != b, a < b, a <= b, a > b, a >= b]
+
+
+func vector_operators(a: Vector3, b: Vector3, s: float) -> Array:
+	return [a + b, a - b, a * s, a / s]
+
+
+func vector2_operators(a: Vector2, b: Vector2, s: float) -> Array:
+	return [a + b, a - b, a * s, a / s]
+
+
+func assignments() -> Array:
+	var i := 3
+	var j := i
+	j += 4
+	var f := 1.5
+	var g := f
+	g *= 2.0
+	# Assigning to one must not change the other.
+	return [i, j, f, g]
+
+
+func sum_ints(values: Array[int]) -> int:
+	var total := 0
+	for value in values:
+		total += value
+	return total
+
+
+func sum_floats(values: Array[float]) -> float:
+	var total := 0.0
+	for value in values:
+		total += value
+	return total
+
+
+func test():
+	print(int_operators(7, 3))
+	print(int_operators(-2, -2))
+	print(float_operators(1.5, 0.5))
+	print(float_operators(-0.25, -0.25))
+	print(vector_operators(Vector3(1, 2, 3), Vector3(4, 5, 6), 2.0))
+	print(vector2_operators(Vector2(1, -2), Vector2(0.5, 4), 4.0))
+	print(assignments())
+
+	var ints: Array[int] = [1, 2, 3, 4]
+	print(sum_ints(ints))
+	var no_ints: Array[int] = []
+	print(sum_ints(no_ints))
+	var floats: Array[float] = [0.5, 0.25, 2.0]
+	print(sum_floats(floats))
+
+	var doubled: Array[int] = []
+	for value in ints:
+		value *= 2
+		doubled.append(value)
+	print(doubled)
+	print(ints)
@@ -30,6 +30,7 @@
 
 #include "godot_navigation_server.h"
 
+#include "core/config/project_settings.h"
 #include "core/os/mutex.h"
 
 #ifndef _3D_DISABLED
@@ -115,10 +116,19 @@
 
 GodotNavigationServer::GodotNavigationServer() :
 		NavigationServer3D() {
+	use_batched_avoidance = GLOBAL_DEF("navigation/avoidance/use_batched_avoidance", true);
 }
 
 GodotNavigationServer::~GodotNavigationServer() {
+	finish_path_queries();
+	finish_flow_field_updates();
 	flush_queries();
+
+	MutexLock lock(path_queries_mutex);
+	for (uint32_t i = 0; i < pending_path_queries.size(); i++) {
+		memdelete(pending_path_queries[i]);
+	}
+	pending_path_queries.clear();
 }
 
 void GodotNavigationServer::add_command(SetCommand *command) const {
@@ -135,6 +145,7 @@ RID GodotNavigationServer::map_create() const {
 	RID rid = map_owner.make_rid();
 	NavMap *space = map_owner.getornull(rid);
 	space->set_self(rid);
+	space->set_use_batched_avoidance(use_batched_avoidance);
 	return rid;
 }
 
@@ -211,6 +222,79 @@ Vector<Vector3> GodotNavigationServer::map_get_path(RID p_map, Vector3 p_origin,
 	return map->get_path(p_origin, p_destination, p_optimize, p_layers);
 }
 
+void GodotNavigationServer::map_query_paths(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, Object *p_receiver, StringName p_method, Variant p_udata, uint32_t p_layers) const {
+	ERR_FAIL_COND(map_owner.getornull(p_map) == nullptr);
+	ERR_FAIL_COND_MSG(p_origins.size() != p_destinations.size(), "The origins and destinations arrays must have the same size.");
+	ERR_FAIL_NULL(p_receiver);
+
+	PathQueryBatch *batch = memnew(PathQueryBatch);
+	batch->map_rid = p_map;
+	batch->origins = p_origins;
+	batch->destinations = p_destinations;
+	batch->optimize = p_optimize;
+	batch->layers = p_layers;
+	batch->receiver = p_receiver->get_instance_id();
+	batch->method = p_method;
+	batch->udata = p_udata;
+
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->path_queries_mutex);
+	mut_this->pending_path_queries.push_back(batch);
+}
+
+void GodotNavigationServer::PathQueryBatch::query_path(uint32_t p_index, void *p_unused) {
+	paths[p_index] = map->get_path(origins[p_index], destinations[p_index], optimize, layers);
+}
+
+void GodotNavigationServer::start_path_queries() {
+	MutexLock lock(path_queries_mutex);
+	for (uint32_t i = 0; i < pending_path_queries.size(); i++) {
+		PathQueryBatch *batch = pending_path_queries[i];
+		batch->map = map_owner.getornull(batch->map_rid);
+		batch->paths.resize(batch->origins.size());
+
+		// The map may have been freed since the request, the paths are left empty.
+		if (batch->map != nullptr && batch->origins.size() > 0) {
+			batch->group_id = WorkerThreadPool::get_singleton()->add_template_group_task(batch, &PathQueryBatch::query_path, (void *)nullptr, batch->origins.size());
+		}
+		running_path_queries.push_back(batch);
+	}
+	pending_path_queries.clear();
+}
+
+void GodotNavigationServer::finish_path_queries() {
+	LocalVector<PathQueryBatch *> finished;
+	{
+		MutexLock lock(path_queries_mutex);
+		finished = running_path_queries;
+		running_path_queries.clear();
+	}
+
+	for (uint32_t i = 0; i < finished.size(); i++) {
+		PathQueryBatch *batch = finished[i];
+		if (batch->group_id != -1) {
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(batch->group_id);
+		}
+
+		Object *obj = ObjectDB::get_instance(batch->receiver);
+		if (obj != nullptr) {
+			Array paths;
+			paths.resize(batch->paths.size());
+			for (uint32_t j = 0; j < batch->paths.size(); j++) {
+				paths[j] = batch->paths[j];
+			}
+
+			const Variant paths_variant = paths;
+			Callable::CallError call_error;
+			const Variant *vp[2] = { &paths_variant, &batch->udata };
+			int argc = (batch->udata.get_type() == Variant::NIL) ? 1 : 2;
+			obj->call(batch->method, vp, argc, call_error);
+		}
+
+		memdelete(batch);
+	}
+}
+
 Vector3 GodotNavigationServer::map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	const NavMap *map = map_owner.getornull(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector3());
@@ -329,6 +413,100 @@ Vector3 GodotNavigationServer::region_get_connection_pathway_end(RID p_region, i
 	return region->get_connection_pathway_end(p_connection_id);
 }
 
+RID GodotNavigationServer::flow_field_create() const {
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->operations_mutex);
+	RID rid = flow_field_owner.make_rid();
+	NavFlowField *flow_field = flow_field_owner.getornull(rid);
+	flow_field->set_self(rid);
+	mut_this->flow_fields.push_back(flow_field);
+	return rid;
+}
+
+COMMAND_2(flow_field_set_map, RID, p_flow_field, RID, p_map) {
+	NavFlowField *flow_field = flow_field_owner.getornull(p_flow_field);
+	ERR_FAIL_COND(flow_field == nullptr);
+
+	if (flow_field->get_map() == p_map) {
+		return; // Pointless
+	}
+
+	ERR_FAIL_COND(p_map.is_valid() && map_owner.getornull(p_map) == nullptr);
+	flow_field->set_map(p_map);
+}
+
+COMMAND_2(flow_field_set_target, RID, p_flow_field, Vector3, p_target) {
+	NavFlowField *flow_field = flow_field_owner.getornull(p_flow_field);
+	ERR_FAIL_COND(flow_field == nullptr);
+
+	flow_field->set_target(p_target);
+}
+
+Vector3 GodotNavigationServer::flow_field_get_target(RID p_flow_field) const {
+	const NavFlowField *flow_field = flow_field_owner.getornull(p_flow_field);
+	ERR_FAIL_COND_V(flow_field == nullptr, Vector3());
+
+	return flow_field->get_target();
+}
+
+COMMAND_2(flow_field_set_layers, RID, p_flow_field, uint32_t, p_layers) {
+	NavFlowField *flow_field = flow_field_owner.getornull(p_flow_field);
+	ERR_FAIL_COND(flow_field == nullptr);
+
+	flow_field->set_layers(p_layers);
+}
+
+uint32_t GodotNavigationServer::flow_field_get_layers(RID p_flow_field) const {
+	const NavFlowField *flow_field = flow_field_owner.getornull(p_flow_field);
+	ERR_FAIL_COND_V(flow_field == nullptr, 0);
+
+	return flow_field->get_layers();
+}
+
+COMMAND_2(flow_field_set_cell_size, RID, p_flow_field, real_t, p_cell_size) {
+	NavFlowField *flow_field = flow_field_owner.getornull(p_flow_field);
+	ERR_FAIL_COND(flow_field == nullptr);
+
+	flow_field->set_cell_size(p_cell_size);
+}
+
+real_t GodotNavigationServer::flow_field_get_cell_size(RID p_flow_field) const {
+	const NavFlowField *flow_field = flow_field_owner.getornull(p_flow_field);
+	ERR_FAIL_COND_V(flow_field == nullptr, 0);
+
+	return flow_field->get_cell_size();
+}
+
+Vector3 GodotNavigationServer::flow_field_get_next_location(RID p_flow_field, Vector3 p_position, real_t p_desired_distance) const {
+	const NavFlowField *flow_field = flow_field_owner.getornull(p_flow_field);
+	ERR_FAIL_COND_V(flow_field == nullptr, p_position);
+
+	return flow_field->get_next_location(p_position, p_desired_distance);
+}
+
+real_t GodotNavigationServer::flow_field_get_distance(RID p_flow_field, Vector3 p_position) const {
+	const NavFlowField *flow_field = flow_field_owner.getornull(p_flow_field);
+	ERR_FAIL_COND_V(flow_field == nullptr, INFINITY);
+
+	return flow_field->get_distance(p_position);
+}
+
+void GodotNavigationServer::start_flow_field_updates() {
+	for (uint32_t i = 0; i < flow_fields.size(); i++) {
+		const NavMap *map = map_owner.getornull(flow_fields[i]->get_map());
+		if (map != nullptr) {
+			flow_fields[i]->start_update(map);
+		}
+	}
+}
+
+void GodotNavigationServer::finish_flow_field_updates() {
+	MutexLock lock(operations_mutex);
+	for (uint32_t i = 0; i < flow_fields.size(); i++) {
+		flow_fields[i]->finish_update();
+	}
+}
+
 RID GodotNavigationServer::agent_create() const {
 	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
 	MutexLock lock(mut_this->operations_mutex);
@@ -468,6 +646,13 @@ COMMAND_1(free, RID, p_object) {
 			agents[i]->set_map(nullptr);
 		}
 
+		// Leave the flow fields on this map without target
+		for (uint32_t i = 0; i < flow_fields.size(); i++) {
+			if (flow_fields[i]->get_map() == p_object) {
+				flow_fields[i]->set_map(RID());
+			}
+		}
+
 		int map_index = active_maps.find(map);
 		active_maps.remove(map_index);
 		active_maps_update_id.remove(map_index);
@@ -495,6 +680,12 @@ COMMAND_1(free, RID, p_object) {
 
 		agent_owner.free(p_object);
 
+	} else if (flow_field_owner.owns(p_object)) {
+		NavFlowField *flow_field = flow_field_owner.getornull(p_object);
+
+		flow_fields.erase(flow_field);
+		flow_field_owner.free(p_object);
+
 	} else {
 		ERR_FAIL_COND("Invalid ID.");
 	}
@@ -519,27 +710,35 @@ void GodotNavigationServer::flush_queries() {
 }
 
 void GodotNavigationServer::process(real_t p_delta_time) {
-	flush_queries();
+	// The path queries and the flow fields read the maps, they must be done
+	// before changing them.
+	finish_path_queries();
+	finish_flow_field_updates();
 
-	if (!active) {
-		return;
-	}
+	flush_queries();
 
-	// In c++ we can't be sure that this is performed in the main thread
-	// even with mutable functions.
-	MutexLock lock(operations_mutex);
-	for (uint32_t i(0); i < active_maps.size(); i++) {
-		active_maps[i]->sync();
-		active_maps[i]->step(p_delta_time);
-		active_maps[i]->dispatch_callbacks();
-
-		// Emit a signal if a map changed.
-		const uint32_t new_map_update_id = active_maps[i]->get_map_update_id();
-		if (new_map_update_id != active_maps_update_id[i]) {
-			emit_signal(SNAME("map_changed"), active_maps[i]->get_self());
-			active_maps_update_id[i] = new_map_update_id;
+	if (active) {
+		// In c++ we can't be sure that this is performed in the main thread
+		// even with mutable functions.
+		MutexLock lock(operations_mutex);
+		for (uint32_t i(0); i < active_maps.size(); i++) {
+			active_maps[i]->sync();
+			active_maps[i]->step(p_delta_time);
+			active_maps[i]->dispatch_callbacks();
+
+			// Emit a signal if a map changed.
+			const uint32_t new_map_update_id = active_maps[i]->get_map_update_id();
+			if (new_map_update_id != active_maps_update_id[i]) {
+				emit_signal(SNAME("map_changed"), active_maps[i]->get_self());
+				active_maps_update_id[i] = new_map_update_id;
+			}
 		}
 	}
+
+	// The queries and the flow fields are updated even while the server is
+	// inactive, like `map_get_path` is, from the maps as they were last synced.
+	start_path_queries();
+	start_flow_field_updates();
 }
 
 #undef COMMAND_1
@@ -31,11 +31,13 @@
 #ifndef GODOT_NAVIGATION_SERVER_H
 #define GODOT_NAVIGATION_SERVER_H
 
+#include "core/os/worker_thread_pool.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 #include "core/templates/rid_owner.h"
 #include "servers/navigation_server_3d.h"
 
+#include "nav_flow_field.h"
 #include "nav_map.h"
 #include "nav_region.h"
 #include "rvo_agent.h"
@@ -75,11 +77,44 @@ class GodotNavigationServer : public NavigationServer3D {
 
 	std::vector<SetCommand *> commands;
 
+	/// A set of paths requested with `map_query_paths`.
+	struct PathQueryBatch {
+		RID map_rid;
+		const NavMap *map = nullptr;
+		Vector<Vector3> origins;
+		Vector<Vector3> destinations;
+		bool optimize = false;
+		uint32_t layers = 1;
+
+		ObjectID receiver;
+		StringName method;
+		Variant udata;
+
+		LocalVector<Vector<Vector3>> paths;
+		WorkerThreadPool::GroupID group_id = -1;
+
+		void query_path(uint32_t p_index, void *p_unused);
+	};
+
+	/// The batches run while the maps are left untouched, between the end of
+	/// a `process` and the beginning of the next one, which waits for them
+	/// before flushing any command or syncing the maps.
+	Mutex path_queries_mutex;
+	LocalVector<PathQueryBatch *> pending_path_queries;
+	LocalVector<PathQueryBatch *> running_path_queries;
+
 	mutable RID_Owner<NavMap> map_owner;
 	mutable RID_Owner<NavRegion> region_owner;
 	mutable RID_Owner<RvoAgent> agent_owner;
+	mutable RID_Owner<NavFlowField> flow_field_owner;
+
+	/// The flow fields are updated like the path queries, while the maps are
+	/// left untouched.
+	LocalVector<NavFlowField *> flow_fields;
 
 	bool active = true;
+	/// Given to the new maps, see `NavMap::set_use_batched_avoidance`.
+	bool use_batched_avoidance = true;
 	LocalVector<NavMap *> active_maps;
 	LocalVector<uint32_t> active_maps_update_id;
 
@@ -103,6 +138,7 @@ public:
 	virtual real_t map_get_edge_connection_margin(RID p_map) const;
 
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers = 1) const;
+	virtual void map_query_paths(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, Object *p_receiver, StringName p_method, Variant p_udata = Variant(), uint32_t p_layers = 1) const;
 
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const;
@@ -120,6 +156,17 @@ public:
 	virtual Vector3 region_get_connection_pathway_start(RID p_region, int p_connection_id) const;
 	virtual Vector3 region_get_connection_pathway_end(RID p_region, int p_connection_id) const;
 
+	virtual RID flow_field_create() const;
+	COMMAND_2(flow_field_set_map, RID, p_flow_field, RID, p_map);
+	COMMAND_2(flow_field_set_target, RID, p_flow_field, Vector3, p_target);
+	virtual Vector3 flow_field_get_target(RID p_flow_field) const;
+	COMMAND_2(flow_field_set_layers, RID, p_flow_field, uint32_t, p_layers);
+	virtual uint32_t flow_field_get_layers(RID p_flow_field) const;
+	COMMAND_2(flow_field_set_cell_size, RID, p_flow_field, real_t, p_cell_size);
+	virtual real_t flow_field_get_cell_size(RID p_flow_field) const;
+	virtual Vector3 flow_field_get_next_location(RID p_flow_field, Vector3 p_position, real_t p_desired_distance = 0.0) const;
+	virtual real_t flow_field_get_distance(RID p_flow_field, Vector3 p_position) const;
+
 	virtual RID agent_create() const;
 	COMMAND_2(agent_set_map, RID, p_agent, RID, p_map);
 	COMMAND_2(agent_set_neighbor_dist, RID, p_agent, real_t, p_dist);
@@ -140,6 +187,12 @@ public:
 
 	void flush_queries();
 	virtual void process(real_t p_delta_time);
+
+private:
+	void start_path_queries();
+	void finish_path_queries();
+	void start_flow_field_updates();
+	void finish_flow_field_updates();
 };
 
 #undef COMMAND_1
@@ -0,0 +1,429 @@
+/*************************************************************************/
+/*  nav_flow_field.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "nav_flow_field.h"
+
+#include "core/math/face3.h"
+#include "core/math/geometry_3d.h"
+#include "core/math/rect2.h"
+#include "core/templates/pair.h"
+#include "core/templates/sort_array.h"
+#include "nav_map.h"
+#include "nav_region.h"
+
+namespace {
+/// The grid is made coarser when the map is too large for this many cells.
+const int64_t MAX_CELLS = 1 << 22;
+
+struct SortOpenPolygons {
+	_FORCE_INLINE_ bool operator()(const Pair<real_t, uint32_t> &A, const Pair<real_t, uint32_t> &B) const {
+		return A.first > B.first;
+	}
+};
+} // namespace
+
+void NavFlowField::Graph::build(const NavMap *p_map, uint32_t p_layers, real_t p_cell_size) {
+	polygons.clear();
+	vertices.clear();
+	links.clear();
+	cell_offsets.clear();
+	cell_polygons.clear();
+	width = 0;
+	depth = 0;
+
+	const std::vector<NavRegion *> &regions = p_map->get_regions();
+
+	// Index of the polygons in the graph, by their ID in the map.
+	LocalVector<int> polygon_indices;
+	for (size_t r(0); r < regions.size(); r++) {
+		if ((regions[r]->get_layers() & p_layers) == 0) {
+			continue;
+		}
+		const std::vector<gd::Polygon> &region_polygons = regions[r]->get_polygons();
+		for (size_t p(0); p < region_polygons.size(); p++) {
+			const uint32_t id = region_polygons[p].id;
+			while (polygon_indices.size() <= id) {
+				polygon_indices.push_back(-1);
+			}
+			polygon_indices[id] = polygons.size();
+
+			Polygon polygon;
+			polygon.first_vertex = vertices.size();
+			polygon.vertex_count = region_polygons[p].points.size();
+			for (size_t v(0); v < region_polygons[p].points.size(); v++) {
+				vertices.push_back(region_polygons[p].points[v].pos);
+			}
+			polygons.push_back(polygon);
+		}
+	}
+
+	if (polygons.is_empty()) {
+		return;
+	}
+
+	// The links, in the same order as the polygons.
+	uint32_t polygon_index = 0;
+	for (size_t r(0); r < regions.size(); r++) {
+		if ((regions[r]->get_layers() & p_layers) == 0) {
+			continue;
+		}
+		const std::vector<gd::Polygon> &region_polygons = regions[r]->get_polygons();
+		for (size_t p(0); p < region_polygons.size(); p++) {
+			Polygon &polygon = polygons[polygon_index++];
+			polygon.first_link = links.size();
+			for (size_t e(0); e < region_polygons[p].edges.size(); e++) {
+				const gd::Edge &edge = region_polygons[p].edges[e];
+				for (int c = 0; c < edge.connections.size(); c++) {
+					const gd::Edge::Connection &connection = edge.connections[c];
+					// The polygons of the regions out of the layers are not in the graph.
+					if (connection.polygon->id >= polygon_indices.size() || polygon_indices[connection.polygon->id] < 0) {
+						continue;
+					}
+
+					Link link;
+					link.polygon = polygon_indices[connection.polygon->id];
+					link.pathway_start = connection.pathway_start;
+					link.pathway_end = connection.pathway_end;
+					links.push_back(link);
+				}
+			}
+			polygon.link_count = links.size() - polygon.first_link;
+		}
+	}
+
+	// Rasterize the bounds of the polygons in the grid.
+	Vector3 end = vertices[0];
+	origin = vertices[0];
+	for (uint32_t i = 1; i < vertices.size(); i++) {
+		origin.x = MIN(origin.x, vertices[i].x);
+		origin.z = MIN(origin.z, vertices[i].z);
+		end.x = MAX(end.x, vertices[i].x);
+		end.z = MAX(end.z, vertices[i].z);
+	}
+
+	cell_size = p_cell_size;
+	while (true) {
+		width = Math::floor((end.x - origin.x) / cell_size) + 1;
+		depth = Math::floor((end.z - origin.z) / cell_size) + 1;
+		if ((int64_t)width * depth <= MAX_CELLS) {
+			break;
+		}
+		cell_size *= 2;
+	}
+
+	LocalVector<Rect2i> polygon_cells;
+	polygon_cells.resize(polygons.size());
+	cell_offsets.resize(width * depth + 1);
+	for (uint32_t i = 0; i < cell_offsets.size(); i++) {
+		cell_offsets[i] = 0;
+	}
+
+	for (uint32_t i = 0; i < polygons.size(); i++) {
+		const Polygon &polygon = polygons[i];
+		Vector2 from = Vector2(vertices[polygon.first_vertex].x, vertices[polygon.first_vertex].z);
+		Vector2 to = from;
+		for (uint32_t v = 1; v < polygon.vertex_count; v++) {
+			const Vector3 &vertex = vertices[polygon.first_vertex + v];
+			from = Vector2(MIN(from.x, vertex.x), MIN(from.y, vertex.z));
+			to = Vector2(MAX(to.x, vertex.x), MAX(to.y, vertex.z));
+		}
+
+		Rect2i &cells = polygon_cells[i];
+		cells.position = Vector2i(Math::floor((from.x - origin.x) / cell_size), Math::floor((from.y - origin.z) / cell_size));
+		cells.size = Vector2i(Math::floor((to.x - origin.x) / cell_size), Math::floor((to.y - origin.z) / cell_size)) - cells.position + Vector2i(1, 1);
+		for (int z = cells.position.y; z < cells.position.y + cells.size.y; z++) {
+			for (int x = cells.position.x; x < cells.position.x + cells.size.x; x++) {
+				cell_offsets[z * width + x + 1]++;
+			}
+		}
+	}
+
+	for (uint32_t i = 1; i < cell_offsets.size(); i++) {
+		cell_offsets[i] += cell_offsets[i - 1];
+	}
+
+	LocalVector<uint32_t> cell_ends;
+	cell_ends.resize(width * depth);
+	for (uint32_t i = 0; i < cell_ends.size(); i++) {
+		cell_ends[i] = cell_offsets[i];
+	}
+	cell_polygons.resize(cell_offsets[cell_offsets.size() - 1]);
+	for (uint32_t i = 0; i < polygons.size(); i++) {
+		const Rect2i &cells = polygon_cells[i];
+		for (int z = cells.position.y; z < cells.position.y + cells.size.y; z++) {
+			for (int x = cells.position.x; x < cells.position.x + cells.size.x; x++) {
+				cell_polygons[cell_ends[z * width + x]++] = i;
+			}
+		}
+	}
+}
+
+real_t NavFlowField::Graph::get_distance_squared(uint32_t p_polygon, const Vector3 &p_point) const {
+	const Polygon &polygon = polygons[p_polygon];
+	const Vector3 *polygon_vertices = &vertices[polygon.first_vertex];
+
+	real_t closest_distance = INFINITY;
+	for (uint32_t v = 2; v < polygon.vertex_count; v++) {
+		const Face3 face(polygon_vertices[0], polygon_vertices[v - 1], polygon_vertices[v]);
+		closest_distance = MIN(closest_distance, p_point.distance_squared_to(face.get_closest_point_to(p_point)));
+	}
+	return closest_distance;
+}
+
+int NavFlowField::Graph::get_polygon(const Vector3 &p_point) const {
+	if (polygons.is_empty()) {
+		return -1;
+	}
+
+	const int cell_x = CLAMP(int(Math::floor((p_point.x - origin.x) / cell_size)), 0, width - 1);
+	const int cell_z = CLAMP(int(Math::floor((p_point.z - origin.z) / cell_size)), 0, depth - 1);
+
+	// The cell of the point has the polygons under or over it, the
+	// surrounding ones are only searched when it's empty.
+	const int max_ring = MAX(width, depth);
+	for (int ring = 0; ring < max_ring; ring++) {
+		int closest_polygon = -1;
+		real_t closest_distance = INFINITY;
+
+		for (int z = MAX(cell_z - ring, 0); z <= MIN(cell_z + ring, depth - 1); z++) {
+			const bool ring_side = ABS(z - cell_z) == ring;
+			const int x_step = ring_side ? 1 : MAX(2 * ring, 1);
+			for (int x = cell_x - ring; x <= cell_x + ring; x += x_step) {
+				if (x < 0 || x >= width) {
+					continue;
+				}
+
+				const uint32_t cell = z * width + x;
+				for (uint32_t i = cell_offsets[cell]; i < cell_offsets[cell + 1]; i++) {
+					const real_t distance = get_distance_squared(cell_polygons[i], p_point);
+					if (distance < closest_distance) {
+						closest_distance = distance;
+						closest_polygon = cell_polygons[i];
+					}
+				}
+			}
+		}
+
+		if (closest_polygon != -1) {
+			return closest_polygon;
+		}
+	}
+
+	return -1;
+}
+
+void NavFlowField::Flow::build(const Graph &p_graph, const Vector3 &p_target) {
+	const uint32_t polygon_count = p_graph.polygons.size();
+	waypoints.resize(polygon_count);
+	next_polygons.resize(polygon_count);
+	distances.resize(polygon_count);
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		next_polygons[i] = -1;
+		distances[i] = INFINITY;
+	}
+
+	const int target_polygon = p_graph.get_polygon(p_target);
+	if (target_polygon < 0) {
+		return;
+	}
+
+	// Dijkstra from the target, each polygon is entered from the closest point
+	// of the pathway to the waypoint of the polygon it leads to.
+	LocalVector<Pair<real_t, uint32_t>> open_list;
+	SortArray<Pair<real_t, uint32_t>, SortOpenPolygons> sorter;
+
+	waypoints[target_polygon] = p_target;
+	distances[target_polygon] = 0;
+	open_list.push_back(Pair<real_t, uint32_t>(0, target_polygon));
+
+	while (!open_list.is_empty()) {
+		const Pair<real_t, uint32_t> open_polygon = open_list[0];
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.resize(open_list.size() - 1);
+
+		const uint32_t polygon_index = open_polygon.second;
+		if (open_polygon.first > distances[polygon_index]) {
+			continue; // Already reached with a shorter distance.
+		}
+
+		const Graph::Polygon &polygon = p_graph.polygons[polygon_index];
+		const Vector3 &waypoint = waypoints[polygon_index];
+		for (uint32_t i = polygon.first_link; i < polygon.first_link + polygon.link_count; i++) {
+			const Graph::Link &link = p_graph.links[i];
+
+			const Vector3 pathway[2] = { link.pathway_start, link.pathway_end };
+			const Vector3 entry = Geometry3D::get_closest_point_to_segment(waypoint, pathway);
+			const real_t distance = distances[polygon_index] + entry.distance_to(waypoint);
+			if (distance >= distances[link.polygon]) {
+				continue;
+			}
+
+			waypoints[link.polygon] = entry;
+			next_polygons[link.polygon] = polygon_index;
+			distances[link.polygon] = distance;
+			open_list.push_back(Pair<real_t, uint32_t>(distance, link.polygon));
+			sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+		}
+	}
+}
+
+NavFlowField::~NavFlowField() {
+	finish_update();
+	if (graph) {
+		memdelete(graph);
+	}
+	if (flow) {
+		memdelete(flow);
+	}
+}
+
+void NavFlowField::set_map(RID p_map) {
+	map = p_map;
+	graph_dirty = true;
+	flow_dirty = true;
+
+	if (!map.is_valid()) {
+		// Nothing to head to anymore.
+		if (graph) {
+			memdelete(graph);
+			graph = nullptr;
+		}
+		if (flow) {
+			memdelete(flow);
+			flow = nullptr;
+		}
+	}
+}
+
+void NavFlowField::set_target(const Vector3 &p_target) {
+	target = p_target;
+	flow_dirty = true;
+}
+
+void NavFlowField::set_layers(uint32_t p_layers) {
+	layers = p_layers;
+	graph_dirty = true;
+	flow_dirty = true;
+}
+
+void NavFlowField::set_cell_size(real_t p_cell_size) {
+	ERR_FAIL_COND(p_cell_size <= 0);
+	cell_size = p_cell_size;
+	graph_dirty = true;
+	flow_dirty = true;
+}
+
+void NavFlowField::start_update(const NavMap *p_map) {
+	ERR_FAIL_COND(update_task_id != WorkerThreadPool::INVALID_TASK_ID);
+
+	// The graph is kept as long as the map doesn't change, so moving the
+	// target only builds the flow again.
+	if (p_map->get_map_update_id() != map_update_id) {
+		graph_dirty = true;
+		flow_dirty = true;
+	}
+	if (!graph_dirty && !flow_dirty) {
+		return;
+	}
+
+	update_map = p_map;
+	map_update_id = p_map->get_map_update_id();
+	if (graph_dirty || graph == nullptr) {
+		next_graph = memnew(Graph);
+	}
+	next_flow = memnew(Flow);
+	graph_dirty = false;
+	flow_dirty = false;
+
+	update_task_id = WorkerThreadPool::get_singleton()->add_template_task(this, &NavFlowField::update, (void *)nullptr);
+}
+
+void NavFlowField::update(void *p_unused) {
+	if (next_graph) {
+		next_graph->build(update_map, layers, cell_size);
+	}
+	next_flow->build(next_graph ? *next_graph : *graph, target);
+}
+
+void NavFlowField::finish_update() {
+	if (update_task_id == WorkerThreadPool::INVALID_TASK_ID) {
+		return;
+	}
+
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(update_task_id);
+	update_task_id = WorkerThreadPool::INVALID_TASK_ID;
+	update_map = nullptr;
+
+	if (next_graph) {
+		if (graph) {
+			memdelete(graph);
+		}
+		graph = next_graph;
+		next_graph = nullptr;
+	}
+
+	if (flow) {
+		memdelete(flow);
+	}
+	flow = next_flow;
+	next_flow = nullptr;
+}
+
+Vector3 NavFlowField::get_next_location(const Vector3 &p_position, real_t p_desired_distance) const {
+	if (graph == nullptr || flow == nullptr) {
+		return p_position;
+	}
+
+	int polygon = graph->get_polygon(p_position);
+	if (polygon < 0 || flow->distances[polygon] == INFINITY) {
+		return p_position;
+	}
+
+	// Skip the waypoints already reached, the agents would stop on them
+	// instead of moving to the next polygon.
+	while (flow->next_polygons[polygon] != -1 && p_position.distance_to(flow->waypoints[polygon]) <= p_desired_distance) {
+		polygon = flow->next_polygons[polygon];
+	}
+
+	return flow->waypoints[polygon];
+}
+
+real_t NavFlowField::get_distance(const Vector3 &p_position) const {
+	if (graph == nullptr || flow == nullptr) {
+		return INFINITY;
+	}
+
+	const int polygon = graph->get_polygon(p_position);
+	if (polygon < 0) {
+		return INFINITY;
+	}
+
+	return flow->distances[polygon] + p_position.distance_to(flow->waypoints[polygon]);
+}
@@ -0,0 +1,157 @@
+/*************************************************************************/
+/*  nav_flow_field.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef NAV_FLOW_FIELD_H
+#define NAV_FLOW_FIELD_H
+
+#include "core/math/vector3.h"
+#include "core/os/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
+#include "nav_rid.h"
+
+class NavMap;
+
+/// Direction of travel towards a target from anywhere on a map, shared by any
+/// number of agents heading to the same place.
+///
+/// The field is computed on a worker thread from a copy of the polygons of
+/// the map, which are also indexed in a grid over the XZ plane so each
+/// position is looked up without searching the whole map.
+class NavFlowField : public NavRid {
+public:
+	/// The polygons of the map which are in the layers of the field.
+	struct Graph {
+		struct Polygon {
+			uint32_t first_vertex = 0;
+			uint32_t vertex_count = 0;
+			uint32_t first_link = 0;
+			uint32_t link_count = 0;
+		};
+
+		/// A connection to another polygon, through the given pathway.
+		struct Link {
+			uint32_t polygon = 0;
+			Vector3 pathway_start;
+			Vector3 pathway_end;
+		};
+
+		LocalVector<Polygon> polygons;
+		LocalVector<Vector3> vertices;
+		LocalVector<Link> links;
+
+		/// Cells of `cell_size` starting at `origin` on the XZ plane, listing
+		/// the polygons that overlap them.
+		Vector3 origin;
+		real_t cell_size = 1.0;
+		int width = 0;
+		int depth = 0;
+		LocalVector<uint32_t> cell_offsets;
+		LocalVector<uint32_t> cell_polygons;
+
+		void build(const NavMap *p_map, uint32_t p_layers, real_t p_cell_size);
+		int get_polygon(const Vector3 &p_point) const;
+
+	private:
+		real_t get_distance_squared(uint32_t p_polygon, const Vector3 &p_point) const;
+	};
+
+	/// The path to the target from each polygon of the graph.
+	struct Flow {
+		/// The point to head to from each polygon: the closest point of the
+		/// pathway to the next polygon, or the target in the last one.
+		LocalVector<Vector3> waypoints;
+		/// The next polygon, -1 for the one of the target or when unreachable.
+		LocalVector<int> next_polygons;
+		/// The distance from the waypoint to the target, INFINITY when unreachable.
+		LocalVector<real_t> distances;
+
+		void build(const Graph &p_graph, const Vector3 &p_target);
+	};
+
+private:
+	RID map;
+	Vector3 target;
+	uint32_t layers = 1;
+	real_t cell_size = 1.0;
+
+	/// Set when the flow, or also the graph, must be built again.
+	bool flow_dirty = true;
+	bool graph_dirty = true;
+	/// The map update ID the graph was built for.
+	uint32_t map_update_id = 0;
+
+	Graph *graph = nullptr;
+	Flow *flow = nullptr;
+
+	/// Built while the map is left untouched, then swapped with the current
+	/// ones, so the field can be sampled in the meantime.
+	const NavMap *update_map = nullptr;
+	Graph *next_graph = nullptr;
+	Flow *next_flow = nullptr;
+	WorkerThreadPool::TaskID update_task_id = WorkerThreadPool::INVALID_TASK_ID;
+
+public:
+	NavFlowField() {}
+	~NavFlowField();
+
+	void set_map(RID p_map);
+	RID get_map() const {
+		return map;
+	}
+
+	void set_target(const Vector3 &p_target);
+	Vector3 get_target() const {
+		return target;
+	}
+
+	void set_layers(uint32_t p_layers);
+	uint32_t get_layers() const {
+		return layers;
+	}
+
+	void set_cell_size(real_t p_cell_size);
+	real_t get_cell_size() const {
+		return cell_size;
+	}
+
+	/// Starts building the field on a worker thread if the target, the
+	/// settings or the map changed since the last time.
+	void start_update(const NavMap *p_map);
+	/// Waits for the update, if any, and makes its result the current field.
+	void finish_update();
+
+	Vector3 get_next_location(const Vector3 &p_position, real_t p_desired_distance) const;
+	real_t get_distance(const Vector3 &p_position) const;
+
+private:
+	void update(void *p_unused);
+};
+
+#endif // NAV_FLOW_FIELD_H
@@ -30,7 +30,7 @@
 
 #include "nav_map.h"
 
-#include "core/os/threaded_array_processor.h"
+#include "core/os/worker_thread_pool.h"
 #include "nav_region.h"
 #include "rvo_agent.h"
 
@@ -42,6 +42,9 @@
 
 #define THREE_POINTS_CROSS_PRODUCT(m_a, m_b, m_c) (((m_c) - (m_a)).cross((m_b) - (m_a)))
 
+// Free edges overlapping more grid cells than this are kept out of the grid.
+#define FREE_EDGE_MAX_CELLS 256
+
 void NavMap::set_up(Vector3 p_up) {
 	up = p_up;
 	regenerate_polygons = true;
@@ -70,48 +73,202 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 	return p;
 }
 
-Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers) const {
-	// Find the start poly and the end poly on this map.
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
-	Vector3 begin_point;
-	Vector3 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
+namespace {
+
+// Scratch buffers of the path queries, kept per thread so consecutive queries
+// reuse their allocations and concurrent ones don't share any state.
+struct PathSearchArena {
+	/// List of all reachable navigation polys.
+	std::vector<gd::NavigationPoly> navigation_polys;
+	/// Binary heap of the navigation polys to visit, sorted by total cost.
+	LocalVector<uint32_t> open_list;
+	/// Index in `navigation_polys` of each map polygon, -1 when not reached.
+	LocalVector<int> polygon_ids;
+
+	void begin(uint32_t p_polygon_count) {
+		navigation_polys.clear();
+		open_list.clear();
+
+		// Entries are reset by `release_polygon_ids()`, only initialize the new ones.
+		const uint32_t old_count = polygon_ids.size();
+		if (old_count < p_polygon_count) {
+			polygon_ids.resize(p_polygon_count);
+			for (uint32_t i = old_count; i < p_polygon_count; i++) {
+				polygon_ids[i] = -1;
+			}
+		}
+	}
+
+	void release_polygon_ids(uint32_t p_from) {
+		for (uint32_t i = p_from; i < navigation_polys.size(); i++) {
+			polygon_ids[navigation_polys[i].poly->id] = -1;
+		}
+	}
 
-		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_layers & p.owner->get_layers()) == 0) {
+	void open_list_push(uint32_t p_id) {
+		navigation_polys[p_id].open_list_index = open_list.size();
+		open_list.push_back(p_id);
+		open_list_sift_up(open_list.size() - 1);
+	}
+
+	uint32_t open_list_pop() {
+		const uint32_t id = open_list[0];
+		const uint32_t last = open_list[open_list.size() - 1];
+		open_list.resize(open_list.size() - 1);
+		if (open_list.size() > 0) {
+			open_list[0] = last;
+			navigation_polys[last].open_list_index = 0;
+			open_list_sift_down(0);
+		}
+		navigation_polys[id].open_list_index = UINT32_MAX;
+		return id;
+	}
+
+	void open_list_sift_up(uint32_t p_index) {
+		const uint32_t id = open_list[p_index];
+		const float cost = navigation_polys[id].total_cost;
+		while (p_index > 0) {
+			const uint32_t parent = (p_index - 1) / 2;
+			if (navigation_polys[open_list[parent]].total_cost <= cost) {
+				break;
+			}
+			open_list[p_index] = open_list[parent];
+			navigation_polys[open_list[p_index]].open_list_index = p_index;
+			p_index = parent;
+		}
+		open_list[p_index] = id;
+		navigation_polys[id].open_list_index = p_index;
+	}
+
+	void open_list_sift_down(uint32_t p_index) {
+		const uint32_t id = open_list[p_index];
+		const float cost = navigation_polys[id].total_cost;
+		const uint32_t size = open_list.size();
+		while (true) {
+			uint32_t child = p_index * 2 + 1;
+			if (child >= size) {
+				break;
+			}
+			if (child + 1 < size && navigation_polys[open_list[child + 1]].total_cost < navigation_polys[open_list[child]].total_cost) {
+				child++;
+			}
+			if (cost <= navigation_polys[open_list[child]].total_cost) {
+				break;
+			}
+			open_list[p_index] = open_list[child];
+			navigation_polys[open_list[p_index]].open_list_index = p_index;
+			p_index = child;
+		}
+		open_list[p_index] = id;
+		navigation_polys[id].open_list_index = p_index;
+	}
+};
+
+thread_local PathSearchArena path_search_arena;
+
+} // namespace
+
+// Returns the point of a convex polygon closest to `p_point`, testing each
+// triangle of the fan around its first vertex.
+static real_t get_closest_point_on_polygon(const gd::Polygon &p_polygon, const Vector3 &p_point, Vector3 &r_point, Vector3 *r_normal) {
+	real_t closest_d = 1e20;
+	for (size_t point_id = 2; point_id < p_polygon.points.size(); point_id++) {
+		const Face3 face(p_polygon.points[0].pos, p_polygon.points[point_id - 1].pos, p_polygon.points[point_id].pos);
+		const Vector3 point = face.get_closest_point_to(p_point);
+		const real_t d = point.distance_squared_to(p_point);
+		if (d < closest_d) {
+			closest_d = d;
+			r_point = point;
+			if (r_normal) {
+				*r_normal = face.get_plane().normal;
+			}
+		}
+	}
+	return closest_d;
+}
+
+static real_t get_aabb_distance_squared(const AABB &p_aabb, const Vector3 &p_point) {
+	const Vector3 end = p_aabb.get_end();
+	real_t d = 0.0;
+	for (int i = 0; i < 3; i++) {
+		if (p_point[i] < p_aabb.position[i]) {
+			d += (p_aabb.position[i] - p_point[i]) * (p_aabb.position[i] - p_point[i]);
+		} else if (p_point[i] > end[i]) {
+			d += (p_point[i] - end[i]) * (p_point[i] - end[i]);
+		}
+	}
+	return d;
+}
+
+const gd::Polygon *NavMap::get_closest_polygon(const Vector3 &p_point, bool p_use_layers, uint32_t p_layers, Vector3 &r_point, Vector3 *r_normal) const {
+	const gd::Polygon *closest_polygon = nullptr;
+	real_t closest_d = 1e20;
+
+	for (size_t r(0); r < regions.size(); r++) {
+		const NavRegion *region = regions[r];
+		const LocalVector<gd::PolygonBVHNode> &bvh_nodes = region->get_bvh_nodes();
+		const LocalVector<uint32_t> &bvh_polygons = region->get_bvh_polygons();
+		const std::vector<gd::Polygon> &polygons = region->get_polygons();
+
+		// Only consider the polygons if they are in a region with compatible layers.
+		if (bvh_nodes.is_empty() || (p_use_layers && (p_layers & region->get_layers()) == 0)) {
 			continue;
 		}
 
-		// For each point cast a face and check the distance between the origin/destination
-		for (size_t point_id = 0; point_id < p.points.size(); point_id++) {
-			const Vector3 p1 = p.points[point_id].pos;
-			const Vector3 p2 = p.points[(point_id + 1) % p.points.size()].pos;
-			const Vector3 p3 = p.points[(point_id + 2) % p.points.size()].pos;
-			const Face3 face(p1, p2, p3);
+		// Depth first traversal, skipping the nodes that can't contain anything
+		// closer than the best polygon found so far.
+		uint32_t stack[64];
+		uint32_t stack_size = 0;
+		stack[stack_size++] = 0;
 
-			Vector3 point = face.get_closest_point_to(p_origin);
-			float distance_to_point = point.distance_to(p_origin);
-			if (distance_to_point < begin_d) {
-				begin_d = distance_to_point;
-				begin_poly = &p;
-				begin_point = point;
+		while (stack_size > 0) {
+			const gd::PolygonBVHNode &node = bvh_nodes[stack[--stack_size]];
+			if (get_aabb_distance_squared(node.aabb, p_point) >= closest_d) {
+				continue;
 			}
 
-			point = face.get_closest_point_to(p_destination);
-			distance_to_point = point.distance_to(p_destination);
-			if (distance_to_point < end_d) {
-				end_d = distance_to_point;
-				end_poly = &p;
-				end_point = point;
+			if (node.count > 0) {
+				for (uint32_t i = node.first; i < node.first + node.count; i++) {
+					const gd::Polygon &p = polygons[bvh_polygons[i]];
+
+					Vector3 point;
+					Vector3 normal;
+					const real_t d = get_closest_point_on_polygon(p, p_point, point, r_normal ? &normal : nullptr);
+					if (d < closest_d) {
+						closest_d = d;
+						closest_polygon = &p;
+						r_point = point;
+						if (r_normal) {
+							*r_normal = normal;
+						}
+					}
+				}
+			} else {
+				ERR_FAIL_COND_V(stack_size + 2 > 64, closest_polygon);
+				// Push the farthest child first so the nearest one is visited first.
+				const real_t d1 = get_aabb_distance_squared(bvh_nodes[node.first].aabb, p_point);
+				const real_t d2 = get_aabb_distance_squared(bvh_nodes[node.first + 1].aabb, p_point);
+				if (d1 < d2) {
+					stack[stack_size++] = node.first + 1;
+					stack[stack_size++] = node.first;
+				} else {
+					stack[stack_size++] = node.first;
+					stack[stack_size++] = node.first + 1;
+				}
 			}
 		}
 	}
 
+	return closest_polygon;
+}
+
+Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers) const {
+	// Find the start poly and the end poly on this map.
+	Vector3 begin_point;
+	Vector3 end_point;
+	const gd::Polygon *begin_poly = get_closest_polygon(p_origin, true, p_layers, begin_point);
+	const gd::Polygon *end_poly = get_closest_polygon(p_destination, true, p_layers, end_point);
+
 	// Check for trivial cases
 	if (!begin_poly || !end_poly) {
 		return Vector<Vector3>();
@@ -124,9 +281,12 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
+	PathSearchArena &arena = path_search_arena;
+	arena.begin(polygon_id_count);
+
 	// List of all reachable navigation polys.
-	std::vector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
+	std::vector<gd::NavigationPoly> &navigation_polys = arena.navigation_polys;
+	navigation_polys.reserve(polygon_id_count * 0.75);
 
 	// Add the start polygon to the reachable navigation polygons.
 	gd::NavigationPoly begin_navigation_poly = gd::NavigationPoly(begin_poly);
@@ -135,10 +295,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
 	navigation_polys.push_back(begin_navigation_poly);
-
-	// List of polygon IDs to visit.
-	List<uint32_t> to_visit;
-	to_visit.push_back(0);
+	arena.polygon_ids[begin_poly->id] = 0;
 
 	// This is an implementation of the A* algorithm.
 	int least_cost_id = 0;
@@ -149,11 +306,9 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	bool is_reachable = true;
 
 	while (true) {
-		gd::NavigationPoly *least_cost_poly = &navigation_polys[least_cost_id];
-
 		// Takes the current least_cost_poly neighbors (iterating over its edges) and compute the traveled_distance.
-		for (size_t i = 0; i < least_cost_poly->poly->edges.size(); i++) {
-			const gd::Edge &edge = least_cost_poly->poly->edges[i];
+		for (size_t i = 0; i < navigation_polys[least_cost_id].poly->edges.size(); i++) {
+			const gd::Edge &edge = navigation_polys[least_cost_id].poly->edges[i];
 
 			// Iterate over connections in this edge, then compute the new optimized travel distance assigned to this polygon.
 			for (int connection_index = 0; connection_index < edge.connections.size(); connection_index++) {
@@ -164,24 +319,30 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					continue;
 				}
 
+				// Pushing to `navigation_polys` may reallocate it, don't keep pointers across iterations.
+				const gd::NavigationPoly &least_cost_poly = navigation_polys[least_cost_id];
 				Vector3 pathway[2] = { connection.pathway_start, connection.pathway_end };
-				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly->entry, pathway);
-				const float new_distance = least_cost_poly->entry.distance_to(new_entry) + least_cost_poly->traveled_distance;
+				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly.entry, pathway);
+				const float new_distance = least_cost_poly.entry.distance_to(new_entry) + least_cost_poly.traveled_distance;
 
-				const std::vector<gd::NavigationPoly>::iterator it = std::find(
-						navigation_polys.begin(),
-						navigation_polys.end(),
-						gd::NavigationPoly(connection.polygon));
+				int &navigation_poly_id = arena.polygon_ids[connection.polygon->id];
 
-				if (it != navigation_polys.end()) {
+				if (navigation_poly_id != -1) {
 					// Polygon already visited, check if we can reduce the travel cost.
-					if (new_distance < it->traveled_distance) {
-						it->back_navigation_poly_id = least_cost_id;
-						it->back_navigation_edge = connection.edge;
-						it->back_navigation_edge_pathway_start = connection.pathway_start;
-						it->back_navigation_edge_pathway_end = connection.pathway_end;
-						it->traveled_distance = new_distance;
-						it->entry = new_entry;
+					gd::NavigationPoly &navigation_poly = navigation_polys[navigation_poly_id];
+					if (new_distance < navigation_poly.traveled_distance) {
+						navigation_poly.back_navigation_poly_id = least_cost_id;
+						navigation_poly.back_navigation_edge = connection.edge;
+						navigation_poly.back_navigation_edge_pathway_start = connection.pathway_start;
+						navigation_poly.back_navigation_edge_pathway_end = connection.pathway_end;
+						navigation_poly.traveled_distance = new_distance;
+						navigation_poly.entry = new_entry;
+						navigation_poly.total_cost = new_distance + new_entry.distance_to(end_point);
+
+						// The cost can only decrease, move it up in the list of polygons to visit.
+						if (navigation_poly.open_list_index != UINT32_MAX) {
+							arena.open_list_sift_up(navigation_poly.open_list_index);
+						}
 					}
 				} else {
 					// Add the neighbour polygon to the reachable ones.
@@ -193,19 +354,18 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					new_navigation_poly.back_navigation_edge_pathway_end = connection.pathway_end;
 					new_navigation_poly.traveled_distance = new_distance;
 					new_navigation_poly.entry = new_entry;
+					new_navigation_poly.total_cost = new_distance + new_entry.distance_to(end_point);
+					navigation_poly_id = new_navigation_poly.self_id;
 					navigation_polys.push_back(new_navigation_poly);
 
 					// Add the neighbour polygon to the polygons to visit.
-					to_visit.push_back(navigation_polys.size() - 1);
+					arena.open_list_push(navigation_poly_id);
 				}
 			}
 		}
 
-		// Removes the least cost polygon from the list of polygons to visit so we can advance.
-		to_visit.erase(least_cost_id);
-
 		// When the list of polygons to visit is empty at this point it means the End Polygon is not reachable
-		if (to_visit.size() == 0) {
+		if (arena.open_list.is_empty()) {
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -216,41 +376,20 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 			// Set as end point the furthest reachable point.
 			end_poly = reachable_end;
-			end_d = 1e20;
-			for (size_t point_id = 2; point_id < end_poly->points.size(); point_id++) {
-				Face3 f(end_poly->points[point_id - 2].pos, end_poly->points[point_id - 1].pos, end_poly->points[point_id].pos);
-				Vector3 spoint = f.get_closest_point_to(p_destination);
-				float dpoint = spoint.distance_to(p_destination);
-				if (dpoint < end_d) {
-					end_point = spoint;
-					end_d = dpoint;
-				}
-			}
+			get_closest_point_on_polygon(*end_poly, p_destination, end_point, nullptr);
 
 			// Reset open and navigation_polys
-			gd::NavigationPoly np = navigation_polys[0];
-			navigation_polys.clear();
-			navigation_polys.push_back(np);
-			to_visit.clear();
-			to_visit.push_back(0);
+			arena.release_polygon_ids(1);
+			navigation_polys.erase(navigation_polys.begin() + 1, navigation_polys.end());
+			least_cost_id = 0;
 
 			reachable_end = nullptr;
 
 			continue;
 		}
 
-		// Find the polygon with the minimum cost from the list of polygons to visit.
-		least_cost_id = -1;
-		float least_cost = 1e30;
-		for (List<uint32_t>::Element *element = to_visit.front(); element != nullptr; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
-			float cost = np->traveled_distance;
-			cost += np->entry.distance_to(end_point);
-			if (cost < least_cost) {
-				least_cost_id = np->self_id;
-				least_cost = cost;
-			}
-		}
+		// Take the polygon with the minimum cost from the list of polygons to visit.
+		least_cost_id = arena.open_list_pop();
 
 		// Stores the further reachable end polygon, in case our goal is not reachable.
 		if (is_reachable) {
@@ -261,8 +400,6 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			}
 		}
 
-		ERR_BREAK(least_cost_id == -1);
-
 		// Check if we reached the end
 		if (navigation_polys[least_cost_id].poly == end_poly) {
 			found_route = true;
@@ -270,6 +407,9 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		}
 	}
 
+	// Leave the polygon ids clean for the next query, only `navigation_polys` is used from here.
+	arena.release_polygon_ids(0);
+
 	// If we did not find a route, return an empty path.
 	if (!found_route) {
 		return Vector<Vector3>();
@@ -375,42 +515,45 @@ Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector
 	real_t closest_point_d = 1e20;
 
 	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the segment
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			Vector3 inters;
-			if (f.intersects_segment(p_from, p_to, &inters)) {
-				const real_t d = closest_point_d = p_from.distance_to(inters);
-				if (use_collision == false) {
-					closest_point = inters;
-					use_collision = true;
-					closest_point_d = d;
-				} else if (closest_point_d > d) {
-					closest_point = inters;
-					closest_point_d = d;
+	for (size_t r(0); r < regions.size(); r++) {
+		const std::vector<gd::Polygon> &polygons = regions[r]->get_polygons();
+		for (size_t i(0); i < polygons.size(); i++) {
+			const gd::Polygon &p = polygons[i];
+
+			// For each point cast a face and check the distance to the segment
+			for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
+				const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				Vector3 inters;
+				if (f.intersects_segment(p_from, p_to, &inters)) {
+					const real_t d = closest_point_d = p_from.distance_to(inters);
+					if (use_collision == false) {
+						closest_point = inters;
+						use_collision = true;
+						closest_point_d = d;
+					} else if (closest_point_d > d) {
+						closest_point = inters;
+						closest_point_d = d;
+					}
 				}
 			}
-		}
-
-		if (use_collision == false) {
-			for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
-				Vector3 a, b;
 
-				Geometry3D::get_closest_points_between_segments(
-						p_from,
-						p_to,
-						p.points[point_id].pos,
-						p.points[(point_id + 1) % p.points.size()].pos,
-						a,
-						b);
-
-				const real_t d = a.distance_to(b);
-				if (d < closest_point_d) {
-					closest_point_d = d;
-					closest_point = b;
+			if (use_collision == false) {
+				for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
+					Vector3 a, b;
+
+					Geometry3D::get_closest_points_between_segments(
+							p_from,
+							p_to,
+							p.points[point_id].pos,
+							p.points[(point_id + 1) % p.points.size()].pos,
+							a,
+							b);
+
+					const real_t d = a.distance_to(b);
+					if (d < closest_point_d) {
+						closest_point_d = d;
+						closest_point = b;
+					}
 				}
 			}
 		}
@@ -420,94 +563,41 @@ Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector
 }
 
 Vector3 NavMap::get_closest_point(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
 	Vector3 closest_point;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_d = d;
-			}
-		}
-	}
-
+	get_closest_polygon(p_point, false, 0, closest_point);
 	return closest_point;
 }
 
 Vector3 NavMap::get_closest_point_normal(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
 	Vector3 closest_point;
 	Vector3 closest_point_normal;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_normal = f.get_plane().normal;
-				closest_point_d = d;
-			}
-		}
-	}
-
+	get_closest_polygon(p_point, false, 0, closest_point, &closest_point_normal);
 	return closest_point_normal;
 }
 
 RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
 	Vector3 closest_point;
-	RID closest_point_owner;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_owner = p.owner->get_self();
-				closest_point_d = d;
-			}
-		}
+	const gd::Polygon *closest_polygon = get_closest_polygon(p_point, false, 0, closest_point);
+	if (!closest_polygon) {
+		return RID();
 	}
-
-	return closest_point_owner;
+	return closest_polygon->owner->get_self();
 }
 
 void NavMap::add_region(NavRegion *p_region) {
+	// The region polygons are linked on the next sync.
 	regions.push_back(p_region);
-	regenerate_links = true;
 }
 
 void NavMap::remove_region(NavRegion *p_region) {
 	const std::vector<NavRegion *>::iterator it = std::find(regions.begin(), regions.end(), p_region);
 	if (it != regions.end()) {
+		// The region may be freed right after, unlink its polygons now.
+		if (p_region->is_linked()) {
+			unlink_region(p_region);
+		}
 		regions.erase(it);
-		regenerate_links = true;
+		links_changed = true;
 	}
 }
 
@@ -555,161 +645,478 @@ void NavMap::sync() {
 		regenerate_links = true;
 	}
 
+	if (regenerate_links) {
+		reset_links();
+	}
+
+	// Unlink the regions that changed while their polygons are still valid,
+	// then update them.
+	LocalVector<NavRegion *> changed_regions;
 	for (size_t r(0); r < regions.size(); r++) {
-		if (regions[r]->sync()) {
-			regenerate_links = true;
+		NavRegion *region = regions[r];
+		if (!region->is_linked() || region->are_polygons_dirty()) {
+			if (region->is_linked()) {
+				unlink_region(region);
+			}
+			region->sync();
+			changed_regions.push_back(region);
 		}
 	}
 
-	if (regenerate_links) {
-		// Remove regions connections.
-		for (size_t r(0); r < regions.size(); r++) {
-			regions[r]->get_connections().clear();
-		}
+	if (changed_regions.size() > 0 || links_changed) {
+		link_regions(changed_regions);
 
-		// Resize the polygon count.
-		int count = 0;
-		for (size_t r(0); r < regions.size(); r++) {
-			count += regions[r]->get_polygons().size();
+		// Update the update ID.
+		map_update_id = (map_update_id + 1) % 9999999;
+	}
+
+	// Update agents tree.
+	if (agents_dirty) {
+		std::vector<RVO::Agent *> raw_agents;
+		raw_agents.reserve(agents.size());
+		for (size_t i(0); i < agents.size(); i++) {
+			raw_agents.push_back(agents[i]->get_agent());
 		}
-		polygons.resize(count);
+		rvo.buildAgentTree(raw_agents);
+	}
 
-		// Copy all region polygons in the map.
-		count = 0;
-		for (size_t r(0); r < regions.size(); r++) {
-			std::copy(
-					regions[r]->get_polygons().data(),
-					regions[r]->get_polygons().data() + regions[r]->get_polygons().size(),
-					polygons.begin() + count);
-			count += regions[r]->get_polygons().size();
+	regenerate_polygons = false;
+	regenerate_links = false;
+	links_changed = false;
+	agents_dirty = false;
+}
+
+void NavMap::reset_links() {
+	edge_connections.clear();
+	new_free_edges.clear();
+	free_edge_cell_size = MAX(edge_connection_margin, cell_size);
+	free_edge_cells.clear();
+	long_free_edges.clear();
+	polygon_id_count = 0;
+	free_polygon_ids.clear();
+
+	for (size_t r(0); r < regions.size(); r++) {
+		std::vector<gd::Polygon> &polygons = regions[r]->get_polygons();
+		for (size_t poly_id(0); poly_id < polygons.size(); poly_id++) {
+			for (size_t e(0); e < polygons[poly_id].edges.size(); e++) {
+				polygons[poly_id].edges[e].connections.clear();
+			}
 		}
+		regions[r]->get_free_edges().clear();
+		regions[r]->get_connections().clear();
+		regions[r]->set_linked(false);
+	}
+}
 
-		// Group all edges per key.
-		Map<gd::EdgeKey, Vector<gd::Edge::Connection>> connections;
+void NavMap::link_regions(const LocalVector<NavRegion *> &p_regions) {
+	// Group the edges of the new polygons with the linked ones.
+	for (uint32_t r = 0; r < p_regions.size(); r++) {
+		std::vector<gd::Polygon> &polygons = p_regions[r]->get_polygons();
 		for (size_t poly_id(0); poly_id < polygons.size(); poly_id++) {
 			gd::Polygon &poly(polygons[poly_id]);
 
+			if (free_polygon_ids.size() > 0) {
+				poly.id = free_polygon_ids[free_polygon_ids.size() - 1];
+				free_polygon_ids.resize(free_polygon_ids.size() - 1);
+			} else {
+				poly.id = polygon_id_count++;
+			}
+
 			for (size_t p(0); p < poly.points.size(); p++) {
 				int next_point = (p + 1) % poly.points.size();
 				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
 
-				Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *connection = connections.find(ek);
+				Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *connection = edge_connections.find(ek);
 				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
+					connection = edge_connections.insert(ek, Vector<gd::Edge::Connection>());
 				}
-				if (connections[ek].size() <= 1) {
+				if (connection->get().size() <= 1) {
 					// Add the polygon/edge tuple to this key.
 					gd::Edge::Connection new_connection;
 					new_connection.polygon = &poly;
 					new_connection.edge = p;
 					new_connection.pathway_start = poly.points[p].pos;
 					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
+
+					if (connection->get().size() == 1) {
+						// Connect edge that are shared in different polygons.
+						const gd::Edge::Connection other = connection->get()[0];
+						if (other.polygon->owner->is_linked()) {
+							// The edge of an already linked region was free until now.
+							remove_free_edge(other);
+						}
+						poly.edges[p].connections.push_back(other);
+						other.polygon->edges[other.edge].connections.push_back(new_connection);
+						// Note: The pathway_start/end are full for those connection and do not need to be modified.
+					}
+					connection->get().push_back(new_connection);
 				} else {
 					// The edge is already connected with another edge, skip.
 					ERR_PRINT("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the current `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problem.");
 				}
 			}
 		}
+	}
 
-		Vector<gd::Edge::Connection> free_edges;
-		for (Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *E = connections.front(); E; E = E->next()) {
-			if (E->get().size() == 2) {
-				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E->get().write[0];
-				gd::Edge::Connection &c2 = E->get().write[1];
-				c1.polygon->edges[c1.edge].connections.push_back(c2);
-				c2.polygon->edges[c2.edge].connections.push_back(c1);
-				// Note: The pathway_start/end are full for those connection and do not need to be modified.
-			} else {
-				CRASH_COND_MSG(E->get().size() != 1, vformat("Number of connection != 1. Found: %d", E->get().size()));
-				free_edges.push_back(E->get()[0]);
-			}
-		}
-
-		// Find the compatible near edges.
-		//
-		// Note:
-		// Considering that the edges must be compatible (for obvious reasons)
-		// to be connected, create new polygons to remove that small gap is
-		// not really useful and would result in wasteful computation during
-		// connection, integration and path finding.
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
-
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
+	// The edges of the new polygons that are not shared are free.
+	for (uint32_t r = 0; r < p_regions.size(); r++) {
+		std::vector<gd::Polygon> &polygons = p_regions[r]->get_polygons();
+		for (size_t poly_id(0); poly_id < polygons.size(); poly_id++) {
+			gd::Polygon &poly(polygons[poly_id]);
+			for (size_t p(0); p < poly.points.size(); p++) {
+				int next_point = (p + 1) % poly.points.size();
+				const Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *connection = edge_connections.find(gd::EdgeKey(poly.points[p].key, poly.points[next_point].key));
+				if (connection && connection->get().size() == 1 && connection->get()[0].polygon == &poly) {
+					new_free_edges.push_back(connection->get()[0]);
 				}
+			}
+		}
+		p_regions[r]->set_linked(true);
+	}
 
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
+	// Find the compatible near edges.
+	//
+	// Note:
+	// Considering that the edges must be compatible (for obvious reasons)
+	// to be connected, create new polygons to remove that small gap is
+	// not really useful and would result in wasteful computation during
+	// connection, integration and path finding.
+	//
+	// Only the pairs that involve a new free edge are tested, against the
+	// free edges already added to the grid cells around it. Each new edge is
+	// added once tested, so the pairs of new edges are tested once too.
+	LocalVector<gd::Edge::Connection> close_edges;
+	for (uint32_t i = 0; i < new_free_edges.size(); i++) {
+		const gd::Edge::Connection &free_edge = new_free_edges[i];
+
+		get_close_free_edges(free_edge, close_edges);
+		for (uint32_t j = 0; j < close_edges.size(); j++) {
+			if (close_edges[j].polygon->owner == free_edge.polygon->owner) {
+				continue;
+			}
+			connect_close_edges(free_edge, close_edges[j]);
+			connect_close_edges(close_edges[j], free_edge);
+		}
 
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				float projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				float projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-					continue;
-				}
+		add_free_edge(free_edge);
+	}
+	new_free_edges.clear();
+}
 
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+void NavMap::unlink_region(NavRegion *p_region) {
+	std::vector<gd::Polygon> &polygons = p_region->get_polygons();
+	for (size_t poly_id(0); poly_id < polygons.size(); poly_id++) {
+		gd::Polygon &poly(polygons[poly_id]);
+
+		for (size_t p(0); p < poly.points.size(); p++) {
+			int next_point = (p + 1) % poly.points.size();
+			gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+
+			Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *connection = edge_connections.find(ek);
+			if (!connection) {
+				continue;
+			}
+
+			Vector<gd::Edge::Connection> &edge_polygons = connection->get();
+			for (int i = edge_polygons.size() - 1; i >= 0; i--) {
+				if (edge_polygons[i].polygon == &poly) {
+					edge_polygons.remove(i);
 				}
-				if ((self1 - other1).length() > edge_connection_margin) {
-					continue;
+			}
+
+			if (edge_polygons.is_empty()) {
+				edge_connections.erase(connection);
+			} else if (edge_polygons.size() == 1 && edge_polygons[0].polygon->owner != p_region) {
+				// The polygon of the other region that shared this edge now has
+				// a free edge, it's connected to the close edges on the next sync.
+				const gd::Edge::Connection &other = edge_polygons[0];
+				other.polygon->edges[other.edge].connections.clear();
+				new_free_edges.push_back(other);
+			}
+
+			poly.edges[p].connections.clear();
+		}
+
+		free_polygon_ids.push_back(poly.id);
+	}
+
+	// Remove the connections from the free edges of the other regions, only
+	// the ones close to the free edges of this region can have some.
+	LocalVector<gd::Edge::Connection> &free_edges = p_region->get_free_edges();
+	for (uint32_t i = 0; i < free_edges.size(); i++) {
+		remove_free_edge_from_cells(free_edges[i]);
+	}
+
+	LocalVector<NavRegion *> changed_regions;
+	LocalVector<gd::Edge::Connection> close_edges;
+	for (uint32_t i = 0; i < free_edges.size(); i++) {
+		get_close_free_edges(free_edges[i], close_edges);
+		for (uint32_t j = 0; j < close_edges.size(); j++) {
+			NavRegion *region = close_edges[j].polygon->owner;
+			if (region == p_region) {
+				continue;
+			}
+
+			Vector<gd::Edge::Connection> &connections = close_edges[j].polygon->edges[close_edges[j].edge].connections;
+			for (int k = connections.size() - 1; k >= 0; k--) {
+				if (connections[k].polygon->owner == p_region) {
+					connections.remove(k);
+					if (changed_regions.find(region) == -1) {
+						changed_regions.push_back(region);
+					}
 				}
+			}
+		}
+	}
+	for (uint32_t i = 0; i < changed_regions.size(); i++) {
+		update_region_connections(changed_regions[i]);
+	}
 
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	for (uint32_t i = new_free_edges.size(); i > 0; i--) {
+		if (new_free_edges[i - 1].polygon->owner == p_region) {
+			new_free_edges.remove_unordered(i - 1);
+		}
+	}
+
+	p_region->get_free_edges().clear();
+	p_region->get_connections().clear();
+	p_region->set_linked(false);
+}
+
+void NavMap::remove_free_edge(const gd::Edge::Connection &p_edge) {
+	NavRegion *region = p_edge.polygon->owner;
+
+	LocalVector<gd::Edge::Connection> &free_edges = region->get_free_edges();
+	for (uint32_t i = 0; i < free_edges.size(); i++) {
+		if (free_edges[i].polygon == p_edge.polygon && free_edges[i].edge == p_edge.edge) {
+			free_edges.remove_unordered(i);
+			remove_free_edge_from_cells(p_edge);
+			break;
+		}
+	}
+	for (uint32_t i = 0; i < new_free_edges.size(); i++) {
+		if (new_free_edges[i].polygon == p_edge.polygon && new_free_edges[i].edge == p_edge.edge) {
+			// Not connected yet.
+			new_free_edges.remove_unordered(i);
+			return;
+		}
+	}
+
+	// Drop the connections to the close edges, in both directions.
+	Vector<gd::Edge::Connection> &connections = p_edge.polygon->edges[p_edge.edge].connections;
+	if (!connections.is_empty()) {
+		connections.clear();
+		update_region_connections(region);
+	}
+
+	LocalVector<NavRegion *> changed_regions;
+	LocalVector<gd::Edge::Connection> close_edges;
+	get_close_free_edges(p_edge, close_edges);
+	for (uint32_t i = 0; i < close_edges.size(); i++) {
+		NavRegion *other_region = close_edges[i].polygon->owner;
+		if (other_region == region) {
+			continue;
+		}
+
+		Vector<gd::Edge::Connection> &other_connections = close_edges[i].polygon->edges[close_edges[i].edge].connections;
+		for (int j = other_connections.size() - 1; j >= 0; j--) {
+			if (other_connections[j].polygon == p_edge.polygon && other_connections[j].edge == p_edge.edge) {
+				other_connections.remove(j);
+				if (changed_regions.find(other_region) == -1) {
+					changed_regions.push_back(other_region);
 				}
-				if ((self2 - other2).length() > edge_connection_margin) {
+			}
+		}
+	}
+	for (uint32_t i = 0; i < changed_regions.size(); i++) {
+		update_region_connections(changed_regions[i]);
+	}
+}
+
+static AABB _get_edge_bounds(const gd::Edge::Connection &p_edge) {
+	AABB bounds(p_edge.polygon->points[p_edge.edge].pos, Vector3());
+	bounds.expand_to(p_edge.polygon->points[(p_edge.edge + 1) % p_edge.polygon->points.size()].pos);
+	return bounds;
+}
+
+static uint64_t _get_cell_key(int p_x, int p_y, int p_z) {
+	gd::PointKey key;
+	key.x = p_x;
+	key.y = p_y;
+	key.z = p_z;
+	return key.key;
+}
+
+bool NavMap::get_free_edge_cell_range(const AABB &p_bounds, Vector3i &r_from, Vector3i &r_to) const {
+	const Vector3 end = p_bounds.position + p_bounds.size;
+	r_from = Vector3i(int(Math::floor(p_bounds.position.x / free_edge_cell_size)), int(Math::floor(p_bounds.position.y / free_edge_cell_size)), int(Math::floor(p_bounds.position.z / free_edge_cell_size)));
+	r_to = Vector3i(int(Math::floor(end.x / free_edge_cell_size)), int(Math::floor(end.y / free_edge_cell_size)), int(Math::floor(end.z / free_edge_cell_size)));
+
+	const Vector3i count = r_to - r_from + Vector3i(1, 1, 1);
+	return int64_t(count.x) * count.y * count.z <= FREE_EDGE_MAX_CELLS;
+}
+
+void NavMap::add_free_edge(const gd::Edge::Connection &p_edge) {
+	p_edge.polygon->owner->get_free_edges().push_back(p_edge);
+
+	Vector3i from;
+	Vector3i to;
+	if (!get_free_edge_cell_range(_get_edge_bounds(p_edge), from, to)) {
+		long_free_edges.push_back(p_edge);
+		return;
+	}
+
+	FreeEdgeCellEntry entry;
+	entry.edge = p_edge;
+	entry.from = from;
+	for (int x = from.x; x <= to.x; x++) {
+		for (int y = from.y; y <= to.y; y++) {
+			for (int z = from.z; z <= to.z; z++) {
+				free_edge_cells[_get_cell_key(x, y, z)].push_back(entry);
+			}
+		}
+	}
+}
+
+void NavMap::remove_free_edge_from_cells(const gd::Edge::Connection &p_edge) {
+	Vector3i from;
+	Vector3i to;
+	if (!get_free_edge_cell_range(_get_edge_bounds(p_edge), from, to)) {
+		for (uint32_t i = 0; i < long_free_edges.size(); i++) {
+			if (long_free_edges[i].polygon == p_edge.polygon && long_free_edges[i].edge == p_edge.edge) {
+				long_free_edges.remove_unordered(i);
+				break;
+			}
+		}
+		return;
+	}
+
+	for (int x = from.x; x <= to.x; x++) {
+		for (int y = from.y; y <= to.y; y++) {
+			for (int z = from.z; z <= to.z; z++) {
+				const uint64_t key = _get_cell_key(x, y, z);
+				LocalVector<FreeEdgeCellEntry> *cell = free_edge_cells.getptr(key);
+				if (!cell) {
 					continue;
 				}
+				for (uint32_t i = 0; i < cell->size(); i++) {
+					if ((*cell)[i].edge.polygon == p_edge.polygon && (*cell)[i].edge.edge == p_edge.edge) {
+						cell->remove_unordered(i);
+						break;
+					}
+				}
+				if (cell->is_empty()) {
+					free_edge_cells.erase(key);
+				}
+			}
+		}
+	}
+}
 
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
+void NavMap::get_close_free_edges(const gd::Edge::Connection &p_edge, LocalVector<gd::Edge::Connection> &r_edges) const {
+	r_edges.clear();
 
-				// Add the connection to the region_connection map.
-				free_edge.polygon->owner->get_connections().push_back(new_connection);
+	Vector3i from;
+	Vector3i to;
+	if (!get_free_edge_cell_range(_get_edge_bounds(p_edge).grow(edge_connection_margin), from, to)) {
+		// Too many cells to look at, take all the free edges.
+		for (size_t r(0); r < regions.size(); r++) {
+			const LocalVector<gd::Edge::Connection> &free_edges = regions[r]->get_free_edges();
+			for (uint32_t i = 0; i < free_edges.size(); i++) {
+				r_edges.push_back(free_edges[i]);
 			}
 		}
+		return;
+	}
 
-		// Update the update ID.
-		map_update_id = (map_update_id + 1) % 9999999;
+	for (uint32_t i = 0; i < long_free_edges.size(); i++) {
+		r_edges.push_back(long_free_edges[i]);
 	}
 
-	// Update agents tree.
-	if (agents_dirty) {
-		std::vector<RVO::Agent *> raw_agents;
-		raw_agents.reserve(agents.size());
-		for (size_t i(0); i < agents.size(); i++) {
-			raw_agents.push_back(agents[i]->get_agent());
+	for (int x = from.x; x <= to.x; x++) {
+		for (int y = from.y; y <= to.y; y++) {
+			for (int z = from.z; z <= to.z; z++) {
+				const LocalVector<FreeEdgeCellEntry> *cell = free_edge_cells.getptr(_get_cell_key(x, y, z));
+				if (!cell) {
+					continue;
+				}
+				for (uint32_t i = 0; i < cell->size(); i++) {
+					// An edge is in all the cells it overlaps, only take it in
+					// the first one it shares with the query.
+					const FreeEdgeCellEntry &entry = (*cell)[i];
+					if (MAX(entry.from.x, from.x) == x && MAX(entry.from.y, from.y) == y && MAX(entry.from.z, from.z) == z) {
+						r_edges.push_back(entry.edge);
+					}
+				}
+			}
 		}
-		rvo.buildAgentTree(raw_agents);
 	}
+}
 
-	regenerate_polygons = false;
-	regenerate_links = false;
-	agents_dirty = false;
+void NavMap::connect_close_edges(const gd::Edge::Connection &p_free_edge, const gd::Edge::Connection &p_other_edge) {
+	Vector3 edge_p1 = p_free_edge.polygon->points[p_free_edge.edge].pos;
+	Vector3 edge_p2 = p_free_edge.polygon->points[(p_free_edge.edge + 1) % p_free_edge.polygon->points.size()].pos;
+
+	Vector3 other_edge_p1 = p_other_edge.polygon->points[p_other_edge.edge].pos;
+	Vector3 other_edge_p2 = p_other_edge.polygon->points[(p_other_edge.edge + 1) % p_other_edge.polygon->points.size()].pos;
+
+	// Compute the projection of the opposite edge on the current one
+	Vector3 edge_vector = edge_p2 - edge_p1;
+	float projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
+	float projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
+	if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+		return;
+	}
+
+	// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+	Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other1;
+	if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+		other1 = other_edge_p1;
+	} else {
+		other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if ((self1 - other1).length() > edge_connection_margin) {
+		return;
+	}
+
+	Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other2;
+	if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+		other2 = other_edge_p2;
+	} else {
+		other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if ((self2 - other2).length() > edge_connection_margin) {
+		return;
+	}
+
+	// The edges can now be connected.
+	gd::Edge::Connection new_connection = p_other_edge;
+	new_connection.pathway_start = (self1 + other1) / 2.0;
+	new_connection.pathway_end = (self2 + other2) / 2.0;
+	p_free_edge.polygon->edges[p_free_edge.edge].connections.push_back(new_connection);
+
+	// Add the connection to the region_connection map.
+	p_free_edge.polygon->owner->get_connections().push_back(new_connection);
+}
+
+void NavMap::update_region_connections(NavRegion *p_region) {
+	// The region connections are the ones of its free edges to the close edges.
+	Vector<gd::Edge::Connection> &region_connections = p_region->get_connections();
+	region_connections.clear();
+
+	const LocalVector<gd::Edge::Connection> &free_edges = p_region->get_free_edges();
+	for (uint32_t i = 0; i < free_edges.size(); i++) {
+		region_connections.append_array(free_edges[i].polygon->edges[free_edges[i].edge].connections);
+	}
 }
 
 void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
+	if (use_batched_avoidance) {
+		rvo_batch.compute_new_velocity((*(agent + index))->get_agent(), deltatime);
+		return;
+	}
 	(*(agent + index))->get_agent()->computeNeighbors(&rvo);
 	(*(agent + index))->get_agent()->computeNewVelocity(deltatime);
 }
@@ -717,7 +1124,12 @@ void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
 void NavMap::step(real_t p_deltatime) {
 	deltatime = p_deltatime;
 	if (controlled_agents.size() > 0) {
-		thread_process_array(
+		if (use_batched_avoidance) {
+			// The agents moved since the last step, unlike the RVO tree the
+			// grid is rebuilt every time.
+			rvo_batch.build(agents);
+		}
+		WorkerThreadPool::get_singleton()->do_work(
 				controlled_agents.size(),
 				this,
 				&NavMap::compute_single_step,
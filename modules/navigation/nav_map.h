@@ -34,8 +34,12 @@
 #include "nav_rid.h"
 
 #include "core/math/math_defs.h"
+#include "core/math/vector3i.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/map.h"
 #include "nav_utils.h"
+#include "rvo_batch.h"
 #include <KdTree.h>
 
 /**
@@ -59,11 +63,37 @@ class NavMap : public NavRid {
 
 	bool regenerate_polygons = true;
 	bool regenerate_links = true;
+	/// Set when a region is removed, to connect the edges it leaves free.
+	bool links_changed = false;
 
 	std::vector<NavRegion *> regions;
 
-	/// Map polygons
-	std::vector<gd::Polygon> polygons;
+	/// The polygons linked to each edge, only the regions that change are
+	/// relinked during the sync.
+	Map<gd::EdgeKey, Vector<gd::Edge::Connection>> edge_connections;
+
+	/// The edges that became free since the last sync, which are not yet
+	/// connected to the close edges of the other regions.
+	LocalVector<gd::Edge::Connection> new_free_edges;
+
+	struct FreeEdgeCellEntry {
+		gd::Edge::Connection edge;
+		/// The first cell of the edge, to report it once per query.
+		Vector3i from;
+	};
+
+	/// The free edges of the linked regions, in the grid cells their bounds
+	/// overlap. The cells are as large as the edge connection margin, so the
+	/// close edges are found in the cells around an edge.
+	real_t free_edge_cell_size = 5.0;
+	HashMap<uint64_t, LocalVector<FreeEdgeCellEntry>> free_edge_cells;
+	/// The free edges overlapping too many cells, returned by every query.
+	LocalVector<gd::Edge::Connection> long_free_edges;
+
+	/// The polygon IDs in use are below this count, the released ones are
+	/// reused first.
+	uint32_t polygon_id_count = 0;
+	LocalVector<uint32_t> free_polygon_ids;
 
 	/// Rvo world
 	RVO::KdTree rvo;
@@ -77,6 +107,10 @@ class NavMap : public NavRid {
 	/// Controlled agents
 	std::vector<RvoAgent *> controlled_agents;
 
+	/// Avoidance through the agent grid instead of the RVO tree.
+	bool use_batched_avoidance = true;
+	RvoBatch rvo_batch;
+
 	/// Physics delta time
 	real_t deltatime = 0.0;
 
@@ -125,6 +159,13 @@ public:
 	void set_agent_as_controlled(RvoAgent *agent);
 	void remove_agent_as_controlled(RvoAgent *agent);
 
+	void set_use_batched_avoidance(bool p_enabled) {
+		use_batched_avoidance = p_enabled;
+	}
+	bool is_using_batched_avoidance() const {
+		return use_batched_avoidance;
+	}
+
 	uint32_t get_map_update_id() const {
 		return map_update_id;
 	}
@@ -134,6 +175,19 @@ public:
 	void dispatch_callbacks();
 
 private:
+	void reset_links();
+	void link_regions(const LocalVector<NavRegion *> &p_regions);
+	void unlink_region(NavRegion *p_region);
+	void remove_free_edge(const gd::Edge::Connection &p_edge);
+	bool get_free_edge_cell_range(const AABB &p_bounds, Vector3i &r_from, Vector3i &r_to) const;
+	void add_free_edge(const gd::Edge::Connection &p_edge);
+	void remove_free_edge_from_cells(const gd::Edge::Connection &p_edge);
+	void get_close_free_edges(const gd::Edge::Connection &p_edge, LocalVector<gd::Edge::Connection> &r_edges) const;
+	void connect_close_edges(const gd::Edge::Connection &p_free_edge, const gd::Edge::Connection &p_other_edge);
+	void update_region_connections(NavRegion *p_region);
+
+	const gd::Polygon *get_closest_polygon(const Vector3 &p_point, bool p_use_layers, uint32_t p_layers, Vector3 &r_point, Vector3 *r_normal = nullptr) const;
+
 	void compute_single_step(uint32_t index, RvoAgent **agent);
 	void clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const;
 };
@@ -32,6 +32,8 @@
 
 #include "nav_map.h"
 
+#include <algorithm>
+
 /**
 	@author AndreaCatania
 */
@@ -94,6 +96,8 @@ void NavRegion::update_polygons() {
 		return;
 	}
 	polygons.clear();
+	bvh_nodes.clear();
+	bvh_polygons.clear();
 	polygons_dirty = false;
 
 	if (map == nullptr) {
@@ -158,4 +162,72 @@ void NavRegion::update_polygons() {
 			p.center = center / float(mesh_poly.size());
 		}
 	}
+
+	build_bvh();
+}
+
+void NavRegion::build_bvh() {
+	bvh_nodes.clear();
+	bvh_polygons.clear();
+	if (polygons.empty()) {
+		return;
+	}
+
+	LocalVector<AABB> polygon_aabbs;
+	LocalVector<Vector3> polygon_centers;
+	polygon_aabbs.resize(polygons.size());
+	polygon_centers.resize(polygons.size());
+	bvh_polygons.resize(polygons.size());
+	for (uint32_t i = 0; i < polygons.size(); i++) {
+		const gd::Polygon &p = polygons[i];
+		AABB aabb;
+		if (p.points.size() > 0) {
+			aabb.position = p.points[0].pos;
+			for (size_t point_id = 1; point_id < p.points.size(); point_id++) {
+				aabb.expand_to(p.points[point_id].pos);
+			}
+		}
+		polygon_aabbs[i] = aabb;
+		polygon_centers[i] = aabb.position + aabb.size * 0.5;
+		bvh_polygons[i] = i;
+	}
+
+	// A binary tree with leaves of at least 2 polygons has less than `polygons.size()` nodes.
+	bvh_nodes.reserve(polygons.size());
+	bvh_nodes.push_back(gd::PolygonBVHNode());
+	build_bvh_node(0, 0, polygons.size(), polygon_aabbs, polygon_centers);
+}
+
+void NavRegion::build_bvh_node(uint32_t p_node, uint32_t p_from, uint32_t p_to, const LocalVector<AABB> &p_polygon_aabbs, const LocalVector<Vector3> &p_polygon_centers) {
+	const uint32_t max_leaf_polygons = 4;
+
+	AABB aabb = p_polygon_aabbs[bvh_polygons[p_from]];
+	AABB centers(p_polygon_centers[bvh_polygons[p_from]], Vector3());
+	for (uint32_t i = p_from + 1; i < p_to; i++) {
+		aabb.merge_with(p_polygon_aabbs[bvh_polygons[i]]);
+		centers.expand_to(p_polygon_centers[bvh_polygons[i]]);
+	}
+	bvh_nodes[p_node].aabb = aabb;
+
+	if (p_to - p_from <= max_leaf_polygons) {
+		bvh_nodes[p_node].first = p_from;
+		bvh_nodes[p_node].count = p_to - p_from;
+		return;
+	}
+
+	// Split at the median polygon along the axis where the centers are the most spread.
+	const int axis = centers.get_longest_axis_index();
+	const uint32_t middle = (p_from + p_to) / 2;
+	std::nth_element(bvh_polygons.ptr() + p_from, bvh_polygons.ptr() + middle, bvh_polygons.ptr() + p_to, [&](uint32_t p_a, uint32_t p_b) {
+		return p_polygon_centers[p_a][axis] < p_polygon_centers[p_b][axis];
+	});
+
+	const uint32_t first_child = bvh_nodes.size();
+	bvh_nodes.push_back(gd::PolygonBVHNode());
+	bvh_nodes.push_back(gd::PolygonBVHNode());
+	bvh_nodes[p_node].first = first_child;
+	bvh_nodes[p_node].count = 0;
+
+	build_bvh_node(first_child, p_from, middle, p_polygon_aabbs, p_polygon_centers);
+	build_bvh_node(first_child + 1, middle, p_to, p_polygon_aabbs, p_polygon_centers);
 }
@@ -33,6 +33,7 @@
 
 #include "scene/resources/navigation_mesh.h"
 
+#include "core/templates/local_vector.h"
 #include "nav_rid.h"
 #include "nav_utils.h"
 #include <vector>
@@ -56,12 +57,26 @@ class NavRegion : public NavRid {
 	/// Cache
 	std::vector<gd::Polygon> polygons;
 
+	/// Bounding volume hierarchy over the polygons, to find the closest one
+	/// to a point without testing all of them.
+	LocalVector<gd::PolygonBVHNode> bvh_nodes;
+	LocalVector<uint32_t> bvh_polygons;
+
+	/// The edges not shared with another polygon of the map, which it may
+	/// connect to the close edges of other regions.
+	LocalVector<gd::Edge::Connection> free_edges;
+	/// True while the polygons are linked to the ones of the map.
+	bool linked = false;
+
 public:
 	NavRegion() {}
 
 	void scratch_polygons() {
 		polygons_dirty = true;
 	}
+	bool are_polygons_dirty() const {
+		return polygons_dirty;
+	}
 
 	void set_map(NavMap *p_map);
 	NavMap *get_map() const {
@@ -91,11 +106,34 @@ public:
 	std::vector<gd::Polygon> const &get_polygons() const {
 		return polygons;
 	}
+	std::vector<gd::Polygon> &get_polygons() {
+		return polygons;
+	}
+
+	const LocalVector<gd::PolygonBVHNode> &get_bvh_nodes() const {
+		return bvh_nodes;
+	}
+	const LocalVector<uint32_t> &get_bvh_polygons() const {
+		return bvh_polygons;
+	}
+
+	LocalVector<gd::Edge::Connection> &get_free_edges() {
+		return free_edges;
+	}
+
+	void set_linked(bool p_linked) {
+		linked = p_linked;
+	}
+	bool is_linked() const {
+		return linked;
+	}
 
 	bool sync();
 
 private:
 	void update_polygons();
+	void build_bvh();
+	void build_bvh_node(uint32_t p_node, uint32_t p_from, uint32_t p_to, const LocalVector<AABB> &p_polygon_aabbs, const LocalVector<Vector3> &p_polygon_centers);
 };
 
 #endif // NAV_REGION_H
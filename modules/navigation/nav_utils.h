@@ -31,6 +31,7 @@
 #ifndef NAV_UTILS_H
 #define NAV_UTILS_H
 
+#include "core/math/aabb.h"
 #include "core/math/vector3.h"
 
 #include <vector>
@@ -94,6 +95,9 @@ struct Edge {
 struct Polygon {
 	NavRegion *owner;
 
+	/// The ID of this `Polygon` in the map it's linked to.
+	uint32_t id = 0;
+
 	/// The points of this `Polygon`
 	std::vector<Point> points;
 
@@ -107,6 +111,16 @@ struct Polygon {
 	Vector3 center;
 };
 
+/// Node of a bounding volume hierarchy over the polygons of a region.
+struct PolygonBVHNode {
+	AABB aabb;
+	/// Index of the first child (the second one follows it), or of the
+	/// first polygon in the polygon list for leaves.
+	uint32_t first = 0;
+	/// Number of polygons in a leaf, zero for internal nodes.
+	uint32_t count = 0;
+};
+
 struct NavigationPoly {
 	uint32_t self_id = 0;
 	/// This poly.
@@ -122,6 +136,10 @@ struct NavigationPoly {
 	Vector3 entry;
 	/// The distance to the destination.
 	float traveled_distance = 0.0;
+	/// The traveled distance plus the estimated distance left, used to sort the open list.
+	float total_cost = 0.0;
+	/// Position in the open list, `UINT32_MAX` when not in it.
+	uint32_t open_list_index = UINT32_MAX;
 
 	NavigationPoly(const Polygon *p_poly) :
 			poly(p_poly) {}
@@ -0,0 +1,436 @@
+/*************************************************************************/
+/*  rvo_batch.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "rvo_batch.h"
+
+#include "core/math/math_funcs.h"
+#include "core/os/worker_thread_pool.h"
+#include "rvo_agent.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace {
+/// Cells per agent at most, the grid is made coarser when the agents are
+/// too spread out for their neighbor distance.
+const float MAX_CELLS_PER_AGENT = 4.0;
+const float MIN_CELLS = 64.0;
+
+_FORCE_INLINE_ bool is_finite(float p_value) {
+	return !Math::is_nan(p_value) && !Math::is_inf(p_value);
+}
+
+// Four lanes of the loops over the neighbors. The operations are the same as
+// in the scalar loops, in the same order, so both give the same results.
+#if defined(__SSE2__)
+#define RVO_BATCH_SIMD
+typedef __m128 Float4;
+typedef __m128 Mask4;
+
+_FORCE_INLINE_ Float4 f4_load(const float *p_src) { return _mm_loadu_ps(p_src); }
+_FORCE_INLINE_ void f4_store(float *r_dst, Float4 p_a) { _mm_storeu_ps(r_dst, p_a); }
+_FORCE_INLINE_ Float4 f4_set(float p_value) { return _mm_set1_ps(p_value); }
+_FORCE_INLINE_ Float4 f4_add(Float4 p_a, Float4 p_b) { return _mm_add_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_sub(Float4 p_a, Float4 p_b) { return _mm_sub_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_mul(Float4 p_a, Float4 p_b) { return _mm_mul_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_div(Float4 p_a, Float4 p_b) { return _mm_div_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_sqrt(Float4 p_a) { return _mm_sqrt_ps(p_a); }
+_FORCE_INLINE_ Mask4 f4_less(Float4 p_a, Float4 p_b) { return _mm_cmplt_ps(p_a, p_b); }
+_FORCE_INLINE_ Mask4 f4_less_equal(Float4 p_a, Float4 p_b) { return _mm_cmple_ps(p_a, p_b); }
+_FORCE_INLINE_ Mask4 f4_and(Mask4 p_a, Mask4 p_b) { return _mm_and_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_select(Mask4 p_mask, Float4 p_a, Float4 p_b) { return _mm_or_ps(_mm_and_ps(p_mask, p_a), _mm_andnot_ps(p_mask, p_b)); }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+// The vector division and square root are only in AArch64.
+#define RVO_BATCH_SIMD
+typedef float32x4_t Float4;
+typedef uint32x4_t Mask4;
+
+_FORCE_INLINE_ Float4 f4_load(const float *p_src) { return vld1q_f32(p_src); }
+_FORCE_INLINE_ void f4_store(float *r_dst, Float4 p_a) { vst1q_f32(r_dst, p_a); }
+_FORCE_INLINE_ Float4 f4_set(float p_value) { return vdupq_n_f32(p_value); }
+_FORCE_INLINE_ Float4 f4_add(Float4 p_a, Float4 p_b) { return vaddq_f32(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_sub(Float4 p_a, Float4 p_b) { return vsubq_f32(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_mul(Float4 p_a, Float4 p_b) { return vmulq_f32(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_div(Float4 p_a, Float4 p_b) { return vdivq_f32(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_sqrt(Float4 p_a) { return vsqrtq_f32(p_a); }
+_FORCE_INLINE_ Mask4 f4_less(Float4 p_a, Float4 p_b) { return vcltq_f32(p_a, p_b); }
+_FORCE_INLINE_ Mask4 f4_less_equal(Float4 p_a, Float4 p_b) { return vcleq_f32(p_a, p_b); }
+_FORCE_INLINE_ Mask4 f4_and(Mask4 p_a, Mask4 p_b) { return vandq_u32(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_select(Mask4 p_mask, Float4 p_a, Float4 p_b) { return vbslq_f32(p_mask, p_a, p_b); }
+#endif
+
+#ifdef RVO_BATCH_SIMD
+// Same as MAX(), which gives the second value when the first one is NaN.
+_FORCE_INLINE_ Float4 f4_max(Float4 p_a, Float4 p_b) { return f4_select(f4_less(p_b, p_a), p_a, p_b); }
+#endif
+} // namespace
+
+void RvoBatch::build(const std::vector<RvoAgent *> &p_agents) {
+	const uint32_t count = p_agents.size();
+
+	agents.resize(count);
+	position_x.resize(count);
+	position_y.resize(count);
+	position_z.resize(count);
+	velocity_x.resize(count);
+	velocity_y.resize(count);
+	velocity_z.resize(count);
+	radius.resize(count);
+	scratches.resize(WorkerThreadPool::get_singleton()->get_thread_count() + 1);
+
+	float min_x = 0.0;
+	float min_z = 0.0;
+	float max_x = 0.0;
+	float max_z = 0.0;
+	float max_neighbor_dist = 0.0;
+	bool first = true;
+	for (uint32_t i = 0; i < count; i++) {
+		const RVO::Agent *agent = p_agents[i]->get_agent();
+		const float x = agent->position_.x();
+		const float z = agent->position_.z();
+		if (!is_finite(x) || !is_finite(z)) {
+			continue;
+		}
+		if (first) {
+			min_x = max_x = x;
+			min_z = max_z = z;
+			first = false;
+		} else {
+			min_x = MIN(min_x, x);
+			min_z = MIN(min_z, z);
+			max_x = MAX(max_x, x);
+			max_z = MAX(max_z, z);
+		}
+		if (agent->maxNeighbors_ > 0) {
+			max_neighbor_dist = MAX(max_neighbor_dist, agent->neighborDist_);
+		}
+	}
+
+	// The neighbors of an agent are then in the 3x3 cells around it.
+	cell_size = max_neighbor_dist > CMP_EPSILON ? max_neighbor_dist : 1.0;
+	const float max_cells = MAX(MIN_CELLS, MAX_CELLS_PER_AGENT * count);
+	while ((Math::floor((max_x - min_x) / cell_size) + 1.0f) * (Math::floor((max_z - min_z) / cell_size) + 1.0f) > max_cells) {
+		cell_size *= 2.0;
+	}
+	origin_x = min_x;
+	origin_z = min_z;
+	width = int(Math::floor((max_x - min_x) / cell_size)) + 1;
+	depth = int(Math::floor((max_z - min_z) / cell_size)) + 1;
+
+	// Counting sort of the agents by cell.
+	LocalVector<uint32_t> cells;
+	cells.resize(count);
+	cell_offsets.resize(width * depth + 1);
+	for (uint32_t c = 0; c < cell_offsets.size(); c++) {
+		cell_offsets[c] = 0;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		const RVO::Agent *agent = p_agents[i]->get_agent();
+		const float x = agent->position_.x();
+		const float z = agent->position_.z();
+		uint32_t cell = 0;
+		if (is_finite(x) && is_finite(z)) {
+			const int cell_x = CLAMP(int((x - origin_x) / cell_size), 0, width - 1);
+			const int cell_z = CLAMP(int((z - origin_z) / cell_size), 0, depth - 1);
+			cell = cell_z * width + cell_x;
+		}
+		cells[i] = cell;
+		cell_offsets[cell + 1]++;
+	}
+	for (uint32_t c = 1; c < cell_offsets.size(); c++) {
+		cell_offsets[c] += cell_offsets[c - 1];
+	}
+
+	LocalVector<uint32_t> next = cell_offsets;
+	for (uint32_t i = 0; i < count; i++) {
+		const RVO::Agent *agent = p_agents[i]->get_agent();
+		const uint32_t index = next[cells[i]]++;
+		agents[index] = agent;
+		position_x[index] = agent->position_.x();
+		position_y[index] = agent->position_.y();
+		position_z[index] = agent->position_.z();
+		velocity_x[index] = agent->velocity_.x();
+		velocity_y[index] = agent->velocity_.y();
+		velocity_z[index] = agent->velocity_.z();
+		radius[index] = agent->radius_;
+	}
+}
+
+void RvoBatch::compute_neighbors(const RVO::Agent *p_agent, Scratch &r_scratch) const {
+	r_scratch.neighbors.clear();
+
+	const float x = p_agent->position_.x();
+	const float y = p_agent->position_.y();
+	const float z = p_agent->position_.z();
+	if (p_agent->maxNeighbors_ == 0 || agents.is_empty() || !is_finite(x) || !is_finite(z)) {
+		return;
+	}
+
+	const float range = p_agent->neighborDist_;
+	float range_sq = range * range;
+
+	const int x_begin = int(CLAMP(Math::floor((x - range - origin_x) / cell_size), 0.0f, float(width - 1)));
+	const int x_end = int(CLAMP(Math::floor((x + range - origin_x) / cell_size), 0.0f, float(width - 1)));
+	const int z_begin = int(CLAMP(Math::floor((z - range - origin_z) / cell_size), 0.0f, float(depth - 1)));
+	const int z_end = int(CLAMP(Math::floor((z + range - origin_z) / cell_size), 0.0f, float(depth - 1)));
+
+	for (int cell_z = z_begin; cell_z <= z_end; cell_z++) {
+		// The cells of a row are next to each other, so are their agents.
+		const uint32_t begin = cell_offsets[cell_z * width + x_begin];
+		const uint32_t end = cell_offsets[cell_z * width + x_end + 1];
+		const uint32_t count = end - begin;
+
+		r_scratch.distances.resize(count);
+		float *distances = r_scratch.distances.ptr();
+		const float *px = position_x.ptr() + begin;
+		const float *py = position_y.ptr() + begin;
+		const float *pz = position_z.ptr() + begin;
+		uint32_t i = 0;
+#ifdef RVO_BATCH_SIMD
+		const Float4 x4 = f4_set(x);
+		const Float4 y4 = f4_set(y);
+		const Float4 z4 = f4_set(z);
+		for (; i + 4 <= count; i += 4) {
+			const Float4 dx = f4_sub(x4, f4_load(px + i));
+			const Float4 dy = f4_sub(y4, f4_load(py + i));
+			const Float4 dz = f4_sub(z4, f4_load(pz + i));
+			f4_store(distances + i, f4_add(f4_add(f4_mul(dx, dx), f4_mul(dy, dy)), f4_mul(dz, dz)));
+		}
+#endif
+		for (; i < count; i++) {
+			const float dx = x - px[i];
+			const float dy = y - py[i];
+			const float dz = z - pz[i];
+			distances[i] = dx * dx + dy * dy + dz * dz;
+		}
+
+		// Same insertion as `RVO::Agent::insertAgentNeighbor`, the range
+		// shrinks to the farthest neighbor once there are enough of them.
+		for (uint32_t i = 0; i < count; i++) {
+			const float dist_sq = distances[i];
+			if (dist_sq >= range_sq || agents[begin + i] == p_agent) {
+				continue;
+			}
+
+			if (r_scratch.neighbors.size() < p_agent->maxNeighbors_) {
+				r_scratch.neighbors.push_back(std::make_pair(dist_sq, begin + i));
+			}
+
+			uint32_t n = r_scratch.neighbors.size() - 1;
+			while (n != 0 && dist_sq < r_scratch.neighbors[n - 1].first) {
+				r_scratch.neighbors[n] = r_scratch.neighbors[n - 1];
+				n--;
+			}
+			r_scratch.neighbors[n] = std::make_pair(dist_sq, begin + i);
+
+			if (r_scratch.neighbors.size() == p_agent->maxNeighbors_) {
+				range_sq = r_scratch.neighbors[r_scratch.neighbors.size() - 1].first;
+			}
+		}
+	}
+}
+
+void RvoBatch::compute_orca_planes(RVO::Agent *p_agent, float p_time_step, Scratch &r_scratch) const {
+	const uint32_t count = r_scratch.neighbors.size();
+
+	r_scratch.position_x.resize(count);
+	r_scratch.position_y.resize(count);
+	r_scratch.position_z.resize(count);
+	r_scratch.velocity_x.resize(count);
+	r_scratch.velocity_y.resize(count);
+	r_scratch.velocity_z.resize(count);
+	r_scratch.combined_radius.resize(count);
+	r_scratch.normal_x.resize(count);
+	r_scratch.normal_y.resize(count);
+	r_scratch.normal_z.resize(count);
+	r_scratch.u_length.resize(count);
+	r_scratch.valid.resize(count);
+
+	const float agent_velocity_x = p_agent->velocity_.x();
+	const float agent_velocity_y = p_agent->velocity_.y();
+	const float agent_velocity_z = p_agent->velocity_.z();
+
+	// Relative positions and velocities, the height is ignored when the
+	// agent avoids the others on the horizontal plane only.
+	const float y_scale = p_agent->ignore_y_ ? 0.0 : 1.0;
+	for (uint32_t i = 0; i < count; i++) {
+		const uint32_t other = r_scratch.neighbors[i].second;
+		const float relative_y = position_y[other] - p_agent->position_.y();
+		r_scratch.combined_radius[i] = p_agent->radius_ + radius[other];
+		r_scratch.valid[i] = !p_agent->ignore_y_ || Math::abs(relative_y) <= r_scratch.combined_radius[i] * 2.0f;
+		r_scratch.position_x[i] = position_x[other] - p_agent->position_.x();
+		r_scratch.position_y[i] = relative_y * y_scale;
+		r_scratch.position_z[i] = position_z[other] - p_agent->position_.z();
+		r_scratch.velocity_x[i] = agent_velocity_x - velocity_x[other];
+		r_scratch.velocity_y[i] = (agent_velocity_y - velocity_y[other]) * y_scale;
+		r_scratch.velocity_z[i] = agent_velocity_z - velocity_z[other];
+	}
+
+	// The three cases of `RVO::Agent::computeNewVelocity` are computed for
+	// every neighbor and the right one is selected, which keeps the loop
+	// free of branches and lets it process four neighbors at once.
+	const float inv_time_horizon = 1.0f / p_agent->timeHorizon_;
+	const float inv_time_step = 1.0f / p_time_step;
+	const float *px = r_scratch.position_x.ptr();
+	const float *py = r_scratch.position_y.ptr();
+	const float *pz = r_scratch.position_z.ptr();
+	const float *vx = r_scratch.velocity_x.ptr();
+	const float *vy = r_scratch.velocity_y.ptr();
+	const float *vz = r_scratch.velocity_z.ptr();
+	const float *combined_radius = r_scratch.combined_radius.ptr();
+	float *nx = r_scratch.normal_x.ptr();
+	float *ny = r_scratch.normal_y.ptr();
+	float *nz = r_scratch.normal_z.ptr();
+	float *u_length = r_scratch.u_length.ptr();
+	uint32_t i = 0;
+#ifdef RVO_BATCH_SIMD
+	const Float4 zero = f4_set(0.0f);
+	const Float4 inv_time_horizon4 = f4_set(inv_time_horizon);
+	const Float4 inv_time_step4 = f4_set(inv_time_step);
+	for (; i + 4 <= count; i += 4) {
+		const Float4 x = f4_load(px + i);
+		const Float4 y = f4_load(py + i);
+		const Float4 z = f4_load(pz + i);
+		const Float4 v_x = f4_load(vx + i);
+		const Float4 v_y = f4_load(vy + i);
+		const Float4 v_z = f4_load(vz + i);
+		const Float4 radius4 = f4_load(combined_radius + i);
+		const Float4 dist_sq = f4_add(f4_add(f4_mul(x, x), f4_mul(y, y)), f4_mul(z, z));
+		const Float4 combined_radius_sq = f4_mul(radius4, radius4);
+
+		const Float4 cut_x = f4_sub(v_x, f4_mul(inv_time_horizon4, x));
+		const Float4 cut_y = f4_sub(v_y, f4_mul(inv_time_horizon4, y));
+		const Float4 cut_z = f4_sub(v_z, f4_mul(inv_time_horizon4, z));
+		const Float4 cut_length_sq = f4_add(f4_add(f4_mul(cut_x, cut_x), f4_mul(cut_y, cut_y)), f4_mul(cut_z, cut_z));
+		const Float4 cut_dot = f4_add(f4_add(f4_mul(cut_x, x), f4_mul(cut_y, y)), f4_mul(cut_z, z));
+		const Float4 cut_length = f4_sqrt(cut_length_sq);
+
+		const Float4 b = f4_add(f4_add(f4_mul(x, v_x), f4_mul(y, v_y)), f4_mul(z, v_z));
+		const Float4 cross_x = f4_sub(f4_mul(y, v_z), f4_mul(z, v_y));
+		const Float4 cross_y = f4_sub(f4_mul(z, v_x), f4_mul(x, v_z));
+		const Float4 cross_z = f4_sub(f4_mul(x, v_y), f4_mul(y, v_x));
+		const Float4 v_length_sq = f4_add(f4_add(f4_mul(v_x, v_x), f4_mul(v_y, v_y)), f4_mul(v_z, v_z));
+		const Float4 cross_length_sq = f4_add(f4_add(f4_mul(cross_x, cross_x), f4_mul(cross_y, cross_y)), f4_mul(cross_z, cross_z));
+		const Float4 c = f4_sub(v_length_sq, f4_div(cross_length_sq, f4_sub(dist_sq, combined_radius_sq)));
+		const Float4 t = f4_div(f4_add(b, f4_sqrt(f4_max(f4_sub(f4_mul(b, b), f4_mul(dist_sq, c)), zero))), dist_sq);
+		const Float4 cone_x = f4_sub(v_x, f4_mul(t, x));
+		const Float4 cone_y = f4_sub(v_y, f4_mul(t, y));
+		const Float4 cone_z = f4_sub(v_z, f4_mul(t, z));
+		const Float4 cone_length = f4_sqrt(f4_add(f4_add(f4_mul(cone_x, cone_x), f4_mul(cone_y, cone_y)), f4_mul(cone_z, cone_z)));
+
+		const Float4 hit_x = f4_sub(v_x, f4_mul(inv_time_step4, x));
+		const Float4 hit_y = f4_sub(v_y, f4_mul(inv_time_step4, y));
+		const Float4 hit_z = f4_sub(v_z, f4_mul(inv_time_step4, z));
+		const Float4 hit_length = f4_sqrt(f4_add(f4_add(f4_mul(hit_x, hit_x), f4_mul(hit_y, hit_y)), f4_mul(hit_z, hit_z)));
+
+		const Mask4 collision = f4_less_equal(dist_sq, combined_radius_sq);
+		const Mask4 cut_off = f4_and(f4_less(cut_dot, zero), f4_less(f4_mul(combined_radius_sq, cut_length_sq), f4_mul(cut_dot, cut_dot)));
+
+		const Float4 w_x = f4_select(collision, hit_x, f4_select(cut_off, cut_x, cone_x));
+		const Float4 w_y = f4_select(collision, hit_y, f4_select(cut_off, cut_y, cone_y));
+		const Float4 w_z = f4_select(collision, hit_z, f4_select(cut_off, cut_z, cone_z));
+		const Float4 w_length = f4_select(collision, hit_length, f4_select(cut_off, cut_length, cone_length));
+		const Float4 scale = f4_select(collision, inv_time_step4, f4_select(cut_off, inv_time_horizon4, t));
+
+		f4_store(nx + i, f4_div(w_x, w_length));
+		f4_store(ny + i, f4_div(w_y, w_length));
+		f4_store(nz + i, f4_div(w_z, w_length));
+		f4_store(u_length + i, f4_sub(f4_mul(radius4, scale), w_length));
+	}
+#endif
+	for (; i < count; i++) {
+		const float dist_sq = px[i] * px[i] + py[i] * py[i] + pz[i] * pz[i];
+		const float combined_radius_sq = combined_radius[i] * combined_radius[i];
+
+		// No collision, projected on the cut-off circle.
+		const float cut_x = vx[i] - inv_time_horizon * px[i];
+		const float cut_y = vy[i] - inv_time_horizon * py[i];
+		const float cut_z = vz[i] - inv_time_horizon * pz[i];
+		const float cut_length_sq = cut_x * cut_x + cut_y * cut_y + cut_z * cut_z;
+		const float cut_dot = cut_x * px[i] + cut_y * py[i] + cut_z * pz[i];
+		const float cut_length = Math::sqrt(cut_length_sq);
+
+		// No collision, projected on the cone.
+		const float b = px[i] * vx[i] + py[i] * vy[i] + pz[i] * vz[i];
+		const float cross_x = py[i] * vz[i] - pz[i] * vy[i];
+		const float cross_y = pz[i] * vx[i] - px[i] * vz[i];
+		const float cross_z = px[i] * vy[i] - py[i] * vx[i];
+		const float c = (vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]) - (cross_x * cross_x + cross_y * cross_y + cross_z * cross_z) / (dist_sq - combined_radius_sq);
+		const float t = (b + Math::sqrt(MAX(b * b - dist_sq * c, 0.0f))) / dist_sq;
+		const float cone_x = vx[i] - t * px[i];
+		const float cone_y = vy[i] - t * py[i];
+		const float cone_z = vz[i] - t * pz[i];
+		const float cone_length = Math::sqrt(cone_x * cone_x + cone_y * cone_y + cone_z * cone_z);
+
+		// Collision.
+		const float hit_x = vx[i] - inv_time_step * px[i];
+		const float hit_y = vy[i] - inv_time_step * py[i];
+		const float hit_z = vz[i] - inv_time_step * pz[i];
+		const float hit_length = Math::sqrt(hit_x * hit_x + hit_y * hit_y + hit_z * hit_z);
+
+		const bool collision = dist_sq <= combined_radius_sq;
+		const bool cut_off = cut_dot < 0.0f && cut_dot * cut_dot > combined_radius_sq * cut_length_sq;
+
+		const float w_x = collision ? hit_x : (cut_off ? cut_x : cone_x);
+		const float w_y = collision ? hit_y : (cut_off ? cut_y : cone_y);
+		const float w_z = collision ? hit_z : (cut_off ? cut_z : cone_z);
+		const float w_length = collision ? hit_length : (cut_off ? cut_length : cone_length);
+		const float scale = collision ? inv_time_step : (cut_off ? inv_time_horizon : t);
+
+		nx[i] = w_x / w_length;
+		ny[i] = w_y / w_length;
+		nz[i] = w_z / w_length;
+		u_length[i] = combined_radius[i] * scale - w_length;
+	}
+
+	// The planes keep the order of the neighbors, the solver depends on it.
+	p_agent->orcaPlanes_.clear();
+	for (uint32_t i = 0; i < count; i++) {
+		if (!r_scratch.valid[i]) {
+			continue;
+		}
+		RVO::Plane plane;
+		plane.normal = RVO::Vector3(nx[i], ny[i], nz[i]);
+		const float half_u = 0.5f * u_length[i];
+		plane.point = RVO::Vector3(agent_velocity_x + half_u * nx[i], agent_velocity_y + half_u * ny[i], agent_velocity_z + half_u * nz[i]);
+		p_agent->orcaPlanes_.push_back(plane);
+	}
+}
+
+void RvoBatch::compute_new_velocity(RVO::Agent *p_agent, float p_time_step) {
+	Scratch &scratch = scratches[WorkerThreadPool::get_singleton()->get_thread_index() + 1];
+
+	compute_neighbors(p_agent, scratch);
+	compute_orca_planes(p_agent, p_time_step, scratch);
+	p_agent->solveNewVelocity();
+}
@@ -0,0 +1,105 @@
+/*************************************************************************/
+/*  rvo_batch.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RVO_BATCH_H
+#define RVO_BATCH_H
+
+#include "core/templates/local_vector.h"
+
+#include <Agent.h>
+#include <vector>
+
+class RvoAgent;
+
+/// Avoidance state of all the agents of a map for one step.
+///
+/// The agents are copied into arrays sorted by the cell of a grid over the
+/// XZ plane, so the neighbors of an agent are found in a few contiguous
+/// ranges, and their ORCA planes are computed in loops over plain floats,
+/// four neighbors at a time with SSE2 or NEON. The planes are then solved by
+/// the RVO agent itself.
+class RvoBatch {
+	/// Working arrays of a thread, reused between the agents.
+	struct Scratch {
+		LocalVector<float> distances;
+		/// The closest agents as (squared distance, index), sorted.
+		LocalVector<std::pair<float, uint32_t>> neighbors;
+
+		LocalVector<float> position_x;
+		LocalVector<float> position_y;
+		LocalVector<float> position_z;
+		LocalVector<float> velocity_x;
+		LocalVector<float> velocity_y;
+		LocalVector<float> velocity_z;
+		LocalVector<float> combined_radius;
+
+		LocalVector<float> normal_x;
+		LocalVector<float> normal_y;
+		LocalVector<float> normal_z;
+		LocalVector<float> u_length;
+		LocalVector<uint8_t> valid;
+	};
+
+	/// The agents and their state, sorted by cell.
+	LocalVector<const RVO::Agent *> agents;
+	LocalVector<float> position_x;
+	LocalVector<float> position_y;
+	LocalVector<float> position_z;
+	LocalVector<float> velocity_x;
+	LocalVector<float> velocity_y;
+	LocalVector<float> velocity_z;
+	LocalVector<float> radius;
+
+	/// Cells of `cell_size` starting at the origin on the XZ plane, the
+	/// agents of a cell are from its offset up to the offset of the next one.
+	float origin_x = 0.0;
+	float origin_z = 0.0;
+	float cell_size = 1.0;
+	int width = 0;
+	int depth = 0;
+	LocalVector<uint32_t> cell_offsets;
+
+	/// One per worker thread, and one for the calling thread.
+	LocalVector<Scratch> scratches;
+
+	void compute_neighbors(const RVO::Agent *p_agent, Scratch &r_scratch) const;
+	void compute_orca_planes(RVO::Agent *p_agent, float p_time_step, Scratch &r_scratch) const;
+
+public:
+	/// Copies the agents of a map and sorts them in the grid. Must be called
+	/// again whenever the agents move.
+	void build(const std::vector<RvoAgent *> &p_agents);
+
+	/// Computes the new velocity of one of the agents given to `build`.
+	/// Thread safe, as long as each agent is computed only once at a time.
+	void compute_new_velocity(RVO::Agent *p_agent, float p_time_step);
+};
+
+#endif // RVO_BATCH_H
@@ -0,0 +1,135 @@
+/*************************************************************************/
+/*  test_navigation_avoidance.h                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAVIGATION_AVOIDANCE_H
+#define TEST_NAVIGATION_AVOIDANCE_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "modules/navigation/nav_map.h"
+#include "modules/navigation/rvo_agent.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationAvoidance {
+
+// Agents scattered at random, about one per 4 square meters, moving in random directions.
+static void create_agents(NavMap &r_map, LocalVector<RvoAgent *> &r_agents, int p_count, bool p_ignore_y) {
+	RandomPCG rng(42);
+	const float side = Math::sqrt(float(p_count)) * 2.0;
+	for (int i = 0; i < p_count; i++) {
+		RvoAgent *agent = memnew(RvoAgent);
+		RVO::Agent *rvo_agent = agent->get_agent();
+		rvo_agent->position_ = RVO::Vector3(rng.random(0.0f, side), p_ignore_y ? rng.random(0.0f, 0.5f) : 0.0f, rng.random(0.0f, side));
+		rvo_agent->velocity_ = RVO::Vector3(rng.random(-1.0f, 1.0f), 0.0, rng.random(-1.0f, 1.0f));
+		rvo_agent->prefVelocity_ = RVO::Vector3(rng.random(-1.0f, 1.0f), 0.0, rng.random(-1.0f, 1.0f));
+		rvo_agent->maxNeighbors_ = 10;
+		rvo_agent->maxSpeed_ = 2.0;
+		rvo_agent->neighborDist_ = 5.0;
+		rvo_agent->radius_ = rng.random(0.5f, 0.8f);
+		rvo_agent->timeHorizon_ = 5.0;
+		rvo_agent->ignore_y_ = p_ignore_y;
+		agent->set_map(&r_map);
+		r_map.add_agent(agent);
+		r_map.set_agent_as_controlled(agent);
+		r_agents.push_back(agent);
+	}
+	r_map.sync();
+}
+
+static void free_agents(NavMap &r_map, LocalVector<RvoAgent *> &r_agents) {
+	for (uint32_t i = 0; i < r_agents.size(); i++) {
+		r_map.remove_agent(r_agents[i]);
+		memdelete(r_agents[i]);
+	}
+	r_agents.clear();
+}
+
+static void check_batched_avoidance(bool p_ignore_y) {
+	NavMap map;
+	LocalVector<RvoAgent *> agents;
+	create_agents(map, agents, 500, p_ignore_y);
+
+	map.set_use_batched_avoidance(false);
+	map.step(1.0 / 60.0);
+	LocalVector<RVO::Vector3> expected;
+	for (uint32_t i = 0; i < agents.size(); i++) {
+		expected.push_back(agents[i]->get_agent()->newVelocity_);
+	}
+
+	map.set_use_batched_avoidance(true);
+	map.step(1.0 / 60.0);
+	int mismatches = 0;
+	for (uint32_t i = 0; i < agents.size(); i++) {
+		if (RVO::absSq(agents[i]->get_agent()->newVelocity_ - expected[i]) > 1e-6) {
+			mismatches++;
+		}
+	}
+	CHECK_MESSAGE(mismatches == 0, "The batched avoidance should compute the same velocities as the RVO agents.");
+
+	free_agents(map, agents);
+}
+
+TEST_CASE("[Navigation] Batched avoidance") {
+	SUBCASE("3D") {
+		check_batched_avoidance(false);
+	}
+	SUBCASE("Ignoring the height") {
+		check_batched_avoidance(true);
+	}
+}
+
+// Compares an avoidance step of the RVO agents with the batched one.
+// Run with `--test --no-skip --test-case="*Benchmark*"`.
+TEST_CASE("[Navigation][Benchmark] Avoidance step" * doctest::skip()) {
+	const int counts[] = { 1000, 10000 };
+	for (const int count : counts) {
+		NavMap map;
+		LocalVector<RvoAgent *> agents;
+		create_agents(map, agents, count, true);
+
+		const int steps = 20;
+		for (int batched = 0; batched < 2; batched++) {
+			map.set_use_batched_avoidance(batched);
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < steps; i++) {
+				map.step(1.0 / 60.0);
+			}
+			uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+			MESSAGE(vformat("%d agents, %s: %.2f msec per step.", count, batched ? "batched" : "RVO tree", double(elapsed) / 1000.0 / steps));
+		}
+
+		free_agents(map, agents);
+	}
+}
+
+} // namespace TestNavigationAvoidance
+
+#endif // TEST_NAVIGATION_AVOIDANCE_H
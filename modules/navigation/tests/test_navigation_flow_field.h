@@ -0,0 +1,134 @@
+/*************************************************************************/
+/*  test_navigation_flow_field.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_NAVIGATION_FLOW_FIELD_H
+#define TEST_NAVIGATION_FLOW_FIELD_H
+
+#include "modules/navigation/nav_flow_field.h"
+#include "modules/navigation/nav_map.h"
+#include "modules/navigation/nav_region.h"
+#include "scene/resources/navigation_mesh.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationFlowField {
+
+// A 4x4 square polygon on the XZ plane.
+static NavRegion *create_tile(NavMap &r_map, const Vector3 &p_position) {
+	Ref<NavigationMesh> mesh;
+	mesh.instantiate();
+	Vector<Vector3> vertices;
+	vertices.push_back(Vector3(0, 0, 0));
+	vertices.push_back(Vector3(0, 0, 4));
+	vertices.push_back(Vector3(4, 0, 4));
+	vertices.push_back(Vector3(4, 0, 0));
+	mesh->set_vertices(vertices);
+	Vector<int> polygon;
+	polygon.push_back(0);
+	polygon.push_back(1);
+	polygon.push_back(2);
+	polygon.push_back(3);
+	mesh->add_polygon(polygon);
+
+	NavRegion *region = memnew(NavRegion);
+	region->set_mesh(mesh);
+	region->set_transform(Transform3D(Basis(), p_position));
+	region->set_map(&r_map);
+	r_map.add_region(region);
+	return region;
+}
+
+TEST_CASE("[Navigation] Flow field distances") {
+	NavMap map;
+	map.set_edge_connection_margin(1.0);
+
+	// A corridor of four tiles sharing their edges, a fifth one connected
+	// through the margin and a last one the target can't reach.
+	LocalVector<NavRegion *> regions;
+	for (int i = 0; i < 4; i++) {
+		regions.push_back(create_tile(map, Vector3(i * 4, 0, 0)));
+	}
+	regions.push_back(create_tile(map, Vector3(16.5, 0, 0)));
+	regions.push_back(create_tile(map, Vector3(40, 0, 0)));
+	map.sync();
+
+	NavFlowField flow_field;
+	flow_field.set_cell_size(1.0);
+	flow_field.set_target(Vector3(2, 0, 2));
+	flow_field.start_update(&map);
+	flow_field.finish_update();
+
+	// Each tile is entered from the closest point of its edge on the way to the target.
+	CHECK(flow_field.get_distance(Vector3(1, 0, 2)) == doctest::Approx(1));
+	CHECK(flow_field.get_distance(Vector3(6, 0, 2)) == doctest::Approx(4));
+	CHECK(flow_field.get_distance(Vector3(14, 0, 2)) == doctest::Approx(12));
+	CHECK(flow_field.get_distance(Vector3(13, 0, 3)) == doctest::Approx(10 + Math_SQRT2));
+	// The pathway to the fifth tile is in the middle of the gap.
+	CHECK(flow_field.get_distance(Vector3(18.25, 0, 2)) == doctest::Approx(16.25));
+
+	CHECK(flow_field.get_next_location(Vector3(14, 0, 2), 0.1).is_equal_approx(Vector3(12, 0, 2)));
+	CHECK_MESSAGE(flow_field.get_next_location(Vector3(12.05, 0, 2), 0.1).is_equal_approx(Vector3(8, 0, 2)), "The waypoints already reached should be skipped.");
+	CHECK(flow_field.get_next_location(Vector3(3, 0, 1), 0.1).is_equal_approx(Vector3(2, 0, 2)));
+
+	SUBCASE("Unreachable region") {
+		CHECK(flow_field.get_distance(Vector3(42, 0, 2)) == INFINITY);
+		CHECK_MESSAGE(flow_field.get_next_location(Vector3(42, 0, 2), 0.1).is_equal_approx(Vector3(42, 0, 2)), "The agents should stay in place where the target can't be reached.");
+	}
+
+	SUBCASE("Moving the target") {
+		flow_field.set_target(Vector3(14, 0, 2));
+		flow_field.start_update(&map);
+		flow_field.finish_update();
+
+		CHECK(flow_field.get_distance(Vector3(14, 0, 2)) == doctest::Approx(0));
+		CHECK(flow_field.get_distance(Vector3(1, 0, 2)) == doctest::Approx(13));
+		CHECK(flow_field.get_distance(Vector3(42, 0, 2)) == INFINITY);
+	}
+
+	SUBCASE("Target out of reach of the others") {
+		flow_field.set_target(Vector3(42, 0, 2));
+		flow_field.start_update(&map);
+		flow_field.finish_update();
+
+		CHECK(flow_field.get_distance(Vector3(43, 0, 3)) == doctest::Approx(Math_SQRT2));
+		CHECK(flow_field.get_distance(Vector3(2, 0, 2)) == INFINITY);
+		CHECK(flow_field.get_distance(Vector3(18, 0, 2)) == INFINITY);
+	}
+
+	for (uint32_t i = 0; i < regions.size(); i++) {
+		map.remove_region(regions[i]);
+		memdelete(regions[i]);
+	}
+}
+
+} // namespace TestNavigationFlowField
+
+#endif // TEST_NAVIGATION_FLOW_FIELD_H
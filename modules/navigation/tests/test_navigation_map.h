@@ -0,0 +1,252 @@
+/*************************************************************************/
+/*  test_navigation_map.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_NAVIGATION_MAP_H
+#define TEST_NAVIGATION_MAP_H
+
+#include "modules/navigation/nav_map.h"
+#include "modules/navigation/nav_region.h"
+#include "scene/resources/navigation_mesh.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationMap {
+
+// A rectangle on the XZ plane, made of two triangles.
+static Ref<NavigationMesh> create_rectangle_mesh(const Vector2 &p_size) {
+	Ref<NavigationMesh> mesh;
+	mesh.instantiate();
+	Vector<Vector3> vertices;
+	vertices.push_back(Vector3(0, 0, 0));
+	vertices.push_back(Vector3(0, 0, p_size.y));
+	vertices.push_back(Vector3(p_size.x, 0, p_size.y));
+	vertices.push_back(Vector3(p_size.x, 0, 0));
+	mesh->set_vertices(vertices);
+
+	Vector<int> polygon;
+	polygon.push_back(0);
+	polygon.push_back(1);
+	polygon.push_back(2);
+	mesh->add_polygon(polygon);
+	polygon.write[1] = 2;
+	polygon.write[2] = 3;
+	mesh->add_polygon(polygon);
+	return mesh;
+}
+
+static NavRegion *create_region(NavMap &r_map, const Ref<NavigationMesh> &p_mesh, const Vector3 &p_position) {
+	NavRegion *region = memnew(NavRegion);
+	region->set_mesh(p_mesh);
+	region->set_transform(Transform3D(Basis(), p_position));
+	region->set_map(&r_map);
+	r_map.add_region(region);
+	return region;
+}
+
+// The connections of all the polygon edges of the map, sorted, with the
+// polygons identified by the index of their region in p_regions.
+static Vector<String> get_connections(NavMap &p_map, const LocalVector<NavRegion *> &p_regions) {
+	Vector<String> connections;
+	for (uint32_t r = 0; r < p_regions.size(); r++) {
+		if (p_regions[r]->get_map() != &p_map) {
+			continue;
+		}
+
+		const std::vector<gd::Polygon> &polygons = p_regions[r]->get_polygons();
+		for (size_t p = 0; p < polygons.size(); p++) {
+			for (size_t e = 0; e < polygons[p].edges.size(); e++) {
+				const Vector<gd::Edge::Connection> &edge_connections = polygons[p].edges[e].connections;
+				for (int c = 0; c < edge_connections.size(); c++) {
+					const gd::Edge::Connection &connection = edge_connections[c];
+					NavRegion *owner = connection.polygon->owner;
+					const int other_polygon = int(connection.polygon - &owner->get_polygons()[0]);
+					connections.push_back(vformat("%d/%d/%d -> ", r, int(p), int(e)) + vformat("%d/%d/%d ", p_regions.find(owner), other_polygon, connection.edge) + vformat("%s %s", connection.pathway_start, connection.pathway_end));
+				}
+			}
+		}
+		connections.push_back(vformat("%d has %d region connections", r, p_regions[r]->get_connections().size()));
+	}
+	connections.sort();
+	return connections;
+}
+
+// Checks the connections left by the incremental syncs are the ones of a full relink.
+static void check_relink(NavMap &r_map, const LocalVector<NavRegion *> &p_regions) {
+	r_map.sync();
+	Vector<String> incremental = get_connections(r_map, p_regions);
+
+	// Setting the margin relinks all the regions on the next sync.
+	r_map.set_edge_connection_margin(r_map.get_edge_connection_margin());
+	r_map.sync();
+	Vector<String> relinked = get_connections(r_map, p_regions);
+
+	CHECK(incremental.size() == relinked.size());
+	CHECK_MESSAGE(incremental == relinked, "The incremental sync should link the regions as a full relink does.");
+}
+
+TEST_CASE("[Navigation] Incremental sync links the regions as a full relink") {
+	NavMap map;
+	map.set_edge_connection_margin(1.0);
+
+	// Rows of 4x4 tiles sharing their edges, the rows are 0.5 apart and
+	// connect through the margin. A long strip below them connects to the
+	// first row, its edge overlaps too many grid cells to be in them.
+	Ref<NavigationMesh> tile = create_rectangle_mesh(Vector2(4, 4));
+	LocalVector<NavRegion *> regions;
+	for (int row = 0; row < 3; row++) {
+		for (int column = 0; column < 4; column++) {
+			regions.push_back(create_region(map, tile, Vector3(column * 4 + row * 0.25, 0, row * 4.5)));
+			map.sync();
+		}
+	}
+	regions.push_back(create_region(map, create_rectangle_mesh(Vector2(300, 1)), Vector3(-1, 0, -1.5)));
+
+	check_relink(map, regions);
+
+	int connected_regions = 0;
+	for (uint32_t r = 0; r < regions.size(); r++) {
+		if (regions[r]->get_connections().size() > 0) {
+			connected_regions++;
+		}
+	}
+	CHECK_MESSAGE(connected_regions == int(regions.size()), "All the regions should connect to the close edges of another row.");
+
+	SUBCASE("Removing regions") {
+		const int removed[] = { 5, 0, 12 };
+		for (const int r : removed) {
+			map.remove_region(regions[r]);
+			regions[r]->set_map(nullptr);
+			check_relink(map, regions);
+		}
+
+		for (const int r : removed) {
+			regions[r]->set_map(&map);
+			map.add_region(regions[r]);
+			check_relink(map, regions);
+		}
+	}
+
+	SUBCASE("Moving regions") {
+		regions[6]->set_transform(Transform3D(Basis(), Vector3(8.25, 0.3, 4.75)));
+		check_relink(map, regions);
+
+		regions[6]->set_transform(Transform3D(Basis(), Vector3(8.25, 0, 4.5)));
+		regions[9]->set_transform(Transform3D(Basis(), Vector3(40, 0, 40)));
+		check_relink(map, regions);
+	}
+
+	for (uint32_t r = 0; r < regions.size(); r++) {
+		if (regions[r]->get_map() == &map) {
+			map.remove_region(regions[r]);
+		}
+		memdelete(regions[r]);
+	}
+}
+
+static real_t get_path_length(const Vector<Vector3> &p_path) {
+	real_t length = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
+// Checks the path goes from p_from to p_to without leaving the floor, and has the expected length.
+static void check_path(const NavMap &p_map, const Vector3 &p_from, const Vector3 &p_to, bool p_optimize, real_t p_length) {
+	const Vector<Vector3> path = p_map.get_path(p_from, p_to, p_optimize);
+	const String text = vformat("The path from %s to %s (optimize: %s)", p_from, p_to, p_optimize);
+	REQUIRE_MESSAGE(path.size() >= 2, (text + " should be found."));
+	CHECK_MESSAGE(path[0].is_equal_approx(p_from), (text + " should start at the origin."));
+	CHECK_MESSAGE(path[path.size() - 1].is_equal_approx(p_to), (text + " should end at the destination."));
+
+	for (int i = 1; i < path.size(); i++) {
+		for (int j = 0; j <= 8; j++) {
+			const Vector3 point = path[i - 1].lerp(path[i], j / 8.0);
+			CHECK_MESSAGE(p_map.get_closest_point(point).distance_to(point) < 0.01, (text + vformat(" should stay on the floor at %s.", point)));
+		}
+	}
+
+	if (p_optimize) {
+		CHECK_MESSAGE(get_path_length(path) == doctest::Approx(p_length).epsilon(0.0001), (text + " should be the shortest one."));
+	} else {
+		CHECK_MESSAGE(get_path_length(path) >= p_length - 0.0001, (text + " can't be shorter than the shortest one."));
+	}
+}
+
+TEST_CASE("[Navigation] Paths around a hole in a map of several regions") {
+	NavMap map;
+	map.set_edge_connection_margin(1.0);
+
+	// A ring of eight 4x4 tiles around a 4x4 hole, from (0, 0) to (12, 12) on XZ.
+	Ref<NavigationMesh> tile = create_rectangle_mesh(Vector2(4, 4));
+	LocalVector<NavRegion *> regions;
+	for (int z = 0; z < 3; z++) {
+		for (int x = 0; x < 3; x++) {
+			if (x != 1 || z != 1) {
+				regions.push_back(create_region(map, tile, Vector3(x * 4, 0, z * 4)));
+			}
+		}
+	}
+	map.sync();
+
+	// The points are kept off the diagonals the tiles are split along, so each one is in a single polygon.
+	const bool optimize_values[2] = { true, false };
+	for (const bool optimize : optimize_values) {
+		// Inside a single tile.
+		check_path(map, Vector3(1, 0, 2), Vector3(3, 0, 2.5), optimize, Math::sqrt(4.25));
+		// Across the hole, both ways around it are as long.
+		check_path(map, Vector3(1, 0, 6), Vector3(11, 0, 6), optimize, Math::sqrt(13.0) * 2 + 4);
+		check_path(map, Vector3(6, 0, 1), Vector3(6, 0, 11), optimize, Math::sqrt(13.0) * 2 + 4);
+		check_path(map, Vector3(1, 0, 2), Vector3(11, 0, 10), optimize, Math::sqrt(45.0) + Math::sqrt(53.0));
+		// Around the short side of the hole, past the (4, 8) corner.
+		check_path(map, Vector3(1, 0, 6), Vector3(11, 0, 10), optimize, Math::sqrt(13.0) + Math::sqrt(53.0));
+		check_path(map, Vector3(11, 0, 10), Vector3(1, 0, 6), optimize, Math::sqrt(13.0) + Math::sqrt(53.0));
+	}
+
+	// Off the floor, the path goes to the closest point, (12, 0, 6).
+	const Vector<Vector3> path = map.get_path(Vector3(1, 0, 6), Vector3(20, 0, 6), true);
+	REQUIRE(path.size() >= 2);
+	CHECK(path[path.size() - 1].is_equal_approx(Vector3(12, 0, 6)));
+	CHECK(get_path_length(path) == doctest::Approx(Math::sqrt(13.0) + 4 + Math::sqrt(20.0)).epsilon(0.0001));
+
+	// The closest points are found in the right region.
+	CHECK(map.get_closest_point(Vector3(13, 1, 13)).is_equal_approx(Vector3(12, 0, 12)));
+	CHECK(map.get_closest_point(Vector3(5, -1, 1)).is_equal_approx(Vector3(5, 0, 1)));
+
+	for (uint32_t r = 0; r < regions.size(); r++) {
+		map.remove_region(regions[r]);
+		memdelete(regions[r]);
+	}
+}
+
+} // namespace TestNavigationMap
+
+#endif // TEST_NAVIGATION_MAP_H
@@ -0,0 +1,189 @@
+/*************************************************************************/
+/*  test_navigation_server_3d.h                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAVIGATION_SERVER_3D_H
+#define TEST_NAVIGATION_SERVER_3D_H
+
+#include "scene/resources/navigation_mesh.h"
+#include "servers/navigation_server_3d.h"
+
+#include "tests/test_macros.h"
+
+// Declared in global namespace because of GDCLASS macro warning (Windows):
+// "Unqualified friend declaration referring to type outside of the nearest enclosing namespace
+// is a Microsoft extension; add a nested name specifier".
+class _TestPathQueryReceiver : public Object {
+	GDCLASS(_TestPathQueryReceiver, Object);
+
+protected:
+	static void _bind_methods() {
+		ClassDB::bind_method(D_METHOD("receive_paths", "paths", "udata"), &_TestPathQueryReceiver::receive_paths);
+	}
+
+public:
+	Array paths;
+	Variant udata;
+	int calls = 0;
+
+	void receive_paths(const Array &p_paths, const Variant &p_udata) {
+		paths = p_paths;
+		udata = p_udata;
+		calls++;
+	}
+};
+
+namespace TestNavigationServer3D {
+
+// An L-shaped floor made of three 4x4 tiles, so paths between the ends have to turn.
+static Ref<NavigationMesh> create_l_mesh() {
+	Ref<NavigationMesh> mesh;
+	mesh.instantiate();
+	Vector<Vector3> vertices;
+	vertices.push_back(Vector3(0, 0, 0));
+	vertices.push_back(Vector3(0, 0, 4));
+	vertices.push_back(Vector3(4, 0, 4));
+	vertices.push_back(Vector3(4, 0, 0));
+	vertices.push_back(Vector3(8, 0, 4));
+	vertices.push_back(Vector3(8, 0, 0));
+	vertices.push_back(Vector3(4, 0, 8));
+	vertices.push_back(Vector3(8, 0, 8));
+	mesh->set_vertices(vertices);
+
+	const int polygons[3][4] = { { 0, 1, 2, 3 }, { 3, 2, 4, 5 }, { 2, 6, 7, 4 } };
+	for (int i = 0; i < 3; i++) {
+		Vector<int> polygon;
+		for (int j = 0; j < 4; j++) {
+			polygon.push_back(polygons[i][j]);
+		}
+		mesh->add_polygon(polygon);
+	}
+	return mesh;
+}
+
+// Two L-shaped floors side by side, the second one connects to the first through the margin.
+static RID create_map(NavigationServer3D *p_server, RID r_regions[2]) {
+	RID map = p_server->map_create();
+	p_server->map_set_active(map, true);
+	p_server->map_set_edge_connection_margin(map, 1.0);
+	const Ref<NavigationMesh> mesh = create_l_mesh();
+	for (int i = 0; i < 2; i++) {
+		r_regions[i] = p_server->region_create();
+		p_server->region_set_navmesh(r_regions[i], mesh);
+		p_server->region_set_transform(r_regions[i], Transform3D(Basis(), Vector3(i * 8.5, 0, 0)));
+		p_server->region_set_map(r_regions[i], map);
+	}
+	p_server->process(0.0);
+	return map;
+}
+
+static void free_map(NavigationServer3D *p_server, RID p_map, RID p_regions[2]) {
+	for (int i = 0; i < 2; i++) {
+		p_server->free(p_regions[i]);
+	}
+	p_server->free(p_map);
+	p_server->process(0.0);
+}
+
+TEST_CASE("[SceneTree][NavigationServer3D] Path queries match map_get_path") {
+	NavigationServer3D *server = NavigationServer3D::get_singleton();
+	RID regions[2];
+	RID map = create_map(server, regions);
+
+	Vector<Vector3> origins;
+	Vector<Vector3> destinations;
+	origins.push_back(Vector3(1, 0, 1));
+	destinations.push_back(Vector3(6, 0, 7));
+	origins.push_back(Vector3(6, 0, 7));
+	destinations.push_back(Vector3(14.5, 0, 7));
+	origins.push_back(Vector3(2, 0, 2));
+	destinations.push_back(Vector3(3, 0, 3));
+	// Off the floor, the closest points are used.
+	origins.push_back(Vector3(-5, 0, 1));
+	destinations.push_back(Vector3(20, 0, 20));
+
+	SUBCASE("Server active") {
+	}
+	SUBCASE("Server inactive") {
+		server->set_active(false);
+	}
+
+	const bool optimize_values[2] = { true, false };
+	for (const bool optimize : optimize_values) {
+		_TestPathQueryReceiver *receiver = memnew(_TestPathQueryReceiver);
+		server->map_query_paths(map, origins, destinations, optimize, receiver, "receive_paths", 42);
+		// The batch starts at the end of the next step and is delivered at the beginning of the following one.
+		server->process(0.0);
+		CHECK(receiver->calls == 0);
+		server->process(0.0);
+		CHECK_MESSAGE(receiver->calls == 1, "The paths should be delivered once, even while the server is inactive.");
+		CHECK(int(receiver->udata) == 42);
+		CHECK(receiver->paths.size() == origins.size());
+
+		for (int i = 0; i < receiver->paths.size(); i++) {
+			const Vector<Vector3> expected = server->map_get_path(map, origins[i], destinations[i], optimize);
+			const Vector<Vector3> path = receiver->paths[i];
+			CHECK(expected.size() >= 2);
+			CHECK_MESSAGE(path == expected, vformat("Path %d should be the one of map_get_path.", i));
+		}
+		memdelete(receiver);
+	}
+
+	server->set_active(true);
+	free_map(server, map, regions);
+}
+
+TEST_CASE("[SceneTree][NavigationServer3D] Flow fields update while the server is inactive") {
+	NavigationServer3D *server = NavigationServer3D::get_singleton();
+	RID regions[2];
+	RID map = create_map(server, regions);
+
+	server->set_active(false);
+	RID flow_field = server->flow_field_create();
+	server->flow_field_set_map(flow_field, map);
+	server->flow_field_set_target(flow_field, Vector3(1, 0, 1));
+	CHECK(server->flow_field_get_distance(flow_field, Vector3(14.5, 0, 7)) == INFINITY);
+
+	// The update starts at the end of the next step and is used from the following one.
+	server->process(0.0);
+	server->process(0.0);
+
+	const real_t distance = server->flow_field_get_distance(flow_field, Vector3(14.5, 0, 7));
+	CHECK_MESSAGE(distance < INFINITY, "The flow field should be built from the last synced map.");
+	CHECK(distance > Vector3(14.5, 0, 7).distance_to(Vector3(1, 0, 1)));
+	CHECK_FALSE(server->flow_field_get_next_location(flow_field, Vector3(14.5, 0, 7), 0.1).is_equal_approx(Vector3(14.5, 0, 7)));
+
+	server->set_active(true);
+	server->free(flow_field);
+	free_map(server, map, regions);
+}
+
+} // namespace TestNavigationServer3D
+
+#endif // TEST_NAVIGATION_SERVER_3D_H
@@ -30,6 +30,8 @@
 
 #include "register_types.h"
 
+#include "core/config/project_settings.h"
+
 #include "lightmap_raycaster.h"
 #include "raycast_occlusion_cull.h"
 
@@ -39,7 +41,10 @@ void register_raycast_types() {
 #ifdef TOOLS_ENABLED
 	LightmapRaycasterEmbree::make_default_raycaster();
 #endif
-	raycast_occlusion_cull = memnew(RaycastOcclusionCull);
+	// Also defined by the rendering server, which doesn't exist yet when the tests register the modules.
+	if (!GLOBAL_DEF_RST("rendering/occlusion_culling/use_software_rasterizer", false)) {
+		raycast_occlusion_cull = memnew(RaycastOcclusionCull);
+	}
 }
 
 void unregister_raycast_types() {
@@ -30,6 +30,7 @@
 
 #include "text_server_adv.h"
 
+#include "core/os/worker_thread_pool.h"
 #include "core/string/print_string.h"
 #include "core/string/translation.h"
 
@@ -966,10 +967,7 @@ _FORCE_INLINE_ TextServerAdvanced::FontGlyph TextServerAdvanced::rasterize_msdf(
 		td.projection = &projection;
 		td.distancePixelConversion = &distancePixelConversion;
 
-		if (p_font_data->work_pool.get_thread_count() == 0) {
-			p_font_data->work_pool.init();
-		}
-		p_font_data->work_pool.do_work(h, this, &TextServerAdvanced::_generateMTSDF_threaded, &td);
+		WorkerThreadPool::get_singleton()->do_work(h, this, &TextServerAdvanced::_generateMTSDF_threaded, &td);
 
 		msdfgen::msdfErrorCorrection(image, shape, projection, p_pixel_range, config);
 
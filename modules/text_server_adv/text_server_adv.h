@@ -39,7 +39,6 @@
 #include "servers/text_server.h"
 
 #include "core/templates/rid_owner.h"
-#include "core/templates/thread_work_pool.h"
 #include "scene/resources/texture.h"
 #include "script_iterator.h"
 
@@ -177,10 +176,8 @@ class TextServerAdvanced : public TextServer {
 		PackedByteArray data;
 		const uint8_t *data_ptr;
 		size_t data_size;
-		mutable ThreadWorkPool work_pool;
 
 		~FontDataAdvanced() {
-			work_pool.finish();
 			for (const Map<Vector2i, FontDataForSizeAdvanced *>::Element *E = cache.front(); E; E = E->next()) {
 				memdelete(E->get());
 			}
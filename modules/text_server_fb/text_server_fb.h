@@ -39,7 +39,6 @@
 #include "servers/text_server.h"
 
 #include "core/templates/rid_owner.h"
-#include "core/templates/thread_work_pool.h"
 #include "scene/resources/texture.h"
 
 #include "modules/modules_enabled.gen.h"
@@ -149,10 +148,7 @@ class TextServerFallback : public TextServer {
 		const uint8_t *data_ptr;
 		size_t data_size;
 
-		mutable ThreadWorkPool work_pool;
-
 		~FontDataFallback() {
-			work_pool.finish();
 			for (const Map<Vector2i, FontDataForSizeFallback *>::Element *E = cache.front(); E; E = E->next()) {
 				memdelete(E->get());
 			}
@@ -41,6 +41,7 @@ class NavigationAgent2D : public Node {
 	Node2D *agent_parent = nullptr;
 
 	RID agent;
+	RID flow_field;
 
 	uint32_t navigable_layers = 1;
 
@@ -113,6 +114,11 @@ public:
 	void set_path_max_distance(real_t p_pmd);
 	real_t get_path_max_distance();
 
+	void set_flow_field(RID p_flow_field);
+	RID get_flow_field() const {
+		return flow_field;
+	}
+
 	void set_target_location(Vector2 p_location);
 	Vector2 get_target_location() const;
 
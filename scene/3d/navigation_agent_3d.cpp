@@ -62,6 +62,9 @@ void NavigationAgent3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_path_max_distance", "max_speed"), &NavigationAgent3D::set_path_max_distance);
 	ClassDB::bind_method(D_METHOD("get_path_max_distance"), &NavigationAgent3D::get_path_max_distance);
 
+	ClassDB::bind_method(D_METHOD("set_flow_field", "flow_field"), &NavigationAgent3D::set_flow_field);
+	ClassDB::bind_method(D_METHOD("get_flow_field"), &NavigationAgent3D::get_flow_field);
+
 	ClassDB::bind_method(D_METHOD("set_target_location", "location"), &NavigationAgent3D::set_target_location);
 	ClassDB::bind_method(D_METHOD("get_target_location"), &NavigationAgent3D::get_target_location);
 	ClassDB::bind_method(D_METHOD("get_next_location"), &NavigationAgent3D::get_next_location);
@@ -177,6 +180,14 @@ real_t NavigationAgent3D::get_path_max_distance() {
 	return path_max_distance;
 }
 
+void NavigationAgent3D::set_flow_field(RID p_flow_field) {
+	flow_field = p_flow_field;
+	navigation_path.clear();
+	target_reached = false;
+	navigation_finished = false;
+	update_frame_id = 0;
+}
+
 void NavigationAgent3D::set_target_location(Vector3 p_location) {
 	target_location = p_location;
 	navigation_path.clear();
@@ -269,6 +280,45 @@ void NavigationAgent3D::update_navigation() {
 
 	Vector3 o = agent_parent->get_global_transform().origin;
 
+	if (flow_field.is_valid()) {
+		// The flow field already knows the way from every polygon, only the
+		// next waypoint is taken from it each frame.
+		target_location = NavigationServer3D::get_singleton()->flow_field_get_target(flow_field);
+
+		// Until the field is built, or if the target can't be reached from
+		// here, there is no path. The agent stays where it is, but hasn't
+		// finished navigating either.
+		if (NavigationServer3D::get_singleton()->flow_field_get_distance(flow_field, o) == INFINITY) {
+			if (navigation_path.size() > 0) {
+				navigation_path.clear();
+				nav_path_index = 0;
+				emit_signal(SNAME("path_changed"));
+			}
+			navigation_finished = false;
+			target_reached = false;
+			return;
+		}
+
+		Vector3 next_location = NavigationServer3D::get_singleton()->flow_field_get_next_location(flow_field, o, target_desired_distance);
+		if (navigation_path.size() != 1 || navigation_path[0] != next_location) {
+			navigation_path.resize(1);
+			navigation_path.write[0] = next_location;
+			nav_path_index = 0;
+			emit_signal(SNAME("path_changed"));
+		}
+		// The target of the field can move, so the agent starts again once
+		// it is left behind.
+		if (o.distance_to(next_location - Vector3(0, navigation_height_offset, 0)) >= target_desired_distance) {
+			navigation_finished = false;
+			target_reached = false;
+		} else if (navigation_finished == false) {
+			_check_distance_to_target();
+			navigation_finished = true;
+			emit_signal(SNAME("navigation_finished"));
+		}
+		return;
+	}
+
 	bool reload_path = false;
 
 	if (NavigationServer3D::get_singleton()->agent_is_map_changed(agent)) {
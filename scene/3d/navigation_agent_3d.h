@@ -41,6 +41,7 @@ class NavigationAgent3D : public Node {
 	Node3D *agent_parent = nullptr;
 
 	RID agent;
+	RID flow_field;
 
 	real_t target_desired_distance = 1.0;
 	real_t radius;
@@ -120,6 +121,11 @@ public:
 	void set_path_max_distance(real_t p_pmd);
 	real_t get_path_max_distance();
 
+	void set_flow_field(RID p_flow_field);
+	RID get_flow_field() const {
+		return flow_field;
+	}
+
 	void set_target_location(Vector3 p_location);
 	Vector3 get_target_location() const;
 
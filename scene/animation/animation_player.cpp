@@ -32,6 +32,7 @@
 
 #include "core/config/engine.h"
 #include "core/object/message_queue.h"
+#include "core/os/worker_thread_pool.h"
 #include "scene/scene_string_names.h"
 #include "servers/audio/audio_stream.h"
 
@@ -183,6 +184,58 @@ void AnimationPlayer::_get_property_list(List<PropertyInfo> *p_list) const {
 	p_list->push_back(PropertyInfo(Variant::ARRAY, "blend_times", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
 }
 
+void AnimationPlayer::_prefetch_batch_player(void *p_userdata, uint32_t p_index) {
+	AnimationPlayer *player = ((AnimationPlayer **)p_userdata)[p_index];
+	player->_sample_transform_tracks(player->prefetch_anim, player->prefetch_time, false);
+}
+
+void AnimationPlayer::_prefetch_batch(AnimationProcessCallback p_callback, double p_delta, uint64_t p_frame) {
+	LocalVector<AnimationPlayer *> players;
+
+	for (SelfList<AnimationPlayer> *E = process_batch.first(); E; E = E->next()) {
+		AnimationPlayer *player = E->self();
+		if (player->prefetch_frame == p_frame) {
+			continue; // Already considered by a batch in this frame, and may be waiting to use its result.
+		}
+		player->prefetch_frame = p_frame;
+		player->prefetch_anim = nullptr;
+
+		if (!player->processing || !player->active || player->process_callback != p_callback || !player->can_process() || player->is_processing_in_sub_thread()) {
+			continue;
+		}
+
+		AnimationData *anim = player->playback.current.from;
+		if (!anim || anim->node_cache.size() != anim->animation->get_track_count()) {
+			continue; // Caches are built when processing, on the main thread.
+		}
+
+		player->prefetch_anim = anim;
+		player->prefetch_time = (float)player->_get_next_pos(player->playback.current, p_delta); // Same precision as PlaybackData::pos.
+		players.push_back(player);
+	}
+
+	if (players.size() < 2) {
+		for (uint32_t i = 0; i < players.size(); i++) {
+			players[i]->prefetch_anim = nullptr; // Not worth it, process as usual.
+		}
+		return;
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&AnimationPlayer::_prefetch_batch_player, players.ptr(), players.size());
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
+void AnimationPlayer::_process_batched(AnimationProcessCallback p_callback, double p_delta) {
+	if (!is_processing_in_sub_thread() && get_tree()->is_parallel_animation_evaluation_enabled()) {
+		uint64_t frame = p_callback == ANIMATION_PROCESS_PHYSICS ? Engine::get_singleton()->get_physics_frames() : Engine::get_singleton()->get_process_frames();
+		if (prefetch_frame != frame) {
+			_prefetch_batch(p_callback, p_delta, frame);
+		}
+	}
+
+	_animation_process(p_delta);
+}
+
 void AnimationPlayer::advance(float p_time) {
 	_animation_process(p_time);
 }
@@ -190,6 +243,7 @@ void AnimationPlayer::advance(float p_time) {
 void AnimationPlayer::_notification(int p_what) {
 	switch (p_what) {
 		case NOTIFICATION_ENTER_TREE: {
+			process_batch.add(&process_batch_element);
 			if (!processing) {
 				//make sure that a previous process state was not saved
 				//only process if "processing" is set
@@ -211,7 +265,7 @@ void AnimationPlayer::_notification(int p_what) {
 			}
 
 			if (processing) {
-				_animation_process(get_process_delta_time());
+				_process_batched(ANIMATION_PROCESS_IDLE, get_process_delta_time());
 			}
 		} break;
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
@@ -220,10 +274,11 @@ void AnimationPlayer::_notification(int p_what) {
 			}
 
 			if (processing) {
-				_animation_process(get_physics_process_delta_time());
+				_process_batched(ANIMATION_PROCESS_PHYSICS, get_physics_process_delta_time());
 			}
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
+			process_batch.remove(&process_batch_element);
 			clear_caches();
 		} break;
 	}
@@ -341,6 +396,34 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim, Node *p_root_ov
 	}
 }
 
+void AnimationPlayer::_sample_transform_tracks(AnimationData *p_anim, double p_time, bool p_compressed_only) {
+	batch_slot.clear();
+#ifndef _3D_DISABLED
+	Animation *a = p_anim->animation.operator->();
+	if (p_compressed_only && !a->is_compressed()) {
+		return;
+	}
+
+	batch_tracks.clear();
+	batch_slot.resize(a->get_track_count());
+	for (int i = 0; i < a->get_track_count(); i++) {
+		TrackNodeCache *nc = p_anim->node_cache[i];
+		if (nc && nc->node_3d && a->track_get_type(i) == Animation::TYPE_TRANSFORM3D && a->track_is_enabled(i) && (!p_compressed_only || a->track_is_compressed(i))) {
+			batch_slot[i] = batch_tracks.size();
+			batch_tracks.push_back(i);
+		} else {
+			batch_slot[i] = -1;
+		}
+	}
+
+	batch_loc.resize(batch_tracks.size());
+	batch_rot.resize(batch_tracks.size());
+	batch_scale.resize(batch_tracks.size());
+	batch_err.resize(batch_tracks.size());
+	a->transform_track_interpolate_batch(batch_tracks.ptr(), batch_tracks.size(), p_time, batch_loc.ptr(), batch_rot.ptr(), batch_scale.ptr(), batch_err.ptr());
+#endif // _3D_DISABLED
+}
+
 void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double p_time, double p_delta, float p_interp, bool p_is_current, bool p_seeked, bool p_started) {
 	_ensure_node_caches(p_anim);
 	ERR_FAIL_COND(p_anim->node_cache.size() != p_anim->animation->get_track_count());
@@ -348,6 +431,12 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double
 	Animation *a = p_anim->animation.operator->();
 	bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
 
+	bool prefetched = p_anim == prefetch_anim && p_time == prefetch_time;
+	prefetch_anim = nullptr;
+	if (!prefetched) {
+		_sample_transform_tracks(p_anim, p_time, true);
+	}
+
 	for (int i = 0; i < a->get_track_count(); i++) {
 		// If an animation changes this animation (or it animates itself)
 		// we need to recreate our animation cache
@@ -380,7 +469,16 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double
 				Quaternion rot;
 				Vector3 scale;
 
-				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale);
+				Error err;
+				if (i < (int)batch_slot.size() && batch_slot[i] >= 0) {
+					int slot = batch_slot[i];
+					err = batch_err[slot];
+					loc = batch_loc[slot];
+					rot = batch_rot[slot];
+					scale = batch_scale[slot];
+				} else {
+					err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale);
+				}
 				//ERR_CONTINUE(err!=OK); //used for testing, should be removed
 
 				if (err != OK) {
@@ -776,20 +874,39 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double
 	}
 }
 
-void AnimationPlayer::_animation_process_data(PlaybackData &cd, double p_delta, float p_blend, bool p_seeked, bool p_started) {
-	double delta = p_delta * speed_scale * cd.speed_scale;
-	double next_pos = cd.pos + delta;
+double AnimationPlayer::_get_next_pos(const PlaybackData &cd, double p_delta) const {
+	double next_pos = cd.pos + p_delta * speed_scale * cd.speed_scale;
 
 	real_t len = cd.from->animation->get_length();
-	bool loop = cd.from->animation->has_loop();
 
-	if (!loop) {
+	if (!cd.from->animation->has_loop()) {
 		if (next_pos < 0) {
 			next_pos = 0;
 		} else if (next_pos > len) {
 			next_pos = len;
 		}
+	} else {
+		double looped_next_pos = Math::fposmod(next_pos, (double)len);
+		if (looped_next_pos == 0 && next_pos != 0) {
+			// Loop multiples of the length to it, rather than 0
+			// so state at time=length is previewable in the editor
+			next_pos = len;
+		} else {
+			next_pos = looped_next_pos;
+		}
+	}
+
+	return next_pos;
+}
 
+void AnimationPlayer::_animation_process_data(PlaybackData &cd, double p_delta, float p_blend, bool p_seeked, bool p_started) {
+	double delta = p_delta * speed_scale * cd.speed_scale;
+	double next_pos = _get_next_pos(cd, p_delta);
+
+	real_t len = cd.from->animation->get_length();
+	bool loop = cd.from->animation->has_loop();
+
+	if (!loop) {
 		bool backwards = signbit(delta); // Negative zero means playing backwards too
 		delta = next_pos - cd.pos; // Fix delta (after determination of backwards because negative zero is lost here)
 
@@ -806,16 +923,6 @@ void AnimationPlayer::_animation_process_data(PlaybackData &cd, double p_delta,
 				end_notify = cd.pos > 0; // Notify only if not already at the beginning
 			}
 		}
-
-	} else {
-		double looped_next_pos = Math::fposmod(next_pos, (double)len);
-		if (looped_next_pos == 0 && next_pos != 0) {
-			// Loop multiples of the length to it, rather than 0
-			// so state at time=length is previewable in the editor
-			next_pos = len;
-		} else {
-			next_pos = looped_next_pos;
-		}
 	}
 
 	cd.pos = next_pos;
@@ -1368,6 +1475,8 @@ void AnimationPlayer::clear_caches() {
 		E->get().node_cache.clear();
 	}
 
+	prefetch_anim = nullptr;
+
 	cache_update_size = 0;
 	cache_update_prop_size = 0;
 	cache_update_bezier_size = 0;
@@ -1690,7 +1799,10 @@ void AnimationPlayer::_bind_methods() {
 	BIND_ENUM_CONSTANT(ANIMATION_METHOD_CALL_IMMEDIATE);
 }
 
-AnimationPlayer::AnimationPlayer() {
+SelfList<AnimationPlayer>::List AnimationPlayer::process_batch;
+
+AnimationPlayer::AnimationPlayer() :
+		process_batch_element(this) {
 	root = SceneStringNames::get_singleton()->path_pp;
 }
 
@@ -31,6 +31,7 @@
 #ifndef ANIMATION_PLAYER_H
 #define ANIMATION_PLAYER_H
 
+#include "core/templates/self_list.h"
 #include "scene/2d/node_2d.h"
 #include "scene/3d/node_3d.h"
 #include "scene/3d/skeleton_3d.h"
@@ -158,6 +159,14 @@ private:
 	int cache_update_prop_size = 0;
 	TrackNodeCache::BezierAnim *cache_update_bezier[NODE_CACHE_UPDATE_MAX];
 	int cache_update_bezier_size = 0;
+
+	// Transform tracks of the animation being processed, sampled in one batch.
+	LocalVector<int> batch_slot; // Index in the batch for each track, -1 if not batched.
+	LocalVector<int> batch_tracks;
+	LocalVector<Vector3> batch_loc;
+	LocalVector<Quaternion> batch_rot;
+	LocalVector<Vector3> batch_scale;
+	LocalVector<Error> batch_err;
 	Set<TrackNodeCache *> playing_caches;
 
 	uint64_t accum_pass = 1;
@@ -201,6 +210,21 @@ private:
 		bool started = false;
 	} playback;
 
+	// Players processed by the engine sample the transform tracks of their current animation
+	// together, in parallel, when the first of them is notified in a frame. Each player uses
+	// the result only if it then processes that same animation at the same time.
+	AnimationData *prefetch_anim = nullptr;
+	double prefetch_time = 0.0;
+	uint64_t prefetch_frame = UINT64_MAX; // Frame of the last batch that considered this player.
+
+	SelfList<AnimationPlayer> process_batch_element;
+
+	static SelfList<AnimationPlayer>::List process_batch;
+
+	static void _prefetch_batch_player(void *p_userdata, uint32_t p_index);
+	static void _prefetch_batch(AnimationProcessCallback p_callback, double p_delta, uint64_t p_frame);
+	void _process_batched(AnimationProcessCallback p_callback, double p_delta);
+
 	List<StringName> queued;
 
 	bool end_reached = false;
@@ -218,6 +242,8 @@ private:
 	void _animation_process_animation(AnimationData *p_anim, double p_time, double p_delta, float p_interp, bool p_is_current = true, bool p_seeked = false, bool p_started = false);
 
 	void _ensure_node_caches(AnimationData *p_anim, Node *p_root_override = nullptr);
+	void _sample_transform_tracks(AnimationData *p_anim, double p_time, bool p_compressed_only);
+	double _get_next_pos(const PlaybackData &cd, double p_delta) const;
 	void _animation_process_data(PlaybackData &cd, double p_delta, float p_blend, bool p_seeked, bool p_started);
 	void _animation_process2(double p_delta, bool p_started);
 	void _animation_update_transforms();
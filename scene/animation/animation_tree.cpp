@@ -32,6 +32,7 @@
 
 #include "animation_blend_tree.h"
 #include "core/config/engine.h"
+#include "core/os/worker_thread_pool.h"
 #include "scene/scene_string_names.h"
 #include "servers/audio/audio_stream.h"
 
@@ -538,12 +539,18 @@ bool AnimationTree::_update_caches(AnimationPlayer *player) {
 	List<StringName> sname;
 	player->get_animation_list(&sname);
 
+	has_side_effect_tracks = false;
+
 	for (const StringName &E : sname) {
 		Ref<Animation> anim = player->get_animation(E);
 		for (int i = 0; i < anim->get_track_count(); i++) {
 			NodePath path = anim->track_get_path(i);
 			Animation::TrackType track_type = anim->track_get_type(i);
 
+			if (track_type == Animation::TYPE_METHOD || track_type == Animation::TYPE_ANIMATION || (track_type == Animation::TYPE_VALUE && anim->value_track_get_update_mode(i) != Animation::UPDATE_CONTINUOUS)) {
+				has_side_effect_tracks = true;
+			}
+
 			TrackCache *track = nullptr;
 			if (track_cache.has(path)) {
 				track = track_cache.get(path);
@@ -718,9 +725,13 @@ void AnimationTree::_clear_caches() {
 
 	track_cache.clear();
 	cache_valid = false;
+
+	// A pending batch evaluation refers to the deleted caches, drop it.
+	deferred_tracks.clear();
+	batch_valid = false;
 }
 
-void AnimationTree::_process_graph(real_t p_delta) {
+bool AnimationTree::_process_graph_prepare() {
 	_update_properties(); //if properties need updating, update them
 
 	//check all tracks, see if they need modification
@@ -731,14 +742,14 @@ void AnimationTree::_process_graph(real_t p_delta) {
 		ERR_PRINT("AnimationTree: root AnimationNode is not set, disabling playback.");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!has_node(animation_player)) {
 		ERR_PRINT("AnimationTree: no valid AnimationPlayer path set, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	AnimationPlayer *player = Object::cast_to<AnimationPlayer>(get_node(animation_player));
@@ -768,15 +779,20 @@ void AnimationTree::_process_graph(real_t p_delta) {
 		ERR_PRINT("AnimationTree: path points to a node not an AnimationPlayer, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!cache_valid) {
 		if (!_update_caches(player)) {
-			return;
+			return false;
 		}
 	}
 
+	state.player = player;
+	return true;
+}
+
+bool AnimationTree::_process_graph_evaluate(real_t p_delta) {
 	{ //setup
 
 		process_pass++;
@@ -785,7 +801,6 @@ void AnimationTree::_process_graph(real_t p_delta) {
 		state.invalid_reasons = "";
 		state.animation_states.clear(); //will need to be re-created
 		state.valid = true;
-		state.player = player;
 		state.last_pass = process_pass;
 		state.tree = this;
 
@@ -811,19 +826,19 @@ void AnimationTree::_process_graph(real_t p_delta) {
 	}
 
 	if (!state.valid) {
-		return; //state is not valid. do nothing.
+		return false; //state is not valid. do nothing.
 	}
-	//apply value/transform/bezier blends to track caches and execute method/audio/animation tracks
 
-	{
-		bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
+	//apply value/transform/bezier blends to track caches, discrete value/method/audio/animation tracks are deferred to the commit
+
+	deferred_tracks.clear();
 
+	{
 		for (const AnimationNode::AnimationState &as : state.animation_states) {
 			Ref<Animation> a = as.animation;
 			double time = as.time;
 			double delta = as.delta;
 			real_t weight = as.blend;
-			bool seeked = as.seeked;
 
 			for (int i = 0; i < a->get_track_count(); i++) {
 				NodePath path = a->track_get_path(i);
@@ -959,46 +974,7 @@ void AnimationTree::_process_graph(real_t p_delta) {
 							Variant::interpolate(t->value, value, blend, t->value);
 
 						} else if (delta != 0) {
-							List<int> indices;
-							a->value_track_get_key_indices(i, time, delta, &indices);
-
-							for (int &F : indices) {
-								Variant value = a->track_get_key_value(i, F);
-								t->object->set_indexed(t->subpath, value);
-							}
-						}
-
-					} break;
-					case Animation::TYPE_METHOD: {
-						if (delta == 0) {
-							continue;
-						}
-						TrackCacheMethod *t = static_cast<TrackCacheMethod *>(track);
-
-						List<int> indices;
-
-						a->method_track_get_key_indices(i, time, delta, &indices);
-
-						for (int &F : indices) {
-							StringName method = a->method_track_get_name(i, F);
-							Vector<Variant> params = a->method_track_get_params(i, F);
-
-							int s = params.size();
-
-							static_assert(VARIANT_ARG_MAX == 8, "This code needs to be updated if VARIANT_ARG_MAX != 8");
-							ERR_CONTINUE(s > VARIANT_ARG_MAX);
-							if (can_call) {
-								t->object->call_deferred(
-										method,
-										s >= 1 ? params[0] : Variant(),
-										s >= 2 ? params[1] : Variant(),
-										s >= 3 ? params[2] : Variant(),
-										s >= 4 ? params[3] : Variant(),
-										s >= 5 ? params[4] : Variant(),
-										s >= 6 ? params[5] : Variant(),
-										s >= 7 ? params[6] : Variant(),
-										s >= 8 ? params[7] : Variant());
-							}
+							deferred_tracks.push_back({ &as, i, blend, track });
 						}
 
 					} break;
@@ -1015,16 +991,131 @@ void AnimationTree::_process_graph(real_t p_delta) {
 						t->value = Math::lerp(t->value, bezier, blend);
 
 					} break;
-					case Animation::TYPE_AUDIO: {
-						TrackCacheAudio *t = static_cast<TrackCacheAudio *>(track);
+					case Animation::TYPE_METHOD:
+					case Animation::TYPE_AUDIO:
+					case Animation::TYPE_ANIMATION: {
+						// These have side effects on other nodes, run them when committing.
+						deferred_tracks.push_back({ &as, i, blend, track });
+					} break;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void AnimationTree::_process_graph_commit() {
+	//execute the discrete value/method/audio/animation tracks collected while evaluating
+
+	{
+		bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
+
+		for (uint32_t j = 0; j < deferred_tracks.size(); j++) {
+			const DeferredTrack &dt = deferred_tracks[j];
+			const AnimationNode::AnimationState &as = *dt.animation_state;
+			Ref<Animation> a = as.animation;
+			double time = as.time;
+			double delta = as.delta;
+			bool seeked = as.seeked;
+			int i = dt.track;
+			real_t blend = dt.blend;
+			TrackCache *track = dt.cache;
+
+			switch (track->type) {
+				case Animation::TYPE_VALUE: {
+					TrackCacheValue *t = static_cast<TrackCacheValue *>(track);
 
-						if (seeked) {
-							//find whatever should be playing
-							int idx = a->track_find_key(i, time);
-							if (idx < 0) {
+					List<int> indices;
+					a->value_track_get_key_indices(i, time, delta, &indices);
+
+					for (int &F : indices) {
+						Variant value = a->track_get_key_value(i, F);
+						t->object->set_indexed(t->subpath, value);
+					}
+				} break;
+				case Animation::TYPE_METHOD: {
+					if (delta == 0) {
+						continue;
+					}
+					TrackCacheMethod *t = static_cast<TrackCacheMethod *>(track);
+
+					List<int> indices;
+
+					a->method_track_get_key_indices(i, time, delta, &indices);
+
+					for (int &F : indices) {
+						StringName method = a->method_track_get_name(i, F);
+						Vector<Variant> params = a->method_track_get_params(i, F);
+
+						int s = params.size();
+
+						static_assert(VARIANT_ARG_MAX == 8, "This code needs to be updated if VARIANT_ARG_MAX != 8");
+						ERR_CONTINUE(s > VARIANT_ARG_MAX);
+						if (can_call) {
+							t->object->call_deferred(
+									method,
+									s >= 1 ? params[0] : Variant(),
+									s >= 2 ? params[1] : Variant(),
+									s >= 3 ? params[2] : Variant(),
+									s >= 4 ? params[3] : Variant(),
+									s >= 5 ? params[4] : Variant(),
+									s >= 6 ? params[5] : Variant(),
+									s >= 7 ? params[6] : Variant(),
+									s >= 8 ? params[7] : Variant());
+						}
+					}
+
+				} break;
+				case Animation::TYPE_AUDIO: {
+					TrackCacheAudio *t = static_cast<TrackCacheAudio *>(track);
+
+					if (seeked) {
+						//find whatever should be playing
+						int idx = a->track_find_key(i, time);
+						if (idx < 0) {
+							continue;
+						}
+
+						Ref<AudioStream> stream = a->audio_track_get_key_stream(i, idx);
+						if (!stream.is_valid()) {
+							t->object->call("stop");
+							t->playing = false;
+							playing_caches.erase(t);
+						} else {
+							real_t start_ofs = a->audio_track_get_key_start_offset(i, idx);
+							start_ofs += time - a->track_get_key_time(i, idx);
+							real_t end_ofs = a->audio_track_get_key_end_offset(i, idx);
+							real_t len = stream->get_length();
+
+							if (start_ofs > len - end_ofs) {
+								t->object->call("stop");
+								t->playing = false;
+								playing_caches.erase(t);
 								continue;
 							}
 
+							t->object->call("set_stream", stream);
+							t->object->call("play", start_ofs);
+
+							t->playing = true;
+							playing_caches.insert(t);
+							if (len && end_ofs > 0) { //force an end at a time
+								t->len = len - start_ofs - end_ofs;
+							} else {
+								t->len = 0;
+							}
+
+							t->start = time;
+						}
+
+					} else {
+						//find stuff to play
+						List<int> to_play;
+						a->track_get_key_indices_in_range(i, time, delta, &to_play);
+						if (to_play.size()) {
+							int idx = to_play.back()->get();
+
 							Ref<AudioStream> stream = a->audio_track_get_key_stream(i, idx);
 							if (!stream.is_valid()) {
 								t->object->call("stop");
@@ -1032,17 +1123,9 @@ void AnimationTree::_process_graph(real_t p_delta) {
 								playing_caches.erase(t);
 							} else {
 								real_t start_ofs = a->audio_track_get_key_start_offset(i, idx);
-								start_ofs += time - a->track_get_key_time(i, idx);
 								real_t end_ofs = a->audio_track_get_key_end_offset(i, idx);
 								real_t len = stream->get_length();
 
-								if (start_ofs > len - end_ofs) {
-									t->object->call("stop");
-									t->playing = false;
-									playing_caches.erase(t);
-									continue;
-								}
-
 								t->object->call("set_stream", stream);
 								t->object->call("play", start_ofs);
 
@@ -1056,136 +1139,108 @@ void AnimationTree::_process_graph(real_t p_delta) {
 
 								t->start = time;
 							}
+						} else if (t->playing) {
+							bool loop = a->has_loop();
 
-						} else {
-							//find stuff to play
-							List<int> to_play;
-							a->track_get_key_indices_in_range(i, time, delta, &to_play);
-							if (to_play.size()) {
-								int idx = to_play.back()->get();
-
-								Ref<AudioStream> stream = a->audio_track_get_key_stream(i, idx);
-								if (!stream.is_valid()) {
-									t->object->call("stop");
-									t->playing = false;
-									playing_caches.erase(t);
-								} else {
-									real_t start_ofs = a->audio_track_get_key_start_offset(i, idx);
-									real_t end_ofs = a->audio_track_get_key_end_offset(i, idx);
-									real_t len = stream->get_length();
-
-									t->object->call("set_stream", stream);
-									t->object->call("play", start_ofs);
-
-									t->playing = true;
-									playing_caches.insert(t);
-									if (len && end_ofs > 0) { //force an end at a time
-										t->len = len - start_ofs - end_ofs;
-									} else {
-										t->len = 0;
-									}
-
-									t->start = time;
-								}
-							} else if (t->playing) {
-								bool loop = a->has_loop();
+							bool stop = false;
 
-								bool stop = false;
+							if (!loop && time < t->start) {
+								stop = true;
+							} else if (t->len > 0) {
+								real_t len = t->start > time ? (a->get_length() - t->start) + time : time - t->start;
 
-								if (!loop && time < t->start) {
+								if (len > t->len) {
 									stop = true;
-								} else if (t->len > 0) {
-									real_t len = t->start > time ? (a->get_length() - t->start) + time : time - t->start;
-
-									if (len > t->len) {
-										stop = true;
-									}
 								}
+							}
 
-								if (stop) {
-									//time to stop
-									t->object->call("stop");
-									t->playing = false;
-									playing_caches.erase(t);
-								}
+							if (stop) {
+								//time to stop
+								t->object->call("stop");
+								t->playing = false;
+								playing_caches.erase(t);
 							}
 						}
+					}
 
-						real_t db = Math::linear2db(MAX(blend, 0.00001));
-						if (t->object->has_method("set_unit_db")) {
-							t->object->call("set_unit_db", db);
-						} else {
-							t->object->call("set_volume_db", db);
-						}
-					} break;
-					case Animation::TYPE_ANIMATION: {
-						TrackCacheAnimation *t = static_cast<TrackCacheAnimation *>(track);
+					real_t db = Math::linear2db(MAX(blend, 0.00001));
+					if (t->object->has_method("set_unit_db")) {
+						t->object->call("set_unit_db", db);
+					} else {
+						t->object->call("set_volume_db", db);
+					}
+				} break;
+				case Animation::TYPE_ANIMATION: {
+					TrackCacheAnimation *t = static_cast<TrackCacheAnimation *>(track);
 
-						AnimationPlayer *player2 = Object::cast_to<AnimationPlayer>(t->object);
+					AnimationPlayer *player2 = Object::cast_to<AnimationPlayer>(t->object);
 
-						if (!player2) {
+					if (!player2) {
+						continue;
+					}
+
+					if (delta == 0 || seeked) {
+						//seek
+						int idx = a->track_find_key(i, time);
+						if (idx < 0) {
 							continue;
 						}
 
-						if (delta == 0 || seeked) {
-							//seek
-							int idx = a->track_find_key(i, time);
-							if (idx < 0) {
-								continue;
-							}
+						double pos = a->track_get_key_time(i, idx);
 
-							double pos = a->track_get_key_time(i, idx);
+						StringName anim_name = a->animation_track_get_key_animation(i, idx);
+						if (String(anim_name) == "[stop]" || !player2->has_animation(anim_name)) {
+							continue;
+						}
 
-							StringName anim_name = a->animation_track_get_key_animation(i, idx);
-							if (String(anim_name) == "[stop]" || !player2->has_animation(anim_name)) {
-								continue;
-							}
+						Ref<Animation> anim = player2->get_animation(anim_name);
 
-							Ref<Animation> anim = player2->get_animation(anim_name);
+						real_t at_anim_pos;
 
-							real_t at_anim_pos;
+						if (anim->has_loop()) {
+							at_anim_pos = Math::fposmod(time - pos, (double)anim->get_length()); //seek to loop
+						} else {
+							at_anim_pos = MAX(anim->get_length(), time - pos); //seek to end
+						}
 
-							if (anim->has_loop()) {
-								at_anim_pos = Math::fposmod(time - pos, (double)anim->get_length()); //seek to loop
-							} else {
-								at_anim_pos = MAX(anim->get_length(), time - pos); //seek to end
-							}
+						if (player2->is_playing() || seeked) {
+							player2->play(anim_name);
+							player2->seek(at_anim_pos);
+							t->playing = true;
+							playing_caches.insert(t);
+						} else {
+							player2->set_assigned_animation(anim_name);
+							player2->seek(at_anim_pos, true);
+						}
+					} else {
+						//find stuff to play
+						List<int> to_play;
+						a->track_get_key_indices_in_range(i, time, delta, &to_play);
+						if (to_play.size()) {
+							int idx = to_play.back()->get();
 
-							if (player2->is_playing() || seeked) {
+							StringName anim_name = a->animation_track_get_key_animation(i, idx);
+							if (String(anim_name) == "[stop]" || !player2->has_animation(anim_name)) {
+								if (playing_caches.has(t)) {
+									playing_caches.erase(t);
+									player2->stop();
+									t->playing = false;
+								}
+							} else {
 								player2->play(anim_name);
-								player2->seek(at_anim_pos);
 								t->playing = true;
 								playing_caches.insert(t);
-							} else {
-								player2->set_assigned_animation(anim_name);
-								player2->seek(at_anim_pos, true);
-							}
-						} else {
-							//find stuff to play
-							List<int> to_play;
-							a->track_get_key_indices_in_range(i, time, delta, &to_play);
-							if (to_play.size()) {
-								int idx = to_play.back()->get();
-
-								StringName anim_name = a->animation_track_get_key_animation(i, idx);
-								if (String(anim_name) == "[stop]" || !player2->has_animation(anim_name)) {
-									if (playing_caches.has(t)) {
-										playing_caches.erase(t);
-										player2->stop();
-										t->playing = false;
-									}
-								} else {
-									player2->play(anim_name);
-									t->playing = true;
-									playing_caches.insert(t);
-								}
 							}
 						}
+					}
 
-					} break;
-				}
+				} break;
+				default: {
+				} //the rest were blended when evaluating
 			}
 		}
+
+		deferred_tracks.clear();
 	}
 
 	{
@@ -1240,20 +1295,173 @@ void AnimationTree::_process_graph(real_t p_delta) {
 	}
 }
 
+void AnimationTree::_process_graph(real_t p_delta) {
+	if (!_process_graph_prepare()) {
+		return;
+	}
+
+	if (!_process_graph_evaluate(p_delta)) {
+		return;
+	}
+
+	_process_graph_commit();
+}
+
+void AnimationTree::_evaluate_batch_group(void *p_userdata, uint32_t p_index) {
+	BatchEvaluation *batch = (BatchEvaluation *)p_userdata;
+	const LocalVector<AnimationTree *> &group = batch->groups[p_index];
+	for (uint32_t i = 0; i < group.size(); i++) {
+		AnimationTree *tree = group[i];
+		tree->batch_valid = tree->_process_graph_evaluate(batch->delta);
+		tree->batch_evaluated_frame = batch->frame;
+	}
+}
+
+void AnimationTree::_evaluate_batch(AnimationProcessCallback p_callback, real_t p_delta, uint64_t p_frame) {
+	// Trees left to process in this frame, in the order the SceneTree processes them.
+	LocalVector<AnimationTree *> pending;
+
+	for (SelfList<AnimationTree> *E = process_batch.first(); E; E = E->next()) {
+		AnimationTree *tree = E->self();
+		if (tree->processed_frame == p_frame) {
+			continue; // Already processed.
+		}
+
+		if (!tree->active || tree->process_callback != p_callback || !tree->can_process() || tree->is_processing_in_sub_thread()) {
+			continue;
+		}
+
+		pending.push_back(tree);
+	}
+
+	pending.sort_custom<Node::ComparatorWithPriority>();
+
+	// The batch starts at this tree, and ends before the first tree whose commit may change how the
+	// trees after it evaluate (scripted nodes, discrete values, methods, animations). That tree is then
+	// processed serially, and starts the next batch.
+	LocalVector<AnimationTree *> trees;
+	bool started = false;
+
+	for (uint32_t i = 0; i < pending.size(); i++) {
+		AnimationTree *tree = pending[i];
+		if (!started) {
+			if (tree != this) {
+				continue; // Not processed this frame.
+			}
+			started = true;
+		}
+
+		if (!tree->_process_graph_prepare()) {
+			// Nothing to commit, and errors were already reported.
+			tree->batch_evaluated_frame = p_frame;
+			tree->batch_valid = false;
+			continue;
+		}
+
+		if (tree->graph_has_scripts || tree->has_side_effect_tracks) {
+			break;
+		}
+
+		trees.push_back(tree);
+	}
+
+	if (trees.size() < 2) {
+		return; // Not worth it, process as usual.
+	}
+
+	// Trees sharing AnimationNode resources go in the same group, evaluated in sequence.
+	LocalVector<uint32_t> parent;
+	parent.resize(trees.size());
+	HashMap<ObjectID, uint32_t> node_owner;
+
+	auto find_root = [&parent](uint32_t p_index) {
+		while (parent[p_index] != p_index) {
+			parent[p_index] = parent[parent[p_index]];
+			p_index = parent[p_index];
+		}
+		return p_index;
+	};
+
+	for (uint32_t i = 0; i < trees.size(); i++) {
+		parent[i] = i;
+		const LocalVector<ObjectID> &nodes = trees[i]->graph_nodes;
+		for (uint32_t j = 0; j < nodes.size(); j++) {
+			const uint32_t *owner = node_owner.getptr(nodes[j]);
+			if (owner) {
+				parent[find_root(i)] = find_root(*owner);
+			} else {
+				node_owner[nodes[j]] = i;
+			}
+		}
+	}
+
+	BatchEvaluation batch;
+	batch.delta = p_delta;
+	batch.frame = p_frame;
+
+	LocalVector<int> root_group;
+	root_group.resize(trees.size());
+	for (uint32_t i = 0; i < trees.size(); i++) {
+		root_group[i] = -1;
+	}
+
+	for (uint32_t i = 0; i < trees.size(); i++) {
+		uint32_t root_index = find_root(i);
+		if (root_group[root_index] == -1) {
+			root_group[root_index] = batch.groups.size();
+			batch.groups.push_back(LocalVector<AnimationTree *>());
+		}
+		batch.groups[root_group[root_index]].push_back(trees[i]);
+	}
+
+	if (batch.groups.size() < 2) {
+		return; // Everything shares the same graph, no parallelism to gain.
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&AnimationTree::_evaluate_batch_group, &batch, batch.groups.size());
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
+void AnimationTree::_process_batched(AnimationProcessCallback p_callback, real_t p_delta) {
+	if (is_processing_in_sub_thread() || !get_tree()->is_parallel_animation_evaluation_enabled()) {
+		_process_graph(p_delta);
+		return;
+	}
+
+	uint64_t frame = p_callback == ANIMATION_PROCESS_PHYSICS ? Engine::get_singleton()->get_physics_frames() : Engine::get_singleton()->get_process_frames();
+	if (batch_evaluated_frame != frame) {
+		// Not part of a batch evaluated earlier in this frame, start a new one.
+		_evaluate_batch(p_callback, p_delta, frame);
+	}
+	processed_frame = frame;
+
+	if (batch_evaluated_frame == frame) {
+		batch_evaluated_frame = UINT64_MAX;
+		if (batch_valid) {
+			_process_graph_commit();
+		}
+		return;
+	}
+
+	_process_graph(p_delta);
+}
+
 void AnimationTree::advance(real_t p_time) {
 	_process_graph(p_time);
 }
 
 void AnimationTree::_notification(int p_what) {
 	if (active && p_what == NOTIFICATION_INTERNAL_PHYSICS_PROCESS && process_callback == ANIMATION_PROCESS_PHYSICS) {
-		_process_graph(get_physics_process_delta_time());
+		_process_batched(ANIMATION_PROCESS_PHYSICS, get_physics_process_delta_time());
 	}
 
 	if (active && p_what == NOTIFICATION_INTERNAL_PROCESS && process_callback == ANIMATION_PROCESS_IDLE) {
-		_process_graph(get_process_delta_time());
+		_process_batched(ANIMATION_PROCESS_IDLE, get_process_delta_time());
 	}
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
+		process_batch.remove(&process_batch_element);
+		batch_evaluated_frame = UINT64_MAX;
 		_clear_caches();
 		if (last_animation_player.is_valid()) {
 			Object *player = ObjectDB::get_instance(last_animation_player);
@@ -1262,6 +1470,7 @@ void AnimationTree::_notification(int p_what) {
 			}
 		}
 	} else if (p_what == NOTIFICATION_ENTER_TREE) {
+		process_batch.add(&process_batch_element);
 		if (last_animation_player.is_valid()) {
 			Object *player = ObjectDB::get_instance(last_animation_player);
 			if (player) {
@@ -1337,6 +1546,12 @@ void AnimationTree::_tree_changed() {
 
 void AnimationTree::_update_properties_for_node(const String &p_base_path, Ref<AnimationNode> node) {
 	ERR_FAIL_COND(node.is_null());
+
+	graph_nodes.push_back(node->get_instance_id());
+	if (node->get_script_instance()) {
+		graph_has_scripts = true; // Scripts may do anything while processing, keep these trees out of the batch.
+	}
+
 	if (!property_parent_map.has(p_base_path)) {
 		property_parent_map[p_base_path] = HashMap<StringName, StringName>();
 	}
@@ -1385,6 +1600,8 @@ void AnimationTree::_update_properties() {
 	property_parent_map.clear();
 	input_activity_map.clear();
 	input_activity_map_get.clear();
+	graph_nodes.clear();
+	graph_has_scripts = false;
 
 	if (root.is_valid()) {
 		_update_properties_for_node(SceneStringNames::get_singleton()->parameters_base_path, root);
@@ -1498,7 +1715,10 @@ void AnimationTree::_bind_methods() {
 	BIND_ENUM_CONSTANT(ANIMATION_PROCESS_MANUAL);
 }
 
-AnimationTree::AnimationTree() {
+SelfList<AnimationTree>::List AnimationTree::process_batch;
+
+AnimationTree::AnimationTree() :
+		process_batch_element(this) {
 }
 
 AnimationTree::~AnimationTree() {
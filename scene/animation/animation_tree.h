@@ -32,6 +32,8 @@
 #define ANIMATION_GRAPH_PLAYER_H
 
 #include "animation_player.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/self_list.h"
 #include "scene/3d/node_3d.h"
 #include "scene/3d/skeleton_3d.h"
 #include "scene/resources/animation.h"
@@ -259,8 +261,46 @@ private:
 
 	void _clear_caches();
 	bool _update_caches(AnimationPlayer *player);
+
+	// Tracks that affect other nodes when applied (discrete values, methods,
+	// audio, animations), collected while evaluating and run when committing.
+	struct DeferredTrack {
+		const AnimationNode::AnimationState *animation_state = nullptr;
+		int track = 0;
+		real_t blend = 0.0;
+		TrackCache *cache = nullptr;
+	};
+
+	LocalVector<DeferredTrack> deferred_tracks;
+
+	// Processing is split in three steps: preparing checks the setup and builds caches (main thread),
+	// evaluating runs the graph and blends into the track caches without touching other nodes (any thread),
+	// committing writes the result to the scene (main thread).
+	bool _process_graph_prepare();
+	bool _process_graph_evaluate(real_t p_delta);
+	void _process_graph_commit();
 	void _process_graph(real_t p_delta);
 
+	// Trees processed by the engine are evaluated together in parallel when the first
+	// of them is notified in a frame, then each commits in its own notification.
+	struct BatchEvaluation {
+		LocalVector<LocalVector<AnimationTree *>> groups;
+		real_t delta = 0.0;
+		uint64_t frame = 0;
+	};
+
+	SelfList<AnimationTree> process_batch_element;
+	uint64_t batch_evaluated_frame = UINT64_MAX; // Frame the result waiting to be committed was evaluated for.
+	bool batch_valid = false;
+	uint64_t processed_frame = UINT64_MAX;
+	bool has_side_effect_tracks = false; // Discrete value, method or animation tracks, which end a batch.
+
+	static SelfList<AnimationTree>::List process_batch;
+
+	static void _evaluate_batch_group(void *p_userdata, uint32_t p_index);
+	void _evaluate_batch(AnimationProcessCallback p_callback, real_t p_delta, uint64_t p_frame);
+	void _process_batched(AnimationProcessCallback p_callback, real_t p_delta);
+
 	uint64_t setup_pass = 1;
 	uint64_t process_pass = 1;
 
@@ -285,6 +325,11 @@ private:
 	HashMap<StringName, Vector<Activity>> input_activity_map;
 	HashMap<StringName, Vector<Activity> *> input_activity_map_get;
 
+	// AnimationNode resources keep transient state while processing, so trees sharing any of them
+	// can't be evaluated at the same time.
+	LocalVector<ObjectID> graph_nodes;
+	bool graph_has_scripts = false;
+
 	void _update_properties_for_node(const String &p_base_path, Ref<AnimationNode> node);
 
 	ObjectID last_animation_player;
@@ -39,7 +39,9 @@
 #include "core/object/message_queue.h"
 #include "core/os/keyboard.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/string/print_string.h"
+#include "core/templates/hash_map.h"
 #include "node.h"
 #include "scene/animation/tween.h"
 #include "scene/debugger/scene_debugger.h"
@@ -406,6 +408,8 @@ void SceneTree::initialize() {
 bool SceneTree::physics_process(double p_time) {
 	root_lock++;
 
+	parallel_animation_evaluation = GLOBAL_GET("animation/processing/parallel_evaluation");
+
 	current_frame++;
 
 	flush_transform_notifications();
@@ -435,6 +439,8 @@ bool SceneTree::physics_process(double p_time) {
 bool SceneTree::process(double p_time) {
 	root_lock++;
 
+	parallel_animation_evaluation = GLOBAL_GET("animation/processing/parallel_evaluation");
+
 	MainLoop::process(p_time);
 
 	process_time = p_time;
@@ -835,9 +841,112 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 
 	call_lock++;
 
+	bool has_sub_threads = false;
 	for (int i = 0; i < node_count; i++) {
+		if (nodes[i]->data.process_thread_group_owner) {
+			has_sub_threads = true;
+			break;
+		}
+	}
+
+	if (has_sub_threads) {
+		_notify_group_pause_threaded(nodes, node_count, p_notification);
+	} else {
+		for (int i = 0; i < node_count; i++) {
+			Node *n = nodes[i];
+			if (call_lock && call_skip.has(n)) {
+				continue;
+			}
+
+			if (!n->can_process()) {
+				continue;
+			}
+			if (!n->can_process_notification(p_notification)) {
+				continue;
+			}
+
+			n->notification(p_notification);
+			//ERR_FAIL_COND(node_count != g.nodes.size());
+		}
+	}
+
+	call_lock--;
+	if (call_lock == 0) {
+		call_skip.clear();
+	}
+}
+
+void SceneTree::_process_thread_group(uint32_t p_index, int p_notification) {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	int thread_index = pool->get_thread_index();
+	// The main thread helps while waiting for the groups, it uses the last queue.
+	uint32_t queue_index = thread_index < 0 ? pool->get_thread_count() : thread_index;
+	MessageQueue *queue = process_thread_queues[queue_index];
+	if (!queue) {
+		// Only this thread uses this slot, so the queue can be created here, the first time the thread runs a group.
+		queue = memnew(MessageQueue(process_thread_queue_size_kb));
+		process_thread_queues[queue_index] = queue;
+	}
+
+	// Deferred calls made while processing are collected per thread and flushed on the main thread afterwards.
+	MessageQueue *prev_queue = MessageQueue::set_thread_singleton_override(queue);
+
+	const LocalVector<Node *> &nodes = process_thread_groups[p_index].nodes;
+	for (uint32_t i = 0; i < nodes.size(); i++) {
 		Node *n = nodes[i];
-		if (call_lock && call_skip.has(n)) {
+		if (!n->can_process()) {
+			continue;
+		}
+		if (!n->can_process_notification(p_notification)) {
+			continue;
+		}
+
+		n->notification(p_notification);
+	}
+
+	MessageQueue::set_thread_singleton_override(prev_queue);
+}
+
+void SceneTree::_process_thread_phase(Node **p_nodes, int p_node_count, int p_notification) {
+	// Split the nodes by thread group, keeping the processing order within each group.
+	HashMap<ObjectID, uint32_t> group_indices;
+	uint32_t group_count = 0;
+	process_main_thread_nodes.clear();
+
+	for (int i = 0; i < p_node_count; i++) {
+		Node *n = p_nodes[i];
+		if (call_skip.has(n)) {
+			continue;
+		}
+
+		Node *owner = n->data.process_thread_group_owner;
+		if (!owner) {
+			process_main_thread_nodes.push_back(n);
+			continue;
+		}
+
+		uint32_t *index = group_indices.getptr(owner->get_instance_id());
+		if (!index) {
+			if (group_count == process_thread_groups.size()) {
+				process_thread_groups.push_back(ProcessThreadGroup());
+			}
+			process_thread_groups[group_count].nodes.clear();
+			group_indices.set(owner->get_instance_id(), group_count);
+			index = group_indices.getptr(owner->get_instance_id());
+			group_count++;
+		}
+		process_thread_groups[*index].nodes.push_back(n);
+	}
+
+	// Sub-thread groups run in parallel. The tree must not be modified meanwhile, so this waits before
+	// processing the main thread nodes.
+	if (group_count > 0) {
+		WorkerThreadPool::get_singleton()->do_work(group_count, this, &SceneTree::_process_thread_group, p_notification);
+	}
+
+	for (uint32_t i = 0; i < process_main_thread_nodes.size(); i++) {
+		Node *n = process_main_thread_nodes[i];
+		if (call_skip.has(n)) {
 			continue;
 		}
 
@@ -849,12 +958,37 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 		}
 
 		n->notification(p_notification);
-		//ERR_FAIL_COND(node_count != g.nodes.size());
 	}
+}
 
-	call_lock--;
-	if (call_lock == 0) {
-		call_skip.clear();
+void SceneTree::_notify_group_pause_threaded(Node **p_nodes, int p_node_count, int p_notification) {
+	if (process_thread_queues.is_empty()) {
+		// One slot per worker thread, plus one for the main thread. Queues are created by _process_thread_group().
+		process_thread_queues.resize(WorkerThreadPool::get_singleton()->get_thread_count() + 1);
+		for (uint32_t i = 0; i < process_thread_queues.size(); i++) {
+			process_thread_queues[i] = nullptr;
+		}
+		process_thread_queue_size_kb = GLOBAL_GET("memory/limits/message_queue/max_size_kb");
+	}
+
+	// The nodes are sorted by process priority. Nodes sharing the same priority form a phase, and phases run
+	// one after the other, so process_priority orders nodes across thread groups too.
+	int from = 0;
+	while (from < p_node_count) {
+		int priority = p_nodes[from]->data.process_priority;
+		int to = from + 1;
+		while (to < p_node_count && p_nodes[to]->data.process_priority == priority) {
+			to++;
+		}
+
+		_process_thread_phase(p_nodes + from, to - from, p_notification);
+		from = to;
+	}
+
+	for (uint32_t i = 0; i < process_thread_queues.size(); i++) {
+		if (process_thread_queues[i]) {
+			process_thread_queues[i]->flush();
+		}
 	}
 }
 
@@ -1322,6 +1456,7 @@ SceneTree::SceneTree() {
 	debug_navigation_color = GLOBAL_DEF("debug/shapes/navigation/geometry_color", Color(0.1, 1.0, 0.7, 0.4));
 	debug_navigation_disabled_color = GLOBAL_DEF("debug/shapes/navigation/disabled_geometry_color", Color(1.0, 0.7, 0.1, 0.4));
 	collision_debug_contacts = GLOBAL_DEF("debug/shapes/collision/max_contacts_displayed", 10000);
+	parallel_animation_evaluation = GLOBAL_DEF("animation/processing/parallel_evaluation", true);
 	ProjectSettings::get_singleton()->set_custom_property_info("debug/shapes/collision/max_contacts_displayed", PropertyInfo(Variant::INT, "debug/shapes/collision/max_contacts_displayed", PROPERTY_HINT_RANGE, "0,20000,1")); // No negative
 
 	GLOBAL_DEF("debug/shapes/collision/draw_2d_outlines", true);
@@ -1449,6 +1584,12 @@ SceneTree::~SceneTree() {
 		memdelete(root);
 	}
 
+	for (uint32_t i = 0; i < process_thread_queues.size(); i++) {
+		if (process_thread_queues[i]) {
+			memdelete(process_thread_queues[i]);
+		}
+	}
+
 	if (singleton == this) {
 		singleton = nullptr;
 	}
@@ -34,6 +34,7 @@
 #include "core/multiplayer/multiplayer_api.h"
 #include "core/os/main_loop.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/self_list.h"
 #include "scene/resources/mesh.h"
 #include "scene/resources/world_2d.h"
@@ -41,6 +42,7 @@
 
 #undef Window
 
+class MessageQueue;
 class PackedScene;
 class Node;
 class Window;
@@ -129,6 +131,20 @@ private:
 	int call_lock = 0;
 	Set<Node *> call_skip; // Skip erased nodes.
 
+	// Nodes processed on worker threads, see Node::set_process_thread_group().
+	struct ProcessThreadGroup {
+		LocalVector<Node *> nodes;
+	};
+
+	LocalVector<ProcessThreadGroup> process_thread_groups; // Kept between frames to reuse memory.
+	LocalVector<Node *> process_main_thread_nodes;
+	LocalVector<MessageQueue *> process_thread_queues; // One per worker thread, plus one for the main thread.
+	uint32_t process_thread_queue_size_kb = 0; // Same as the global message queue.
+
+	void _process_thread_group(uint32_t p_index, int p_notification);
+	void _process_thread_phase(Node **p_nodes, int p_node_count, int p_notification);
+	void _notify_group_pause_threaded(Node **p_nodes, int p_node_count, int p_notification);
+
 	List<ObjectID> delete_queue;
 
 	Map<UGCall, Vector<Variant>> unique_group_calls;
@@ -163,6 +179,8 @@ private:
 	Ref<MultiplayerAPI> multiplayer;
 	bool multiplayer_poll = true;
 
+	bool parallel_animation_evaluation = true;
+
 	static SceneTree *singleton;
 	friend class Node;
 
@@ -339,6 +357,9 @@ public:
 	Ref<MultiplayerAPI> get_multiplayer() const;
 	void set_multiplayer_poll_enabled(bool p_enabled);
 	bool is_multiplayer_poll_enabled() const;
+
+	// "animation/processing/parallel_evaluation", read once per frame rather than by every animation node.
+	_FORCE_INLINE_ bool is_parallel_animation_evaluation_enabled() const { return parallel_animation_evaluation; }
 	void set_multiplayer(Ref<MultiplayerAPI> p_multiplayer);
 
 	static void add_idle_callback(IdleCallback p_callback);
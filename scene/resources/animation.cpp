@@ -33,6 +33,12 @@
 #include "core/math/geometry_3d.h"
 #include "scene/scene_string_names.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 	String name = p_name;
 
@@ -74,6 +80,15 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 			track_set_imported(track, p_value);
 		} else if (what == "enabled") {
 			track_set_enabled(track, p_value);
+		} else if (what == "compressed") {
+			ERR_FAIL_COND_V(track_get_type(track) != TYPE_TRANSFORM3D, false);
+			TransformTrack *tt = static_cast<TransformTrack *>(tracks[track]);
+			if (p_value) {
+				// Keys were reduced when first compressed, only quantize them again.
+				_transform_track_compress(tt);
+			} else {
+				_transform_track_decompress(tt);
+			}
 		} else if (what == "keys" || what == "key_values") {
 			if (track_get_type(track) == TYPE_TRANSFORM3D) {
 				TransformTrack *tt = static_cast<TransformTrack *>(tracks[track]);
@@ -84,6 +99,7 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 				const real_t *r = values.ptr();
 
 				int64_t count = vcount / TRANSFORM_TRACK_SIZE;
+				_transform_track_decompress(tt);
 				tt->transforms.resize(count);
 
 				for (int i = 0; i < count; i++) {
@@ -351,6 +367,8 @@ bool Animation::_get(const StringName &p_name, Variant &r_ret) const {
 			r_ret = track_is_imported(track);
 		} else if (what == "enabled") {
 			r_ret = track_is_enabled(track);
+		} else if (what == "compressed") {
+			r_ret = track_is_compressed(track);
 		} else if (what == "keys") {
 			if (track_get_type(track) == TYPE_TRANSFORM3D) {
 				Vector<real_t> keys;
@@ -578,6 +596,10 @@ void Animation::_get_property_list(List<PropertyInfo> *p_list) const {
 		p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/imported", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/enabled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::ARRAY, "tracks/" + itos(i) + "/keys", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
+		if (track_is_compressed(i)) {
+			// Listed after the keys, so they are quantized again when loaded.
+			p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/compressed", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
+		}
 	}
 }
 
@@ -780,16 +802,24 @@ Error Animation::transform_track_get_key(int p_track, int p_key, Vector3 *r_loc,
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM3D, ERR_INVALID_PARAMETER);
-	ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
+
+	TransformKey tk;
+	if (tt->compressed) {
+		ERR_FAIL_INDEX_V(p_key, (int)tt->compressed_keys.times.size(), ERR_INVALID_PARAMETER);
+		tk = _transform_track_get_compressed_key(tt, p_key).value;
+	} else {
+		ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
+		tk = tt->transforms[p_key].value;
+	}
 
 	if (r_loc) {
-		*r_loc = tt->transforms[p_key].value.loc;
+		*r_loc = tk.loc;
 	}
 	if (r_rot) {
-		*r_rot = tt->transforms[p_key].value.rot;
+		*r_rot = tk.rot;
 	}
 	if (r_scale) {
-		*r_scale = tt->transforms[p_key].value.scale;
+		*r_scale = tk.scale;
 	}
 
 	return OK;
@@ -808,6 +838,7 @@ int Animation::transform_track_insert_key(int p_track, double p_time, const Vect
 	tkey.value.rot = p_rot;
 	tkey.value.scale = p_scale;
 
+	_transform_track_decompress(tt);
 	int ret = _insert(p_time, tt->transforms, tkey);
 	emit_changed();
 	return ret;
@@ -826,6 +857,7 @@ void Animation::track_remove_key(int p_track, int p_idx) {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_idx, tt->transforms.size());
 			tt->transforms.remove(p_idx);
 
@@ -872,6 +904,17 @@ int Animation::track_find_key(int p_track, double p_time, bool p_exact) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				const LocalVector<float> &times = tt->compressed_keys.times;
+				int k = _find_compressed(times, p_time);
+				if (k < 0 || k >= (int)times.size()) {
+					return -1;
+				}
+				if (times[k] != p_time && p_exact) {
+					return -1;
+				}
+				return k;
+			}
 			int k = _find(tt->transforms, p_time);
 			if (k < 0 || k >= tt->transforms.size()) {
 				return -1;
@@ -1056,6 +1099,9 @@ int Animation::track_get_key_count(int p_track) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				return tt->compressed_keys.times.size();
+			}
 			return tt->transforms.size();
 		} break;
 		case TYPE_VALUE: {
@@ -1090,13 +1136,15 @@ Variant Animation::track_get_key_value(int p_track, int p_key_idx) const {
 
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
-			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), Variant());
+			Vector3 loc;
+			Quaternion rot;
+			Vector3 scale;
+			ERR_FAIL_COND_V(transform_track_get_key(p_track, p_key_idx, &loc, &rot, &scale) != OK, Variant());
 
 			Dictionary d;
-			d["location"] = tt->transforms[p_key_idx].value.loc;
-			d["rotation"] = tt->transforms[p_key_idx].value.rot;
-			d["scale"] = tt->transforms[p_key_idx].value.scale;
+			d["location"] = loc;
+			d["rotation"] = rot;
+			d["scale"] = scale;
 
 			return d;
 		} break;
@@ -1159,6 +1207,10 @@ double Animation::track_get_key_time(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, (int)tt->compressed_keys.times.size(), -1);
+				return tt->compressed_keys.times[p_key_idx];
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].time;
 		} break;
@@ -1204,6 +1256,7 @@ void Animation::track_set_key_time(int p_track, int p_key_idx, double p_time) {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			TKey<TransformKey> key = tt->transforms[p_key_idx];
 			key.time = p_time;
@@ -1268,6 +1321,11 @@ real_t Animation::track_get_key_transition(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				// Only tracks without easing are compressed.
+				ERR_FAIL_INDEX_V(p_key_idx, (int)tt->compressed_keys.times.size(), -1);
+				return 1.0;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].transition;
 		} break;
@@ -1304,6 +1362,7 @@ void Animation::track_set_key_value(int p_track, int p_key_idx, const Variant &p
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 
 			Dictionary d = p_value;
@@ -1387,6 +1446,7 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, real_t p_tr
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			tt->transforms.write[p_key_idx].transition = p_transition;
 		} break;
@@ -1736,9 +1796,32 @@ Error Animation::transform_track_interpolate(int p_track, double p_time, Vector3
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 
+	if (tt->compressed && tt->interpolation != INTERPOLATION_CUBIC) {
+		Error err = OK;
+		transform_track_interpolate_batch(&p_track, 1, p_time, r_loc, r_rot, r_scale, &err);
+		return err;
+	}
+
 	bool ok = false;
 
-	TransformKey tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	TransformKey tk;
+	if (tt->compressed) {
+		int idx = 0;
+		int next = 0;
+		real_t c = 0.0;
+		ok = _compressed_get_key_pair(tt, p_time, idx, next, c);
+		if (ok) {
+			if (idx == next) {
+				tk = _transform_track_get_compressed_key(tt, idx).value;
+			} else {
+				int pre = MAX(idx - 1, 0);
+				int post = MIN(next + 1, (int)tt->compressed_keys.times.size() - 1);
+				tk = _cubic_interpolate(_transform_track_get_compressed_key(tt, pre).value, _transform_track_get_compressed_key(tt, idx).value, _transform_track_get_compressed_key(tt, next).value, _transform_track_get_compressed_key(tt, post).value, c);
+			}
+		}
+	} else {
+		tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	}
 
 	if (!ok) {
 		return ERR_UNAVAILABLE;
@@ -1759,6 +1842,374 @@ Error Animation::transform_track_interpolate(int p_track, double p_time, Vector3
 	return OK;
 }
 
+// Flips the target rotations of p_count blends whose dot product with the source rotation is negative.
+static void _batch_fix_rotation_hemisphere(const float *p_from_x, const float *p_from_y, const float *p_from_z, const float *p_from_w, float *r_to_x, float *r_to_y, float *r_to_z, float *r_to_w, int p_count) {
+	int k = 0;
+
+#if defined(__SSE2__)
+	const __m128 sign_bit = _mm_set1_ps(-0.0f);
+	for (; k + 4 <= p_count; k += 4) {
+		__m128 to_x = _mm_loadu_ps(r_to_x + k);
+		__m128 to_y = _mm_loadu_ps(r_to_y + k);
+		__m128 to_z = _mm_loadu_ps(r_to_z + k);
+		__m128 to_w = _mm_loadu_ps(r_to_w + k);
+
+		__m128 dot = _mm_mul_ps(_mm_loadu_ps(p_from_x + k), to_x);
+		dot = _mm_add_ps(dot, _mm_mul_ps(_mm_loadu_ps(p_from_y + k), to_y));
+		dot = _mm_add_ps(dot, _mm_mul_ps(_mm_loadu_ps(p_from_z + k), to_z));
+		dot = _mm_add_ps(dot, _mm_mul_ps(_mm_loadu_ps(p_from_w + k), to_w));
+
+		__m128 flip = _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), sign_bit);
+		_mm_storeu_ps(r_to_x + k, _mm_xor_ps(to_x, flip));
+		_mm_storeu_ps(r_to_y + k, _mm_xor_ps(to_y, flip));
+		_mm_storeu_ps(r_to_z + k, _mm_xor_ps(to_z, flip));
+		_mm_storeu_ps(r_to_w + k, _mm_xor_ps(to_w, flip));
+	}
+#elif defined(__ARM_NEON)
+	const uint32x4_t sign_bit = vdupq_n_u32(0x80000000);
+	for (; k + 4 <= p_count; k += 4) {
+		float32x4_t to_x = vld1q_f32(r_to_x + k);
+		float32x4_t to_y = vld1q_f32(r_to_y + k);
+		float32x4_t to_z = vld1q_f32(r_to_z + k);
+		float32x4_t to_w = vld1q_f32(r_to_w + k);
+
+		float32x4_t dot = vmulq_f32(vld1q_f32(p_from_x + k), to_x);
+		dot = vaddq_f32(dot, vmulq_f32(vld1q_f32(p_from_y + k), to_y));
+		dot = vaddq_f32(dot, vmulq_f32(vld1q_f32(p_from_z + k), to_z));
+		dot = vaddq_f32(dot, vmulq_f32(vld1q_f32(p_from_w + k), to_w));
+
+		uint32x4_t flip = vandq_u32(vcltq_f32(dot, vdupq_n_f32(0.0f)), sign_bit);
+		vst1q_f32(r_to_x + k, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(to_x), flip)));
+		vst1q_f32(r_to_y + k, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(to_y), flip)));
+		vst1q_f32(r_to_z + k, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(to_z), flip)));
+		vst1q_f32(r_to_w + k, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(to_w), flip)));
+	}
+#endif
+
+	for (; k < p_count; k++) {
+		float dot = p_from_x[k] * r_to_x[k] + p_from_y[k] * r_to_y[k] + p_from_z[k] * r_to_z[k] + p_from_w[k] * r_to_w[k];
+		if (dot < 0.0f) {
+			r_to_x[k] = -r_to_x[k];
+			r_to_y[k] = -r_to_y[k];
+			r_to_z[k] = -r_to_z[k];
+			r_to_w[k] = -r_to_w[k];
+		}
+	}
+}
+
+// Linear blend of p_count values: r_from[k] += (p_to[k] - r_from[k]) * p_weight[k].
+static void _batch_blend(float *r_from, const float *p_to, const float *p_weight, int p_count) {
+	int k = 0;
+
+#if defined(__SSE2__)
+	for (; k + 4 <= p_count; k += 4) {
+		__m128 from = _mm_loadu_ps(r_from + k);
+		__m128 delta = _mm_sub_ps(_mm_loadu_ps(p_to + k), from);
+		_mm_storeu_ps(r_from + k, _mm_add_ps(from, _mm_mul_ps(delta, _mm_loadu_ps(p_weight + k))));
+	}
+#elif defined(__ARM_NEON)
+	for (; k + 4 <= p_count; k += 4) {
+		float32x4_t from = vld1q_f32(r_from + k);
+		float32x4_t delta = vsubq_f32(vld1q_f32(p_to + k), from);
+		vst1q_f32(r_from + k, vaddq_f32(from, vmulq_f32(delta, vld1q_f32(p_weight + k))));
+	}
+#endif
+
+	for (; k < p_count; k++) {
+		r_from[k] += (p_to[k] - r_from[k]) * p_weight[k];
+	}
+}
+
+void Animation::transform_track_interpolate_batch(const int *p_tracks, int p_track_count, double p_time, Vector3 *r_loc, Quaternion *r_rot, Vector3 *r_scale, Error *r_err) const {
+	typedef CompressedTransformKeys CK;
+
+	enum {
+		BATCH_SIZE = 64
+	};
+
+	// Components of the two keys to blend for each compressed track. Blending runs over
+	// these contiguous arrays, four tracks at a time with SSE2 or NEON.
+	float from[CK::COMPONENT_MAX][BATCH_SIZE];
+	float to[CK::COMPONENT_MAX][BATCH_SIZE];
+	float weight[BATCH_SIZE];
+	int slot[BATCH_SIZE];
+
+	for (int base = 0; base < p_track_count; base += BATCH_SIZE) {
+		int end = MIN(base + BATCH_SIZE, p_track_count);
+		int count = 0;
+
+		for (int i = base; i < end; i++) {
+			int track = p_tracks[i];
+			if (r_err) {
+				r_err[i] = ERR_INVALID_PARAMETER;
+			}
+			ERR_CONTINUE(track < 0 || track >= tracks.size());
+			const Track *t = tracks[track];
+			ERR_CONTINUE(t->type != TYPE_TRANSFORM3D);
+			const TransformTrack *tt = static_cast<const TransformTrack *>(t);
+
+			if (!tt->compressed || tt->interpolation == INTERPOLATION_CUBIC) {
+				Error err = transform_track_interpolate(track, p_time, r_loc ? &r_loc[i] : nullptr, r_rot ? &r_rot[i] : nullptr, r_scale ? &r_scale[i] : nullptr);
+				if (r_err) {
+					r_err[i] = err;
+				}
+				continue;
+			}
+
+			int idx = 0;
+			int next = 0;
+			real_t c = 0.0;
+			if (!_compressed_get_key_pair(tt, p_time, idx, next, c)) {
+				if (r_err) {
+					r_err[i] = ERR_UNAVAILABLE;
+				}
+				continue;
+			}
+			if (r_err) {
+				r_err[i] = OK;
+			}
+
+			const CK &ck = tt->compressed_keys;
+			for (int j = 0; j < CK::COMPONENT_MAX; j++) {
+				from[j][count] = ck.get_component(j, idx);
+				to[j][count] = ck.get_component(j, next);
+			}
+			weight[count] = tt->interpolation == INTERPOLATION_NEAREST ? 0.0 : c;
+			slot[count] = i;
+			count++;
+		}
+
+		// Rotations are kept on the same hemisphere when compressing, but keys blended
+		// across a loop may not be, take the shortest path.
+		_batch_fix_rotation_hemisphere(from[CK::ROT_X], from[CK::ROT_Y], from[CK::ROT_Z], from[CK::ROT_W], to[CK::ROT_X], to[CK::ROT_Y], to[CK::ROT_Z], to[CK::ROT_W], count);
+
+		for (int j = 0; j < CK::COMPONENT_MAX; j++) {
+			_batch_blend(from[j], to[j], weight, count);
+		}
+
+		for (int k = 0; k < count; k++) {
+			int i = slot[k];
+			if (r_loc) {
+				r_loc[i] = Vector3(from[CK::LOC_X][k], from[CK::LOC_Y][k], from[CK::LOC_Z][k]);
+			}
+			if (r_rot) {
+				// Normalized linear blend, close to a slerp for keys this near.
+				r_rot[i] = Quaternion(from[CK::ROT_X][k], from[CK::ROT_Y][k], from[CK::ROT_Z][k], from[CK::ROT_W][k]).normalized();
+			}
+			if (r_scale) {
+				r_scale[i] = Vector3(from[CK::SCALE_X][k], from[CK::SCALE_Y][k], from[CK::SCALE_Z][k]);
+			}
+		}
+	}
+}
+
+int Animation::_find_compressed(const LocalVector<float> &p_times, double p_time) const {
+	int len = p_times.size();
+	if (len == 0) {
+		return -2;
+	}
+
+	int low = 0;
+	int high = len - 1;
+	int middle = 0;
+
+	while (low <= high) {
+		middle = (low + high) / 2;
+
+		if (Math::is_equal_approx(p_time, (double)p_times[middle])) { //match
+			return middle;
+		} else if (p_time < p_times[middle]) {
+			high = middle - 1; //search low end of array
+		} else {
+			low = middle + 1; //search high end of array
+		}
+	}
+
+	if (p_times[middle] > p_time) {
+		middle--;
+	}
+
+	return middle;
+}
+
+bool Animation::_compressed_get_key_pair(const TransformTrack *p_track, double p_time, int &r_idx, int &r_next, real_t &r_c) const {
+	// Same key selection as _interpolate(), on the compressed key times.
+	const LocalVector<float> &times = p_track->compressed_keys.times;
+	int len = _find_compressed(times, length) + 1; // try to find last key (there may be more past the end)
+
+	if (len <= 0) {
+		return false;
+	}
+
+	r_c = 0.0;
+	if (len == 1) {
+		r_idx = r_next = 0;
+		return true;
+	}
+
+	int idx = _find_compressed(times, p_time);
+	int next = 0;
+	real_t delta = 0.0;
+	real_t from = 0.0;
+
+	if (loop && p_track->loop_wrap) {
+		if (idx >= 0) {
+			if ((idx + 1) < len) {
+				next = idx + 1;
+				delta = times[next] - times[idx];
+			} else {
+				next = 0;
+				delta = (length - times[idx]) + times[next];
+			}
+			from = p_time - times[idx];
+		} else {
+			// on loop, behind first key
+			idx = len - 1;
+			next = 0;
+			real_t endtime = MAX(length - times[idx], 0.0); // may be keys past the end
+			delta = endtime + times[next];
+			from = endtime + p_time;
+		}
+	} else {
+		if (idx >= 0) {
+			if ((idx + 1) < len) {
+				next = idx + 1;
+				delta = times[next] - times[idx];
+				from = p_time - times[idx];
+			} else {
+				next = idx;
+			}
+		} else if (loop) {
+			// only allow extending first key to anim start if looping
+			idx = next = 0;
+		} else {
+			return false;
+		}
+	}
+
+	if (idx != next && !Math::is_zero_approx(delta)) {
+		r_c = from / delta;
+	}
+	r_idx = idx;
+	r_next = next;
+	return true;
+}
+
+bool Animation::_transform_track_compress(TransformTrack *p_track) {
+	typedef CompressedTransformKeys CK;
+
+	if (p_track->compressed) {
+		return true;
+	}
+
+	int key_count = p_track->transforms.size();
+	if (key_count == 0) {
+		return false;
+	}
+
+	const TKey<TransformKey> *keys = p_track->transforms.ptr();
+	for (int i = 0; i < key_count; i++) {
+		if (keys[i].transition != 1.0) {
+			return false; // Compressed keys store no easing.
+		}
+	}
+
+	LocalVector<float> values;
+	values.resize(key_count * CK::COMPONENT_MAX);
+
+	Quaternion prev_rot;
+	for (int i = 0; i < key_count; i++) {
+		const TransformKey &tk = keys[i].value;
+		Quaternion rot = tk.rot;
+		// Keep consecutive rotations on the same hemisphere, so blending them per component takes the short path.
+		if (i > 0 && prev_rot.dot(rot) < 0) {
+			rot = -rot;
+		}
+		prev_rot = rot;
+
+		float *v = &values[i * CK::COMPONENT_MAX];
+		v[CK::LOC_X] = tk.loc.x;
+		v[CK::LOC_Y] = tk.loc.y;
+		v[CK::LOC_Z] = tk.loc.z;
+		v[CK::ROT_X] = rot.x;
+		v[CK::ROT_Y] = rot.y;
+		v[CK::ROT_Z] = rot.z;
+		v[CK::ROT_W] = rot.w;
+		v[CK::SCALE_X] = tk.scale.x;
+		v[CK::SCALE_Y] = tk.scale.y;
+		v[CK::SCALE_Z] = tk.scale.z;
+	}
+
+	CK &ck = p_track->compressed_keys;
+	ck.times.resize(key_count);
+	for (int i = 0; i < key_count; i++) {
+		ck.times[i] = keys[i].time;
+	}
+
+	for (int j = 0; j < CK::COMPONENT_MAX; j++) {
+		float min = values[j];
+		float max = values[j];
+		for (int i = 1; i < key_count; i++) {
+			min = MIN(min, values[i * CK::COMPONENT_MAX + j]);
+			max = MAX(max, values[i * CK::COMPONENT_MAX + j]);
+		}
+
+		float step = (max - min) / 65535.0f;
+		ck.component_min[j] = min;
+		ck.component_step[j] = step;
+
+		ck.components[j].resize(key_count);
+		for (int i = 0; i < key_count; i++) {
+			float q = step > 0.0f ? Math::round((values[i * CK::COMPONENT_MAX + j] - min) / step) : 0.0f;
+			ck.components[j][i] = CLAMP(int(q), 0, 65535);
+		}
+	}
+
+	p_track->transforms.clear();
+	p_track->compressed = true;
+	return true;
+}
+
+void Animation::_transform_track_decompress(TransformTrack *p_track) {
+	if (!p_track->compressed) {
+		return;
+	}
+
+	p_track->transforms = _transform_track_get_keys(p_track);
+
+	CompressedTransformKeys &ck = p_track->compressed_keys;
+	ck.times.reset();
+	for (int j = 0; j < CompressedTransformKeys::COMPONENT_MAX; j++) {
+		ck.components[j].reset();
+	}
+	p_track->compressed = false;
+}
+
+Animation::TKey<Animation::TransformKey> Animation::_transform_track_get_compressed_key(const TransformTrack *p_track, int p_key) const {
+	typedef CompressedTransformKeys CK;
+	const CK &ck = p_track->compressed_keys;
+
+	TKey<TransformKey> key;
+	key.time = ck.times[p_key];
+	key.value.loc = Vector3(ck.get_component(CK::LOC_X, p_key), ck.get_component(CK::LOC_Y, p_key), ck.get_component(CK::LOC_Z, p_key));
+	key.value.rot = Quaternion(ck.get_component(CK::ROT_X, p_key), ck.get_component(CK::ROT_Y, p_key), ck.get_component(CK::ROT_Z, p_key), ck.get_component(CK::ROT_W, p_key)).normalized();
+	key.value.scale = Vector3(ck.get_component(CK::SCALE_X, p_key), ck.get_component(CK::SCALE_Y, p_key), ck.get_component(CK::SCALE_Z, p_key));
+	return key;
+}
+
+Vector<Animation::TKey<Animation::TransformKey>> Animation::_transform_track_get_keys(const TransformTrack *p_track) const {
+	if (!p_track->compressed) {
+		return p_track->transforms;
+	}
+
+	Vector<TKey<TransformKey>> keys;
+	keys.resize(p_track->compressed_keys.times.size());
+	for (int i = 0; i < keys.size(); i++) {
+		keys.write[i] = _transform_track_get_compressed_key(p_track, i);
+	}
+	return keys;
+}
+
 Variant Animation::value_track_interpolate(int p_track, double p_time) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), 0);
 	Track *t = tracks[p_track];
@@ -1909,6 +2360,43 @@ void Animation::_track_get_key_indices_in_range(const Vector<T> &p_array, double
 	}
 }
 
+void Animation::_transform_track_get_key_indices_in_range(const TransformTrack *p_track, double from_time, double to_time, List<int> *p_indices) const {
+	if (!p_track->compressed) {
+		_track_get_key_indices_in_range(p_track->transforms, from_time, to_time, p_indices);
+		return;
+	}
+
+	// Same as _track_get_key_indices_in_range(), but only looks at the key times so nothing is decompressed.
+	const LocalVector<float> &times = p_track->compressed_keys.times;
+
+	if (from_time != length && to_time == length) {
+		to_time = length * 1.01; //include a little more if at the end
+	}
+
+	int to = _find_compressed(times, to_time);
+
+	if (to >= 0 && times[to] >= to_time) {
+		to--;
+	}
+
+	if (to < 0) {
+		return; // not bother
+	}
+
+	int from = _find_compressed(times, from_time);
+
+	if (from < 0 || times[from] < from_time) {
+		from++;
+	}
+
+	int max = times.size();
+
+	for (int i = from; i <= to; i++) {
+		ERR_CONTINUE(i < 0 || i >= max); // shouldn't happen
+		p_indices->push_back(i);
+	}
+}
+
 void Animation::track_get_key_indices_in_range(int p_track, double p_time, double p_delta, List<int> *p_indices) const {
 	ERR_FAIL_INDEX(p_track, tracks.size());
 	const Track *t = tracks[p_track];
@@ -1935,8 +2423,8 @@ void Animation::track_get_key_indices_in_range(int p_track, double p_time, doubl
 			switch (t->type) {
 				case TYPE_TRANSFORM3D: {
 					const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-					_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
-					_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					_transform_track_get_key_indices_in_range(tt, from_time, length, p_indices);
+					_transform_track_get_key_indices_in_range(tt, 0, to_time, p_indices);
 
 				} break;
 				case TYPE_VALUE: {
@@ -1991,7 +2479,7 @@ void Animation::track_get_key_indices_in_range(int p_track, double p_time, doubl
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-			_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			_transform_track_get_key_indices_in_range(tt, from_time, to_time, p_indices);
 
 		} break;
 		case TYPE_VALUE: {
@@ -2629,6 +3117,7 @@ void Animation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("track_get_interpolation_loop_wrap", "track_idx"), &Animation::track_get_interpolation_loop_wrap);
 
 	ClassDB::bind_method(D_METHOD("transform_track_interpolate", "track_idx", "time_sec"), &Animation::_transform_track_interpolate);
+	ClassDB::bind_method(D_METHOD("track_is_compressed", "track_idx"), &Animation::track_is_compressed);
 	ClassDB::bind_method(D_METHOD("value_track_set_update_mode", "track_idx", "mode"), &Animation::value_track_set_update_mode);
 	ClassDB::bind_method(D_METHOD("value_track_get_update_mode", "track_idx"), &Animation::value_track_get_update_mode);
 
@@ -2675,6 +3164,9 @@ void Animation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("clear"), &Animation::clear);
 	ClassDB::bind_method(D_METHOD("copy_track", "track_idx", "to_animation"), &Animation::copy_track);
 
+	ClassDB::bind_method(D_METHOD("compress", "allowed_linear_error", "allowed_angular_error", "max_optimizable_angle"), &Animation::compress, DEFVAL(0.05), DEFVAL(0.01), DEFVAL(Math_PI * 0.125));
+	ClassDB::bind_method(D_METHOD("is_compressed"), &Animation::is_compressed);
+
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "length", PROPERTY_HINT_RANGE, "0.001,99999,0.001"), "set_length", "get_length");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "set_loop", "has_loop");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "step", PROPERTY_HINT_RANGE, "0,4096,0.001"), "set_step", "get_step");
@@ -2880,6 +3372,7 @@ void Animation::_transform_track_optimize(int p_idx, real_t p_allowed_linear_err
 	ERR_FAIL_INDEX(p_idx, tracks.size());
 	ERR_FAIL_COND(tracks[p_idx]->type != TYPE_TRANSFORM3D);
 	TransformTrack *tt = static_cast<TransformTrack *>(tracks[p_idx]);
+	_transform_track_decompress(tt);
 	bool prev_erased = false;
 	TKey<TransformKey> first_erased;
 
@@ -2919,9 +3412,46 @@ void Animation::_transform_track_optimize(int p_idx, real_t p_allowed_linear_err
 void Animation::optimize(real_t p_allowed_linear_err, real_t p_allowed_angular_err, real_t p_max_optimizable_angle) {
 	for (int i = 0; i < tracks.size(); i++) {
 		if (tracks[i]->type == TYPE_TRANSFORM3D) {
+			TransformTrack *tt = static_cast<TransformTrack *>(tracks[i]);
+			bool was_compressed = tt->compressed;
 			_transform_track_optimize(i, p_allowed_linear_err, p_allowed_angular_err, p_max_optimizable_angle);
+			if (was_compressed) {
+				_transform_track_compress(tt);
+			}
+		}
+	}
+}
+
+void Animation::compress(real_t p_allowed_linear_err, real_t p_allowed_angular_err, real_t p_max_optimizable_angle) {
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i]->type != TYPE_TRANSFORM3D) {
+			continue;
+		}
+
+		TransformTrack *tt = static_cast<TransformTrack *>(tracks[i]);
+		if (tt->compressed) {
+			continue;
 		}
+
+		_transform_track_optimize(i, p_allowed_linear_err, p_allowed_angular_err, p_max_optimizable_angle);
+		_transform_track_compress(tt);
 	}
+
+	emit_changed();
+}
+
+bool Animation::is_compressed() const {
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i]->type == TYPE_TRANSFORM3D && static_cast<const TransformTrack *>(tracks[i])->compressed) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Animation::track_is_compressed(int p_track) const {
+	ERR_FAIL_INDEX_V(p_track, tracks.size(), false);
+	return tracks[p_track]->type == TYPE_TRANSFORM3D && static_cast<const TransformTrack *>(tracks[p_track])->compressed;
 }
 
 Animation::Animation() {}
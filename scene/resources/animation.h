@@ -32,6 +32,7 @@
 #define ANIMATION_H
 
 #include "core/io/resource.h"
+#include "core/templates/local_vector.h"
 
 #define ANIM_MIN_LENGTH 0.001
 
@@ -97,8 +98,38 @@ private:
 
 	/* TRANSFORM TRACK */
 
+	// Compressed transform keys, see compress(). Each component is quantized to 16 bits
+	// within its own range and stored in a separate array (structure of arrays), which
+	// uses about a third of the memory of regular keys and keeps batch sampling cache friendly.
+	struct CompressedTransformKeys {
+		enum {
+			LOC_X,
+			LOC_Y,
+			LOC_Z,
+			ROT_X,
+			ROT_Y,
+			ROT_Z,
+			ROT_W,
+			SCALE_X,
+			SCALE_Y,
+			SCALE_Z,
+			COMPONENT_MAX
+		};
+
+		LocalVector<float> times;
+		LocalVector<uint16_t> components[COMPONENT_MAX];
+		float component_min[COMPONENT_MAX] = {};
+		float component_step[COMPONENT_MAX] = {}; // Value = min + quantized * step.
+
+		_FORCE_INLINE_ float get_component(int p_component, uint32_t p_key) const {
+			return component_min[p_component] + float(components[p_component][p_key]) * component_step[p_component];
+		}
+	};
+
 	struct TransformTrack : public Track {
 		Vector<TKey<TransformKey>> transforms;
+		bool compressed = false; // If true, keys live in compressed_keys and transforms is empty.
+		CompressedTransformKeys compressed_keys;
 
 		TransformTrack() { type = TYPE_TRANSFORM3D; }
 	};
@@ -205,6 +236,14 @@ private:
 	template <class T>
 	_FORCE_INLINE_ void _track_get_key_indices_in_range(const Vector<T> &p_array, double from_time, double to_time, List<int> *p_indices) const;
 
+	bool _transform_track_compress(TransformTrack *p_track);
+	void _transform_track_decompress(TransformTrack *p_track);
+	TKey<TransformKey> _transform_track_get_compressed_key(const TransformTrack *p_track, int p_key) const;
+	Vector<TKey<TransformKey>> _transform_track_get_keys(const TransformTrack *p_track) const;
+	int _find_compressed(const LocalVector<float> &p_times, double p_time) const;
+	void _transform_track_get_key_indices_in_range(const TransformTrack *p_track, double from_time, double to_time, List<int> *p_indices) const;
+	bool _compressed_get_key_pair(const TransformTrack *p_track, double p_time, int &r_idx, int &r_next, real_t &r_c) const;
+
 	_FORCE_INLINE_ void _value_track_get_key_indices_in_range(const ValueTrack *vt, double from_time, double to_time, List<int> *p_indices) const;
 	_FORCE_INLINE_ void _method_track_get_key_indices_in_range(const MethodTrack *mt, double from_time, double to_time, List<int> *p_indices) const;
 
@@ -325,6 +364,7 @@ public:
 	bool track_get_interpolation_loop_wrap(int p_track) const;
 
 	Error transform_track_interpolate(int p_track, double p_time, Vector3 *r_loc, Quaternion *r_rot, Vector3 *r_scale) const;
+	void transform_track_interpolate_batch(const int *p_tracks, int p_track_count, double p_time, Vector3 *r_loc, Quaternion *r_rot, Vector3 *r_scale, Error *r_err) const;
 
 	Variant value_track_interpolate(int p_track, double p_time) const;
 	void value_track_get_key_indices(int p_track, double p_time, double p_delta, List<int> *p_indices) const;
@@ -352,6 +392,10 @@ public:
 
 	void optimize(real_t p_allowed_linear_err = 0.05, real_t p_allowed_angular_err = 0.01, real_t p_max_optimizable_angle = Math_PI * 0.125);
 
+	void compress(real_t p_allowed_linear_err = 0.05, real_t p_allowed_angular_err = 0.01, real_t p_max_optimizable_angle = Math_PI * 0.125);
+	bool is_compressed() const;
+	bool track_is_compressed(int p_track) const;
+
 	Animation();
 	~Animation();
 };
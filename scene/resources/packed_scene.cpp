@@ -45,6 +45,43 @@ bool SceneState::can_instantiate() const {
 	return nodes.size() > 0;
 }
 
+void SceneState::_build_instantiation_plan() const {
+	MutexLock lock(instantiation_plan_mutex);
+	if (instantiation_plan_ready.is_set()) {
+		return; // Built by another thread meanwhile.
+	}
+
+	instantiation_plan.resize(nodes.size());
+	instantiation_plan_properties.clear();
+
+	for (int i = 0; i < nodes.size(); i++) {
+		const NodeData &n = nodes[i];
+		NodePlan &node_plan = instantiation_plan[i];
+		node_plan.first_property = instantiation_plan_properties.size();
+
+		bool from_class_db = !(i == 0 && base_scene_idx >= 0) && n.instance < 0 && n.type != TYPE_INSTANCED && n.type >= 0 && n.type < names.size();
+		node_plan.type = from_class_db ? names[n.type] : StringName();
+
+		for (int j = 0; j < n.properties.size(); j++) {
+			PropertyPlan property_plan;
+			int name = n.properties[j].name;
+			if (from_class_db && name >= 0 && name < names.size() && names[name] != CoreStringNames::get_singleton()->_script && names[name] != CoreStringNames::get_singleton()->_meta) {
+				property_plan.setter = ClassDB::get_property_setter_bind(node_plan.type, names[name], &property_plan.index);
+			}
+			instantiation_plan_properties.push_back(property_plan);
+		}
+	}
+
+	instantiation_plan_ready.set();
+}
+
+void SceneState::_clear_instantiation_plan() {
+	MutexLock lock(instantiation_plan_mutex);
+	instantiation_plan_ready.clear();
+	instantiation_plan.clear();
+	instantiation_plan_properties.clear();
+}
+
 Node *SceneState::instantiate(GenEditState p_edit_state) const {
 	// nodes where instancing failed (because something is missing)
 	List<Node *> stray_instances;
@@ -82,6 +119,14 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 	bool gen_node_path_cache = p_edit_state != GEN_EDIT_STATE_DISABLED && node_path_cache.is_empty();
 
+	const NodePlan *plan = nullptr;
+	if (p_edit_state == GEN_EDIT_STATE_DISABLED) {
+		if (!instantiation_plan_ready.is_set()) {
+			_build_instantiation_plan();
+		}
+		plan = instantiation_plan.ptr();
+	}
+
 	Map<Ref<Resource>, Ref<Resource>> resources_local_to_scene;
 
 	for (int i = 0; i < nc; i++) {
@@ -190,6 +235,12 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			if (nprop_count) {
 				const NodeData::Property *nprops = &n.properties[0];
 
+				// Placeholders created for missing classes can't use the resolved setters.
+				const PropertyPlan *nsetters = nullptr;
+				if (plan && plan[i].type != StringName() && node->get_class_name() == plan[i].type) {
+					nsetters = &instantiation_plan_properties[plan[i].first_property];
+				}
+
 				for (int j = 0; j < nprop_count; j++) {
 					bool valid;
 					ERR_FAIL_INDEX_V(nprops[j].name, sname_count, nullptr);
@@ -246,7 +297,21 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 						} else if (p_edit_state == GEN_EDIT_STATE_INSTANCE) {
 							value = value.duplicate(true); // Duplicate arrays and dictionaries for the editor
 						}
-						node->set(snames[nprops[j].name], value, &valid);
+
+						if (nsetters && nsetters[j].setter && !node->get_script_instance()) {
+							// Same call ClassDB::set_property() would end up doing.
+							Callable::CallError ce;
+							if (nsetters[j].index >= 0) {
+								Variant index = nsetters[j].index;
+								const Variant *args[2] = { &index, &value };
+								nsetters[j].setter->call(node, args, 2, ce);
+							} else {
+								const Variant *args[1] = { &value };
+								nsetters[j].setter->call(node, args, 1, ce);
+							}
+						} else {
+							node->set(snames[nprops[j].name], value, &valid);
+						}
 					}
 				}
 			}
@@ -921,6 +986,7 @@ String SceneState::get_path() const {
 }
 
 void SceneState::clear() {
+	_clear_instantiation_plan();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1086,6 +1152,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 
 	ERR_FAIL_COND_MSG(version > PACKED_SCENE_VERSION, "Save format version too new.");
 
+	_clear_instantiation_plan();
+
 	const int node_count = p_dictionary["node_count"];
 	const Vector<int> snodes = p_dictionary["nodes"];
 	ERR_FAIL_COND(snodes.size() < node_count);
@@ -1523,6 +1591,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.instance = p_instance;
 	nd.index = p_index;
 
+	_clear_instantiation_plan();
 	nodes.push_back(nd);
 
 	return nodes.size() - 1;
@@ -1536,6 +1605,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value) {
 	NodeData::Property prop;
 	prop.name = p_name;
 	prop.value = p_value;
+	_clear_instantiation_plan();
 	nodes.write[p_node].properties.push_back(prop);
 }
 
@@ -1547,6 +1617,7 @@ void SceneState::add_node_group(int p_node, int p_group) {
 
 void SceneState::set_base_scene(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, variants.size());
+	_clear_instantiation_plan();
 	base_scene_idx = p_idx;
 }
 
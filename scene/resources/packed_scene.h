@@ -32,6 +32,9 @@
 #define PACKED_SCENE_H
 
 #include "core/io/resource.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "scene/main/node.h"
 
 class SceneState : public RefCounted {
@@ -87,6 +90,27 @@ class SceneState : public RefCounted {
 
 	Vector<ConnectionData> connections;
 
+	// Property setters resolved once for the nodes created from ClassDB, so
+	// instantiating the scene again skips the per-property ClassDB lookups.
+	// Only used at runtime (GEN_EDIT_STATE_DISABLED).
+	struct PropertyPlan {
+		MethodBind *setter = nullptr; // If null, the property goes through Object::set().
+		int index = -1;
+	};
+
+	struct NodePlan {
+		StringName type; // Empty if the node is not created from ClassDB.
+		uint32_t first_property = 0;
+	};
+
+	mutable LocalVector<NodePlan> instantiation_plan;
+	mutable LocalVector<PropertyPlan> instantiation_plan_properties;
+	mutable SafeFlag instantiation_plan_ready;
+	mutable BinaryMutex instantiation_plan_mutex;
+
+	void _build_instantiation_plan() const;
+	void _clear_instantiation_plan();
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 
@@ -56,6 +56,12 @@ NavigationServer2D *NavigationServer2D::singleton = nullptr;
 		return NavigationServer3D::get_singleton()->FUNC_NAME(CONV_0(D_0)); \
 	}
 
+#define FORWARD_1_R_C(CONV_R, FUNC_NAME, T_0, D_0, CONV_0)                          \
+	NavigationServer2D::FUNC_NAME(T_0 D_0)                                          \
+			const {                                                                 \
+		return CONV_R(NavigationServer3D::get_singleton()->FUNC_NAME(CONV_0(D_0))); \
+	}
+
 #define FORWARD_2_C(FUNC_NAME, T_0, D_0, T_1, D_1, CONV_0, CONV_1)                       \
 	NavigationServer2D::FUNC_NAME(T_0 D_0, T_1 D_1)                                      \
 			const {                                                                      \
@@ -68,6 +74,12 @@ NavigationServer2D *NavigationServer2D::singleton = nullptr;
 		return CONV_R(NavigationServer3D::get_singleton()->FUNC_NAME(CONV_0(D_0), CONV_1(D_1))); \
 	}
 
+#define FORWARD_3_R_C(CONV_R, FUNC_NAME, T_0, D_0, T_1, D_1, T_2, D_2, CONV_0, CONV_1, CONV_2)                \
+	NavigationServer2D::FUNC_NAME(T_0 D_0, T_1 D_1, T_2 D_2)                                                  \
+			const {                                                                                           \
+		return CONV_R(NavigationServer3D::get_singleton()->FUNC_NAME(CONV_0(D_0), CONV_1(D_1), CONV_2(D_2))); \
+	}
+
 #define FORWARD_4_R_C(CONV_R, FUNC_NAME, T_0, D_0, T_1, D_1, T_2, D_2, T_3, D_3, CONV_0, CONV_1, CONV_2, CONV_3)           \
 	NavigationServer2D::FUNC_NAME(T_0 D_0, T_1 D_1, T_2 D_2, T_3 D_3)                                                      \
 			const {                                                                                                        \
@@ -183,6 +195,17 @@ void NavigationServer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("region_get_connection_pathway_start", "region", "connection"), &NavigationServer2D::region_get_connection_pathway_start);
 	ClassDB::bind_method(D_METHOD("region_get_connection_pathway_end", "region", "connection"), &NavigationServer2D::region_get_connection_pathway_end);
 
+	ClassDB::bind_method(D_METHOD("flow_field_create"), &NavigationServer2D::flow_field_create);
+	ClassDB::bind_method(D_METHOD("flow_field_set_map", "flow_field", "map"), &NavigationServer2D::flow_field_set_map);
+	ClassDB::bind_method(D_METHOD("flow_field_set_target", "flow_field", "target"), &NavigationServer2D::flow_field_set_target);
+	ClassDB::bind_method(D_METHOD("flow_field_get_target", "flow_field"), &NavigationServer2D::flow_field_get_target);
+	ClassDB::bind_method(D_METHOD("flow_field_set_layers", "flow_field", "layers"), &NavigationServer2D::flow_field_set_layers);
+	ClassDB::bind_method(D_METHOD("flow_field_get_layers", "flow_field"), &NavigationServer2D::flow_field_get_layers);
+	ClassDB::bind_method(D_METHOD("flow_field_set_cell_size", "flow_field", "cell_size"), &NavigationServer2D::flow_field_set_cell_size);
+	ClassDB::bind_method(D_METHOD("flow_field_get_cell_size", "flow_field"), &NavigationServer2D::flow_field_get_cell_size);
+	ClassDB::bind_method(D_METHOD("flow_field_get_next_location", "flow_field", "position", "desired_distance"), &NavigationServer2D::flow_field_get_next_location, DEFVAL(0.0));
+	ClassDB::bind_method(D_METHOD("flow_field_get_distance", "flow_field", "position"), &NavigationServer2D::flow_field_get_distance);
+
 	ClassDB::bind_method(D_METHOD("agent_create"), &NavigationServer2D::agent_create);
 	ClassDB::bind_method(D_METHOD("agent_set_map", "agent", "map"), &NavigationServer2D::agent_set_map);
 	ClassDB::bind_method(D_METHOD("agent_set_neighbor_dist", "agent", "dist"), &NavigationServer2D::agent_set_neighbor_dist);
@@ -242,6 +265,17 @@ int FORWARD_1_C(region_get_connections_count, RID, p_region, rid_to_rid);
 Vector2 FORWARD_2_R_C(v3_to_v2, region_get_connection_pathway_start, RID, p_region, int, p_connection_id, rid_to_rid, int_to_int);
 Vector2 FORWARD_2_R_C(v3_to_v2, region_get_connection_pathway_end, RID, p_region, int, p_connection_id, rid_to_rid, int_to_int);
 
+RID FORWARD_0_C(flow_field_create);
+void FORWARD_2_C(flow_field_set_map, RID, p_flow_field, RID, p_map, rid_to_rid, rid_to_rid);
+void FORWARD_2_C(flow_field_set_target, RID, p_flow_field, Vector2, p_target, rid_to_rid, v2_to_v3);
+Vector2 FORWARD_1_R_C(v3_to_v2, flow_field_get_target, RID, p_flow_field, rid_to_rid);
+void FORWARD_2_C(flow_field_set_layers, RID, p_flow_field, uint32_t, p_layers, rid_to_rid, uint32_to_uint32);
+uint32_t FORWARD_1_C(flow_field_get_layers, RID, p_flow_field, rid_to_rid);
+void FORWARD_2_C(flow_field_set_cell_size, RID, p_flow_field, real_t, p_cell_size, rid_to_rid, real_to_real);
+real_t FORWARD_1_C(flow_field_get_cell_size, RID, p_flow_field, rid_to_rid);
+Vector2 FORWARD_3_R_C(v3_to_v2, flow_field_get_next_location, RID, p_flow_field, Vector2, p_position, real_t, p_desired_distance, rid_to_rid, v2_to_v3, real_to_real);
+real_t FORWARD_2_C(flow_field_get_distance, RID, p_flow_field, Vector2, p_position, rid_to_rid, v2_to_v3);
+
 RID NavigationServer2D::agent_create() const {
 	RID agent = NavigationServer3D::get_singleton()->agent_create();
 	NavigationServer3D::get_singleton()->agent_set_ignore_y(agent, true);
@@ -105,6 +105,32 @@ public:
 	virtual Vector2 region_get_connection_pathway_start(RID p_region, int p_connection_id) const;
 	virtual Vector2 region_get_connection_pathway_end(RID p_region, int p_connection_id) const;
 
+	/// Creates a flow field, the direction to follow to reach a target from
+	/// any point of a map, shared by all the agents heading to it.
+	virtual RID flow_field_create() const;
+
+	/// Set the map of this flow field.
+	virtual void flow_field_set_map(RID p_flow_field, RID p_map) const;
+
+	/// Set the location to reach.
+	virtual void flow_field_set_target(RID p_flow_field, Vector2 p_target) const;
+	virtual Vector2 flow_field_get_target(RID p_flow_field) const;
+
+	/// Set the layers of the regions the flow field goes through.
+	virtual void flow_field_set_layers(RID p_flow_field, uint32_t p_layers) const;
+	virtual uint32_t flow_field_get_layers(RID p_flow_field) const;
+
+	/// Set the size of the cells used to look up the polygons of the map.
+	virtual void flow_field_set_cell_size(RID p_flow_field, real_t p_cell_size) const;
+	virtual real_t flow_field_get_cell_size(RID p_flow_field) const;
+
+	/// Returns the next location to head to from the given position, skipping
+	/// the ones closer than the desired distance.
+	virtual Vector2 flow_field_get_next_location(RID p_flow_field, Vector2 p_position, real_t p_desired_distance = 0.0) const;
+
+	/// Returns the distance to the target along the flow field.
+	virtual real_t flow_field_get_distance(RID p_flow_field, Vector2 p_position) const;
+
 	/// Creates the agent.
 	virtual RID agent_create() const;
 
@@ -47,6 +47,7 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_set_edge_connection_margin", "map", "margin"), &NavigationServer3D::map_set_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_get_edge_connection_margin", "map"), &NavigationServer3D::map_get_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_get_path", "map", "origin", "destination", "optimize", "layers"), &NavigationServer3D::map_get_path, DEFVAL(1));
+	ClassDB::bind_method(D_METHOD("map_query_paths", "map", "origins", "destinations", "optimize", "receiver", "method", "userdata", "layers"), &NavigationServer3D::map_query_paths, DEFVAL(Variant()), DEFVAL(1));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_to_segment", "map", "start", "end", "use_collision"), &NavigationServer3D::map_get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point", "map", "to_point"), &NavigationServer3D::map_get_closest_point);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_normal", "map", "to_point"), &NavigationServer3D::map_get_closest_point_normal);
@@ -63,6 +64,17 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("region_get_connection_pathway_start", "region", "connection"), &NavigationServer3D::region_get_connection_pathway_start);
 	ClassDB::bind_method(D_METHOD("region_get_connection_pathway_end", "region", "connection"), &NavigationServer3D::region_get_connection_pathway_end);
 
+	ClassDB::bind_method(D_METHOD("flow_field_create"), &NavigationServer3D::flow_field_create);
+	ClassDB::bind_method(D_METHOD("flow_field_set_map", "flow_field", "map"), &NavigationServer3D::flow_field_set_map);
+	ClassDB::bind_method(D_METHOD("flow_field_set_target", "flow_field", "target"), &NavigationServer3D::flow_field_set_target);
+	ClassDB::bind_method(D_METHOD("flow_field_get_target", "flow_field"), &NavigationServer3D::flow_field_get_target);
+	ClassDB::bind_method(D_METHOD("flow_field_set_layers", "flow_field", "layers"), &NavigationServer3D::flow_field_set_layers);
+	ClassDB::bind_method(D_METHOD("flow_field_get_layers", "flow_field"), &NavigationServer3D::flow_field_get_layers);
+	ClassDB::bind_method(D_METHOD("flow_field_set_cell_size", "flow_field", "cell_size"), &NavigationServer3D::flow_field_set_cell_size);
+	ClassDB::bind_method(D_METHOD("flow_field_get_cell_size", "flow_field"), &NavigationServer3D::flow_field_get_cell_size);
+	ClassDB::bind_method(D_METHOD("flow_field_get_next_location", "flow_field", "position", "desired_distance"), &NavigationServer3D::flow_field_get_next_location, DEFVAL(0.0));
+	ClassDB::bind_method(D_METHOD("flow_field_get_distance", "flow_field", "position"), &NavigationServer3D::flow_field_get_distance);
+
 	ClassDB::bind_method(D_METHOD("agent_create"), &NavigationServer3D::agent_create);
 	ClassDB::bind_method(D_METHOD("agent_set_map", "agent", "map"), &NavigationServer3D::agent_set_map);
 	ClassDB::bind_method(D_METHOD("agent_set_neighbor_dist", "agent", "dist"), &NavigationServer3D::agent_set_neighbor_dist);
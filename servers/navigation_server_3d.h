@@ -90,6 +90,11 @@ public:
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigable_layers = 1) const = 0;
 
+	/// Computes the paths between each pair of origin and destination in
+	/// parallel. The receiver method is called with the array of paths during
+	/// a later `process`.
+	virtual void map_query_paths(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, Object *p_receiver, StringName p_method, Variant p_udata = Variant(), uint32_t p_navigable_layers = 1) const = 0;
+
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const = 0;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const = 0;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const = 0;
@@ -119,6 +124,32 @@ public:
 	virtual Vector3 region_get_connection_pathway_start(RID p_region, int p_connection_id) const = 0;
 	virtual Vector3 region_get_connection_pathway_end(RID p_region, int p_connection_id) const = 0;
 
+	/// Creates a flow field, the direction to follow to reach a target from
+	/// any point of a map, shared by all the agents heading to it.
+	virtual RID flow_field_create() const = 0;
+
+	/// Set the map of this flow field.
+	virtual void flow_field_set_map(RID p_flow_field, RID p_map) const = 0;
+
+	/// Set the location to reach.
+	virtual void flow_field_set_target(RID p_flow_field, Vector3 p_target) const = 0;
+	virtual Vector3 flow_field_get_target(RID p_flow_field) const = 0;
+
+	/// Set the layers of the regions the flow field goes through.
+	virtual void flow_field_set_layers(RID p_flow_field, uint32_t p_layers) const = 0;
+	virtual uint32_t flow_field_get_layers(RID p_flow_field) const = 0;
+
+	/// Set the size of the cells used to look up the polygons of the map.
+	virtual void flow_field_set_cell_size(RID p_flow_field, real_t p_cell_size) const = 0;
+	virtual real_t flow_field_get_cell_size(RID p_flow_field) const = 0;
+
+	/// Returns the next location to head to from the given position, skipping
+	/// the ones closer than the desired distance.
+	virtual Vector3 flow_field_get_next_location(RID p_flow_field, Vector3 p_position, real_t p_desired_distance = 0.0) const = 0;
+
+	/// Returns the distance to the target along the flow field.
+	virtual real_t flow_field_get_distance(RID p_flow_field, Vector3 p_position) const = 0;
+
 	/// Creates the agent.
 	virtual RID agent_create() const = 0;
 
@@ -161,8 +161,9 @@ void BodyPair3DSW::validate_contacts() {
 	}
 }
 
-bool BodyPair3DSW::_test_ccd(real_t p_step, Body3DSW *p_A, int p_shape_A, const Transform3D &p_xform_A, Body3DSW *p_B, int p_shape_B, const Transform3D &p_xform_B) {
-	Vector3 motion = p_A->get_linear_velocity() * p_step;
+bool BodyPair3DSW::_test_ccd(real_t p_step, const Shape3DSW *p_shape_A, const Transform3D &p_xform_A, const Shape3DSW *p_shape_B, const Transform3D &p_xform_B) {
+	// Motion of A relative to B during this step, so a single sweep covers both bodies moving.
+	Vector3 motion = (A->get_linear_velocity() - B->get_linear_velocity()) * p_step;
 	real_t mlen = motion.length();
 	if (mlen < CMP_EPSILON) {
 		return false;
@@ -170,35 +171,44 @@ bool BodyPair3DSW::_test_ccd(real_t p_step, Body3DSW *p_A, int p_shape_A, const
 
 	Vector3 mnormal = motion / mlen;
 
+	// Only sweep if a body with CCD moves more than 1/3 of its size in that direction, slower ones are caught by the regular contacts.
+	bool fast_object = false;
 	real_t min, max;
-	p_A->get_shape(p_shape_A)->project_range(mnormal, p_xform_A, min, max);
-	bool fast_object = mlen > (max - min) * 0.3; //going too fast in that direction
+	if (A->is_continuous_collision_detection_enabled() && collide_A) {
+		p_shape_A->project_range(mnormal, p_xform_A, min, max);
+		fast_object = mlen > (max - min) * 0.3;
+	}
+	if (!fast_object && B->is_continuous_collision_detection_enabled() && collide_B) {
+		p_shape_B->project_range(mnormal, p_xform_B, min, max);
+		fast_object = mlen > (max - min) * 0.3;
+	}
 
-	if (!fast_object) { //did it move enough in this direction to even attempt raycast? let's say it should move more than 1/3 the size of the object in that axis
+	if (!fast_object) {
 		return false;
 	}
 
-	//cast a segment from support in motion normal, in the same direction of motion by motion length
-	//support is the worst case collision point, so real collision happened before
-	Vector3 s = p_A->get_shape(p_shape_A)->get_support(p_xform_A.basis.xform(mnormal).normalized());
-	Vector3 from = p_xform_A.xform(s);
-	Vector3 to = from + motion;
-
-	Transform3D from_inv = p_xform_B.affine_inverse();
-
-	Vector3 local_from = from_inv.xform(from - mnormal * mlen * 0.1); //start from a little inside the bounding box
-	Vector3 local_to = from_inv.xform(to);
-
-	Vector3 rpos, rnorm;
-	if (!p_B->get_shape(p_shape_B)->intersect_segment(local_from, local_to, rpos, rnorm)) {
+	real_t toi;
+	Vector3 point_A, point_B, normal;
+	if (!CollisionSolver3DSW::solve_time_of_impact(p_shape_A, p_xform_A, motion, p_shape_B, p_xform_B, space->get_contact_max_allowed_penetration(), toi, point_A, point_B, normal)) {
 		return false;
 	}
 
-	//shorten the linear velocity so it does not hit, but gets close enough, next frame will hit softly or soft enough
-	Vector3 hitpos = p_xform_B.xform(rpos);
-
-	real_t newlen = hitpos.distance_to(from) - (max - min) * 0.01;
-	p_A->set_linear_velocity((mnormal * newlen) / p_step);
+	// Replace the contacts by a speculative one at the time of impact. Its negative depth lets the solver
+	// remove only the part of the velocity that would make the bodies go past each other during this step.
+	Vector3 global_A = point_A - motion * toi;
+
+	Contact &c = contacts[0];
+	c.acc_normal_impulse = 0;
+	c.acc_bias_impulse = 0;
+	c.acc_bias_impulse_center_of_mass = 0;
+	c.acc_tangent_impulse = Vector3();
+	c.index_A = 0;
+	c.index_B = 0;
+	c.local_A = A->get_inv_transform().basis.xform(global_A);
+	c.local_B = B->get_inv_transform().basis.xform(point_B - offset_B);
+	c.normal = normal;
+	c.mass_normal = 0; // will be computed in pre_solve()
+	contact_count = 1;
 
 	return true;
 }
@@ -247,18 +257,15 @@ bool BodyPair3DSW::setup(real_t p_step) {
 
 	collided = CollisionSolver3DSW::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis);
 
-	if (!collided) {
-		//test ccd (currently just a raycast)
+	speculative = false;
 
-		if (A->is_continuous_collision_detection_enabled() && collide_A) {
-			_test_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B);
-		}
-
-		if (B->is_continuous_collision_detection_enabled() && collide_B) {
-			_test_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A);
+	if (!collided) {
+		if ((A->is_continuous_collision_detection_enabled() && collide_A) || (B->is_continuous_collision_detection_enabled() && collide_B)) {
+			speculative = _test_ccd(p_step, shape_A_ptr, xform_A, shape_B_ptr, xform_B);
+			collided = speculative;
 		}
 
-		return false;
+		return collided;
 	}
 
 	return true;
@@ -312,6 +319,27 @@ bool BodyPair3DSW::pre_solve(real_t p_step) {
 		Vector3 axis = global_A - global_B;
 		real_t depth = axis.dot(c.normal);
 
+		if (speculative) {
+			// Not touching yet, the gap can be closed during this step but not crossed.
+			c.rA = global_A - A->get_center_of_mass();
+			c.rB = global_B - B->get_center_of_mass() - offset_B;
+
+			Vector3 inertia_A = inv_inertia_tensor_A.xform(c.rA.cross(c.normal));
+			Vector3 inertia_B = inv_inertia_tensor_B.xform(c.rB.cross(c.normal));
+			real_t kNormal = inv_mass_A + inv_mass_B;
+			kNormal += c.normal.dot(inertia_A.cross(c.rA)) + c.normal.dot(inertia_B.cross(c.rB));
+			c.mass_normal = 1.0f / kNormal;
+
+			c.bias = 0;
+			c.depth = depth;
+			c.bounce = MAX(-depth, 0.0f) * inv_dt;
+			c.acc_bias_impulse = 0;
+			c.acc_bias_impulse_center_of_mass = 0;
+			c.active = true;
+			do_process = true;
+			continue;
+		}
+
 		if (depth <= 0.0) {
 			continue;
 		}
@@ -75,6 +75,14 @@ int BroadPhase3DBVH::cull_aabb(const AABB &p_aabb, CollisionObject3DSW **p_resul
 	return bvh.cull_aabb(p_aabb, p_results, p_max_results, p_result_indices);
 }
 
+void BroadPhase3DBVH::cull_segments(const Vector3 *p_from, const Vector3 *p_to, int p_count, int p_max_results, LocalVector<PacketHit> &r_hits) const {
+	bvh.cull_segments(p_from, p_to, p_count, p_max_results, r_hits);
+}
+
+void BroadPhase3DBVH::cull_aabbs(const AABB *p_aabbs, int p_count, int p_max_results, LocalVector<PacketHit> &r_hits) const {
+	bvh.cull_aabbs(p_aabbs, p_count, p_max_results, r_hits);
+}
+
 void *BroadPhase3DBVH::_pair_callback(void *self, uint32_t p_A, CollisionObject3DSW *p_object_A, int subindex_A, uint32_t p_B, CollisionObject3DSW *p_object_B, int subindex_B) {
 	BroadPhase3DBVH *bpo = (BroadPhase3DBVH *)(self);
 	if (!bpo->pair_callback) {
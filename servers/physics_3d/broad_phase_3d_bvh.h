@@ -60,6 +60,9 @@ public:
 	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, CollisionObject3DSW **p_results, int p_max_results, int *p_result_indices = nullptr);
 	virtual int cull_aabb(const AABB &p_aabb, CollisionObject3DSW **p_results, int p_max_results, int *p_result_indices = nullptr);
 
+	virtual void cull_segments(const Vector3 *p_from, const Vector3 *p_to, int p_count, int p_max_results, LocalVector<PacketHit> &r_hits) const;
+	virtual void cull_aabbs(const AABB *p_aabbs, int p_count, int p_max_results, LocalVector<PacketHit> &r_hits) const;
+
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata);
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
 
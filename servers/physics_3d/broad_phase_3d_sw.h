@@ -32,7 +32,9 @@
 #define BROAD_PHASE_SW_H
 
 #include "core/math/aabb.h"
+#include "core/math/bvh_tree.h"
 #include "core/math/math_funcs.h"
+#include "core/templates/local_vector.h"
 
 class CollisionObject3DSW;
 
@@ -44,6 +46,8 @@ public:
 
 	typedef uint32_t ID;
 
+	typedef BVH_PacketHit<CollisionObject3DSW> PacketHit;
+
 	typedef void *(*PairCallback)(CollisionObject3DSW *A, int p_subindex_A, CollisionObject3DSW *B, int p_subindex_B, void *p_userdata);
 	typedef void (*UnpairCallback)(CollisionObject3DSW *A, int p_subindex_A, CollisionObject3DSW *B, int p_subindex_B, void *p_data, void *p_userdata);
 
@@ -61,6 +65,11 @@ public:
 	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, CollisionObject3DSW **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
 	virtual int cull_aabb(const AABB &p_aabb, CollisionObject3DSW **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
 
+	// Packets of up to BVHCommon::CULL_PACKET_MAX queries, the hits are appended to r_hits.
+	// Unlike the culls above, these can be called from several threads at once.
+	virtual void cull_segments(const Vector3 *p_from, const Vector3 *p_to, int p_count, int p_max_results, LocalVector<PacketHit> &r_hits) const = 0;
+	virtual void cull_aabbs(const AABB *p_aabbs, int p_count, int p_max_results, LocalVector<PacketHit> &r_hits) const = 0;
+
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) = 0;
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) = 0;
 
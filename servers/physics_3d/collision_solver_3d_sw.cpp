@@ -570,3 +570,116 @@ bool CollisionSolver3DSW::solve_distance(const Shape3DSW *p_shape_A, const Trans
 		return gjk_epa_calculate_distance(p_shape_A, p_transform_A, p_shape_B, p_transform_B, r_point_A, r_point_B); //should pass sepaxis..
 	}
 }
+
+struct _ConcaveTimeOfImpactInfo {
+	const Transform3D *transform_A;
+	const Shape3DSW *shape_A;
+	const Transform3D *transform_B;
+	Vector3 motion;
+	real_t tolerance;
+	bool hit;
+	real_t toi;
+	Vector3 point_A, point_B, normal;
+};
+
+bool CollisionSolver3DSW::concave_time_of_impact_callback(void *p_userdata, Shape3DSW *p_convex) {
+	_ConcaveTimeOfImpactInfo &cinfo = *(_ConcaveTimeOfImpactInfo *)(p_userdata);
+
+	real_t toi;
+	Vector3 point_A, point_B, normal;
+	if (gjk_epa_calculate_time_of_impact(cinfo.shape_A, *cinfo.transform_A, cinfo.motion, p_convex, *cinfo.transform_B, cinfo.tolerance, toi, point_A, point_B, normal)) {
+		if (!cinfo.hit || toi < cinfo.toi) {
+			cinfo.hit = true;
+			cinfo.toi = toi;
+			cinfo.point_A = point_A;
+			cinfo.point_B = point_B;
+			cinfo.normal = normal;
+		}
+	}
+
+	return false;
+}
+
+bool CollisionSolver3DSW::solve_time_of_impact_plane(const Shape3DSW *p_shape_A, const Transform3D &p_transform_A, const Vector3 &p_motion, const Shape3DSW *p_shape_B, const Transform3D &p_transform_B, real_t p_tolerance, real_t &r_toi, Vector3 &r_point_A, Vector3 &r_point_B, Vector3 &r_normal) {
+	const PlaneShape3DSW *plane = static_cast<const PlaneShape3DSW *>(p_shape_B);
+	Plane p = p_transform_B.xform(plane->get_plane());
+
+	real_t closing = -p_motion.dot(p.normal);
+	if (closing <= CMP_EPSILON) {
+		return false;
+	}
+
+	Vector3 point_plane, point_A;
+	if (solve_distance_plane(p_shape_B, p_transform_B, p_shape_A, p_transform_A, point_plane, point_A)) {
+		return false; // Already touching.
+	}
+
+	real_t toi = MAX(p.distance_to(point_A) - p_tolerance, (real_t)0.0) / closing;
+	if (toi > 1.0) {
+		return false;
+	}
+
+	r_toi = toi;
+	r_point_A = point_A + p_motion * toi;
+	r_point_B = p.project(r_point_A);
+	r_normal = -p.normal;
+	return true;
+}
+
+bool CollisionSolver3DSW::solve_time_of_impact(const Shape3DSW *p_shape_A, const Transform3D &p_transform_A, const Vector3 &p_motion, const Shape3DSW *p_shape_B, const Transform3D &p_transform_B, real_t p_tolerance, real_t &r_toi, Vector3 &r_point_A, Vector3 &r_point_B, Vector3 &r_normal) {
+	PhysicsServer3D::ShapeType type_A = p_shape_A->get_type();
+	PhysicsServer3D::ShapeType type_B = p_shape_B->get_type();
+	bool static_A = p_shape_A->is_concave() || type_A == PhysicsServer3D::SHAPE_PLANE;
+	bool static_B = p_shape_B->is_concave() || type_B == PhysicsServer3D::SHAPE_PLANE;
+
+	if (static_A && static_B) {
+		return false;
+	}
+
+	if (static_A) {
+		// Sweep B backwards against A instead, then move the result back to the frame where A moves.
+		Vector3 normal;
+		if (!solve_time_of_impact(p_shape_B, p_transform_B, -p_motion, p_shape_A, p_transform_A, p_tolerance, r_toi, r_point_B, r_point_A, normal)) {
+			return false;
+		}
+		r_point_A += p_motion * r_toi;
+		r_point_B += p_motion * r_toi;
+		r_normal = -normal;
+		return true;
+	}
+
+	if (type_B == PhysicsServer3D::SHAPE_PLANE) {
+		return solve_time_of_impact_plane(p_shape_A, p_transform_A, p_motion, p_shape_B, p_transform_B, p_tolerance, r_toi, r_point_A, r_point_B, r_normal);
+	}
+
+	if (p_shape_B->is_concave()) {
+		const ConcaveShape3DSW *concave_B = static_cast<const ConcaveShape3DSW *>(p_shape_B);
+
+		_ConcaveTimeOfImpactInfo cinfo;
+		cinfo.transform_A = &p_transform_A;
+		cinfo.shape_A = p_shape_A;
+		cinfo.transform_B = &p_transform_B;
+		cinfo.motion = p_motion;
+		cinfo.tolerance = p_tolerance;
+		cinfo.hit = false;
+		cinfo.toi = 0;
+
+		// Only the faces touched by the swept AABB of A can be hit.
+		AABB swept_aabb = p_transform_A.xform(p_shape_A->get_aabb());
+		swept_aabb = swept_aabb.merge(AABB(swept_aabb.position + p_motion, swept_aabb.size));
+		AABB local_aabb = p_transform_B.affine_inverse().xform(swept_aabb.grow(p_tolerance));
+
+		concave_B->cull(local_aabb, concave_time_of_impact_callback, &cinfo);
+		if (!cinfo.hit) {
+			return false;
+		}
+
+		r_toi = cinfo.toi;
+		r_point_A = cinfo.point_A;
+		r_point_B = cinfo.point_B;
+		r_normal = cinfo.normal;
+		return true;
+	}
+
+	return gjk_epa_calculate_time_of_impact(p_shape_A, p_transform_A, p_motion, p_shape_B, p_transform_B, p_tolerance, r_toi, r_point_A, r_point_B, r_normal);
+}
@@ -47,11 +47,14 @@ private:
 	static bool solve_soft_body(const Shape3DSW *p_shape_A, const Transform3D &p_transform_A, const Shape3DSW *p_shape_B, const Transform3D &p_transform_B, CallbackResult p_result_callback, void *p_userdata, bool p_swap_result);
 	static bool solve_concave(const Shape3DSW *p_shape_A, const Transform3D &p_transform_A, const Shape3DSW *p_shape_B, const Transform3D &p_transform_B, CallbackResult p_result_callback, void *p_userdata, bool p_swap_result, real_t p_margin_A = 0, real_t p_margin_B = 0);
 	static bool concave_distance_callback(void *p_userdata, Shape3DSW *p_convex);
+	static bool concave_time_of_impact_callback(void *p_userdata, Shape3DSW *p_convex);
+	static bool solve_time_of_impact_plane(const Shape3DSW *p_shape_A, const Transform3D &p_transform_A, const Vector3 &p_motion, const Shape3DSW *p_shape_B, const Transform3D &p_transform_B, real_t p_tolerance, real_t &r_toi, Vector3 &r_point_A, Vector3 &r_point_B, Vector3 &r_normal);
 	static bool solve_distance_plane(const Shape3DSW *p_shape_A, const Transform3D &p_transform_A, const Shape3DSW *p_shape_B, const Transform3D &p_transform_B, Vector3 &r_point_A, Vector3 &r_point_B);
 
 public:
 	static bool solve_static(const Shape3DSW *p_shape_A, const Transform3D &p_transform_A, const Shape3DSW *p_shape_B, const Transform3D &p_transform_B, CallbackResult p_result_callback, void *p_userdata, Vector3 *r_sep_axis = nullptr, real_t p_margin_A = 0, real_t p_margin_B = 0);
 	static bool solve_distance(const Shape3DSW *p_shape_A, const Transform3D &p_transform_A, const Shape3DSW *p_shape_B, const Transform3D &p_transform_B, Vector3 &r_point_A, Vector3 &r_point_B, const AABB &p_concave_hint, Vector3 *r_sep_axis = nullptr);
+	static bool solve_time_of_impact(const Shape3DSW *p_shape_A, const Transform3D &p_transform_A, const Vector3 &p_motion, const Shape3DSW *p_shape_B, const Transform3D &p_transform_B, real_t p_tolerance, real_t &r_toi, Vector3 &r_point_A, Vector3 &r_point_B, Vector3 &r_normal);
 };
 
 #endif // COLLISION_SOLVER__SW_H
@@ -1005,6 +1005,51 @@ bool gjk_epa_calculate_distance(const Shape3DSW *p_shape_A, const Transform3D &p
 	return false;
 }
 
+bool gjk_epa_calculate_time_of_impact(const Shape3DSW *p_shape_A, const Transform3D &p_transform_A, const Vector3 &p_motion, const Shape3DSW *p_shape_B, const Transform3D &p_transform_B, real_t p_tolerance, real_t &r_toi, Vector3 &r_point_A, Vector3 &r_point_B, Vector3 &r_normal) {
+	// Conservative advancement: shape A is moved along p_motion (relative to B) in steps that can't
+	// make the shapes touch, as the distance can't shrink faster than the motion along the closest direction.
+	static const int max_iterations = 32;
+
+	Transform3D transform_A = p_transform_A;
+	real_t toi = 0.0;
+
+	for (int i = 0; i < max_iterations; i++) {
+		GjkEpa2::sResults res;
+		if (!GjkEpa2::Distance(p_shape_A, transform_A, 0.0, p_shape_B, p_transform_B, 0.0, p_transform_B.origin - transform_A.origin, res)) {
+			if (i == 0) {
+				// Already touching, this is handled by the regular contacts.
+				return false;
+			}
+			// Numerical issue after advancing, keep the last separated result.
+			break;
+		}
+
+		Vector3 normal = -res.normal; // From A to B.
+		real_t closing = p_motion.dot(normal);
+		if (closing <= CMP_EPSILON) {
+			return false; // Moving apart, or parallel to the closest feature.
+		}
+
+		r_point_A = res.witnesses[0];
+		r_point_B = res.witnesses[1];
+		r_normal = normal;
+
+		if (res.distance <= p_tolerance) {
+			break;
+		}
+
+		toi += (res.distance - p_tolerance * 0.5) / closing;
+		if (toi > 1.0) {
+			return false;
+		}
+
+		transform_A.origin = p_transform_A.origin + p_motion * toi;
+	}
+
+	r_toi = toi;
+	return true;
+}
+
 bool gjk_epa_calculate_penetration(const Shape3DSW *p_shape_A, const Transform3D &p_transform_A, const Shape3DSW *p_shape_B, const Transform3D &p_transform_B, CollisionSolver3DSW::CallbackResult p_result_callback, void *p_userdata, bool p_swap, real_t p_margin_A, real_t p_margin_B) {
 	GjkEpa2::sResults res;
 
@@ -32,6 +32,7 @@
 
 #include "collision_solver_3d_sw.h"
 #include "core/config/project_settings.h"
+#include "core/os/worker_thread_pool.h"
 #include "physics_server_3d_sw.h"
 
 _FORCE_INLINE_ static bool _can_collide_with(CollisionObject3DSW *p_object, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
@@ -104,14 +105,18 @@ int PhysicsDirectSpaceState3DSW::intersect_point(const Vector3 &p_point, ShapeRe
 bool PhysicsDirectSpaceState3DSW::intersect_ray(const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_ray) {
 	ERR_FAIL_COND_V(space->locked, false);
 
+	int amount = space->broadphase->cull_segment(p_from, p_to, space->intersection_query_results, Space3DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	return _intersect_ray(p_from, p_to, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_result, p_exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas, p_pick_ray);
+}
+
+bool PhysicsDirectSpaceState3DSW::_intersect_ray(const Vector3 &p_from, const Vector3 &p_to, CollisionObject3DSW *const *p_objects, const int *p_subindices, int p_amount, RayResult &r_result, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_ray) const {
 	Vector3 begin, end;
 	Vector3 normal;
 	begin = p_from;
 	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, Space3DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -120,22 +125,22 @@ bool PhysicsDirectSpaceState3DSW::intersect_ray(const Vector3 &p_from, const Vec
 	const CollisionObject3DSW *res_obj;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_collision_mask, p_collide_with_bodies, p_collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_objects[i], p_collision_mask, p_collide_with_bodies, p_collide_with_areas)) {
 			continue;
 		}
 
-		if (p_pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
+		if (p_pick_ray && !(p_objects[i]->is_ray_pickable())) {
 			continue;
 		}
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_exclude.has(p_objects[i]->get_self())) {
 			continue;
 		}
 
-		const CollisionObject3DSW *col_obj = space->intersection_query_results[i];
+		const CollisionObject3DSW *col_obj = p_objects[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_subindices[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -192,29 +197,33 @@ int PhysicsDirectSpaceState3DSW::intersect_shape(const RID &p_shape, const Trans
 
 	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, Space3DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
+	return _intersect_shape(shape, p_xform, p_margin, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_results, p_result_max, p_exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+}
+
+int PhysicsDirectSpaceState3DSW::_intersect_shape(const Shape3DSW *p_shape, const Transform3D &p_xform, real_t p_margin, CollisionObject3DSW *const *p_objects, const int *p_subindices, int p_amount, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) const {
 	int cc = 0;
 
 	//Transform3D ai = p_xform.affine_inverse();
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_amount; i++) {
 		if (cc >= p_result_max) {
 			break;
 		}
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_collision_mask, p_collide_with_bodies, p_collide_with_areas)) {
+		if (!_can_collide_with(p_objects[i], p_collision_mask, p_collide_with_bodies, p_collide_with_areas)) {
 			continue;
 		}
 
 		//area can't be picked by ray (default)
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_exclude.has(p_objects[i]->get_self())) {
 			continue;
 		}
 
-		const CollisionObject3DSW *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const CollisionObject3DSW *col_obj = p_objects[i];
+		int shape_idx = p_subindices[i];
 
-		if (!CollisionSolver3DSW::solve_static(shape, p_xform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_margin, 0)) {
+		if (!CollisionSolver3DSW::solve_static(p_shape, p_xform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_margin, 0)) {
 			continue;
 		}
 
@@ -239,18 +248,22 @@ bool PhysicsDirectSpaceState3DSW::cast_motion(const RID &p_shape, const Transfor
 	Shape3DSW *shape = PhysicsServer3DSW::singletonsw->shape_owner.getornull(p_shape);
 	ERR_FAIL_COND_V(!shape, false);
 
-	AABB aabb = p_xform.xform(shape->get_aabb());
-	aabb = aabb.merge(AABB(aabb.position + p_motion, aabb.size)); //motion
-	aabb = aabb.grow(p_margin);
+	AABB aabb = _get_motion_aabb(shape, p_xform, p_motion, p_margin);
 
 	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, Space3DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
+	_cast_motion(shape, p_xform, p_motion, aabb, space->intersection_query_results, space->intersection_query_subindex_results, amount, p_closest_safe, p_closest_unsafe, p_exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas, r_info);
+
+	return true;
+}
+
+void PhysicsDirectSpaceState3DSW::_cast_motion(Shape3DSW *p_shape, const Transform3D &p_xform, const Vector3 &p_motion, const AABB &p_aabb, CollisionObject3DSW *const *p_objects, const int *p_subindices, int p_amount, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, ShapeRestInfo *r_info) const {
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
 	Transform3D xform_inv = p_xform.affine_inverse();
 	MotionShape3DSW mshape;
-	mshape.shape = shape;
+	mshape.shape = p_shape;
 	mshape.motion = xform_inv.basis.xform(p_motion);
 
 	bool best_first = true;
@@ -259,31 +272,31 @@ bool PhysicsDirectSpaceState3DSW::cast_motion(const RID &p_shape, const Transfor
 
 	Vector3 closest_A, closest_B;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_collision_mask, p_collide_with_bodies, p_collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_objects[i], p_collision_mask, p_collide_with_bodies, p_collide_with_areas)) {
 			continue;
 		}
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_exclude.has(p_objects[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const CollisionObject3DSW *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const CollisionObject3DSW *col_obj = p_objects[i];
+		int shape_idx = p_subindices[i];
 
 		Vector3 point_A, point_B;
 		Vector3 sep_axis = motion_normal;
 
 		Transform3D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (CollisionSolver3DSW::solve_distance(&mshape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (CollisionSolver3DSW::solve_distance(&mshape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, p_aabb, &sep_axis)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
 		sep_axis = motion_normal;
 
-		if (!CollisionSolver3DSW::solve_distance(shape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (!CollisionSolver3DSW::solve_distance(p_shape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, p_aabb, &sep_axis)) {
 			continue;
 		}
 
@@ -298,7 +311,7 @@ bool PhysicsDirectSpaceState3DSW::cast_motion(const RID &p_shape, const Transfor
 
 			Vector3 lA, lB;
 			Vector3 sep = motion_normal; //important optimization for this to work fast enough
-			bool collided = !CollisionSolver3DSW::solve_distance(&mshape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
+			bool collided = !CollisionSolver3DSW::solve_distance(&mshape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, p_aabb, &sep);
 
 			if (collided) {
 				hi = fraction;
@@ -350,8 +363,6 @@ bool PhysicsDirectSpaceState3DSW::cast_motion(const RID &p_shape, const Transfor
 
 	p_closest_safe = best_safe;
 	p_closest_unsafe = best_unsafe;
-
-	return true;
 }
 
 bool PhysicsDirectSpaceState3DSW::collide_shape(RID p_shape, const Transform3D &p_shape_xform, real_t p_margin, Vector3 *r_results, int p_result_max, int &r_result_count, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
@@ -531,6 +542,265 @@ Vector3 PhysicsDirectSpaceState3DSW::get_closest_point_to_object_volume(RID p_ob
 	}
 }
 
+AABB PhysicsDirectSpaceState3DSW::_get_motion_aabb(const Shape3DSW *p_shape, const Transform3D &p_xform, const Vector3 &p_motion, real_t p_margin) const {
+	AABB aabb = p_xform.xform(p_shape->get_aabb());
+	aabb = aabb.merge(AABB(aabb.position + p_motion, aabb.size)); //motion
+	return aabb.grow(p_margin);
+}
+
+void PhysicsDirectSpaceState3DSW::QueryScratch::group_hits(int p_query_count) {
+	for (int q = 0; q <= p_query_count; q++) {
+		offsets[q] = 0;
+	}
+	for (uint32_t i = 0; i < hits.size(); i++) {
+		offsets[hits[i].query + 1]++;
+	}
+	for (int q = 1; q <= p_query_count; q++) {
+		offsets[q] += offsets[q - 1];
+	}
+
+	int next[BVHCommon::CULL_PACKET_MAX];
+	for (int q = 0; q < p_query_count; q++) {
+		next[q] = offsets[q];
+	}
+
+	objects.resize(hits.size());
+	subindices.resize(hits.size());
+	for (uint32_t i = 0; i < hits.size(); i++) {
+		const int index = next[hits[i].query]++;
+		objects[index] = hits[i].userdata;
+		subindices[index] = hits[i].subindex;
+	}
+}
+
+void PhysicsDirectSpaceState3DSW::_sort_queries(const LocalVector<Vector3> &p_centers) {
+	// Queries are sorted along a Morton curve, so the queries of a packet
+	// are close to each other and reach the same nodes of the broadphase.
+	AABB bounds(p_centers[0], Vector3());
+	for (uint32_t i = 1; i < p_centers.size(); i++) {
+		bounds.expand_to(p_centers[i]);
+	}
+	Vector3 scale;
+	for (int i = 0; i < 3; i++) {
+		scale[i] = 1023.0 / MAX(bounds.size[i], (real_t)CMP_EPSILON);
+	}
+
+	LocalVector<uint64_t> keys;
+	keys.resize(p_centers.size());
+	for (uint32_t i = 0; i < p_centers.size(); i++) {
+		const Vector3 cell = ((p_centers[i] - bounds.position) * scale).floor();
+		uint64_t code = 0;
+		for (int bit = 0; bit < 10; bit++) {
+			code |= uint64_t((uint32_t(cell.x) >> bit) & 1) << (bit * 3);
+			code |= uint64_t((uint32_t(cell.y) >> bit) & 1) << (bit * 3 + 1);
+			code |= uint64_t((uint32_t(cell.z) >> bit) & 1) << (bit * 3 + 2);
+		}
+		keys[i] = (code << 32) | i;
+	}
+	keys.sort();
+
+	query_order.resize(keys.size());
+	for (uint32_t i = 0; i < keys.size(); i++) {
+		query_order[i] = uint32_t(keys[i] & 0xFFFFFFFF);
+	}
+
+	query_scratches.resize(WorkerThreadPool::get_singleton()->get_thread_count() + 1);
+}
+
+PhysicsDirectSpaceState3DSW::QueryScratch &PhysicsDirectSpaceState3DSW::_get_query_scratch() {
+	return query_scratches[WorkerThreadPool::get_singleton()->get_thread_index() + 1];
+}
+
+void PhysicsDirectSpaceState3DSW::_intersect_ray_packet(uint32_t p_packet, RayBatch *p_batch) {
+	QueryScratch &scratch = _get_query_scratch();
+	const int begin = p_packet * BVHCommon::CULL_PACKET_MAX;
+	const int count = MIN(int(BVHCommon::CULL_PACKET_MAX), int(query_order.size()) - begin);
+
+	Vector3 from[BVHCommon::CULL_PACKET_MAX];
+	Vector3 to[BVHCommon::CULL_PACKET_MAX];
+	for (int q = 0; q < count; q++) {
+		from[q] = p_batch->from[query_order[begin + q]];
+		to[q] = p_batch->to[query_order[begin + q]];
+	}
+
+	scratch.hits.clear();
+	space->broadphase->cull_segments(from, to, count, Space3DSW::INTERSECTION_QUERY_MAX, scratch.hits);
+	scratch.group_hits(count);
+
+	const QueryFilter &filter = p_batch->filter;
+	for (int q = 0; q < count; q++) {
+		const uint32_t index = query_order[begin + q];
+		const int offset = scratch.offsets[q];
+		p_batch->hits[index] = _intersect_ray(from[q], to[q], scratch.objects.ptr() + offset, scratch.subindices.ptr() + offset, scratch.offsets[q + 1] - offset, p_batch->results[index], *filter.exclude, filter.collision_mask, filter.collide_with_bodies, filter.collide_with_areas, p_batch->pick_ray);
+	}
+}
+
+void PhysicsDirectSpaceState3DSW::_intersect_shape_packet(uint32_t p_packet, ShapeBatch *p_batch) {
+	QueryScratch &scratch = _get_query_scratch();
+	const int begin = p_packet * BVHCommon::CULL_PACKET_MAX;
+	const int count = MIN(int(BVHCommon::CULL_PACKET_MAX), int(query_order.size()) - begin);
+
+	AABB aabbs[BVHCommon::CULL_PACKET_MAX];
+	for (int q = 0; q < count; q++) {
+		aabbs[q] = p_batch->xforms[query_order[begin + q]].xform(p_batch->shape->get_aabb());
+	}
+
+	scratch.hits.clear();
+	space->broadphase->cull_aabbs(aabbs, count, Space3DSW::INTERSECTION_QUERY_MAX, scratch.hits);
+	scratch.group_hits(count);
+
+	const QueryFilter &filter = p_batch->filter;
+	for (int q = 0; q < count; q++) {
+		const uint32_t index = query_order[begin + q];
+		const int offset = scratch.offsets[q];
+		p_batch->result_counts[index] = _intersect_shape(p_batch->shape, p_batch->xforms[index], p_batch->margin, scratch.objects.ptr() + offset, scratch.subindices.ptr() + offset, scratch.offsets[q + 1] - offset, p_batch->results + index * p_batch->result_max, p_batch->result_max, *filter.exclude, filter.collision_mask, filter.collide_with_bodies, filter.collide_with_areas);
+	}
+}
+
+void PhysicsDirectSpaceState3DSW::_cast_motion_packet(uint32_t p_packet, ShapeBatch *p_batch) {
+	QueryScratch &scratch = _get_query_scratch();
+	const int begin = p_packet * BVHCommon::CULL_PACKET_MAX;
+	const int count = MIN(int(BVHCommon::CULL_PACKET_MAX), int(query_order.size()) - begin);
+
+	AABB aabbs[BVHCommon::CULL_PACKET_MAX];
+	for (int q = 0; q < count; q++) {
+		const uint32_t index = query_order[begin + q];
+		aabbs[q] = _get_motion_aabb(p_batch->shape, p_batch->xforms[index], p_batch->motions[index], p_batch->margin);
+	}
+
+	scratch.hits.clear();
+	space->broadphase->cull_aabbs(aabbs, count, Space3DSW::INTERSECTION_QUERY_MAX, scratch.hits);
+	scratch.group_hits(count);
+
+	const QueryFilter &filter = p_batch->filter;
+	for (int q = 0; q < count; q++) {
+		const uint32_t index = query_order[begin + q];
+		const int offset = scratch.offsets[q];
+		ShapeRestInfo *info = p_batch->infos ? &p_batch->infos[index] : nullptr;
+		_cast_motion(p_batch->shape, p_batch->xforms[index], p_batch->motions[index], aabbs[q], scratch.objects.ptr() + offset, scratch.subindices.ptr() + offset, scratch.offsets[q + 1] - offset, p_batch->closest_safe[index], p_batch->closest_unsafe[index], *filter.exclude, filter.collision_mask, filter.collide_with_bodies, filter.collide_with_areas, info);
+	}
+}
+
+int PhysicsDirectSpaceState3DSW::intersect_rays(const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_ray) {
+	ERR_FAIL_COND_V(space->locked, 0);
+	if (p_ray_count <= 0) {
+		return 0;
+	}
+
+	LocalVector<Vector3> centers;
+	centers.resize(p_ray_count);
+	for (int i = 0; i < p_ray_count; i++) {
+		centers[i] = (p_from[i] + p_to[i]) * 0.5;
+	}
+	_sort_queries(centers);
+
+	RayBatch batch;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.results = r_results;
+	batch.hits = r_hits;
+	batch.pick_ray = p_pick_ray;
+	batch.filter.exclude = &p_exclude;
+	batch.filter.collision_mask = p_collision_mask;
+	batch.filter.collide_with_bodies = p_collide_with_bodies;
+	batch.filter.collide_with_areas = p_collide_with_areas;
+
+	const uint32_t packet_count = (p_ray_count + BVHCommon::CULL_PACKET_MAX - 1) / BVHCommon::CULL_PACKET_MAX;
+	if (packet_count == 1) {
+		_intersect_ray_packet(0, &batch);
+	} else {
+		WorkerThreadPool::get_singleton()->do_work(packet_count, this, &PhysicsDirectSpaceState3DSW::_intersect_ray_packet, &batch);
+	}
+
+	int hit_count = 0;
+	for (int i = 0; i < p_ray_count; i++) {
+		if (r_hits[i]) {
+			hit_count++;
+		}
+	}
+	return hit_count;
+}
+
+void PhysicsDirectSpaceState3DSW::intersect_shapes(const RID &p_shape, const Transform3D *p_xforms, int p_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	ERR_FAIL_COND(space->locked);
+	if (p_count <= 0) {
+		return;
+	}
+
+	Shape3DSW *shape = PhysicsServer3DSW::singletonsw->shape_owner.getornull(p_shape);
+	ERR_FAIL_COND(!shape);
+
+	if (p_result_max <= 0) {
+		for (int i = 0; i < p_count; i++) {
+			r_result_counts[i] = 0;
+		}
+		return;
+	}
+
+	LocalVector<Vector3> centers;
+	centers.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		centers[i] = p_xforms[i].origin;
+	}
+	_sort_queries(centers);
+
+	ShapeBatch batch;
+	batch.shape = shape;
+	batch.xforms = p_xforms;
+	batch.margin = p_margin;
+	batch.results = r_results;
+	batch.result_max = p_result_max;
+	batch.result_counts = r_result_counts;
+	batch.filter.exclude = &p_exclude;
+	batch.filter.collision_mask = p_collision_mask;
+	batch.filter.collide_with_bodies = p_collide_with_bodies;
+	batch.filter.collide_with_areas = p_collide_with_areas;
+
+	const uint32_t packet_count = (p_count + BVHCommon::CULL_PACKET_MAX - 1) / BVHCommon::CULL_PACKET_MAX;
+	if (packet_count == 1) {
+		_intersect_shape_packet(0, &batch);
+	} else {
+		WorkerThreadPool::get_singleton()->do_work(packet_count, this, &PhysicsDirectSpaceState3DSW::_intersect_shape_packet, &batch);
+	}
+}
+
+void PhysicsDirectSpaceState3DSW::cast_motions(const RID &p_shape, const Transform3D *p_xforms, const Vector3 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, ShapeRestInfo *r_infos) {
+	ERR_FAIL_COND(space->locked);
+	if (p_count <= 0) {
+		return;
+	}
+
+	Shape3DSW *shape = PhysicsServer3DSW::singletonsw->shape_owner.getornull(p_shape);
+	ERR_FAIL_COND(!shape);
+
+	LocalVector<Vector3> centers;
+	centers.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		centers[i] = p_xforms[i].origin + p_motions[i] * 0.5;
+	}
+	_sort_queries(centers);
+
+	ShapeBatch batch;
+	batch.shape = shape;
+	batch.xforms = p_xforms;
+	batch.motions = p_motions;
+	batch.margin = p_margin;
+	batch.closest_safe = r_closest_safe;
+	batch.closest_unsafe = r_closest_unsafe;
+	batch.infos = r_infos;
+	batch.filter.exclude = &p_exclude;
+	batch.filter.collision_mask = p_collision_mask;
+	batch.filter.collide_with_bodies = p_collide_with_bodies;
+	batch.filter.collide_with_areas = p_collide_with_areas;
+
+	const uint32_t packet_count = (p_count + BVHCommon::CULL_PACKET_MAX - 1) / BVHCommon::CULL_PACKET_MAX;
+	if (packet_count == 1) {
+		_cast_motion_packet(0, &batch);
+	} else {
+		WorkerThreadPool::get_singleton()->do_work(packet_count, this, &PhysicsDirectSpaceState3DSW::_cast_motion_packet, &batch);
+	}
+}
+
 PhysicsDirectSpaceState3DSW::PhysicsDirectSpaceState3DSW() {
 	space = nullptr;
 }
@@ -1159,6 +1429,8 @@ Space3DSW::Space3DSW() {
 	body_time_to_sleep = GLOBAL_DEF("physics/3d/time_before_sleep", 0.5);
 	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/time_before_sleep", PropertyInfo(Variant::FLOAT, "physics/3d/time_before_sleep", PROPERTY_HINT_RANGE, "0,5,0.01,or_greater"));
 	body_angular_velocity_damp_ratio = 10;
+	parallel_island_min_constraints = GLOBAL_DEF("physics/3d/parallel_island_min_constraints", 256);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/parallel_island_min_constraints", PropertyInfo(Variant::INT, "physics/3d/parallel_island_min_constraints", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"));
 
 	broadphase = BroadPhase3DSW::create_func();
 	broadphase->set_pair_callback(_broadphase_pair, this);
@@ -39,12 +39,74 @@
 #include "collision_object_3d_sw.h"
 #include "core/config/project_settings.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/typedefs.h"
 #include "soft_body_3d_sw.h"
 
 class PhysicsDirectSpaceState3DSW : public PhysicsDirectSpaceState3D {
 	GDCLASS(PhysicsDirectSpaceState3DSW, PhysicsDirectSpaceState3D);
 
+	// Batches are culled in packets of queries close to each other, the
+	// packets are spread over the worker threads.
+	struct QueryScratch {
+		LocalVector<BroadPhase3DSW::PacketHit> hits;
+		// The hits sorted by query, from offsets[query] to offsets[query + 1].
+		LocalVector<CollisionObject3DSW *> objects;
+		LocalVector<int> subindices;
+		int offsets[BVHCommon::CULL_PACKET_MAX + 1];
+
+		void group_hits(int p_query_count);
+	};
+
+	struct QueryFilter {
+		const Set<RID> *exclude = nullptr;
+		uint32_t collision_mask = UINT32_MAX;
+		bool collide_with_bodies = true;
+		bool collide_with_areas = false;
+	};
+
+	struct RayBatch {
+		const Vector3 *from = nullptr;
+		const Vector3 *to = nullptr;
+		RayResult *results = nullptr;
+		bool *hits = nullptr;
+		bool pick_ray = false;
+		QueryFilter filter;
+	};
+
+	struct ShapeBatch {
+		Shape3DSW *shape = nullptr;
+		const Transform3D *xforms = nullptr;
+		const Vector3 *motions = nullptr;
+		real_t margin = 0.0;
+		// intersect_shapes
+		ShapeResult *results = nullptr;
+		int result_max = 0;
+		int *result_counts = nullptr;
+		// cast_motions
+		real_t *closest_safe = nullptr;
+		real_t *closest_unsafe = nullptr;
+		ShapeRestInfo *infos = nullptr;
+		QueryFilter filter;
+	};
+
+	// Order of the queries of the current batch.
+	LocalVector<uint32_t> query_order;
+	// One per worker thread, and one for the calling thread.
+	LocalVector<QueryScratch> query_scratches;
+
+	bool _intersect_ray(const Vector3 &p_from, const Vector3 &p_to, CollisionObject3DSW *const *p_objects, const int *p_subindices, int p_amount, RayResult &r_result, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_ray) const;
+	int _intersect_shape(const Shape3DSW *p_shape, const Transform3D &p_xform, real_t p_margin, CollisionObject3DSW *const *p_objects, const int *p_subindices, int p_amount, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) const;
+	void _cast_motion(Shape3DSW *p_shape, const Transform3D &p_xform, const Vector3 &p_motion, const AABB &p_aabb, CollisionObject3DSW *const *p_objects, const int *p_subindices, int p_amount, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, ShapeRestInfo *r_info) const;
+
+	void _sort_queries(const LocalVector<Vector3> &p_centers);
+	QueryScratch &_get_query_scratch();
+	AABB _get_motion_aabb(const Shape3DSW *p_shape, const Transform3D &p_xform, const Vector3 &p_motion, real_t p_margin) const;
+
+	void _intersect_ray_packet(uint32_t p_packet, RayBatch *p_batch);
+	void _intersect_shape_packet(uint32_t p_packet, ShapeBatch *p_batch);
+	void _cast_motion_packet(uint32_t p_packet, ShapeBatch *p_batch);
+
 public:
 	Space3DSW *space;
 
@@ -56,6 +118,10 @@ public:
 	virtual bool rest_info(RID p_shape, const Transform3D &p_shape_xform, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = UINT32_MAX, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const override;
 
+	virtual int intersect_rays(const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = UINT32_MAX, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_pick_ray = false) override;
+	virtual void intersect_shapes(const RID &p_shape, const Transform3D *p_xforms, int p_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = UINT32_MAX, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+	virtual void cast_motions(const RID &p_shape, const Transform3D *p_xforms, const Vector3 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = UINT32_MAX, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, ShapeRestInfo *r_infos = nullptr) override;
+
 	PhysicsDirectSpaceState3DSW();
 };
 
@@ -110,6 +176,8 @@ private:
 	real_t body_time_to_sleep;
 	real_t body_angular_velocity_damp_ratio;
 
+	int parallel_island_min_constraints;
+
 	bool locked;
 
 	real_t last_step = 0.001;
@@ -167,6 +235,7 @@ public:
 	_FORCE_INLINE_ real_t get_body_angular_velocity_sleep_threshold() const { return body_angular_velocity_sleep_threshold; }
 	_FORCE_INLINE_ real_t get_body_time_to_sleep() const { return body_time_to_sleep; }
 	_FORCE_INLINE_ real_t get_body_angular_velocity_damp_ratio() const { return body_angular_velocity_damp_ratio; }
+	_FORCE_INLINE_ int get_parallel_island_min_constraints() const { return parallel_island_min_constraints; }
 
 	void update();
 	void setup();
@@ -32,6 +32,7 @@
 #include "joints_3d_sw.h"
 
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 
 #define BODY_ISLAND_COUNT_RESERVE 128
 #define BODY_ISLAND_SIZE_RESERVE 512
@@ -39,6 +40,10 @@
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
 
+// Colors with less constraints than this are not worth dispatching to threads.
+#define PARALLEL_COLOR_MIN_CONSTRAINTS 32
+#define MAX_CONSTRAINT_COLORS 64
+
 void Step3DSW::_populate_island(Body3DSW *p_body, LocalVector<Body3DSW *> &p_body_island, LocalVector<Constraint3DSW *> &p_constraint_island) {
 	p_body->set_island_step(_step);
 
@@ -128,9 +133,122 @@ void Step3DSW::_pre_solve_island(LocalVector<Constraint3DSW *> &p_constraint_isl
 	p_constraint_island.resize(valid_constraint_count);
 }
 
+bool Step3DSW::color_island(const LocalVector<Constraint3DSW *> &p_constraint_island, ColoredIsland &r_colored_island) {
+	// Greedy coloring: each constraint gets the first color not used yet by any of its dynamic bodies.
+	// Static and kinematic bodies are only read by the solver, so they can be shared by any number of constraints.
+	// The ones that don't fit in any color go to a last group which is solved serially.
+	HashMap<RID, uint64_t> body_colors;
+	LocalVector<uint32_t> constraint_colors;
+	constraint_colors.resize(p_constraint_island.size());
+
+	r_colored_island.color_offsets.resize(MAX_CONSTRAINT_COLORS + 2);
+	for (uint32_t color = 0; color < r_colored_island.color_offsets.size(); ++color) {
+		r_colored_island.color_offsets[color] = 0;
+	}
+
+	uint32_t constraint_count = p_constraint_island.size();
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		Constraint3DSW *constraint = p_constraint_island[constraint_index];
+		if (constraint->get_soft_body_count() > 0) {
+			return false; // Soft bodies are updated as a whole.
+		}
+
+		uint64_t used_colors = 0;
+		for (int i = 0; i < constraint->get_body_count(); i++) {
+			const Body3DSW *body = constraint->get_body_ptr()[i];
+			if (body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+				used_colors |= body_colors[body->get_self()];
+			}
+		}
+
+		uint32_t color = 0;
+		while (color < MAX_CONSTRAINT_COLORS && (used_colors & (uint64_t(1) << color))) {
+			++color;
+		}
+
+		if (color < MAX_CONSTRAINT_COLORS) {
+			for (int i = 0; i < constraint->get_body_count(); i++) {
+				const Body3DSW *body = constraint->get_body_ptr()[i];
+				if (body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+					body_colors[body->get_self()] |= uint64_t(1) << color;
+				}
+			}
+		}
+
+		constraint_colors[constraint_index] = color;
+		r_colored_island.color_offsets[color + 1]++;
+	}
+
+	for (uint32_t color = 1; color < r_colored_island.color_offsets.size(); ++color) {
+		r_colored_island.color_offsets[color] += r_colored_island.color_offsets[color - 1];
+	}
+
+	// Keep the original order inside each color, it's the order the serial solver would use.
+	LocalVector<uint32_t> next = r_colored_island.color_offsets;
+	r_colored_island.constraints.resize(constraint_count);
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		r_colored_island.constraints[next[constraint_colors[constraint_index]]++] = p_constraint_island[constraint_index];
+	}
+
+	return true;
+}
+
+void Step3DSW::_solve_constraint(uint32_t p_constraint_index, Constraint3DSW **p_constraints) {
+	p_constraints[p_constraint_index]->solve(delta);
+}
+
+void Step3DSW::_solve_colored_island(ColoredIsland &p_colored_island) {
+	LocalVector<uint32_t> &color_offsets = p_colored_island.color_offsets;
+	Constraint3DSW **constraints = p_colored_island.constraints.ptr();
+	uint32_t color_count = color_offsets.size() - 1;
+
+	int current_priority = 1;
+
+	while (color_offsets[color_count] > 0) {
+		for (int i = 0; i < iterations; i++) {
+			for (uint32_t color = 0; color < color_count; ++color) {
+				uint32_t begin = color_offsets[color];
+				uint32_t count = color_offsets[color + 1] - begin;
+				if (count >= PARALLEL_COLOR_MIN_CONSTRAINTS && color < MAX_CONSTRAINT_COLORS) {
+					WorkerThreadPool::get_singleton()->do_work(count, this, &Step3DSW::_solve_constraint, constraints + begin);
+				} else {
+					for (uint32_t constraint_index = begin; constraint_index < begin + count; ++constraint_index) {
+						constraints[constraint_index]->solve(delta);
+					}
+				}
+			}
+		}
+
+		// Check priority to keep only higher priority constraints, color by color.
+		uint32_t priority_constraint_count = 0;
+		++current_priority;
+		uint32_t begin = 0;
+		for (uint32_t color = 0; color < color_count; ++color) {
+			uint32_t end = color_offsets[color + 1];
+			for (uint32_t constraint_index = begin; constraint_index < end; ++constraint_index) {
+				Constraint3DSW *constraint = constraints[constraint_index];
+				if (constraint->get_priority() >= current_priority) {
+					// Keep this constraint for the next iteration.
+					constraints[priority_constraint_count++] = constraint;
+				}
+			}
+			begin = end;
+			color_offsets[color + 1] = priority_constraint_count;
+		}
+	}
+}
+
 void Step3DSW::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	LocalVector<Constraint3DSW *> &constraint_island = constraint_islands[p_island_index];
 
+	if (parallel_island_min_constraints > 0 && constraint_island.size() >= (uint32_t)parallel_island_min_constraints) {
+		ColoredIsland colored_island;
+		if (color_island(constraint_island, colored_island)) {
+			_solve_colored_island(colored_island);
+			return;
+		}
+	}
+
 	int current_priority = 1;
 
 	uint32_t constraint_count = constraint_island.size();
@@ -189,6 +307,7 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	iterations = p_iterations;
 	delta = p_delta;
+	parallel_island_min_constraints = p_space->get_parallel_island_min_constraints();
 
 	const SelfList<Body3DSW>::List *body_list = &p_space->get_active_body_list();
 
@@ -339,7 +458,7 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
 
 	uint32_t total_contraint_count = all_constraints.size();
-	work_pool.do_work(total_contraint_count, this, &Step3DSW::_setup_contraint, nullptr);
+	WorkerThreadPool::get_singleton()->do_work(total_contraint_count, this, &Step3DSW::_setup_contraint, nullptr);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -358,8 +477,9 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	// Warning: _solve_island modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
+	// Large islands are also split into colors which are solved in parallel, see _solve_colored_island().
 	if (island_count > 1) {
-		work_pool.do_work(island_count, this, &Step3DSW::_solve_island, nullptr);
+		WorkerThreadPool::get_singleton()->do_work(island_count, this, &Step3DSW::_solve_island, nullptr);
 	} else if (island_count > 0) {
 		_solve_island(0);
 	}
@@ -412,10 +532,7 @@ Step3DSW::Step3DSW() {
 	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
-
-	work_pool.init();
 }
 
 Step3DSW::~Step3DSW() {
-	work_pool.finish();
 }
@@ -34,15 +34,26 @@
 #include "space_3d_sw.h"
 
 #include "core/templates/local_vector.h"
-#include "core/templates/thread_work_pool.h"
 
 class Step3DSW {
+public:
+	// Constraints of a large island, grouped by color so that no two constraints
+	// of the same color write to the same body and each color can be solved in parallel.
+	// The constraints of color `i` are from `color_offsets[i]` to `color_offsets[i + 1]`,
+	// the last color holds the ones that didn't fit in any other and is solved serially.
+	struct ColoredIsland {
+		LocalVector<Constraint3DSW *> constraints;
+		LocalVector<uint32_t> color_offsets;
+	};
+
+	static bool color_island(const LocalVector<Constraint3DSW *> &p_constraint_island, ColoredIsland &r_colored_island);
+
+private:
 	uint64_t _step;
 
 	int iterations = 0;
 	real_t delta = 0.0;
-
-	ThreadWorkPool work_pool;
+	int parallel_island_min_constraints = 0;
 
 	LocalVector<LocalVector<Body3DSW *>> body_islands;
 	LocalVector<LocalVector<Constraint3DSW *>> constraint_islands;
@@ -53,6 +64,8 @@ class Step3DSW {
 	void _setup_contraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
 	void _pre_solve_island(LocalVector<Constraint3DSW *> &p_constraint_island) const;
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
+	void _solve_colored_island(ColoredIsland &p_colored_island);
+	void _solve_constraint(uint32_t p_constraint_index, Constraint3DSW **p_constraints);
 	void _check_suspend(const LocalVector<Body3DSW *> &p_body_island) const;
 
 public:
@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/string/print_string.h"
+#include "core/templates/local_vector.h"
 
 PhysicsServer3D *PhysicsServer3D::singleton = nullptr;
 
@@ -349,6 +350,128 @@ Dictionary PhysicsDirectSpaceState3D::_get_rest_info(const Ref<PhysicsShapeQuery
 	return r;
 }
 
+Array PhysicsDirectSpaceState3D::_intersect_rays(const PackedVector3Array &p_from, const PackedVector3Array &p_to, const Vector<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	ERR_FAIL_COND_V(p_from.size() != p_to.size(), Array());
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude.size(); i++) {
+		exclude.insert(p_exclude[i]);
+	}
+
+	Vector<RayResult> results;
+	results.resize(p_from.size());
+	LocalVector<bool> hits;
+	hits.resize(p_from.size());
+	intersect_rays(p_from.ptr(), p_to.ptr(), p_from.size(), results.ptrw(), hits.ptr(), exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+
+	Array ret;
+	ret.resize(p_from.size());
+	for (int i = 0; i < p_from.size(); i++) {
+		Dictionary d;
+		if (hits[i]) {
+			d["position"] = results[i].position;
+			d["normal"] = results[i].normal;
+			d["collider_id"] = results[i].collider_id;
+			d["collider"] = results[i].collider;
+			d["shape"] = results[i].shape;
+			d["rid"] = results[i].rid;
+		}
+		ret[i] = d;
+	}
+
+	return ret;
+}
+
+Array PhysicsDirectSpaceState3D::_intersect_shapes(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const Array &p_transforms, int p_max_results) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
+
+	Vector<Transform3D> xforms;
+	xforms.resize(p_transforms.size());
+	for (int i = 0; i < p_transforms.size(); i++) {
+		xforms.write[i] = p_transforms[i];
+	}
+
+	Vector<ShapeResult> sr;
+	sr.resize(xforms.size() * p_max_results);
+	Vector<int> counts;
+	counts.resize(xforms.size());
+	intersect_shapes(p_shape_query->shape, xforms.ptr(), xforms.size(), p_shape_query->margin, sr.ptrw(), p_max_results, counts.ptrw(), p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
+
+	Array ret;
+	ret.resize(xforms.size());
+	for (int i = 0; i < xforms.size(); i++) {
+		Array shapes;
+		shapes.resize(counts[i]);
+		for (int j = 0; j < counts[i]; j++) {
+			const ShapeResult &result = sr[i * p_max_results + j];
+			Dictionary d;
+			d["rid"] = result.rid;
+			d["collider_id"] = result.collider_id;
+			d["collider"] = result.collider;
+			d["shape"] = result.shape;
+			shapes[j] = d;
+		}
+		ret[i] = shapes;
+	}
+
+	return ret;
+}
+
+Array PhysicsDirectSpaceState3D::_cast_motions(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const Array &p_transforms, const PackedVector3Array &p_motions) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
+	ERR_FAIL_COND_V(p_transforms.size() != p_motions.size(), Array());
+
+	Vector<Transform3D> xforms;
+	xforms.resize(p_transforms.size());
+	for (int i = 0; i < p_transforms.size(); i++) {
+		xforms.write[i] = p_transforms[i];
+	}
+
+	Vector<real_t> closest_safe;
+	closest_safe.resize(xforms.size());
+	Vector<real_t> closest_unsafe;
+	closest_unsafe.resize(xforms.size());
+	cast_motions(p_shape_query->shape, xforms.ptr(), p_motions.ptr(), xforms.size(), p_shape_query->margin, closest_safe.ptrw(), closest_unsafe.ptrw(), p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
+
+	Array ret;
+	ret.resize(xforms.size());
+	for (int i = 0; i < xforms.size(); i++) {
+		Array r;
+		r.resize(2);
+		r[0] = closest_safe[i];
+		r[1] = closest_unsafe[i];
+		ret[i] = r;
+	}
+
+	return ret;
+}
+
+int PhysicsDirectSpaceState3D::intersect_rays(const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_ray) {
+	int hit_count = 0;
+	for (int i = 0; i < p_ray_count; i++) {
+		r_hits[i] = intersect_ray(p_from[i], p_to[i], r_results[i], p_exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas, p_pick_ray);
+		if (r_hits[i]) {
+			hit_count++;
+		}
+	}
+	return hit_count;
+}
+
+void PhysicsDirectSpaceState3D::intersect_shapes(const RID &p_shape, const Transform3D *p_xforms, int p_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	for (int i = 0; i < p_count; i++) {
+		r_result_counts[i] = intersect_shape(p_shape, p_xforms[i], p_margin, r_results + i * p_result_max, p_result_max, p_exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+	}
+}
+
+void PhysicsDirectSpaceState3D::cast_motions(const RID &p_shape, const Transform3D *p_xforms, const Vector3 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, ShapeRestInfo *r_infos) {
+	for (int i = 0; i < p_count; i++) {
+		r_closest_safe[i] = 1.0;
+		r_closest_unsafe[i] = 1.0;
+		cast_motion(p_shape, p_xforms[i], p_motions[i], p_margin, r_closest_safe[i], r_closest_unsafe[i], p_exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas, r_infos ? &r_infos[i] : nullptr);
+	}
+}
+
 PhysicsDirectSpaceState3D::PhysicsDirectSpaceState3D() {
 }
 
@@ -358,6 +481,9 @@ void PhysicsDirectSpaceState3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("cast_motion", "shape", "motion"), &PhysicsDirectSpaceState3D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "shape", "max_results"), &PhysicsDirectSpaceState3D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "shape"), &PhysicsDirectSpaceState3D::_get_rest_info);
+	ClassDB::bind_method(D_METHOD("intersect_rays", "from", "to", "exclude", "collision_mask", "collide_with_bodies", "collide_with_areas"), &PhysicsDirectSpaceState3D::_intersect_rays, DEFVAL(Array()), DEFVAL(UINT32_MAX), DEFVAL(true), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("intersect_shapes", "shape", "transforms", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shapes, DEFVAL(32));
+	ClassDB::bind_method(D_METHOD("cast_motions", "shape", "transforms", "motions"), &PhysicsDirectSpaceState3D::_cast_motions);
 }
 
 ///////////////////////////////
@@ -147,6 +147,9 @@ private:
 	Array _cast_motion(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const Vector3 &p_motion);
 	Array _collide_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query);
+	Array _intersect_rays(const PackedVector3Array &p_from, const PackedVector3Array &p_to, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = UINT32_MAX, bool p_collide_with_bodies = true, bool p_collide_with_areas = false);
+	Array _intersect_shapes(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const Array &p_transforms, int p_max_results = 32);
+	Array _cast_motions(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const Array &p_transforms, const PackedVector3Array &p_motions);
 
 protected:
 	static void _bind_methods();
@@ -191,6 +194,16 @@ public:
 
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const = 0;
 
+	// Batches of queries sharing the same filters. By default they are run one by one.
+
+	// r_results and r_hits hold one entry per ray, the results of the rays which hit nothing are left untouched.
+	// Returns the number of rays which hit something.
+	virtual int intersect_rays(const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = UINT32_MAX, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_pick_ray = false);
+	// r_results holds p_result_max entries per transform, r_result_counts one entry per transform.
+	virtual void intersect_shapes(const RID &p_shape, const Transform3D *p_xforms, int p_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = UINT32_MAX, bool p_collide_with_bodies = true, bool p_collide_with_areas = false);
+	// r_closest_safe, r_closest_unsafe and r_infos, if not null, hold one entry per transform.
+	virtual void cast_motions(const RID &p_shape, const Transform3D *p_xforms, const Vector3 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = UINT32_MAX, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, ShapeRestInfo *r_infos = nullptr);
+
 	PhysicsDirectSpaceState3D();
 };
 
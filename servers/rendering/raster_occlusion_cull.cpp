@@ -0,0 +1,617 @@
+/*************************************************************************/
+/*  raster_occlusion_cull.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "raster_occlusion_cull.h"
+
+#include "core/os/worker_thread_pool.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+// Four pixels of a span. The operations are the same as in the scalar loop,
+// in the same order, so both give the same depths.
+#if defined(__SSE2__)
+#define RASTER_OCCLUSION_CULL_SIMD
+typedef __m128 Float4;
+typedef __m128 Mask4;
+
+_FORCE_INLINE_ Float4 f4_load(const float *p_src) { return _mm_loadu_ps(p_src); }
+_FORCE_INLINE_ void f4_store(float *r_dst, Float4 p_a) { _mm_storeu_ps(r_dst, p_a); }
+_FORCE_INLINE_ Float4 f4_set(float p_value) { return _mm_set1_ps(p_value); }
+_FORCE_INLINE_ Float4 f4_add(Float4 p_a, Float4 p_b) { return _mm_add_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_mul(Float4 p_a, Float4 p_b) { return _mm_mul_ps(p_a, p_b); }
+_FORCE_INLINE_ Mask4 f4_less(Float4 p_a, Float4 p_b) { return _mm_cmplt_ps(p_a, p_b); }
+_FORCE_INLINE_ Mask4 f4_less_equal(Float4 p_a, Float4 p_b) { return _mm_cmple_ps(p_a, p_b); }
+_FORCE_INLINE_ Mask4 f4_and(Mask4 p_a, Mask4 p_b) { return _mm_and_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_select(Mask4 p_mask, Float4 p_a, Float4 p_b) { return _mm_or_ps(_mm_and_ps(p_mask, p_a), _mm_andnot_ps(p_mask, p_b)); }
+#elif defined(__ARM_NEON)
+#define RASTER_OCCLUSION_CULL_SIMD
+typedef float32x4_t Float4;
+typedef uint32x4_t Mask4;
+
+_FORCE_INLINE_ Float4 f4_load(const float *p_src) { return vld1q_f32(p_src); }
+_FORCE_INLINE_ void f4_store(float *r_dst, Float4 p_a) { vst1q_f32(r_dst, p_a); }
+_FORCE_INLINE_ Float4 f4_set(float p_value) { return vdupq_n_f32(p_value); }
+_FORCE_INLINE_ Float4 f4_add(Float4 p_a, Float4 p_b) { return vaddq_f32(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_mul(Float4 p_a, Float4 p_b) { return vmulq_f32(p_a, p_b); }
+_FORCE_INLINE_ Mask4 f4_less(Float4 p_a, Float4 p_b) { return vcltq_f32(p_a, p_b); }
+_FORCE_INLINE_ Mask4 f4_less_equal(Float4 p_a, Float4 p_b) { return vcleq_f32(p_a, p_b); }
+_FORCE_INLINE_ Mask4 f4_and(Mask4 p_a, Mask4 p_b) { return vandq_u32(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_select(Mask4 p_mask, Float4 p_a, Float4 p_b) { return vbslq_f32(p_mask, p_a, p_b); }
+#endif
+
+#ifdef RASTER_OCCLUSION_CULL_SIMD
+// Same as MAX(), which gives the second value when the first one is NaN.
+_FORCE_INLINE_ Float4 f4_max(Float4 p_a, Float4 p_b) { return f4_select(f4_less(p_b, p_a), p_a, p_b); }
+
+static_assert(RasterOcclusionCull::SPAN_SIZE == 8, "SPAN_OFFSETS must have one entry per pixel of a span.");
+// Offset of each pixel from the start of its span.
+const float SPAN_OFFSETS[RasterOcclusionCull::SPAN_SIZE] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+#endif
+} // namespace
+
+RasterOcclusionCull *RasterOcclusionCull::raster_singleton = nullptr;
+
+void RasterOcclusionCull::RasterHZBuffer::clear() {
+	HZBuffer::clear();
+
+	tile_triangles.clear();
+	tiles_size = Size2i();
+}
+
+void RasterOcclusionCull::RasterHZBuffer::resize(const Size2i &p_size) {
+	if (p_size == Size2i()) {
+		clear();
+		return;
+	}
+
+	if (!sizes.is_empty() && p_size == sizes[0]) {
+		return; // Size didn't change
+	}
+
+	HZBuffer::resize(p_size);
+
+	tiles_size = Size2i((p_size.x + TILE_WIDTH - 1) / TILE_WIDTH, (p_size.y + TILE_HEIGHT - 1) / TILE_HEIGHT);
+	tile_triangles.resize(tiles_size.x * tiles_size.y);
+}
+
+////////////////////////////////////////////////////////
+
+bool RasterOcclusionCull::is_occluder(RID p_rid) {
+	return occluder_owner.owns(p_rid);
+}
+
+RID RasterOcclusionCull::occluder_allocate() {
+	return occluder_owner.allocate_rid();
+}
+
+void RasterOcclusionCull::occluder_initialize(RID p_occluder) {
+	Occluder *occluder = memnew(Occluder);
+	occluder_owner.initialize_rid(p_occluder, occluder);
+}
+
+void RasterOcclusionCull::occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+	Occluder *occluder = occluder_owner.getornull(p_occluder);
+	ERR_FAIL_COND(!occluder);
+
+	occluder->vertices = p_vertices;
+	occluder->indices = p_indices;
+
+	for (Set<InstanceID>::Element *E = occluder->users.front(); E; E = E->next()) {
+		RID scenario_rid = E->get().scenario;
+		RID instance_rid = E->get().instance;
+		ERR_CONTINUE(!scenarios.has(scenario_rid));
+		Scenario &scenario = scenarios[scenario_rid];
+		ERR_CONTINUE(!scenario.instances.has(instance_rid));
+
+		if (!scenario.dirty_instances.has(instance_rid)) {
+			scenario.dirty_instances.insert(instance_rid);
+			scenario.dirty_instances_array.push_back(instance_rid);
+		}
+	}
+}
+
+void RasterOcclusionCull::free_occluder(RID p_occluder) {
+	Occluder *occluder = occluder_owner.getornull(p_occluder);
+	ERR_FAIL_COND(!occluder);
+	memdelete(occluder);
+	occluder_owner.free(p_occluder);
+}
+
+////////////////////////////////////////////////////////
+
+void RasterOcclusionCull::add_scenario(RID p_scenario) {
+	if (!scenarios.has(p_scenario)) {
+		scenarios[p_scenario] = Scenario();
+	}
+}
+
+void RasterOcclusionCull::remove_scenario(RID p_scenario) {
+	ERR_FAIL_COND(!scenarios.has(p_scenario));
+	scenarios.erase(p_scenario);
+}
+
+void RasterOcclusionCull::scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform3D &p_xform, bool p_enabled) {
+	ERR_FAIL_COND(!scenarios.has(p_scenario));
+	Scenario &scenario = scenarios[p_scenario];
+
+	if (!scenario.instances.has(p_instance)) {
+		scenario.instances[p_instance] = OccluderInstance();
+	}
+
+	OccluderInstance &instance = scenario.instances[p_instance];
+
+	bool changed = false;
+
+	if (instance.occluder != p_occluder) {
+		Occluder *old_occluder = occluder_owner.getornull(instance.occluder);
+		if (old_occluder) {
+			old_occluder->users.erase(InstanceID(p_scenario, p_instance));
+		}
+
+		instance.occluder = p_occluder;
+
+		if (p_occluder.is_valid()) {
+			Occluder *occluder = occluder_owner.getornull(p_occluder);
+			ERR_FAIL_COND(!occluder);
+			occluder->users.insert(InstanceID(p_scenario, p_instance));
+		}
+		changed = true;
+	}
+
+	if (instance.xform != p_xform) {
+		instance.xform = p_xform;
+		changed = true;
+	}
+
+	instance.enabled = p_enabled;
+
+	if (changed && !scenario.dirty_instances.has(p_instance)) {
+		scenario.dirty_instances.insert(p_instance);
+		scenario.dirty_instances_array.push_back(p_instance);
+	}
+}
+
+void RasterOcclusionCull::scenario_remove_instance(RID p_scenario, RID p_instance) {
+	ERR_FAIL_COND(!scenarios.has(p_scenario));
+	Scenario &scenario = scenarios[p_scenario];
+
+	OccluderInstance *instance = scenario.instances.getptr(p_instance);
+	if (!instance) {
+		return;
+	}
+
+	Occluder *occluder = occluder_owner.getornull(instance->occluder);
+	if (occluder) {
+		occluder->users.erase(InstanceID(p_scenario, p_instance));
+	}
+
+	scenario.instances.erase(p_instance);
+	// The RID may still be in dirty_instances_array, it's skipped when updating.
+	scenario.dirty_instances.erase(p_instance);
+}
+
+void RasterOcclusionCull::Scenario::_update_dirty_instance(uint32_t p_idx, RID *p_instances) {
+	OccluderInstance *occ_inst = instances.getptr(p_instances[p_idx]);
+
+	if (!occ_inst) {
+		return;
+	}
+
+	Occluder *occ = raster_singleton->occluder_owner.getornull(occ_inst->occluder);
+
+	if (!occ) {
+		occ_inst->xformed_vertices.clear();
+		occ_inst->indices.clear();
+		return;
+	}
+
+	int vertex_count = occ->vertices.size();
+	occ_inst->xformed_vertices.resize(vertex_count);
+
+	const Vector3 *read = occ->vertices.ptr();
+	Vector3 *write = occ_inst->xformed_vertices.ptr();
+	for (int i = 0; i < vertex_count; i++) {
+		write[i] = occ_inst->xform.xform(read[i]);
+		if (i == 0) {
+			occ_inst->aabb = AABB(write[i], Vector3());
+		} else {
+			occ_inst->aabb.expand_to(write[i]);
+		}
+	}
+
+	// Drop the triangles with invalid indices here, so rasterization doesn't have to check.
+	occ_inst->indices.clear();
+	int index_count = occ->indices.size() - occ->indices.size() % 3;
+	const int32_t *indices = occ->indices.ptr();
+	for (int i = 0; i < index_count; i += 3) {
+		if ((uint32_t)indices[i] >= (uint32_t)vertex_count || (uint32_t)indices[i + 1] >= (uint32_t)vertex_count || (uint32_t)indices[i + 2] >= (uint32_t)vertex_count) {
+			continue;
+		}
+		occ_inst->indices.push_back(indices[i]);
+		occ_inst->indices.push_back(indices[i + 1]);
+		occ_inst->indices.push_back(indices[i + 2]);
+	}
+}
+
+void RasterOcclusionCull::Scenario::update() {
+	if (dirty_instances_array.is_empty()) {
+		return;
+	}
+
+	WorkerThreadPool::get_singleton()->do_work(dirty_instances_array.size(), this, &Scenario::_update_dirty_instance, dirty_instances_array.ptr());
+
+	dirty_instances.clear();
+	dirty_instances_array.clear();
+}
+
+////////////////////////////////////////////////////////
+
+void RasterOcclusionCull::_add_triangle(const FrameData *p_data, const Vector3 *p_view_vertices, LocalVector<Triangle> &r_triangles) const {
+	// Clip against the near plane, the visible side is z <= -z_near in view space.
+	Vector3 clipped[4];
+	int clipped_count = 0;
+	for (int i = 0; i < 3; i++) {
+		const Vector3 &a = p_view_vertices[i];
+		const Vector3 &b = p_view_vertices[(i + 1) % 3];
+		real_t dist_a = -a.z - p_data->z_near;
+		real_t dist_b = -b.z - p_data->z_near;
+
+		if (dist_a >= 0) {
+			clipped[clipped_count++] = a;
+		}
+		if ((dist_a >= 0) != (dist_b >= 0)) {
+			clipped[clipped_count++] = a + (b - a) * (dist_a / (dist_a - dist_b));
+		}
+	}
+
+	if (clipped_count < 3) {
+		return;
+	}
+
+	// Same mapping as HZBuffer::is_occluded(), shifted by half a pixel so that
+	// integer coordinates are pixel centers.
+	const Size2i size = p_data->buffer->get_size();
+
+	float x[4];
+	float y[4];
+	float depth[4]; // Linear in screen space, the larger the closer.
+	for (int i = 0; i < clipped_count; i++) {
+		Vector3 ndc = p_data->cam_projection.xform(clipped[i]);
+		x[i] = (ndc.x * 0.5f + 0.5f) * size.x - 0.5f;
+		y[i] = (ndc.y * 0.5f + 0.5f) * size.y - 0.5f;
+		depth[i] = p_data->cam_orthogonal ? clipped[i].z : -1.0f / clipped[i].z;
+	}
+
+	// The clipped polygon is convex, split it as a fan.
+	for (int i = 1; i < clipped_count - 1; i++) {
+		const int v[3] = { 0, i, i + 1 };
+
+		float area = (x[v[1]] - x[v[0]]) * (y[v[2]] - y[v[0]]) - (y[v[1]] - y[v[0]]) * (x[v[2]] - x[v[0]]);
+		if (Math::abs(area) < CMP_EPSILON) {
+			continue;
+		}
+
+		Triangle t;
+		t.min_x = MAX(0, (int)Math::ceil(MIN(x[v[0]], MIN(x[v[1]], x[v[2]]))));
+		t.max_x = MIN(size.x - 1, (int)Math::floor(MAX(x[v[0]], MAX(x[v[1]], x[v[2]]))));
+		t.min_y = MAX(0, (int)Math::ceil(MIN(y[v[0]], MIN(y[v[1]], y[v[2]]))));
+		t.max_y = MIN(size.y - 1, (int)Math::floor(MAX(y[v[0]], MAX(y[v[1]], y[v[2]]))));
+		if (t.min_x > t.max_x || t.min_y > t.max_y) {
+			continue;
+		}
+
+		// Edge k is the one opposite to vertex k, it's equal to the area at that vertex.
+		float inv_area = 1.0f / area;
+		float flip = area > 0 ? 1.0f : -1.0f;
+		t.depth_a = 0.0f;
+		t.depth_b = 0.0f;
+		t.depth_c = 0.0f;
+		for (int k = 0; k < 3; k++) {
+			int from = v[(k + 1) % 3];
+			int to = v[(k + 2) % 3];
+			float a = y[from] - y[to];
+			float b = x[to] - x[from];
+			float c = x[from] * y[to] - y[from] * x[to];
+
+			t.edge_a[k] = a * flip;
+			t.edge_b[k] = b * flip;
+			t.edge_c[k] = c * flip;
+
+			float weight = depth[v[k]] * inv_area;
+			t.depth_a += a * weight;
+			t.depth_b += b * weight;
+			t.depth_c += c * weight;
+		}
+
+		r_triangles.push_back(t);
+	}
+}
+
+void RasterOcclusionCull::_setup_instance(uint32_t p_idx, FrameData *p_data) {
+	const OccluderInstance *instance = visible_instances[p_idx];
+	LocalVector<Triangle> &r_triangles = thread_triangles[WorkerThreadPool::get_singleton()->get_thread_index() + 1];
+
+	const Vector3 *vertices = instance->xformed_vertices.ptr();
+	const uint32_t *indices = instance->indices.ptr();
+	uint32_t index_count = instance->indices.size();
+
+	Vector3 view_vertices[3];
+	for (uint32_t i = 0; i < index_count; i += 3) {
+		view_vertices[0] = p_data->cam_inv_transform.xform(vertices[indices[i]]);
+		view_vertices[1] = p_data->cam_inv_transform.xform(vertices[indices[i + 1]]);
+		view_vertices[2] = p_data->cam_inv_transform.xform(vertices[indices[i + 2]]);
+		_add_triangle(p_data, view_vertices, r_triangles);
+	}
+}
+
+void RasterOcclusionCull::_raster_tile(uint32_t p_idx, FrameData *p_data) {
+	RasterHZBuffer *buffer = p_data->buffer;
+	const Size2i size = buffer->get_size();
+	const int tile_x = (p_idx % buffer->get_tiles_size().x) * TILE_WIDTH;
+	const int tile_y = (p_idx / buffer->get_tiles_size().x) * TILE_HEIGHT;
+
+	// Closest depth of each pixel, in the linear form of Triangle (the larger the closer).
+	float tile_depth[TILE_HEIGHT][TILE_WIDTH];
+	for (int y = 0; y < TILE_HEIGHT; y++) {
+		for (int x = 0; x < TILE_WIDTH; x++) {
+			tile_depth[y][x] = -FLT_MAX;
+		}
+	}
+
+	const LocalVector<uint32_t> &tile_triangles = buffer->tile_triangles[p_idx];
+	for (uint32_t i = 0; i < tile_triangles.size(); i++) {
+		const Triangle &t = triangles[tile_triangles[i]];
+
+		const int min_x = MAX(t.min_x - tile_x, 0);
+		const int max_x = MIN(t.max_x - tile_x, TILE_WIDTH - 1);
+		const int min_y = MAX(t.min_y - tile_y, 0);
+		const int max_y = MIN(t.max_y - tile_y, TILE_HEIGHT - 1);
+
+#ifdef RASTER_OCCLUSION_CULL_SIMD
+		const Float4 zero = f4_set(0.0f);
+		const Float4 miss = f4_set(-FLT_MAX);
+		const Float4 edge_a_0 = f4_set(t.edge_a[0]);
+		const Float4 edge_a_1 = f4_set(t.edge_a[1]);
+		const Float4 edge_a_2 = f4_set(t.edge_a[2]);
+		const Float4 depth_a = f4_set(t.depth_a);
+#endif
+
+		for (int y = min_y; y <= max_y; y++) {
+			const float fy = tile_y + y;
+			const float row_0 = t.edge_b[0] * fy + t.edge_c[0];
+			const float row_1 = t.edge_b[1] * fy + t.edge_c[1];
+			const float row_2 = t.edge_b[2] * fy + t.edge_c[2];
+			const float row_depth = t.depth_b * fy + t.depth_c;
+
+#ifdef RASTER_OCCLUSION_CULL_SIMD
+			const Float4 row_0_4 = f4_set(row_0);
+			const Float4 row_1_4 = f4_set(row_1);
+			const Float4 row_2_4 = f4_set(row_2);
+			const Float4 row_depth_4 = f4_set(row_depth);
+#endif
+
+			// The pixels of a span that fall outside the bounding rect also fail the edge tests.
+			for (int x = min_x & ~(SPAN_SIZE - 1); x <= max_x; x += SPAN_SIZE) {
+				float *span_depth = &tile_depth[y][x];
+#ifdef RASTER_OCCLUSION_CULL_SIMD
+				const Float4 span_x = f4_set(tile_x + x);
+				for (int k = 0; k < SPAN_SIZE; k += 4) {
+					const Float4 fx = f4_add(span_x, f4_load(&SPAN_OFFSETS[k]));
+					Mask4 inside = f4_less_equal(zero, f4_add(f4_mul(edge_a_0, fx), row_0_4));
+					inside = f4_and(inside, f4_less_equal(zero, f4_add(f4_mul(edge_a_1, fx), row_1_4)));
+					inside = f4_and(inside, f4_less_equal(zero, f4_add(f4_mul(edge_a_2, fx), row_2_4)));
+					const Float4 depth = f4_select(inside, f4_add(f4_mul(depth_a, fx), row_depth_4), miss);
+					f4_store(&span_depth[k], f4_max(f4_load(&span_depth[k]), depth));
+				}
+#else
+				for (int k = 0; k < SPAN_SIZE; k++) {
+					const float fx = tile_x + x + k;
+					const bool inside = (t.edge_a[0] * fx + row_0 >= 0.0f) & (t.edge_a[1] * fx + row_1 >= 0.0f) & (t.edge_a[2] * fx + row_2 >= 0.0f);
+					const float depth = inside ? t.depth_a * fx + row_depth : -FLT_MAX;
+					span_depth[k] = MAX(span_depth[k], depth);
+				}
+#endif
+			}
+		}
+	}
+
+	// Convert to the distance along the pixel ray from the near plane, which is what the HZ buffer stores.
+	float *write = buffer->get_depth_ptr();
+	const int max_x = MIN(TILE_WIDTH, size.x - tile_x);
+	const int max_y = MIN(TILE_HEIGHT, size.y - tile_y);
+	const float miss_depth = p_data->z_far * 1.05f;
+
+	for (int y = 0; y < max_y; y++) {
+		for (int x = 0; x < max_x; x++) {
+			const float depth = tile_depth[y][x];
+			float distance;
+			if (depth == -FLT_MAX) {
+				distance = miss_depth;
+			} else if (p_data->cam_orthogonal) {
+				distance = -depth - p_data->z_near;
+			} else {
+				Vector3 near_point = p_data->near_origin + p_data->near_dx * (tile_x + x) + p_data->near_dy * (tile_y + y);
+				distance = (1.0f / depth - p_data->z_near) * near_point.length() / p_data->z_near;
+			}
+			write[(tile_y + y) * size.x + tile_x + x] = CLAMP(distance, 0.0f, miss_depth);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////
+
+void RasterOcclusionCull::add_buffer(RID p_buffer) {
+	ERR_FAIL_COND(buffers.has(p_buffer));
+	buffers[p_buffer] = RasterHZBuffer();
+}
+
+void RasterOcclusionCull::remove_buffer(RID p_buffer) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers.erase(p_buffer);
+}
+
+void RasterOcclusionCull::buffer_set_scenario(RID p_buffer, RID p_scenario) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	ERR_FAIL_COND(p_scenario.is_valid() && !scenarios.has(p_scenario));
+	buffers[p_buffer].scenario_rid = p_scenario;
+}
+
+void RasterOcclusionCull::buffer_set_size(RID p_buffer, const Vector2i &p_size) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers[p_buffer].resize(p_size);
+}
+
+void RasterOcclusionCull::buffer_update(RID p_buffer, const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal) {
+	if (!buffers.has(p_buffer)) {
+		return;
+	}
+
+	RasterHZBuffer &buffer = buffers[p_buffer];
+
+	if (buffer.is_empty() || !scenarios.has(buffer.scenario_rid)) {
+		return;
+	}
+
+	Scenario &scenario = scenarios[buffer.scenario_rid];
+	scenario.update();
+
+	FrameData frame;
+	frame.buffer = &buffer;
+	frame.cam_inv_transform = p_cam_transform.affine_inverse();
+	frame.cam_projection = p_cam_projection;
+	frame.cam_orthogonal = p_cam_orthogonal;
+	frame.z_near = p_cam_projection.get_z_near();
+	frame.z_far = p_cam_projection.get_z_far();
+	buffer.set_depth_range(frame.z_far);
+
+	// Near plane points are an affine function of the pixel position, so three are enough.
+	// Pixels are sampled at their centers, as in _add_triangle().
+	const Size2i size = buffer.get_size();
+	const CameraMatrix inv_projection = p_cam_projection.inverse();
+	Vector3 near_points[3];
+	const Vector2 pixels[3] = { Vector2(0, 0), Vector2(1, 0), Vector2(0, 1) };
+	for (int i = 0; i < 3; i++) {
+		float u = (pixels[i].x + 0.5f) / size.x * 2.0f - 1.0f;
+		float v = (pixels[i].y + 0.5f) / size.y * 2.0f - 1.0f;
+		Plane near_point = inv_projection.xform4(Plane(u, v, -1.0, 1.0));
+		near_points[i] = near_point.normal / near_point.d;
+	}
+	frame.near_origin = near_points[0];
+	frame.near_dx = near_points[1] - near_points[0];
+	frame.near_dy = near_points[2] - near_points[0];
+
+	// Cull occluder instances outside of the camera frustum.
+	Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
+	Vector3 endpoints[8];
+	p_cam_projection.get_endpoints(p_cam_transform, endpoints);
+
+	visible_instances.clear();
+	const RID *instance_rid = nullptr;
+	while ((instance_rid = scenario.instances.next(instance_rid))) {
+		const OccluderInstance *instance = scenario.instances.getptr(*instance_rid);
+		if (!instance->enabled || instance->indices.is_empty()) {
+			continue;
+		}
+		if (!instance->aabb.intersects_convex_shape(planes.ptr(), planes.size(), endpoints, 8)) {
+			continue;
+		}
+		visible_instances.push_back(instance);
+	}
+
+	// Set up the triangles of all visible instances, each thread in its own list.
+	for (uint32_t i = 0; i < thread_triangles.size(); i++) {
+		thread_triangles[i].clear();
+	}
+
+	if (!visible_instances.is_empty()) {
+		WorkerThreadPool::get_singleton()->do_work(visible_instances.size(), this, &RasterOcclusionCull::_setup_instance, &frame);
+	}
+
+	// Bin the triangles into the tiles they touch.
+	for (uint32_t i = 0; i < buffer.tile_triangles.size(); i++) {
+		buffer.tile_triangles[i].clear();
+	}
+
+	triangles.clear();
+	const int tiles_width = buffer.get_tiles_size().x;
+	for (uint32_t i = 0; i < thread_triangles.size(); i++) {
+		for (uint32_t j = 0; j < thread_triangles[i].size(); j++) {
+			const Triangle &t = thread_triangles[i][j];
+			uint32_t index = triangles.size();
+			triangles.push_back(t);
+
+			for (int tile_y = t.min_y / TILE_HEIGHT; tile_y <= t.max_y / TILE_HEIGHT; tile_y++) {
+				for (int tile_x = t.min_x / TILE_WIDTH; tile_x <= t.max_x / TILE_WIDTH; tile_x++) {
+					buffer.tile_triangles[tile_y * tiles_width + tile_x].push_back(index);
+				}
+			}
+		}
+	}
+
+	// Tiles don't share pixels, so they are rasterized in parallel.
+	WorkerThreadPool::get_singleton()->do_work(buffer.tile_triangles.size(), this, &RasterOcclusionCull::_raster_tile, &frame);
+
+	buffer.update_mips();
+}
+
+RasterOcclusionCull::HZBuffer *RasterOcclusionCull::buffer_get_ptr(RID p_buffer) {
+	if (!buffers.has(p_buffer)) {
+		return nullptr;
+	}
+	return &buffers[p_buffer];
+}
+
+RID RasterOcclusionCull::buffer_get_debug_texture(RID p_buffer) {
+	ERR_FAIL_COND_V(!buffers.has(p_buffer), RID());
+	return buffers[p_buffer].get_debug_texture();
+}
+
+////////////////////////////////////////////////////////
+
+RasterOcclusionCull::RasterOcclusionCull() {
+	raster_singleton = this;
+	thread_triangles.resize(WorkerThreadPool::get_singleton()->get_thread_count() + 1);
+}
+
+RasterOcclusionCull::~RasterOcclusionCull() {
+	List<RID> occluders;
+	occluder_owner.get_owned_list(&occluders);
+	for (List<RID>::Element *E = occluders.front(); E; E = E->next()) {
+		free_occluder(E->get());
+	}
+
+	raster_singleton = nullptr;
+}
@@ -0,0 +1,174 @@
+/*************************************************************************/
+/*  raster_occlusion_cull.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef RASTER_OCCLUSION_CULL_H
+#define RASTER_OCCLUSION_CULL_H
+
+#include "core/math/camera_matrix.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/rid_owner.h"
+#include "servers/rendering/renderer_scene_occlusion_cull.h"
+
+// Occlusion culling backend which fills the HZ buffer with a tiled software
+// depth rasterizer. It has no dependencies, so it works on every platform, and
+// it's used when the Embree based backend of the raycast module isn't available.
+class RasterOcclusionCull : public RendererSceneOcclusionCull {
+public:
+	static const int TILE_WIDTH = 32;
+	static const int TILE_HEIGHT = 8;
+	static const int SPAN_SIZE = 8;
+
+	// A triangle set up for rasterization, in pixel coordinates of the HZ buffer
+	// shifted by half a pixel, so that pixel centers have integer coordinates.
+	// Pixels inside have all three edge functions positive, the depth is
+	// interpolated linearly (as 1/depth for perspective projections).
+	struct Triangle {
+		float edge_a[3];
+		float edge_b[3];
+		float edge_c[3];
+		float depth_a;
+		float depth_b;
+		float depth_c;
+		int min_x;
+		int min_y;
+		int max_x;
+		int max_y;
+	};
+
+	class RasterHZBuffer : public HZBuffer {
+		Size2i tiles_size;
+
+	public:
+		RID scenario_rid;
+		LocalVector<LocalVector<uint32_t>> tile_triangles;
+
+		virtual void clear() override;
+		virtual void resize(const Size2i &p_size) override;
+
+		_FORCE_INLINE_ Size2i get_size() const { return sizes[0]; }
+		_FORCE_INLINE_ Size2i get_tiles_size() const { return tiles_size; }
+		_FORCE_INLINE_ float *get_depth_ptr() { return mips[0]; }
+		_FORCE_INLINE_ void set_depth_range(float p_range) { debug_tex_range = p_range; }
+	};
+
+private:
+	struct InstanceID {
+		RID scenario;
+		RID instance;
+
+		bool operator<(const InstanceID &rhs) const {
+			if (instance == rhs.instance) {
+				return rhs.scenario < scenario;
+			}
+			return instance < rhs.instance;
+		}
+
+		InstanceID() {}
+		InstanceID(RID s, RID i) :
+				scenario(s), instance(i) {}
+	};
+
+	struct Occluder {
+		PackedVector3Array vertices;
+		PackedInt32Array indices;
+		Set<InstanceID> users;
+	};
+
+	struct OccluderInstance {
+		RID occluder;
+		LocalVector<Vector3> xformed_vertices;
+		LocalVector<uint32_t> indices;
+		AABB aabb;
+		Transform3D xform;
+		bool enabled = true;
+	};
+
+	struct Scenario {
+		HashMap<RID, OccluderInstance> instances;
+		Set<RID> dirty_instances; // To avoid duplicates
+		LocalVector<RID> dirty_instances_array; // To iterate and split into threads
+
+		void _update_dirty_instance(uint32_t p_idx, RID *p_instances);
+		void update();
+	};
+
+	struct FrameData {
+		RasterHZBuffer *buffer = nullptr;
+		Transform3D cam_inv_transform;
+		CameraMatrix cam_projection;
+		bool cam_orthogonal = false;
+		float z_near = 0.0;
+		float z_far = 0.0;
+		// Near plane position of pixel (0, 0) in view space, and its change per pixel.
+		Vector3 near_origin;
+		Vector3 near_dx;
+		Vector3 near_dy;
+	};
+
+	static RasterOcclusionCull *raster_singleton;
+
+	RID_PtrOwner<Occluder> occluder_owner;
+	HashMap<RID, Scenario> scenarios;
+	HashMap<RID, RasterHZBuffer> buffers;
+
+	LocalVector<const OccluderInstance *> visible_instances;
+	LocalVector<LocalVector<Triangle>> thread_triangles;
+	LocalVector<Triangle> triangles;
+
+	void _add_triangle(const FrameData *p_data, const Vector3 *p_view_vertices, LocalVector<Triangle> &r_triangles) const;
+	void _setup_instance(uint32_t p_idx, FrameData *p_data);
+	void _raster_tile(uint32_t p_idx, FrameData *p_data);
+
+public:
+	virtual bool is_occluder(RID p_rid) override;
+	virtual RID occluder_allocate() override;
+	virtual void occluder_initialize(RID p_occluder) override;
+	virtual void occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) override;
+	virtual void free_occluder(RID p_occluder) override;
+
+	virtual void add_scenario(RID p_scenario) override;
+	virtual void remove_scenario(RID p_scenario) override;
+	virtual void scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform3D &p_xform, bool p_enabled) override;
+	virtual void scenario_remove_instance(RID p_scenario, RID p_instance) override;
+
+	virtual void add_buffer(RID p_buffer) override;
+	virtual void remove_buffer(RID p_buffer) override;
+	virtual HZBuffer *buffer_get_ptr(RID p_buffer) override;
+	virtual void buffer_set_scenario(RID p_buffer, RID p_scenario) override;
+	virtual void buffer_set_size(RID p_buffer, const Vector2i &p_size) override;
+	virtual void buffer_update(RID p_buffer, const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal) override;
+	virtual RID buffer_get_debug_texture(RID p_buffer) override;
+
+	RasterOcclusionCull();
+	~RasterOcclusionCull();
+};
+
+#endif // RASTER_OCCLUSION_CULL_H
@@ -66,6 +66,8 @@ void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas
 		}
 	}
 
+	_mark_canvas_batches(list);
+
 	RENDER_TIMESTAMP("Render Canvas Items");
 
 	bool sdf_flag;
@@ -75,6 +77,90 @@ void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas
 	}
 }
 
+// Finds the textures bound by the first and last drawing commands of the item, as the
+// RD canvas renderer binds them. Returns false if the item has no command that binds a texture.
+static bool _get_item_batch_textures(const RendererCanvasRender::Item *p_item, RID &r_first, RID &r_last) {
+	bool found = false;
+
+	for (const RendererCanvasRender::Item::Command *c = p_item->commands; c; c = c->next) {
+		RID texture;
+
+		switch (c->type) {
+			case RendererCanvasRender::Item::Command::TYPE_RECT: {
+				texture = static_cast<const RendererCanvasRender::Item::CommandRect *>(c)->texture;
+			} break;
+			case RendererCanvasRender::Item::Command::TYPE_NINEPATCH: {
+				texture = static_cast<const RendererCanvasRender::Item::CommandNinePatch *>(c)->texture;
+			} break;
+			case RendererCanvasRender::Item::Command::TYPE_POLYGON: {
+				texture = static_cast<const RendererCanvasRender::Item::CommandPolygon *>(c)->texture;
+			} break;
+			case RendererCanvasRender::Item::Command::TYPE_PRIMITIVE: {
+				// Primitives are always drawn with the default texture.
+				texture = RID();
+			} break;
+			case RendererCanvasRender::Item::Command::TYPE_MESH: {
+				texture = static_cast<const RendererCanvasRender::Item::CommandMesh *>(c)->texture;
+			} break;
+			case RendererCanvasRender::Item::Command::TYPE_MULTIMESH: {
+				texture = static_cast<const RendererCanvasRender::Item::CommandMultiMesh *>(c)->texture;
+			} break;
+			case RendererCanvasRender::Item::Command::TYPE_PARTICLES: {
+				texture = static_cast<const RendererCanvasRender::Item::CommandParticles *>(c)->texture;
+			} break;
+			default: {
+				continue; // Doesn't bind a texture.
+			}
+		}
+
+		if (!found) {
+			r_first = texture;
+			found = true;
+		}
+		r_last = texture;
+	}
+
+	return found;
+}
+
+// Marks the items of the render list that can't share the state left by the previous item,
+// and counts the runs of items between them. Items are still drawn one by one: the renderer
+// only uses the marks to skip rebinding the texture within a run.
+void RendererCanvasCull::_mark_canvas_batches(RendererCanvasRender::Item *p_list) {
+	RendererCanvasRender::Item *prev = nullptr;
+	RID batch_texture;
+	bool batch_has_texture = false;
+
+	for (RendererCanvasRender::Item *ci = p_list; ci; ci = ci->next) {
+		RID first_texture;
+		RID last_texture;
+		bool has_texture = _get_item_batch_textures(ci, first_texture, last_texture);
+
+		// Back buffer copies and canvas groups split the render list, so they always start a batch.
+		bool batch_break = prev == nullptr || ci->copy_back_buffer != nullptr || ci->canvas_group != nullptr || ci->canvas_group_owner != nullptr || prev->canvas_group != nullptr;
+		// Compare the effective material, which may be inherited from a parent, and the item's own
+		// material, which is the one the RD canvas renderer binds.
+		const RID material = ci->material_owner ? ci->material_owner->material : ci->material;
+		const RID prev_material = prev ? (prev->material_owner ? prev->material_owner->material : prev->material) : RID();
+		batch_break = batch_break || ci->final_clip_owner != prev->final_clip_owner || material != prev_material || ci->material != prev->material;
+		batch_break = batch_break || ci->texture_filter != prev->texture_filter || ci->texture_repeat != prev->texture_repeat;
+		batch_break = batch_break || (has_texture && batch_has_texture && first_texture != batch_texture);
+
+		if (batch_break) {
+			possible_batches++;
+			batch_has_texture = false;
+		}
+		if (has_texture) {
+			batch_texture = last_texture;
+			batch_has_texture = true;
+		}
+
+		ci->batch_break = batch_break;
+		items_drawn++;
+		prev = ci;
+	}
+}
+
 void _collect_ysort_children(RendererCanvasCull::Item *p_canvas_item, Transform2D p_transform, RendererCanvasCull::Item *p_material_owner, RendererCanvasCull::Item **r_items, int &r_index) {
 	int child_item_count = p_canvas_item->child_items.size();
 	RendererCanvasCull::Item **child_items = p_canvas_item->child_items.ptrw();
@@ -388,6 +474,11 @@ bool RendererCanvasCull::was_sdf_used() {
 	return sdf_used;
 }
 
+void RendererCanvasCull::reset_render_info() {
+	items_drawn = 0;
+	possible_batches = 0;
+}
+
 RID RendererCanvasCull::canvas_allocate() {
 	return canvas_owner.allocate_rid();
 }
@@ -171,6 +171,9 @@ public:
 	bool sdf_used = false;
 	bool snapping_2d_transforms_to_pixel = false;
 
+	uint64_t items_drawn = 0;
+	uint64_t possible_batches = 0;
+
 	PagedAllocator<Item::VisibilityNotifierData> visibility_notifier_allocator;
 	SelfList<Item::VisibilityNotifierData>::List visibility_notifier_list;
 
@@ -179,6 +182,7 @@ public:
 private:
 	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel);
 	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool allow_y_sort);
+	void _mark_canvas_batches(RendererCanvasRender::Item *p_list);
 
 	RendererCanvasRender::Item **z_list;
 	RendererCanvasRender::Item **z_last_list;
@@ -188,6 +192,12 @@ public:
 
 	bool was_sdf_used();
 
+	// Canvas items sent to the renderer since the last reset_render_info(), and the number
+	// of batches they could be merged into. Items are not merged into fewer draw calls.
+	void reset_render_info();
+	uint64_t get_items_drawn() const { return items_drawn; }
+	uint64_t get_possible_batches() const { return possible_batches; }
+
 	RID canvas_allocate();
 	void canvas_initialize(RID p_rid);
 
@@ -351,6 +351,9 @@ public:
 		ViewportRender *vp_render;
 		bool distance_field;
 		bool light_masked;
+		// True when the item starts a new batch, i.e. it can't keep the clip, material and
+		// texture state left by the previous item in the render list.
+		bool batch_break;
 
 		Rect2 global_rect_cache;
 
@@ -558,6 +561,7 @@ public:
 			copy_back_buffer = nullptr;
 			distance_field = false;
 			light_masked = false;
+			batch_break = true;
 			update_when_visible = false;
 			z_final = 0;
 			texture_filter = RS::CANVAS_ITEM_TEXTURE_FILTER_DEFAULT;
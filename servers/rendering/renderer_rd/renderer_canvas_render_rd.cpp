@@ -392,7 +392,7 @@ void RendererCanvasRenderRD::_bind_canvas_texture(RD::DrawListID p_draw_list, RI
 	r_last_texture = p_texture;
 }
 
-void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_render_target, const Item *p_item, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants) {
+void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_render_target, const Item *p_item, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants, BatchTextureState &r_batch_texture) {
 	//create an empty push constant
 
 	RS::CanvasItemTextureFilter current_filter = default_filter;
@@ -419,9 +419,11 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 		push_constant.src_rect[i] = 0;
 		push_constant.dst_rect[i] = 0;
 	}
-	push_constant.flags = 0;
-	push_constant.color_texture_pixel_size[0] = 0;
-	push_constant.color_texture_pixel_size[1] = 0;
+	// Continue from the texture bound by the previous item of the batch, if any.
+	push_constant.flags = r_batch_texture.flags;
+	push_constant.specular_shininess = r_batch_texture.specular_shininess;
+	push_constant.color_texture_pixel_size[0] = r_batch_texture.texpixel_size.x;
+	push_constant.color_texture_pixel_size[1] = r_batch_texture.texpixel_size.y;
 
 	push_constant.pad[0] = 0;
 	push_constant.pad[1] = 0;
@@ -462,8 +464,8 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 
 	bool reclip = false;
 
-	RID last_texture;
-	Size2 texpixel_size;
+	RID last_texture = r_batch_texture.last_texture;
+	Size2 texpixel_size = r_batch_texture.texpixel_size;
 
 	bool skipping = false;
 
@@ -916,6 +918,11 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 		//will make it re-enable clipping if needed afterwards
 		current_clip = nullptr;
 	}
+
+	r_batch_texture.last_texture = last_texture;
+	r_batch_texture.texpixel_size = texpixel_size;
+	r_batch_texture.flags = push_constant.flags & (FLAGS_DEFAULT_NORMAL_MAP_USED | FLAGS_DEFAULT_SPECULAR_MAP_USED);
+	r_batch_texture.specular_shininess = push_constant.specular_shininess;
 }
 
 RID RendererCanvasRenderRD::_create_base_uniform_set(RID p_to_render_target, bool p_backbuffer) {
@@ -1071,9 +1078,17 @@ void RendererCanvasRenderRD::_render_items(RID p_to_render_target, int p_item_co
 
 	PipelineVariants *pipeline_variants = &shader.pipeline_variants;
 
+	BatchTextureState batch_texture;
+
 	for (int i = 0; i < p_item_count; i++) {
 		Item *ci = items[i];
 
+		if (ci->batch_break) {
+			// Items of the same batch share clip, material and texture sampling, so the
+			// texture bound by the previous item can be kept.
+			batch_texture = BatchTextureState();
+		}
+
 		if (current_clip != ci->final_clip_owner) {
 			current_clip = ci->final_clip_owner;
 
@@ -1113,7 +1128,7 @@ void RendererCanvasRenderRD::_render_items(RID p_to_render_target, int p_item_co
 			}
 		}
 
-		_render_item(draw_list, p_to_render_target, ci, fb_format, canvas_transform_inverse, current_clip, p_lights, pipeline_variants);
+		_render_item(draw_list, p_to_render_target, ci, fb_format, canvas_transform_inverse, current_clip, p_lights, pipeline_variants, batch_texture);
 
 		prev_material = material;
 	}
@@ -32,6 +32,8 @@
 
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
+#include "raster_occlusion_cull.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
 
@@ -819,6 +821,20 @@ void RendererSceneCull::instance_set_layer_mask(RID p_instance, uint32_t p_mask)
 	}
 }
 
+#ifdef DEBUG_ENABLED
+static bool _is_transform_finite(const Transform3D &p_transform) {
+	for (int i = 0; i < 4; i++) {
+		const Vector3 &v = i < 3 ? p_transform.basis.elements[i] : p_transform.origin;
+		for (int j = 0; j < 3; j++) {
+			if (Math::is_inf(v[j]) || Math::is_nan(v[j])) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+#endif
+
 void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D &p_transform) {
 	Instance *instance = instance_owner.getornull(p_instance);
 	ERR_FAIL_COND(!instance);
@@ -828,22 +844,35 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 	}
 
 #ifdef DEBUG_ENABLED
-
-	for (int i = 0; i < 4; i++) {
-		const Vector3 &v = i < 3 ? p_transform.basis.elements[i] : p_transform.origin;
-		ERR_FAIL_COND(Math::is_inf(v.x));
-		ERR_FAIL_COND(Math::is_nan(v.x));
-		ERR_FAIL_COND(Math::is_inf(v.y));
-		ERR_FAIL_COND(Math::is_nan(v.y));
-		ERR_FAIL_COND(Math::is_inf(v.z));
-		ERR_FAIL_COND(Math::is_nan(v.z));
-	}
-
+	ERR_FAIL_COND_MSG(!_is_transform_finite(p_transform), "Instance transform contains infinite or NaN values.");
 #endif
 	instance->transform = p_transform;
 	_instance_queue_update(instance, true);
 }
 
+void RendererSceneCull::instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms) {
+	ERR_FAIL_COND(p_instances.size() != p_transforms.size());
+
+	// One command updates the whole batch, the instances are then refreshed
+	// together by update_dirty_instances().
+	const RID *instances = p_instances.ptr();
+	const Transform3D *transforms = p_transforms.ptr();
+	for (int i = 0; i < p_instances.size(); i++) {
+		Instance *instance = instance_owner.getornull(instances[i]);
+		ERR_CONTINUE(!instance);
+
+		const Transform3D &transform = transforms[i];
+		if (instance->transform == transform) {
+			continue;
+		}
+#ifdef DEBUG_ENABLED
+		ERR_CONTINUE_MSG(!_is_transform_finite(transform), "Instance transform contains infinite or NaN values.");
+#endif
+		instance->transform = transform;
+		_instance_queue_update(instance, true);
+	}
+}
+
 void RendererSceneCull::instance_attach_object_instance_id(RID p_instance, ObjectID p_id) {
 	Instance *instance = instance_owner.getornull(p_instance);
 	ERR_FAIL_COND(!instance);
@@ -1413,7 +1442,7 @@ void RendererSceneCull::instance_geometry_get_shader_parameter_list(RID p_instan
 	}
 }
 
-void RendererSceneCull::_update_instance(Instance *p_instance) {
+void RendererSceneCull::_update_instance(Instance *p_instance, bool p_bounds_updated) {
 	p_instance->version++;
 
 	if (p_instance->base_type == RS::INSTANCE_LIGHT) {
@@ -1492,9 +1521,9 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		}
 	}
 
-	AABB new_aabb;
-	new_aabb = p_instance->transform.xform(p_instance->aabb);
-	p_instance->transformed_aabb = new_aabb;
+	if (!p_bounds_updated) {
+		_update_instance_bounds(p_instance);
+	}
 
 	if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
 		InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(p_instance->base_data);
@@ -1527,21 +1556,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		return;
 	}
 
-	//quantize to improve moving object performance
-	AABB bvh_aabb = p_instance->transformed_aabb;
-
-	if (p_instance->indexer_id.is_valid() && bvh_aabb != p_instance->prev_transformed_aabb) {
-		//assume motion, see if bounds need to be quantized
-		AABB motion_aabb = bvh_aabb.merge(p_instance->prev_transformed_aabb);
-		float motion_longest_axis = motion_aabb.get_longest_axis_size();
-		float longest_axis = p_instance->transformed_aabb.get_longest_axis_size();
-
-		if (motion_longest_axis < longest_axis * 2) {
-			//moved but not a lot, use motion aabb quantizing
-			float quantize_size = Math::pow(2.0, Math::ceil(Math::log(motion_longest_axis) / Math::log(2.0))) * 0.5; //one fifth
-			bvh_aabb.quantize(quantize_size);
-		}
-	}
+	const AABB &bvh_aabb = p_instance->bvh_aabb;
 
 	if (!p_instance->indexer_id.is_valid()) {
 		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
@@ -1627,7 +1642,9 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		p_instance->scenario->instance_aabbs.push_back(InstanceBounds(p_instance->transformed_aabb));
 		_update_instance_visibility_dependencies(p_instance);
 	} else {
-		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
+		if (p_bounds_updated) {
+			// Already refitted together with the other dirty instances.
+		} else if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
 			p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY].update(p_instance->indexer_id, bvh_aabb);
 		} else {
 			p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES].update(p_instance->indexer_id, bvh_aabb);
@@ -1689,6 +1706,32 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 	p_instance->prev_transformed_aabb = p_instance->transformed_aabb;
 }
 
+void RendererSceneCull::_update_instance_bounds(Instance *p_instance) {
+	if (p_instance->aabb.has_no_surface()) {
+		return;
+	}
+
+	p_instance->transformed_aabb = p_instance->transform.xform(p_instance->aabb);
+
+	//quantize to improve moving object performance
+	AABB bvh_aabb = p_instance->transformed_aabb;
+
+	if (p_instance->indexer_id.is_valid() && bvh_aabb != p_instance->prev_transformed_aabb) {
+		//assume motion, see if bounds need to be quantized
+		AABB motion_aabb = bvh_aabb.merge(p_instance->prev_transformed_aabb);
+		float motion_longest_axis = motion_aabb.get_longest_axis_size();
+		float longest_axis = p_instance->transformed_aabb.get_longest_axis_size();
+
+		if (motion_longest_axis < longest_axis * 2) {
+			//moved but not a lot, use motion aabb quantizing
+			float quantize_size = Math::pow(2.0, Math::ceil(Math::log(motion_longest_axis) / Math::log(2.0))) * 0.5; //one fifth
+			bvh_aabb.quantize(quantize_size);
+		}
+	}
+
+	p_instance->bvh_aabb = bvh_aabb;
+}
+
 void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 	if (!p_instance->indexer_id.is_valid()) {
 		return; //nothing to do
@@ -2431,14 +2474,14 @@ void RendererSceneCull::render_camera(RID p_render_buffers, RID p_camera, RID p_
 
 	RENDER_TIMESTAMP("Update occlusion buffer")
 	// For now just cull on the first camera
-	RendererSceneOcclusionCull::get_singleton()->buffer_update(p_viewport, camera_data.main_transform, camera_data.main_projection, camera_data.is_ortogonal, RendererThreadPool::singleton->thread_work_pool);
+	RendererSceneOcclusionCull::get_singleton()->buffer_update(p_viewport, camera_data.main_transform, camera_data.main_projection, camera_data.is_ortogonal);
 
 	_render_scene(&camera_data, p_render_buffers, environment, camera->effects, camera->visible_layers, p_scenario, p_viewport, p_shadow_atlas, RID(), -1, p_screen_lod_threshold, true, r_render_info);
 #endif
 }
 
 void RendererSceneCull::_visibility_cull_threaded(uint32_t p_thread, VisibilityCullData *cull_data) {
-	uint32_t total_threads = RendererThreadPool::singleton->thread_work_pool.get_thread_count();
+	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
 	uint32_t bin_from = p_thread * cull_data->cull_count / total_threads;
 	uint32_t bin_to = (p_thread + 1 == total_threads) ? cull_data->cull_count : ((p_thread + 1) * cull_data->cull_count / total_threads);
 
@@ -2496,7 +2539,7 @@ int RendererSceneCull::_visibility_range_check(InstanceVisibilityData &r_vis_dat
 
 void RendererSceneCull::_scene_cull_threaded(uint32_t p_thread, CullData *cull_data) {
 	uint32_t cull_total = cull_data->scenario->instance_data.size();
-	uint32_t total_threads = RendererThreadPool::singleton->thread_work_pool.get_thread_count();
+	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
 	uint32_t cull_from = p_thread * cull_total / total_threads;
 	uint32_t cull_to = (p_thread + 1 == total_threads) ? cull_total : ((p_thread + 1) * cull_total / total_threads);
 
@@ -2781,7 +2824,7 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 			}
 
 			if (visibility_cull_data.cull_count > thread_cull_threshold) {
-				RendererThreadPool::singleton->thread_work_pool.do_work(RendererThreadPool::singleton->thread_work_pool.get_thread_count(), this, &RendererSceneCull::_visibility_cull_threaded, &visibility_cull_data);
+				WorkerThreadPool::get_singleton()->do_work(WorkerThreadPool::get_singleton()->get_thread_count(), this, &RendererSceneCull::_visibility_cull_threaded, &visibility_cull_data);
 			} else {
 				_visibility_cull(visibility_cull_data, visibility_cull_data.cull_offset, visibility_cull_data.cull_offset + visibility_cull_data.cull_count);
 			}
@@ -2886,7 +2929,7 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 				scene_cull_result_threads[i].clear();
 			}
 
-			RendererThreadPool::singleton->thread_work_pool.do_work(scene_cull_result_threads.size(), this, &RendererSceneCull::_scene_cull_threaded, &cull_data);
+			WorkerThreadPool::get_singleton()->do_work(scene_cull_result_threads.size(), this, &RendererSceneCull::_scene_cull_threaded, &cull_data);
 
 			for (uint32_t i = 0; i < scene_cull_result_threads.size(); i++) {
 				scene_cull_result.append_from(scene_cull_result_threads[i]);
@@ -3524,7 +3567,7 @@ void RendererSceneCull::_update_instance_shader_parameters_from_material(Map<Str
 	}
 }
 
-void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
+void RendererSceneCull::_update_dirty_instance_dependencies(Instance *p_instance) {
 	if (p_instance->update_aabb) {
 		_update_instance_aabb(p_instance);
 	}
@@ -3714,6 +3757,10 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 	}
 
 	_instance_update_list.remove(&p_instance->update_item);
+}
+
+void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
+	_update_dirty_instance_dependencies(p_instance);
 
 	_update_instance(p_instance);
 
@@ -3721,11 +3768,79 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 	p_instance->update_dependencies = false;
 }
 
+void RendererSceneCull::_update_dirty_instances_bounds_threaded(uint32_t p_thread, LocalVector<Instance *> *p_instances) {
+	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
+	uint32_t from = p_thread * p_instances->size() / total_threads;
+	uint32_t to = (p_thread + 1 == total_threads) ? p_instances->size() : ((p_thread + 1) * p_instances->size() / total_threads);
+
+	for (uint32_t i = from; i < to; i++) {
+		_update_instance_bounds((*p_instances)[i]);
+	}
+}
+
+void RendererSceneCull::_refit_dirty_instances(const LocalVector<Instance *> &p_instances) {
+	for (uint32_t i = 0; i < p_instances.size(); i++) {
+		Instance *instance = p_instances[i];
+
+		// Same conditions under which _update_instance() moves an indexed instance.
+		if (!instance->indexer_id.is_valid() || instance->aabb.has_no_surface() || instance->scenario == nullptr || !instance->visible || instance->transform.basis.determinant() == 0) {
+			continue;
+		}
+
+		Scenario *scenario = instance->scenario;
+		if (scenario->refit_ids[Scenario::INDEXER_GEOMETRY].is_empty() && scenario->refit_ids[Scenario::INDEXER_VOLUMES].is_empty()) {
+			refit_scenarios.push_back(scenario);
+		}
+
+		Scenario::IndexerType indexer = ((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) ? Scenario::INDEXER_GEOMETRY : Scenario::INDEXER_VOLUMES;
+		scenario->refit_ids[indexer].push_back(instance->indexer_id);
+		scenario->refit_aabbs[indexer].push_back(instance->bvh_aabb);
+	}
+
+	for (uint32_t i = 0; i < refit_scenarios.size(); i++) {
+		Scenario *scenario = refit_scenarios[i];
+		for (int j = 0; j < Scenario::INDEXER_MAX; j++) {
+			if (scenario->refit_ids[j].size()) {
+				scenario->indexers[j].refit(scenario->refit_ids[j].ptr(), scenario->refit_aabbs[j].ptr(), scenario->refit_ids[j].size());
+				scenario->refit_ids[j].clear();
+				scenario->refit_aabbs[j].clear();
+			}
+		}
+	}
+	refit_scenarios.clear();
+}
+
 void RendererSceneCull::update_dirty_instances() {
 	RSG::storage->update_dirty_resources();
 
+	// Updating an instance can queue others (e.g. geometry captured by a moved lightmap),
+	// so the list is processed in rounds until it stays empty.
 	while (_instance_update_list.first()) {
-		_update_dirty_instance(_instance_update_list.first()->self());
+		dirty_instances.clear();
+		while (_instance_update_list.first()) {
+			Instance *instance = _instance_update_list.first()->self();
+			_update_dirty_instance_dependencies(instance);
+			// Cleared here, so instances queued again further down keep their flags for the next round.
+			instance->update_aabb = false;
+			instance->update_dependencies = false;
+			dirty_instances.push_back(instance);
+		}
+
+		// Bounds only depend on the instance itself, so they can be computed in parallel.
+		if (dirty_instances.size() > thread_cull_threshold) {
+			WorkerThreadPool::get_singleton()->do_work(WorkerThreadPool::get_singleton()->get_thread_count(), this, &RendererSceneCull::_update_dirty_instances_bounds_threaded, &dirty_instances);
+		} else {
+			for (uint32_t i = 0; i < dirty_instances.size(); i++) {
+				_update_instance_bounds(dirty_instances[i]);
+			}
+		}
+
+		// Move all the indexed instances in one pass, so pairing below sees their new bounds.
+		_refit_dirty_instances(dirty_instances);
+
+		for (uint32_t i = 0; i < dirty_instances.size(); i++) {
+			_update_instance(dirty_instances[i], true);
+		}
 	}
 }
 
@@ -3847,16 +3962,17 @@ RendererSceneCull::RendererSceneCull() {
 	}
 
 	scene_cull_result.init(&rid_cull_page_pool, &geometry_instance_cull_page_pool, &instance_cull_page_pool);
-	scene_cull_result_threads.resize(RendererThreadPool::singleton->thread_work_pool.get_thread_count());
+	scene_cull_result_threads.resize(WorkerThreadPool::get_singleton()->get_thread_count());
 	for (uint32_t i = 0; i < scene_cull_result_threads.size(); i++) {
 		scene_cull_result_threads[i].init(&rid_cull_page_pool, &geometry_instance_cull_page_pool, &instance_cull_page_pool);
 	}
 
 	indexer_update_iterations = GLOBAL_GET("rendering/limits/spatial_indexer/update_iterations_per_frame");
 	thread_cull_threshold = GLOBAL_GET("rendering/limits/spatial_indexer/threaded_cull_minimum_instances");
-	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)RendererThreadPool::singleton->thread_work_pool.get_thread_count()); //make sure there is at least one thread per CPU
+	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count()); //make sure there is at least one thread per CPU
 
-	dummy_occlusion_culling = memnew(RendererSceneOcclusionCull);
+	// Replaced by the raycast module when it's available, unless the software rasterizer is requested.
+	fallback_occlusion_culling = memnew(RasterOcclusionCull);
 }
 
 RendererSceneCull::~RendererSceneCull() {
@@ -3876,7 +3992,7 @@ RendererSceneCull::~RendererSceneCull() {
 	}
 	scene_cull_result_threads.clear();
 
-	if (dummy_occlusion_culling) {
-		memdelete(dummy_occlusion_culling);
+	if (fallback_occlusion_culling) {
+		memdelete(fallback_occlusion_culling);
 	}
 }
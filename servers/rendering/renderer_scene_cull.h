@@ -120,7 +120,7 @@ public:
 
 	/* VISIBILITY NOTIFIER API */
 
-	RendererSceneOcclusionCull *dummy_occlusion_culling;
+	RendererSceneOcclusionCull *fallback_occlusion_culling;
 
 	/* SCENARIO API */
 
@@ -335,6 +335,10 @@ public:
 		PagedArray<InstanceData> instance_data;
 		VisibilityArray instance_visibility;
 
+		// Indexer leaves moved by the current update_dirty_instances() round.
+		LocalVector<DynamicBVH::ID> refit_ids[INDEXER_MAX];
+		LocalVector<AABB> refit_aabbs[INDEXER_MAX];
+
 		Scenario() {
 			indexers[INDEXER_GEOMETRY].set_index(INDEXER_GEOMETRY);
 			indexers[INDEXER_VOLUMES].set_index(INDEXER_VOLUMES);
@@ -417,6 +421,7 @@ public:
 		AABB aabb;
 		AABB transformed_aabb;
 		AABB prev_transformed_aabb;
+		AABB bvh_aabb; // Bounds stored in the scenario indexer, quantized while moving.
 
 		struct InstanceShaderParameter {
 			int32_t index = -1;
@@ -905,6 +910,9 @@ public:
 
 	uint32_t thread_cull_threshold = 200;
 
+	LocalVector<Instance *> dirty_instances;
+	LocalVector<Scenario *> refit_scenarios;
+
 	RID_Owner<Instance, true> instance_owner;
 
 	uint32_t geometry_instance_pair_mask; // used in traditional forward, unnecessary on clustered
@@ -916,6 +924,7 @@ public:
 	virtual void instance_set_scenario(RID p_instance, RID p_scenario);
 	virtual void instance_set_layer_mask(RID p_instance, uint32_t p_mask);
 	virtual void instance_set_transform(RID p_instance, const Transform3D &p_transform);
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms);
 	virtual void instance_attach_object_instance_id(RID p_instance, ObjectID p_id);
 	virtual void instance_set_blend_shape_weight(RID p_instance, int p_shape, float p_weight);
 	virtual void instance_set_surface_override_material(RID p_instance, int p_surface, RID p_material);
@@ -953,9 +962,13 @@ public:
 	virtual Variant instance_geometry_get_shader_parameter(RID p_instance, const StringName &p_parameter) const;
 	virtual Variant instance_geometry_get_shader_parameter_default_value(RID p_instance, const StringName &p_parameter) const;
 
-	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
+	_FORCE_INLINE_ void _update_instance(Instance *p_instance, bool p_bounds_updated = false);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
+	_FORCE_INLINE_ void _update_instance_bounds(Instance *p_instance);
+	void _update_dirty_instance_dependencies(Instance *p_instance);
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
+	void _update_dirty_instances_bounds_threaded(uint32_t p_thread, LocalVector<Instance *> *p_instances);
+	void _refit_dirty_instances(const LocalVector<Instance *> &p_instances);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 	void _unpair_instance(Instance *p_instance);
 
@@ -192,6 +192,8 @@ public:
 	int total_objects_drawn = 0;
 	int total_vertices_drawn = 0;
 	int total_draw_calls_used = 0;
+	int total_canvas_items_drawn = 0;
+	int total_canvas_possible_batches = 0;
 
 private:
 	void _configure_3d_render_buffers(Viewport *p_viewport);
@@ -274,6 +276,8 @@ public:
 	int get_total_objects_drawn() const;
 	int get_total_vertices_drawn() const;
 	int get_total_draw_calls_used() const;
+	int get_total_canvas_items_drawn() const;
+	int get_total_canvas_possible_batches() const;
 
 	// Workaround for setting this on thread.
 	void call_set_vsync_mode(DisplayServer::VSyncMode p_mode, DisplayServer::WindowID p_window);
@@ -107,6 +107,35 @@ Array RenderingServer::_instances_cull_convex_bind(const Array &p_convex, RID p_
 	return to_array(ids);
 }
 
+void RenderingServer::_instances_set_transforms_bind(const Array &p_instances, const Vector<float> &p_buffer) {
+	const int count = p_instances.size();
+	ERR_FAIL_COND_MSG(p_buffer.size() != count * 12, "The buffer must contain 12 floats per instance.");
+
+	Vector<RID> instances;
+	instances.resize(count);
+	Vector<Transform3D> transforms;
+	transforms.resize(count);
+
+	RID *instances_ptr = instances.ptrw();
+	Transform3D *transforms_ptr = transforms.ptrw();
+	const float *data = p_buffer.ptr();
+	for (int i = 0; i < count; i++) {
+		Variant v = p_instances[i];
+		ERR_FAIL_COND(v.get_type() != Variant::RID);
+		instances_ptr[i] = v;
+
+		// Same layout as the 3D transforms of a multimesh buffer.
+		const float *dataptr = &data[i * 12];
+		Transform3D &t = transforms_ptr[i];
+		t.basis.elements[0] = Vector3(dataptr[0], dataptr[1], dataptr[2]);
+		t.basis.elements[1] = Vector3(dataptr[4], dataptr[5], dataptr[6]);
+		t.basis.elements[2] = Vector3(dataptr[8], dataptr[9], dataptr[10]);
+		t.origin = Vector3(dataptr[3], dataptr[7], dataptr[11]);
+	}
+
+	instances_set_transforms(instances, transforms);
+}
+
 RID RenderingServer::get_test_texture() {
 	if (test_texture.is_valid()) {
 		return test_texture;
@@ -2421,6 +2450,7 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("instance_set_scenario", "instance", "scenario"), &RenderingServer::instance_set_scenario);
 	ClassDB::bind_method(D_METHOD("instance_set_layer_mask", "instance", "mask"), &RenderingServer::instance_set_layer_mask);
 	ClassDB::bind_method(D_METHOD("instance_set_transform", "instance", "transform"), &RenderingServer::instance_set_transform);
+	ClassDB::bind_method(D_METHOD("instances_set_transforms", "instances", "buffer"), &RenderingServer::_instances_set_transforms_bind);
 	ClassDB::bind_method(D_METHOD("instance_attach_object_instance_id", "instance", "id"), &RenderingServer::instance_attach_object_instance_id);
 	ClassDB::bind_method(D_METHOD("instance_set_blend_shape_weight", "instance", "shape", "weight"), &RenderingServer::instance_set_blend_shape_weight);
 	ClassDB::bind_method(D_METHOD("instance_set_surface_override_material", "instance", "surface", "material"), &RenderingServer::instance_set_surface_override_material);
@@ -2705,6 +2735,8 @@ void RenderingServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(RENDERING_INFO_TEXTURE_MEM_USED);
 	BIND_ENUM_CONSTANT(RENDERING_INFO_BUFFER_MEM_USED);
 	BIND_ENUM_CONSTANT(RENDERING_INFO_VIDEO_MEM_USED);
+	BIND_ENUM_CONSTANT(RENDERING_INFO_TOTAL_CANVAS_ITEMS_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDERING_INFO_TOTAL_CANVAS_POSSIBLE_BATCHES_IN_FRAME);
 
 	BIND_ENUM_CONSTANT(FEATURE_SHADERS);
 	BIND_ENUM_CONSTANT(FEATURE_MULTITHREADED);
@@ -2765,7 +2797,6 @@ void RenderingServer::set_render_loop_enabled(bool p_enabled) {
 RenderingServer::RenderingServer() {
 	//ERR_FAIL_COND(singleton);
 
-	thread_pool = memnew(RendererThreadPool);
 	singleton = this;
 
 	GLOBAL_DEF_RST("rendering/textures/vram_compression/import_bptc", false);
@@ -2875,6 +2906,7 @@ RenderingServer::RenderingServer() {
 
 	GLOBAL_DEF_RST("rendering/occlusion_culling/occlusion_rays_per_thread", 512);
 	GLOBAL_DEF_RST("rendering/occlusion_culling/bvh_build_quality", 2);
+	GLOBAL_DEF_RST("rendering/occlusion_culling/use_software_rasterizer", false);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/occlusion_culling/bvh_build_quality", PropertyInfo(Variant::INT, "rendering/occlusion_culling/bvh_build_quality", PROPERTY_HINT_ENUM, "Low,Medium,High"));
 
 	GLOBAL_DEF("rendering/environment/glow/upscale_mode", 1);
@@ -2925,6 +2957,5 @@ RenderingServer::RenderingServer() {
 }
 
 RenderingServer::~RenderingServer() {
-	memdelete(thread_pool);
 	singleton = nullptr;
 }
@@ -0,0 +1,113 @@
+/*************************************************************************/
+/*  test_animation.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_ANIMATION_H
+#define TEST_ANIMATION_H
+
+#include "scene/resources/animation.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAnimation {
+
+static Ref<Animation> create_transform_animation() {
+	Ref<Animation> animation = memnew(Animation);
+	animation->set_length(2.0);
+	int track = animation->add_track(Animation::TYPE_TRANSFORM3D);
+	for (int i = 0; i <= 40; i++) {
+		double time = i * 0.05;
+		animation->transform_track_insert_key(track, time, Vector3(time, Math::sin(time * 3.0), -2.0 * time), Quaternion(Vector3(0, 1, 0), time), Vector3(1, 1, 1) * (1.0 + time));
+	}
+	return animation;
+}
+
+TEST_CASE("[Animation] Compressed transform tracks") {
+	Ref<Animation> reference = create_transform_animation();
+	Ref<Animation> animation = create_transform_animation();
+
+	animation->compress(0.001, 0.001);
+	CHECK(animation->is_compressed());
+	CHECK(animation->track_is_compressed(0));
+	CHECK(animation->track_get_key_count(0) > 0);
+	CHECK(animation->track_get_key_count(0) <= reference->track_get_key_count(0));
+	CHECK(animation->track_get_key_transition(0, 0) == 1.0);
+
+	for (int i = 0; i <= 100; i++) {
+		double time = i * 0.02;
+		Vector3 loc[2];
+		Quaternion rot[2];
+		Vector3 scale[2];
+		CHECK(reference->transform_track_interpolate(0, time, &loc[0], &rot[0], &scale[0]) == OK);
+		CHECK(animation->transform_track_interpolate(0, time, &loc[1], &rot[1], &scale[1]) == OK);
+
+		CHECK_MESSAGE(loc[0].distance_to(loc[1]) < 0.01, "Compressed positions should be close to the original ones.");
+		CHECK_MESSAGE(rot[0].angle_to(rot[1]) < 0.01, "Compressed rotations should be close to the original ones.");
+		CHECK_MESSAGE(scale[0].distance_to(scale[1]) < 0.01, "Compressed scales should be close to the original ones.");
+
+		int track = 0;
+		Vector3 batch_loc;
+		Quaternion batch_rot;
+		Vector3 batch_scale;
+		Error batch_err = FAILED;
+		animation->transform_track_interpolate_batch(&track, 1, time, &batch_loc, &batch_rot, &batch_scale, &batch_err);
+		CHECK(batch_err == OK);
+		CHECK(batch_loc.is_equal_approx(loc[1]));
+		CHECK(batch_rot.is_equal_approx(rot[1]));
+		CHECK(batch_scale.is_equal_approx(scale[1]));
+	}
+
+	// Keys in range are found from the compressed key times.
+	const double ranges[][2] = { { 0.01, 0.01 }, { 0.33, 0.25 }, { 1.99, 1.98 }, { 1.02, 0.3 } };
+	for (const double *range : ranges) {
+		List<int> indices;
+		animation->track_get_key_indices_in_range(0, range[0], range[1], &indices);
+
+		List<int> expected;
+		for (int i = 0; i < animation->track_get_key_count(0); i++) {
+			const double key_time = animation->track_get_key_time(0, i);
+			if (key_time >= range[0] - range[1] && key_time < range[0]) {
+				expected.push_back(i);
+			}
+		}
+
+		CHECK(indices.size() == expected.size());
+		for (const List<int>::Element *E = indices.front(), *F = expected.front(); E && F; E = E->next(), F = F->next()) {
+			CHECK(E->get() == F->get());
+		}
+	}
+
+	animation->transform_track_insert_key(0, 2.0, Vector3(), Quaternion(), Vector3(1, 1, 1));
+	CHECK_MESSAGE(!animation->track_is_compressed(0), "Editing keys should decompress the track.");
+	CHECK(!animation->is_compressed());
+}
+
+} // namespace TestAnimation
+
+#endif // TEST_ANIMATION_H
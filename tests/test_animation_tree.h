@@ -0,0 +1,261 @@
+/*************************************************************************/
+/*  test_animation_tree.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_ANIMATION_TREE_H
+#define TEST_ANIMATION_TREE_H
+
+#include "core/config/project_settings.h"
+#include "scene/3d/node_3d.h"
+#include "scene/animation/animation_blend_tree.h"
+#include "scene/animation/animation_player.h"
+#include "scene/animation/animation_tree.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAnimationTree {
+
+static Ref<Animation> create_move_animation(int p_variant) {
+	Ref<Animation> animation = memnew(Animation);
+	animation->set_length(1.0);
+	animation->set_loop(true);
+	int track = animation->add_track(Animation::TYPE_TRANSFORM3D);
+	animation->track_set_path(track, NodePath("Target"));
+	for (int i = 0; i <= 4; i++) {
+		double time = i * 0.25;
+		Vector3 loc = Vector3(p_variant + 1, 2 * p_variant, -p_variant) * time + Vector3(0, Math::sin(time * (p_variant + 1)), 0);
+		animation->transform_track_insert_key(track, time, loc, Quaternion(Vector3(0, 1, 0), time * (p_variant + 1)), Vector3(1, 1, 1) * (1.0 + time));
+	}
+	return animation;
+}
+
+static Ref<Animation> create_constant_animation(const Vector3 &p_loc) {
+	Ref<Animation> animation = memnew(Animation);
+	animation->set_length(1.0);
+	int track = animation->add_track(Animation::TYPE_TRANSFORM3D);
+	animation->track_set_path(track, NodePath("Target"));
+	animation->transform_track_insert_key(track, 0.0, p_loc, Quaternion(), Vector3(1, 1, 1));
+	return animation;
+}
+
+// A Node3D with a "Target" Node3D child, an AnimationPlayer and, if p_root is valid, an AnimationTree.
+static Node3D *create_rig(const String &p_name, const Ref<AnimationNode> &p_root) {
+	Node3D *rig = memnew(Node3D);
+	rig->set_name(p_name);
+
+	Node3D *target = memnew(Node3D);
+	target->set_name("Target");
+	rig->add_child(target);
+
+	AnimationPlayer *player = memnew(AnimationPlayer);
+	player->set_name("AnimationPlayer");
+	rig->add_child(player);
+
+	if (p_root.is_valid()) {
+		AnimationTree *tree = memnew(AnimationTree);
+		tree->set_name("AnimationTree");
+		tree->set_tree_root(p_root);
+		tree->set_animation_player(NodePath("../AnimationPlayer"));
+		rig->add_child(tree);
+	}
+
+	return rig;
+}
+
+static AnimationPlayer *get_player(Node *p_rig) {
+	return Object::cast_to<AnimationPlayer>(p_rig->get_node(NodePath("AnimationPlayer")));
+}
+
+static AnimationTree *get_animation_tree(Node *p_rig) {
+	return Object::cast_to<AnimationTree>(p_rig->get_node(NodePath("AnimationTree")));
+}
+
+static Transform3D get_target_transform(Node *p_rig) {
+	return Object::cast_to<Node3D>(p_rig->get_node(NodePath("Target")))->get_transform();
+}
+
+static void set_parallel_evaluation(bool p_enabled) {
+	ProjectSettings::get_singleton()->set_setting("animation/processing/parallel_evaluation", p_enabled);
+}
+
+static LocalVector<Transform3D> process_trees(bool p_parallel, double p_delta) {
+	set_parallel_evaluation(p_parallel);
+
+	LocalVector<Node *> rigs;
+	for (int i = 0; i < 8; i++) {
+		Ref<AnimationNodeAnimation> root;
+		root.instantiate();
+		root->set_animation("move");
+
+		Node *rig = create_rig("Rig" + itos(i), root);
+		get_player(rig)->add_animation("move", create_move_animation(i));
+		SceneTree::get_singleton()->get_root()->add_child(rig);
+		get_animation_tree(rig)->set_active(true);
+		rigs.push_back(rig);
+	}
+
+	SceneTree::get_singleton()->process(p_delta);
+
+	LocalVector<Transform3D> result;
+	for (uint32_t i = 0; i < rigs.size(); i++) {
+		result.push_back(get_target_transform(rigs[i]));
+		memdelete(rigs[i]);
+	}
+	return result;
+}
+
+static LocalVector<Transform3D> process_players(bool p_parallel, double p_delta) {
+	set_parallel_evaluation(p_parallel);
+
+	LocalVector<Node *> rigs;
+	for (int i = 0; i < 8; i++) {
+		Node *rig = create_rig("Rig" + itos(i), Ref<AnimationNode>());
+		AnimationPlayer *player = get_player(rig);
+		player->add_animation("move", create_move_animation(i));
+		SceneTree::get_singleton()->get_root()->add_child(rig);
+		player->play("move");
+		player->advance(0); // Builds the caches, players only sample ahead of time once they exist.
+		rigs.push_back(rig);
+	}
+
+	SceneTree::get_singleton()->process(p_delta);
+
+	LocalVector<Transform3D> result;
+	for (uint32_t i = 0; i < rigs.size(); i++) {
+		result.push_back(get_target_transform(rigs[i]));
+		memdelete(rigs[i]);
+	}
+	return result;
+}
+
+TEST_CASE("[SceneTree][AnimationTree] Parallel evaluation matches serial processing") {
+	bool parallel_evaluation = GLOBAL_GET("animation/processing/parallel_evaluation");
+	const double deltas[] = { 0.1, 0.35, 0.8 };
+
+	for (const double delta : deltas) {
+		LocalVector<Transform3D> serial = process_trees(false, delta);
+		LocalVector<Transform3D> parallel = process_trees(true, delta);
+		REQUIRE(serial.size() == parallel.size());
+		for (uint32_t i = 0; i < serial.size(); i++) {
+			CHECK_MESSAGE(parallel[i].is_equal_approx(serial[i]), vformat("AnimationTree %d should have the same pose after %f seconds.", i, delta));
+		}
+
+		serial = process_players(false, delta);
+		parallel = process_players(true, delta);
+		REQUIRE(serial.size() == parallel.size());
+		for (uint32_t i = 0; i < serial.size(); i++) {
+			CHECK_MESSAGE(parallel[i].is_equal_approx(serial[i]), vformat("AnimationPlayer %d should have the same pose after %f seconds.", i, delta));
+		}
+	}
+
+	set_parallel_evaluation(parallel_evaluation);
+}
+
+// A discrete value track of the first tree changes the blend of the second one. As in serial
+// processing, the second tree must see the change in the same frame.
+static Vector3 process_discrete_track_to_other_tree(bool p_parallel) {
+	set_parallel_evaluation(p_parallel);
+
+	Ref<AnimationNodeAnimation> setter_root;
+	setter_root.instantiate();
+	setter_root->set_animation("set_blend");
+
+	Node *setter = create_rig("Setter", setter_root);
+	Ref<Animation> set_blend;
+	set_blend.instantiate();
+	set_blend->set_length(1.0);
+	int track = set_blend->add_track(Animation::TYPE_VALUE);
+	set_blend->track_set_path(track, NodePath("../Blended/AnimationTree:parameters/blend/blend_amount"));
+	set_blend->value_track_set_update_mode(track, Animation::UPDATE_DISCRETE);
+	set_blend->track_insert_key(track, 0.05, 1.0);
+	get_player(setter)->add_animation("set_blend", set_blend);
+
+	Ref<AnimationNodeBlendTree> blended_root;
+	blended_root.instantiate();
+	Ref<AnimationNodeAnimation> left;
+	left.instantiate();
+	left->set_animation("left");
+	Ref<AnimationNodeAnimation> right;
+	right.instantiate();
+	right->set_animation("right");
+	blended_root->add_node("left", left);
+	blended_root->add_node("right", right);
+	blended_root->add_node("blend", memnew(AnimationNodeBlend2));
+	blended_root->connect_node("blend", 0, "left");
+	blended_root->connect_node("blend", 1, "right");
+	blended_root->connect_node("output", 0, "blend");
+
+	Node *blended = create_rig("Blended", blended_root);
+	get_player(blended)->add_animation("left", create_constant_animation(Vector3()));
+	get_player(blended)->add_animation("right", create_constant_animation(Vector3(10, 0, 0)));
+
+	LocalVector<Node *> rigs;
+	rigs.push_back(setter);
+	rigs.push_back(blended);
+	// Trees processed after them, so the second tree can be part of a batch.
+	for (int i = 0; i < 4; i++) {
+		Ref<AnimationNodeAnimation> root;
+		root.instantiate();
+		root->set_animation("move");
+		Node *rig = create_rig("Rig" + itos(i), root);
+		get_player(rig)->add_animation("move", create_move_animation(i));
+		rigs.push_back(rig);
+	}
+
+	for (uint32_t i = 0; i < rigs.size(); i++) {
+		SceneTree::get_singleton()->get_root()->add_child(rigs[i]);
+		get_animation_tree(rigs[i])->set_active(true);
+	}
+
+	SceneTree::get_singleton()->process(0.1);
+
+	Vector3 result = get_target_transform(blended).origin;
+	for (uint32_t i = 0; i < rigs.size(); i++) {
+		memdelete(rigs[i]);
+	}
+	return result;
+}
+
+TEST_CASE("[SceneTree][AnimationTree] Discrete value tracks affect the trees processed after them") {
+	bool parallel_evaluation = GLOBAL_GET("animation/processing/parallel_evaluation");
+
+	Vector3 serial = process_discrete_track_to_other_tree(false);
+	CHECK(serial.is_equal_approx(Vector3(10, 0, 0)));
+
+	Vector3 parallel = process_discrete_track_to_other_tree(true);
+	CHECK_MESSAGE(parallel.is_equal_approx(serial), "The blend set by the first tree should apply in the same frame.");
+
+	set_parallel_evaluation(parallel_evaluation);
+}
+
+} // namespace TestAnimationTree
+
+#endif // TEST_ANIMATION_TREE_H
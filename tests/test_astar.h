@@ -218,6 +218,146 @@ TEST_CASE("[AStar] Add/Remove") {
 	// It's been great work, cheers. \(^ ^)/
 }
 
+TEST_CASE("[AStar] Closest point with spatial index") {
+	Math::seed(0);
+
+	AStar a;
+	AStar b;
+	b.set_spatial_index_cell_size(4);
+	for (int i = 0; i < 200; i++) {
+		Vector3 pos(Math::rand() % 50, Math::rand() % 50, Math::rand() % 50);
+		a.add_point(i, pos);
+		b.add_point(i, pos);
+		if (i % 7 == 0) {
+			a.set_point_disabled(i);
+			b.set_point_disabled(i);
+		}
+	}
+	// Move some points around, which changes their cell.
+	for (int i = 0; i < 200; i += 5) {
+		Vector3 pos(Math::rand() % 50, Math::rand() % 50, Math::rand() % 50);
+		a.set_point_position(i, pos);
+		b.set_point_position(i, pos);
+	}
+
+	for (int i = 0; i < 200; i++) {
+		// Also query positions far outside of the points.
+		Vector3 pos(Math::rand() % 100 - 25, Math::rand() % 100 - 25, Math::rand() % 100 - 25);
+		CHECK(a.get_closest_point(pos) == b.get_closest_point(pos));
+		CHECK(a.get_closest_point(pos, true) == b.get_closest_point(pos, true));
+	}
+
+	b.clear();
+	CHECK(b.get_closest_point(Vector3()) == -1);
+}
+
+TEST_CASE("[AStar] Hierarchical paths") {
+	// Grid with random walls, searched with and without clusters.
+	const int N = 24;
+	Math::seed(0);
+
+	AStar a;
+	AStar b;
+	b.set_cluster_size(6);
+	for (int x = 0; x < N; x++) {
+		for (int y = 0; y < N; y++) {
+			a.add_point(x * N + y, Vector3(x, y, 0));
+			b.add_point(x * N + y, Vector3(x, y, 0));
+		}
+	}
+	for (int x = 0; x < N; x++) {
+		for (int y = 0; y < N; y++) {
+			if (x + 1 < N) {
+				a.connect_points(x * N + y, (x + 1) * N + y);
+				b.connect_points(x * N + y, (x + 1) * N + y);
+			}
+			if (y + 1 < N) {
+				// Some one-way connections too.
+				bool bidirectional = Math::rand() % 4 != 0;
+				a.connect_points(x * N + y, x * N + y + 1, bidirectional);
+				b.connect_points(x * N + y, x * N + y + 1, bidirectional);
+			}
+		}
+	}
+
+	for (int round = 0; round < 4; round++) {
+		for (int i = 0; i < N * 2; i++) {
+			int id = Math::rand() % (N * N);
+			bool disabled = Math::rand() % 3 != 0;
+			a.set_point_disabled(id, disabled);
+			b.set_point_disabled(id, disabled);
+			a.set_point_weight_scale(id, 1 + Math::rand() % 3);
+			b.set_point_weight_scale(id, a.get_point_weight_scale(id));
+		}
+
+		for (int i = 0; i < 100; i++) {
+			int from = Math::rand() % (N * N);
+			int to = Math::rand() % (N * N);
+			Vector<int> flat = a.get_id_path(from, to);
+			Vector<int> route = b.get_id_path(from, to);
+			REQUIRE(flat.is_empty() == route.is_empty());
+			if (route.is_empty()) {
+				continue;
+			}
+
+			CHECK(route[0] == from);
+			CHECK(route[route.size() - 1] == to);
+			real_t flat_cost = 0;
+			for (int j = 1; j < flat.size(); j++) {
+				flat_cost += a.get_point_position(flat[j - 1]).distance_to(a.get_point_position(flat[j])) * a.get_point_weight_scale(flat[j]);
+			}
+			real_t cost = 0;
+			for (int j = 1; j < route.size(); j++) {
+				CHECK(b.are_points_connected(route[j - 1], route[j], false));
+				CHECK(!b.is_point_disabled(route[j]));
+				cost += b.get_point_position(route[j - 1]).distance_to(b.get_point_position(route[j])) * b.get_point_weight_scale(route[j]);
+			}
+			CHECK(cost == doctest::Approx(flat_cost));
+		}
+	}
+}
+
+TEST_CASE("[AStar] Batch of paths") {
+	const int N = 16;
+	Math::seed(0);
+
+	AStar a;
+	for (int x = 0; x < N; x++) {
+		for (int y = 0; y < N; y++) {
+			a.add_point(x * N + y, Vector3(x, y, 0), 1 + Math::rand() % 3);
+			if (x > 0) {
+				a.connect_points((x - 1) * N + y, x * N + y);
+			}
+			if (y > 0) {
+				a.connect_points(x * N + y - 1, x * N + y);
+			}
+		}
+	}
+	for (int i = 0; i < N; i++) {
+		a.set_point_disabled(Math::rand() % (N * N));
+	}
+
+	Vector<int> from_ids;
+	Vector<int> to_ids;
+	for (int i = 0; i < 200; i++) {
+		from_ids.push_back(Math::rand() % (N * N));
+		to_ids.push_back(Math::rand() % (N * N));
+	}
+
+	for (int cluster_size = 0; cluster_size <= 4; cluster_size += 4) {
+		a.set_cluster_size(cluster_size);
+		Array paths = a.get_id_paths(from_ids, to_ids);
+		REQUIRE(paths.size() == from_ids.size());
+		for (int i = 0; i < from_ids.size(); i++) {
+			CHECK(Vector<int>(paths[i]) == a.get_id_path(from_ids[i], to_ids[i]));
+		}
+	}
+
+	ERR_PRINT_OFF;
+	CHECK(a.get_id_paths(from_ids, Vector<int>()).is_empty());
+	ERR_PRINT_ON;
+}
+
 TEST_CASE("[Stress][AStar] Find paths") {
 	// Random stress tests with Floyd-Warshall.
 	const int N = 30;
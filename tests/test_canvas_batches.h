@@ -0,0 +1,188 @@
+/*************************************************************************/
+/*  test_canvas_batches.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CANVAS_BATCHES_H
+#define TEST_CANVAS_BATCHES_H
+
+#include "core/io/image.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCanvasBatches {
+
+// A canvas with a row of 8x8 items, drawn in the order they were added.
+struct CanvasScene {
+	RID canvas;
+	RID texture_a;
+	RID texture_b;
+	Vector<RID> items;
+
+	RID add_item(RID p_texture = RID()) {
+		RID item = RS::get_singleton()->canvas_item_create();
+		RS::get_singleton()->canvas_item_set_parent(item, canvas);
+		RS::get_singleton()->canvas_item_set_draw_index(item, items.size());
+
+		const Rect2 rect(items.size() * 8, 0, 8, 8);
+		if (p_texture.is_valid()) {
+			RS::get_singleton()->canvas_item_add_texture_rect(item, rect, p_texture);
+		} else {
+			RS::get_singleton()->canvas_item_add_rect(item, rect, Color(1, 1, 1));
+		}
+
+		items.push_back(item);
+		return item;
+	}
+
+	bool is_batch_break(RID p_item) const {
+		return RSG::canvas->canvas_item_owner.getornull(p_item)->batch_break;
+	}
+
+	void render() {
+		RSG::canvas->render_canvas(RID(), RSG::canvas->canvas_owner.getornull(canvas), Transform2D(), nullptr, nullptr, Rect2(0, 0, 256, 256), RS::CANVAS_ITEM_TEXTURE_FILTER_LINEAR, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED, false, false);
+	}
+
+	CanvasScene() {
+		canvas = RS::get_singleton()->canvas_create();
+
+		Ref<Image> image;
+		image.instantiate();
+		image->create(4, 4, false, Image::FORMAT_RGBA8);
+		texture_a = RS::get_singleton()->texture_2d_create(image);
+		texture_b = RS::get_singleton()->texture_2d_create(image);
+
+		RSG::canvas->reset_render_info();
+	}
+
+	// The dummy storage claims every RID in RenderingServer::free(), so the canvas is freed directly.
+	~CanvasScene() {
+		for (int i = 0; i < items.size(); i++) {
+			RSG::canvas->free(items[i]);
+		}
+		RSG::canvas->free(canvas);
+		RS::get_singleton()->free(texture_a);
+		RS::get_singleton()->free(texture_b);
+	}
+};
+
+// The dummy rasterizer doesn't create render targets, so viewports aren't drawn when running
+// tests. The canvas is rendered directly instead, which is what feeds the counters returned
+// by RenderingServer::get_rendering_info() for the frame.
+TEST_CASE("[SceneTree][RenderingServer] Canvas items and possible batches") {
+	CanvasScene scene;
+
+	SUBCASE("Untextured items with the same state make one batch") {
+		scene.add_item();
+		scene.add_item();
+		scene.add_item();
+		scene.render();
+
+		CHECK(RSG::canvas->get_items_drawn() == 3);
+		CHECK(RSG::canvas->get_possible_batches() == 1);
+	}
+
+	SUBCASE("A new texture starts a batch") {
+		RID a1 = scene.add_item(scene.texture_a);
+		RID a2 = scene.add_item(scene.texture_a);
+		RID b = scene.add_item(scene.texture_b);
+		scene.render();
+
+		CHECK(RSG::canvas->get_items_drawn() == 3);
+		CHECK(RSG::canvas->get_possible_batches() == 2);
+		CHECK(scene.is_batch_break(a1));
+		CHECK_FALSE(scene.is_batch_break(a2));
+		CHECK(scene.is_batch_break(b));
+	}
+
+	SUBCASE("Untextured items bind the default texture") {
+		scene.add_item(scene.texture_a);
+		scene.add_item();
+		scene.add_item(scene.texture_a);
+		scene.render();
+
+		CHECK(RSG::canvas->get_items_drawn() == 3);
+		CHECK(RSG::canvas->get_possible_batches() == 3);
+	}
+
+	SUBCASE("A different texture filter starts a batch") {
+		scene.add_item();
+		RID nearest = scene.add_item();
+		RS::get_singleton()->canvas_item_set_default_texture_filter(nearest, RS::CANVAS_ITEM_TEXTURE_FILTER_NEAREST);
+		scene.add_item();
+		scene.render();
+
+		CHECK(RSG::canvas->get_items_drawn() == 3);
+		CHECK(RSG::canvas->get_possible_batches() == 3);
+		CHECK(scene.is_batch_break(nearest));
+	}
+
+	SUBCASE("Hidden items are not counted") {
+		scene.add_item();
+		RID hidden = scene.add_item();
+		RS::get_singleton()->canvas_item_set_visible(hidden, false);
+		scene.add_item();
+		scene.render();
+
+		CHECK(RSG::canvas->get_items_drawn() == 2);
+		CHECK(RSG::canvas->get_possible_batches() == 1);
+	}
+
+	SUBCASE("Counters add up over the frame until they are reset") {
+		scene.add_item(scene.texture_a);
+		scene.add_item(scene.texture_b);
+		scene.render();
+		scene.render();
+
+		CHECK(RSG::canvas->get_items_drawn() == 4);
+		CHECK(RSG::canvas->get_possible_batches() == 4);
+
+		RSG::canvas->reset_render_info();
+		CHECK(RSG::canvas->get_items_drawn() == 0);
+		CHECK(RSG::canvas->get_possible_batches() == 0);
+	}
+}
+
+TEST_CASE("[SceneTree][RenderingServer] Rendering info reports the canvas counters of the last frame") {
+	CanvasScene scene;
+	scene.add_item(scene.texture_a);
+	scene.add_item(scene.texture_a);
+	scene.render();
+
+	// No viewport is drawn, so the frame resets the counters and reports them as zero.
+	RS::get_singleton()->draw(false);
+	CHECK(RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_TOTAL_CANVAS_ITEMS_IN_FRAME) == 0);
+	CHECK(RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_TOTAL_CANVAS_POSSIBLE_BATCHES_IN_FRAME) == 0);
+	CHECK(RSG::canvas->get_items_drawn() == 0);
+}
+
+} // namespace TestCanvasBatches
+
+#endif // TEST_CANVAS_BATCHES_H
@@ -38,6 +38,7 @@
 #include "core/os/semaphore.h"
 #include "core/os/thread.h"
 #include "core/templates/command_queue_mt.h"
+#include "core/templates/safe_refcount.h"
 #include "test_macros.h"
 
 #if !defined(NO_THREADS)
@@ -426,6 +427,120 @@ TEST_CASE("[Stress][CommandQueue] Stress test command queue") {
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
+
+// Several producer threads push into one queue while a reader flushes it.
+struct MultiProducerState {
+	CommandQueueMT command_queue = CommandQueueMT(false);
+	Vector<int> last_values;
+	int received = 0;
+	SafeNumeric<uint32_t> order_errors; // Also written by the producers.
+	int commands_per_producer = 0;
+	SafeFlag exit_reader;
+
+	struct Producer {
+		MultiProducerState *state = nullptr;
+		int index = 0;
+	};
+
+	void receive(int p_producer, int p_value) {
+		// Commands from the same producer must arrive in the order they were pushed.
+		if (last_values[p_producer] + 1 != p_value) {
+			order_errors.increment();
+		}
+		last_values.write[p_producer] = p_value;
+		received++;
+	}
+
+	int receive_and_ret(int p_producer, int p_value) {
+		receive(p_producer, p_value);
+		return p_value;
+	}
+
+	static void producer_loop(void *p_userdata) {
+		Producer *producer = (Producer *)p_userdata;
+		MultiProducerState *state = producer->state;
+		for (int i = 0; i < state->commands_per_producer; i++) {
+			if (i % 1024 == 1023) {
+				int ret = -1;
+				state->command_queue.push_and_ret(state, &MultiProducerState::receive_and_ret, producer->index, i, &ret);
+				if (ret != i) {
+					state->order_errors.increment();
+				}
+			} else {
+				state->command_queue.push(state, &MultiProducerState::receive, producer->index, i);
+			}
+		}
+	}
+
+	static void reader_loop(void *p_userdata) {
+		MultiProducerState *state = (MultiProducerState *)p_userdata;
+		while (!state->exit_reader.is_set()) {
+			state->command_queue.flush_if_pending();
+		}
+		state->command_queue.flush_all();
+	}
+
+	uint64_t run(int p_producer_count, int p_commands_per_producer) {
+		commands_per_producer = p_commands_per_producer;
+		last_values.resize(p_producer_count);
+		last_values.fill(-1);
+		received = 0;
+		exit_reader.clear();
+
+		Thread reader_thread;
+		reader_thread.start(&MultiProducerState::reader_loop, this);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		Vector<Producer> producers;
+		producers.resize(p_producer_count);
+		Vector<Thread *> threads;
+		for (int i = 0; i < p_producer_count; i++) {
+			producers.write[i].state = this;
+			producers.write[i].index = i;
+			Thread *thread = memnew(Thread);
+			thread->start(&MultiProducerState::producer_loop, &producers.write[i]);
+			threads.push_back(thread);
+		}
+		for (int i = 0; i < p_producer_count; i++) {
+			threads[i]->wait_to_finish();
+			memdelete(threads[i]);
+		}
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		exit_reader.set();
+		reader_thread.wait_to_finish();
+		return elapsed;
+	}
+};
+
+TEST_CASE("[CommandQueue] Multiple producers") {
+	const char *COMMAND_QUEUE_SETTING = "memory/limits/command_queue/multithreading_queue_size_kb";
+	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING, 1);
+	MultiProducerState state;
+	state.run(4, 4096);
+
+	CHECK_MESSAGE(state.received == 4 * 4096,
+			"Reader should have read every message pushed by the producers.");
+	CHECK_MESSAGE(state.order_errors.get() == 0,
+			"Messages from each producer should be read in the order they were pushed.");
+	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
+			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
+}
+
+// Measures push throughput with several producers feeding one reader.
+// Run with `--test --no-skip --test-case="*Benchmark*"`.
+TEST_CASE("[CommandQueue][Benchmark] Multi-producer throughput" * doctest::skip()) {
+	const int commands_per_producer = 1000000;
+	const int max_threads = MAX(OS::get_singleton()->get_processor_count() - 1, 1);
+	for (int producer_count = 1; producer_count <= max_threads; producer_count *= 2) {
+		MultiProducerState state;
+		uint64_t elapsed = state.run(producer_count, commands_per_producer);
+		CHECK(state.received == producer_count * commands_per_producer);
+
+		double ns_per_push = double(elapsed) * 1000.0 / double(commands_per_producer);
+		MESSAGE(vformat("%d producer(s): %d usec, %.1f ns per push per producer.", producer_count, elapsed, ns_per_push));
+	}
+}
 } // namespace TestCommandQueue
 
 #endif // !defined(NO_THREADS)
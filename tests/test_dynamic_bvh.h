@@ -0,0 +1,145 @@
+/*************************************************************************/
+/*  test_dynamic_bvh.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_DYNAMIC_BVH_H
+#define TEST_DYNAMIC_BVH_H
+
+#include "core/math/dynamic_bvh.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestDynamicBVH {
+
+struct CollectResult {
+	LocalVector<uint32_t> indices;
+
+	bool operator()(void *p_data) {
+		indices.push_back((uint32_t)(uintptr_t)p_data);
+		return false;
+	}
+};
+
+static String get_query_results(DynamicBVH &p_bvh, const AABB &p_query) {
+	CollectResult result;
+	p_bvh.aabb_query(p_query, result);
+	result.indices.sort();
+	String text;
+	for (uint32_t i = 0; i < result.indices.size(); i++) {
+		text += itos(result.indices[i]) + " ";
+	}
+	return text;
+}
+
+static String get_expected_results(const LocalVector<AABB> &p_boxes, const AABB &p_query) {
+	String text;
+	for (uint32_t i = 0; i < p_boxes.size(); i++) {
+		// DynamicBVH volumes are closed, unlike AABB::intersects().
+		const Vector3 box_end = p_boxes[i].position + p_boxes[i].size;
+		const Vector3 query_end = p_query.position + p_query.size;
+		if (p_boxes[i].position.x <= query_end.x && box_end.x >= p_query.position.x &&
+				p_boxes[i].position.y <= query_end.y && box_end.y >= p_query.position.y &&
+				p_boxes[i].position.z <= query_end.z && box_end.z >= p_query.position.z) {
+			text += itos(i) + " ";
+		}
+	}
+	return text;
+}
+
+static AABB get_union(const LocalVector<AABB> &p_boxes) {
+	AABB result = p_boxes[0];
+	for (uint32_t i = 1; i < p_boxes.size(); i++) {
+		result.merge_with(p_boxes[i]);
+	}
+	return result;
+}
+
+TEST_CASE("[DynamicBVH] Refit keeps queries exact after many small moves") {
+	RandomPCG rng(42);
+	DynamicBVH bvh;
+	LocalVector<DynamicBVH::ID> ids;
+	LocalVector<AABB> boxes;
+	LocalVector<Vector3> velocities;
+
+	const int box_count = 500;
+	for (int i = 0; i < box_count; i++) {
+		const AABB box(Vector3(rng.random(-50.0, 50.0), rng.random(-50.0, 50.0), rng.random(-50.0, 50.0)), Vector3(1, 1, 1) * rng.random(0.5, 2.0));
+		ids.push_back(bvh.insert(box, (void *)(uintptr_t)i));
+		boxes.push_back(box);
+		// Every box drifts in a steady direction, so it ends far from the siblings it started with.
+		velocities.push_back(Vector3(rng.random(-1.0, 1.0), rng.random(-1.0, 1.0), rng.random(-1.0, 1.0)) * 0.1);
+	}
+
+	LocalVector<DynamicBVH::ID> moved_ids;
+	LocalVector<AABB> moved_boxes;
+	for (int step = 0; step < 300; step++) {
+		moved_ids.clear();
+		moved_boxes.clear();
+		for (int i = 0; i < box_count; i++) {
+			// Some boxes stay still, others also grow or shrink.
+			if ((i + step) % 4 == 0) {
+				continue;
+			}
+			boxes[i].position += velocities[i];
+			if (i % 7 == 0) {
+				boxes[i].size = Vector3(1, 1, 1) * (1.0 + 0.5 * Math::sin(step * 0.1 + i));
+			}
+			moved_ids.push_back(ids[i]);
+			moved_boxes.push_back(boxes[i]);
+		}
+		bvh.refit(moved_ids.ptr(), moved_boxes.ptr(), moved_ids.size());
+
+		// The ancestors must shrink with their leaves rather than keep the space they left.
+		const AABB root = bvh.get_root_aabb();
+		const AABB leaves = get_union(boxes);
+		CHECK_MESSAGE(root.position.distance_to(leaves.position) < 0.001, vformat("The root volume after %d steps should start where the union of the leaves does.", step + 1));
+		CHECK_MESSAGE((root.position + root.size).distance_to(leaves.position + leaves.size) < 0.001, vformat("The root volume after %d steps should end where the union of the leaves does.", step + 1));
+
+		if (step % 50 == 49) {
+			for (int i = 0; i < 20; i++) {
+				const AABB query(Vector3(rng.random(-80.0, 80.0), rng.random(-80.0, 80.0), rng.random(-80.0, 80.0)), Vector3(rng.random(1.0, 30.0), rng.random(1.0, 30.0), rng.random(1.0, 30.0)));
+				CHECK_MESSAGE(get_query_results(bvh, query) == get_expected_results(boxes, query), vformat("Query %d after %d steps should find the same boxes as a brute force search.", i, step + 1));
+			}
+		}
+	}
+
+	CHECK(bvh.get_leaf_count() == box_count);
+
+	// Small queries near the places the boxes drifted away from.
+	for (int i = 0; i < box_count; i += 25) {
+		const AABB query(boxes[i].position - velocities[i] * 200, Vector3(0.5, 0.5, 0.5));
+		CHECK(get_query_results(bvh, query) == get_expected_results(boxes, query));
+	}
+}
+
+} // namespace TestDynamicBVH
+
+#endif // TEST_DYNAMIC_BVH_H
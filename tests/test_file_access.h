@@ -32,6 +32,7 @@
 #define TEST_FILE_ACCESS_H
 
 #include "core/io/file_access.h"
+#include "core/io/file_access_pack.h"
 #include "test_utils.h"
 
 namespace TestFileAccess {
@@ -79,6 +80,53 @@ TEST_CASE("[FileAccess] CSV read") {
 
 	f->close();
 }
+
+TEST_CASE("[FileAccess] Reading a file from a pack mapped in memory") {
+	// Simulates a mapped pack: some other file, then ours at an offset.
+	const char pack[] = "OTHERFILE\x04\x00\x00\x00"
+					   "abc\x00TAIL";
+	PackedData::PackedFile pf;
+	pf.pack = "res://mapped.pck";
+	pf.offset = 9;
+	pf.size = 12;
+	pf.src = nullptr;
+	pf.encrypted = false;
+
+	FileAccessPack f("res://file.bin", pf, (const uint8_t *)pack);
+	CHECK(f.is_open());
+	CHECK(f.get_length() == 12);
+	CHECK(f.get_32() == 4);
+
+	const uint8_t *view = f.get_view(4);
+	REQUIRE(view != nullptr);
+	CHECK(String((const char *)view) == "abc");
+	CHECK_MESSAGE(f.get_position() == 4, "Getting a view should not move the position.");
+	CHECK_MESSAGE(f.get_view(9) == nullptr, "Views must not extend past the end of the file.");
+
+	uint8_t buffer[8] = {};
+	CHECK(f.get_buffer(buffer, 8) == 8);
+	CHECK(String((const char *)buffer, 3) == "abc");
+	CHECK(buffer[4] == 'T');
+	CHECK(!f.eof_reached());
+
+	CHECK(f.get_buffer(buffer, 1) == 0);
+	CHECK(f.eof_reached());
+	CHECK(f.get_view(1) == nullptr);
+
+	f.seek(4);
+	CHECK(f.get_8() == 'a');
+
+	// Using a closed file fails without touching the mapping.
+	f.close();
+	CHECK_FALSE(f.is_open());
+	CHECK(f.get_view(1) == nullptr);
+	ERR_PRINT_OFF;
+	f.seek(0);
+	CHECK(f.get_8() == 0);
+	CHECK(f.get_buffer(buffer, 4) == uint64_t(-1));
+	ERR_PRINT_ON;
+	f.close();
+}
 } // namespace TestFileAccess
 
 #endif // TEST_FILE_ACCESS_H
@@ -30,12 +30,24 @@
 
 #include "test_main.h"
 
+#include "core/input/input.h"
+#include "core/object/message_queue.h"
 #include "core/templates/list.h"
+#include "scene/main/scene_tree.h"
+#include "servers/display_server.h"
+#include "servers/navigation_server_2d.h"
+#include "servers/navigation_server_3d.h"
+#include "servers/physics_server_2d.h"
+#include "servers/physics_server_3d.h"
+#include "servers/rendering/rendering_server_default.h"
 
 #include "test_aabb.h"
+#include "test_animation.h"
+#include "test_animation_tree.h"
 #include "test_array.h"
 #include "test_astar.h"
 #include "test_basis.h"
+#include "test_canvas_batches.h"
 #include "test_class_db.h"
 #include "test_color.h"
 #include "test_command_queue.h"
@@ -43,6 +55,7 @@
 #include "test_crypto.h"
 #include "test_curve.h"
 #include "test_dictionary.h"
+#include "test_dynamic_bvh.h"
 #include "test_expression.h"
 #include "test_file_access.h"
 #include "test_geometry_2d.h"
@@ -62,23 +75,30 @@
 #include "test_oa_hash_map.h"
 #include "test_object.h"
 #include "test_ordered_hash_map.h"
+#include "test_packed_scene.h"
 #include "test_paged_array.h"
 #include "test_path_3d.h"
 #include "test_pck_packer.h"
 #include "test_physics_2d.h"
 #include "test_physics_3d.h"
+#include "test_physics_server_3d.h"
 #include "test_random_number_generator.h"
+#include "test_raster_occlusion_cull.h"
 #include "test_rect2.h"
 #include "test_render.h"
+#include "test_renderer_scene_cull.h"
 #include "test_resource.h"
+#include "test_scene_tree.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_string_name.h"
 #include "test_text_server.h"
 #include "test_time.h"
 #include "test_translation.h"
 #include "test_validate_testing.h"
 #include "test_variant.h"
 #include "test_vector.h"
+#include "test_worker_thread_pool.h"
 #include "test_xml_parser.h"
 
 #include "modules/modules_tests.gen.h"
@@ -146,3 +166,101 @@ int test_main(int argc, char *argv[]) {
 
 	return test_context.run();
 }
+
+// Sets up the servers and a SceneTree for test cases with "[SceneTree]" in their name,
+// and tears them down afterwards. Rendering uses the dummy rasterizer.
+struct GodotTestCaseListener : public doctest::IReporter {
+	GodotTestCaseListener(const doctest::ContextOptions &p_in) {}
+
+	bool scene_tree_setup = false;
+	Input *input = nullptr;
+	PhysicsServer3D *physics_3d_server = nullptr;
+	PhysicsServer2D *physics_2d_server = nullptr;
+	NavigationServer3D *navigation_3d_server = nullptr;
+	NavigationServer2D *navigation_2d_server = nullptr;
+
+	void test_case_start(const doctest::TestCaseData &p_in) override {
+		String name = String(p_in.m_name);
+		if (name.find("[SceneTree]") == -1) {
+			return;
+		}
+
+		GLOBAL_DEF("internationalization/rendering/force_right_to_left_layout_direction", false);
+
+		scene_tree_setup = true;
+
+		memnew(MessageQueue);
+		input = memnew(Input);
+
+		Error err = OK;
+		for (int i = 0; i < DisplayServer::get_create_function_count(); i++) {
+			if (String("headless") == DisplayServer::get_create_function_name(i)) {
+				DisplayServer::create(i, "", DisplayServer::WINDOW_MODE_MINIMIZED, DisplayServer::VSYNC_ENABLED, 0, Vector2i(), err);
+				break;
+			}
+		}
+		memnew(RenderingServerDefault());
+		RenderingServerDefault::get_singleton()->init();
+
+		physics_3d_server = PhysicsServer3DManager::new_default_server();
+		physics_3d_server->init();
+		physics_2d_server = PhysicsServer2DManager::new_default_server();
+		physics_2d_server->init();
+
+		navigation_3d_server = NavigationServer3DManager::new_default_server();
+		navigation_2d_server = memnew(NavigationServer2D);
+
+		memnew(SceneTree);
+		SceneTree::get_singleton()->initialize();
+	}
+
+	void test_case_end(const doctest::CurrentTestCaseStats &) override {
+		if (!scene_tree_setup) {
+			return;
+		}
+		scene_tree_setup = false;
+
+		SceneTree::get_singleton()->finalize();
+		MessageQueue::get_singleton()->flush();
+		memdelete(SceneTree::get_singleton());
+
+		memdelete(navigation_2d_server);
+		navigation_2d_server = nullptr;
+		memdelete(navigation_3d_server);
+		navigation_3d_server = nullptr;
+
+		physics_2d_server->finish();
+		memdelete(physics_2d_server);
+		physics_2d_server = nullptr;
+		physics_3d_server->finish();
+		memdelete(physics_3d_server);
+		physics_3d_server = nullptr;
+
+		RenderingServer::get_singleton()->sync();
+		RenderingServer::get_singleton()->finish();
+		memdelete(RenderingServer::get_singleton());
+
+		if (DisplayServer::get_singleton()) {
+			memdelete(DisplayServer::get_singleton());
+		}
+
+		memdelete(input);
+		input = nullptr;
+
+		MessageQueue::get_singleton()->flush();
+		memdelete(MessageQueue::get_singleton());
+	}
+
+	void test_run_start() override {}
+	void test_run_end(const doctest::TestRunStats &) override {}
+	void test_case_reenter(const doctest::TestCaseData &) override {}
+	void test_case_exception(const doctest::TestCaseException &) override {}
+	void subcase_start(const doctest::SubcaseSignature &) override {}
+	void subcase_end() override {}
+	void report_query(const doctest::QueryData &) override {}
+	void log_assert(const doctest::AssertData &) override {}
+	void log_message(const doctest::MessageData &) override {}
+	void test_case_skipped(const doctest::TestCaseData &) override {}
+};
+
+REGISTER_LISTENER("GodotTestCaseListener", 1, GodotTestCaseListener);
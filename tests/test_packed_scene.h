@@ -0,0 +1,183 @@
+/*************************************************************************/
+/*  test_packed_scene.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PACKED_SCENE_H
+#define TEST_PACKED_SCENE_H
+
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/os/os.h"
+#include "scene/2d/node_2d.h"
+#include "scene/3d/node_3d.h"
+#include "scene/gui/control.h"
+#include "scene/resources/packed_scene.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPackedScene {
+
+// Root (Node2D)
+// ├── Panel (Control), with indexed properties.
+// └── Spatial (Node3D)
+//     └── Leaf (Node), in a persistent group.
+static Node *create_scene() {
+	Node2D *root = memnew(Node2D);
+	root->set_name("Root");
+	root->set_position(Vector2(10, 20));
+	root->set_rotation(0.5);
+	root->set_z_index(3);
+	root->set_meta("tag", "root");
+
+	Control *panel = memnew(Control);
+	panel->set_name("Panel");
+	panel->set("anchor_right", 1.0);
+	panel->set("anchor_bottom", 0.5);
+	panel->set_modulate(Color(1, 0.5, 0.25));
+	root->add_child(panel);
+	panel->set_owner(root);
+
+	Node3D *spatial = memnew(Node3D);
+	spatial->set_name("Spatial");
+	spatial->set_transform(Transform3D(Basis(Vector3(0, 1, 0), 1.0), Vector3(1, 2, 3)));
+	spatial->set_visible(false);
+	root->add_child(spatial);
+	spatial->set_owner(root);
+
+	Node *leaf = memnew(Node);
+	leaf->set_name("Leaf");
+	leaf->set_process_priority(4);
+	leaf->add_to_group("leaves", true);
+	spatial->add_child(leaf);
+	leaf->set_owner(root);
+
+	return root;
+}
+
+// Compares the names, classes, groups and stored properties of two node trees.
+static void check_same_tree(Node *p_node, Node *p_expected) {
+	const String path = String(p_expected->get_name());
+	CHECK_MESSAGE(p_node->get_name() == p_expected->get_name(), vformat("%s should have the expected name.", path));
+	CHECK_MESSAGE(p_node->get_class() == p_expected->get_class(), vformat("%s should have the expected class.", path));
+	CHECK_MESSAGE(p_node->is_in_group("leaves") == p_expected->is_in_group("leaves"), vformat("%s should be in the expected groups.", path));
+
+	List<PropertyInfo> properties;
+	p_expected->get_property_list(&properties);
+	for (const PropertyInfo &E : properties) {
+		// Dictionaries are compared by reference, so the metadata is checked separately.
+		if (!(E.usage & PROPERTY_USAGE_STORAGE) || E.name == "__meta__") {
+			continue;
+		}
+		CHECK_MESSAGE(p_node->get(E.name).hash_compare(p_expected->get(E.name)), vformat("Property \"%s\" of %s should have the expected value.", E.name, path));
+	}
+
+	REQUIRE_MESSAGE(p_node->get_child_count() == p_expected->get_child_count(), vformat("%s should have the expected children.", path));
+	for (int i = 0; i < p_expected->get_child_count(); i++) {
+		check_same_tree(p_node->get_child(i), p_expected->get_child(i));
+	}
+}
+
+TEST_CASE("[SceneTree][PackedScene] Instantiation with resolved setters matches Object::set()") {
+	Node *original = create_scene();
+	Ref<PackedScene> scene;
+	scene.instantiate();
+	REQUIRE(scene->pack(original) == OK);
+
+	SUBCASE("Instantiating at runtime gives the packed tree") {
+		// The first instantiation builds the plan, the second one only uses it.
+		Node *first = scene->instantiate();
+		Node *second = scene->instantiate();
+		REQUIRE(first);
+		REQUIRE(second);
+
+		check_same_tree(first, original);
+		check_same_tree(second, original);
+		CHECK(Object::cast_to<Node2D>(second)->get_position() == Vector2(10, 20));
+		CHECK(second->get_meta("tag") == "root");
+		CHECK(double(second->get_node(NodePath("Panel"))->get("anchor_right")) == doctest::Approx(1.0));
+		CHECK(double(second->get_node(NodePath("Panel"))->get("anchor_bottom")) == doctest::Approx(0.5));
+
+		memdelete(first);
+		memdelete(second);
+	}
+
+	SUBCASE("Runtime and editor instantiation give the same tree") {
+		// The editor states don't use the plan, every property goes through Object::set().
+		Node *runtime = scene->instantiate(PackedScene::GEN_EDIT_STATE_DISABLED);
+		Node *editor = scene->instantiate(PackedScene::GEN_EDIT_STATE_INSTANCE);
+		REQUIRE(runtime);
+		REQUIRE(editor);
+
+		check_same_tree(runtime, editor);
+
+		memdelete(runtime);
+		memdelete(editor);
+	}
+
+	SUBCASE("Packing again replaces the plan") {
+		Node *first = scene->instantiate();
+		memdelete(first);
+
+		Object::cast_to<Node2D>(original)->set_position(Vector2(-4, 8));
+		original->get_node(NodePath("Panel"))->set("anchor_right", 0.75);
+		REQUIRE(scene->pack(original) == OK);
+
+		Node *second = scene->instantiate();
+		REQUIRE(second);
+		check_same_tree(second, original);
+		CHECK(Object::cast_to<Node2D>(second)->get_position() == Vector2(-4, 8));
+
+		memdelete(second);
+	}
+
+	SUBCASE("Loading a saved scene gives the packed tree") {
+		const String path = OS::get_singleton()->get_cache_path().plus_file("packed_scene_plan.tscn");
+		REQUIRE(ResourceSaver::save(path, scene) == OK);
+
+		Ref<PackedScene> loaded = ResourceLoader::load(path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+		REQUIRE(loaded.is_valid());
+
+		Node *first = loaded->instantiate();
+		Node *second = loaded->instantiate();
+		REQUIRE(first);
+		REQUIRE(second);
+
+		check_same_tree(first, original);
+		check_same_tree(second, original);
+
+		memdelete(first);
+		memdelete(second);
+	}
+
+	memdelete(original);
+}
+
+} // namespace TestPackedScene
+
+#endif // TEST_PACKED_SCENE_H
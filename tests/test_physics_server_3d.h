@@ -0,0 +1,463 @@
+/*************************************************************************/
+/*  test_physics_server_3d.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_PHYSICS_SERVER_3D_H
+#define TEST_PHYSICS_SERVER_3D_H
+
+#include "core/config/project_settings.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "servers/physics_3d/body_3d_sw.h"
+#include "servers/physics_3d/constraint_3d_sw.h"
+#include "servers/physics_3d/step_3d_sw.h"
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer3D {
+
+// Static boxes and spheres scattered in a 20 meters cube, with a few areas among them.
+struct QueryScene {
+	RID space;
+	RID box_shape;
+	RID sphere_shape;
+	LocalVector<RID> bodies;
+	LocalVector<RID> areas;
+
+	QueryScene() {
+		PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+		space = ps->space_create();
+		ps->space_set_active(space, true);
+
+		box_shape = ps->box_shape_create();
+		ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+		sphere_shape = ps->sphere_shape_create();
+		ps->shape_set_data(sphere_shape, 0.6);
+
+		RandomPCG rng(7);
+		for (int i = 0; i < 200; i++) {
+			const Transform3D xform(Basis(Vector3(0, 1, 0), rng.random(0.0f, 3.0f)), Vector3(rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f)));
+			const RID shape = (i % 3) ? box_shape : sphere_shape;
+			if (i % 10 == 0) {
+				RID area = ps->area_create();
+				ps->area_add_shape(area, shape);
+				ps->area_set_transform(area, xform);
+				ps->area_set_monitorable(area, true);
+				ps->area_set_space(area, space);
+				areas.push_back(area);
+			} else {
+				RID body = ps->body_create();
+				ps->body_set_mode(body, PhysicsServer3D::BODY_MODE_STATIC);
+				ps->body_add_shape(body, shape);
+				ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, xform);
+				ps->body_set_collision_layer(body, (i % 2) ? 1 : 2);
+				ps->body_set_space(body, space);
+				bodies.push_back(body);
+			}
+		}
+	}
+
+	~QueryScene() {
+		PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+		for (uint32_t i = 0; i < bodies.size(); i++) {
+			ps->free(bodies[i]);
+		}
+		for (uint32_t i = 0; i < areas.size(); i++) {
+			ps->free(areas[i]);
+		}
+		ps->free(box_shape);
+		ps->free(sphere_shape);
+		ps->free(space);
+	}
+};
+
+// The filters the batches are compared with: everything, a collision mask
+// with areas and bodies, and an exclusion.
+struct QueryFilter {
+	Set<RID> exclude;
+	uint32_t collision_mask = UINT32_MAX;
+	bool collide_with_bodies = true;
+	bool collide_with_areas = false;
+};
+
+static LocalVector<QueryFilter> get_filters(const QueryScene &p_scene) {
+	LocalVector<QueryFilter> filters;
+	filters.push_back(QueryFilter());
+
+	QueryFilter masked;
+	masked.collision_mask = 2;
+	masked.collide_with_areas = true;
+	filters.push_back(masked);
+
+	QueryFilter excluded;
+	for (uint32_t i = 0; i < p_scene.bodies.size(); i += 4) {
+		excluded.exclude.insert(p_scene.bodies[i]);
+	}
+	filters.push_back(excluded);
+	return filters;
+}
+
+static String get_shape_results(const PhysicsDirectSpaceState3D::ShapeResult *p_results, int p_count) {
+	Vector<String> results;
+	for (int i = 0; i < p_count; i++) {
+		results.push_back(vformat("%d:%d", (int64_t)p_results[i].rid.get_id(), p_results[i].shape));
+	}
+	results.sort();
+	return String(" ").join(results);
+}
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Batched ray queries match single queries") {
+	QueryScene scene;
+	PhysicsDirectSpaceState3D *state = PhysicsServer3D::get_singleton()->space_get_direct_state(scene.space);
+	REQUIRE(state);
+
+	// More rays than a packet, so the batch is split between threads.
+	RandomPCG rng(11);
+	const int ray_count = 150;
+	LocalVector<Vector3> from;
+	LocalVector<Vector3> to;
+	for (int i = 0; i < ray_count; i++) {
+		from.push_back(Vector3(rng.random(-12.0f, 12.0f), rng.random(-12.0f, 12.0f), rng.random(-12.0f, 12.0f)));
+		to.push_back(from[i] + Vector3(rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f)).normalized() * rng.random(1.0f, 15.0f));
+	}
+
+	const LocalVector<QueryFilter> filters = get_filters(scene);
+	for (uint32_t f = 0; f < filters.size(); f++) {
+		const QueryFilter &filter = filters[f];
+		LocalVector<PhysicsDirectSpaceState3D::RayResult> results;
+		results.resize(ray_count);
+		bool hits[ray_count];
+		const int hit_count = state->intersect_rays(from.ptr(), to.ptr(), ray_count, results.ptr(), hits, filter.exclude, filter.collision_mask, filter.collide_with_bodies, filter.collide_with_areas);
+
+		int expected_hit_count = 0;
+		for (int i = 0; i < ray_count; i++) {
+			PhysicsDirectSpaceState3D::RayResult expected;
+			const bool hit = state->intersect_ray(from[i], to[i], expected, filter.exclude, filter.collision_mask, filter.collide_with_bodies, filter.collide_with_areas);
+			CHECK_MESSAGE(hits[i] == hit, vformat("Ray %d with filter %d should hit as a single query.", i, f));
+			if (!hit || !hits[i]) {
+				continue;
+			}
+			expected_hit_count++;
+			CHECK(results[i].rid == expected.rid);
+			CHECK(results[i].shape == expected.shape);
+			CHECK(results[i].position.is_equal_approx(expected.position));
+			CHECK(results[i].normal.is_equal_approx(expected.normal));
+		}
+		CHECK(hit_count == expected_hit_count);
+		CHECK_MESSAGE(expected_hit_count > 0, "Some rays should hit.");
+	}
+}
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Batched shape queries match single queries") {
+	QueryScene scene;
+	PhysicsDirectSpaceState3D *state = PhysicsServer3D::get_singleton()->space_get_direct_state(scene.space);
+	REQUIRE(state);
+
+	RandomPCG rng(13);
+	const int query_count = 100;
+	const int result_max = 32;
+	LocalVector<Transform3D> xforms;
+	for (int i = 0; i < query_count; i++) {
+		xforms.push_back(Transform3D(Basis(Vector3(1, 0, 0), rng.random(0.0f, 3.0f)), Vector3(rng.random(-11.0f, 11.0f), rng.random(-11.0f, 11.0f), rng.random(-11.0f, 11.0f))));
+	}
+
+	const LocalVector<QueryFilter> filters = get_filters(scene);
+	for (uint32_t f = 0; f < filters.size(); f++) {
+		const QueryFilter &filter = filters[f];
+		LocalVector<PhysicsDirectSpaceState3D::ShapeResult> results;
+		results.resize(query_count * result_max);
+		int result_counts[query_count];
+		state->intersect_shapes(scene.box_shape, xforms.ptr(), query_count, 0.0, results.ptr(), result_max, result_counts, filter.exclude, filter.collision_mask, filter.collide_with_bodies, filter.collide_with_areas);
+
+		int total = 0;
+		for (int i = 0; i < query_count; i++) {
+			PhysicsDirectSpaceState3D::ShapeResult expected[result_max];
+			const int expected_count = state->intersect_shape(scene.box_shape, xforms[i], 0.0, expected, result_max, filter.exclude, filter.collision_mask, filter.collide_with_bodies, filter.collide_with_areas);
+			CHECK_MESSAGE(result_counts[i] == expected_count, vformat("Shape query %d with filter %d should find as many objects as a single query.", i, f));
+			CHECK(get_shape_results(results.ptr() + i * result_max, result_counts[i]) == get_shape_results(expected, expected_count));
+			total += expected_count;
+		}
+		CHECK_MESSAGE(total > 0, "Some shapes should intersect objects.");
+	}
+}
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Batched motion casts match single casts") {
+	QueryScene scene;
+	PhysicsDirectSpaceState3D *state = PhysicsServer3D::get_singleton()->space_get_direct_state(scene.space);
+	REQUIRE(state);
+
+	RandomPCG rng(17);
+	const int query_count = 100;
+	LocalVector<Transform3D> xforms;
+	LocalVector<Vector3> motions;
+	for (int i = 0; i < query_count; i++) {
+		xforms.push_back(Transform3D(Basis(), Vector3(rng.random(-11.0f, 11.0f), rng.random(-11.0f, 11.0f), rng.random(-11.0f, 11.0f))));
+		motions.push_back(Vector3(rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f)).normalized() * rng.random(0.5f, 8.0f));
+	}
+
+	const LocalVector<QueryFilter> filters = get_filters(scene);
+	for (uint32_t f = 0; f < filters.size(); f++) {
+		const QueryFilter &filter = filters[f];
+		real_t closest_safe[query_count];
+		real_t closest_unsafe[query_count];
+		LocalVector<PhysicsDirectSpaceState3D::ShapeRestInfo> infos;
+		infos.resize(query_count);
+		state->cast_motions(scene.sphere_shape, xforms.ptr(), motions.ptr(), query_count, 0.0, closest_safe, closest_unsafe, filter.exclude, filter.collision_mask, filter.collide_with_bodies, filter.collide_with_areas, infos.ptr());
+
+		int blocked = 0;
+		for (int i = 0; i < query_count; i++) {
+			real_t expected_safe = 0.0;
+			real_t expected_unsafe = 0.0;
+			PhysicsDirectSpaceState3D::ShapeRestInfo expected_info;
+			state->cast_motion(scene.sphere_shape, xforms[i], motions[i], 0.0, expected_safe, expected_unsafe, filter.exclude, filter.collision_mask, filter.collide_with_bodies, filter.collide_with_areas, &expected_info);
+			CHECK_MESSAGE(closest_safe[i] == doctest::Approx(expected_safe), vformat("Motion %d with filter %d should stop as a single cast.", i, f));
+			CHECK(closest_unsafe[i] == doctest::Approx(expected_unsafe));
+			CHECK(infos[i].rid == expected_info.rid);
+			if (expected_safe < 1.0) {
+				blocked++;
+				CHECK(infos[i].point.is_equal_approx(expected_info.point));
+			}
+		}
+		CHECK_MESSAGE(blocked > 0, "Some motions should be blocked.");
+	}
+}
+
+// Steps the physics as the main loop does, at 60 Hz.
+static void step_physics(int p_steps) {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	for (int i = 0; i < p_steps; i++) {
+		ps->sync();
+		ps->flush_queries();
+		ps->end_sync();
+		ps->step(1.0 / 60.0);
+	}
+}
+
+// Shoots a small body at 300 m/s, 5 meters per step, at a 10 centimeters
+// thick plate and returns its height after a second.
+static real_t shoot_at_plate(const RID &p_shape, bool p_ccd) {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->area_set_param(space, PhysicsServer3D::AREA_PARAM_GRAVITY, 0.0);
+	ps->area_set_param(space, PhysicsServer3D::AREA_PARAM_LINEAR_DAMP, 0.0);
+
+	RID plate_shape = ps->box_shape_create();
+	ps->shape_set_data(plate_shape, Vector3(5, 0.05, 5));
+	RID plate = ps->body_create();
+	ps->body_set_mode(plate, PhysicsServer3D::BODY_MODE_STATIC);
+	ps->body_add_shape(plate, plate_shape);
+	ps->body_set_space(plate, space);
+
+	// Starts so that no step ends with the body touching the plate.
+	RID body = ps->body_create();
+	ps->body_set_mode(body, PhysicsServer3D::BODY_MODE_DYNAMIC);
+	ps->body_add_shape(body, p_shape);
+	ps->body_set_enable_continuous_collision_detection(body, p_ccd);
+	ps->body_set_space(body, space);
+	ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, 10.3, 0)));
+	ps->body_set_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(0, -300, 0));
+
+	step_physics(60);
+
+	const Transform3D xform = ps->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+	ps->free(body);
+	ps->free(plate);
+	ps->free(plate_shape);
+	ps->free(space);
+	return xform.origin.y;
+}
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Continuous collision detection stops fast bodies at thin plates") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID sphere = ps->sphere_shape_create();
+	ps->shape_set_data(sphere, 0.05);
+	RID thin_box = ps->box_shape_create();
+	ps->shape_set_data(thin_box, Vector3(0.3, 0.02, 0.3));
+	const RID shapes[] = { sphere, thin_box };
+
+	for (const RID &shape : shapes) {
+		CHECK_MESSAGE(shoot_at_plate(shape, false) < -1.0, "Without continuous collision detection, the body should go through the plate.");
+
+		const real_t height = shoot_at_plate(shape, true);
+		CHECK_MESSAGE(height > 0.0, "The body should not tunnel through the plate.");
+		CHECK_MESSAGE(height < 0.5, "The body should stop on the plate.");
+	}
+
+	ps->free(sphere);
+	ps->free(thin_box);
+}
+
+class TestConstraint : public Constraint3DSW {
+	Body3DSW *bodies[2];
+
+public:
+	int uses = 0;
+
+	virtual bool setup(real_t p_step) override { return true; }
+	virtual bool pre_solve(real_t p_step) override { return true; }
+	virtual void solve(real_t p_step) override {}
+
+	TestConstraint(Body3DSW *p_body_a, Body3DSW *p_body_b) :
+			Constraint3DSW(bodies, 2) {
+		bodies[0] = p_body_a;
+		bodies[1] = p_body_b;
+	}
+};
+
+TEST_CASE("[PhysicsServer3D] Constraint coloring never puts two constraints of a body in the same color") {
+	const int body_count = 64;
+	LocalVector<Body3DSW *> bodies;
+	for (int i = 0; i < body_count; i++) {
+		Body3DSW *body = memnew(Body3DSW);
+		body->set_self(RID::from_uint64(i + 1));
+		body->set_mode(i < 4 ? PhysicsServer3D::BODY_MODE_STATIC : PhysicsServer3D::BODY_MODE_DYNAMIC);
+		bodies.push_back(body);
+	}
+
+	// Static bodies are shared by many constraints, like the ground under a stack.
+	RandomPCG rng(7);
+	LocalVector<Constraint3DSW *> constraints;
+	for (int i = 0; i < 1000; i++) {
+		const uint32_t a = rng.rand() % body_count;
+		const uint32_t b = (a + 1 + rng.rand() % (body_count - 1)) % body_count;
+		constraints.push_back(memnew(TestConstraint(bodies[a], bodies[b])));
+	}
+
+	Step3DSW::ColoredIsland colored_island;
+	REQUIRE(Step3DSW::color_island(constraints, colored_island));
+
+	const LocalVector<uint32_t> &offsets = colored_island.color_offsets;
+	REQUIRE(offsets.size() >= 2);
+	CHECK(offsets[0] == 0);
+	CHECK(offsets[offsets.size() - 1] == constraints.size());
+	REQUIRE(colored_island.constraints.size() == constraints.size());
+
+	for (uint32_t i = 0; i < colored_island.constraints.size(); i++) {
+		static_cast<TestConstraint *>(colored_island.constraints[i])->uses++;
+	}
+	for (uint32_t i = 0; i < constraints.size(); i++) {
+		CHECK_MESSAGE(static_cast<TestConstraint *>(constraints[i])->uses == 1, vformat("Constraint %d should be in exactly one color.", i));
+	}
+
+	// The last group is solved serially, the others in parallel.
+	for (uint32_t color = 0; color + 2 < offsets.size(); color++) {
+		HashMap<RID, uint32_t> body_constraints;
+		for (uint32_t i = offsets[color]; i < offsets[color + 1]; i++) {
+			Constraint3DSW *constraint = colored_island.constraints[i];
+			for (int j = 0; j < constraint->get_body_count(); j++) {
+				Body3DSW *body = constraint->get_body_ptr()[j];
+				if (body->get_mode() == PhysicsServer3D::BODY_MODE_STATIC) {
+					continue;
+				}
+				CHECK_MESSAGE(!body_constraints.has(body->get_self()), vformat("Constraints %d and %d of color %d share a body.", body_constraints.has(body->get_self()) ? body_constraints[body->get_self()] : 0, i, color));
+				body_constraints[body->get_self()] = i;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < constraints.size(); i++) {
+		memdelete(constraints[i]);
+	}
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+		memdelete(bodies[i]);
+	}
+}
+
+// Builds a wall of boxes in contact, a single island with about 470 contacts,
+// and returns the positions of the boxes after two seconds.
+static LocalVector<Vector3> settle_box_wall(int p_parallel_island_min_constraints) {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	// Read when the space is created.
+	ProjectSettings::get_singleton()->set_setting("physics/3d/parallel_island_min_constraints", p_parallel_island_min_constraints);
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	RID ground_shape = ps->box_shape_create();
+	ps->shape_set_data(ground_shape, Vector3(50, 0.5, 50));
+	RID ground = ps->body_create();
+	ps->body_set_mode(ground, PhysicsServer3D::BODY_MODE_STATIC);
+	ps->body_add_shape(ground, ground_shape);
+	ps->body_set_space(ground, space);
+	ps->body_set_state(ground, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -0.5, 0)));
+
+	RID box_shape = ps->box_shape_create();
+	ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+	LocalVector<RID> boxes;
+	for (int row = 0; row < 8; row++) {
+		for (int column = 0; column < 30; column++) {
+			RID box = ps->body_create();
+			ps->body_set_mode(box, PhysicsServer3D::BODY_MODE_DYNAMIC);
+			ps->body_add_shape(box, box_shape);
+			ps->body_set_space(box, space);
+			ps->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(column * 0.999, 0.5 + row, 0)));
+			boxes.push_back(box);
+		}
+	}
+
+	step_physics(120);
+
+	LocalVector<Vector3> positions;
+	for (uint32_t i = 0; i < boxes.size(); i++) {
+		const Transform3D xform = ps->body_get_state(boxes[i], PhysicsServer3D::BODY_STATE_TRANSFORM);
+		positions.push_back(xform.origin);
+		ps->free(boxes[i]);
+	}
+	ps->free(box_shape);
+	ps->free(ground);
+	ps->free(ground_shape);
+	ps->free(space);
+	return positions;
+}
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Box walls settle the same with the colored solver") {
+	const Variant setting = ProjectSettings::get_singleton()->get_setting("physics/3d/parallel_island_min_constraints");
+
+	// Zero solves every island serially.
+	const LocalVector<Vector3> serial = settle_box_wall(0);
+	const LocalVector<Vector3> colored = settle_box_wall(64);
+	REQUIRE(serial.size() == colored.size());
+
+	for (uint32_t i = 0; i < serial.size(); i++) {
+		CHECK_MESSAGE(colored[i].distance_to(serial[i]) < 0.1, vformat("Box %d should settle at %s, not %s.", i, serial[i], colored[i]));
+	}
+	for (uint32_t i = serial.size() - 30; i < serial.size(); i++) {
+		CHECK_MESSAGE(serial[i].y > 7.0, "The serial solver should keep the wall standing.");
+		CHECK_MESSAGE(colored[i].y > 7.0, "The colored solver should keep the wall standing.");
+	}
+
+	ProjectSettings::get_singleton()->set_setting("physics/3d/parallel_island_min_constraints", setting);
+}
+
+} // namespace TestPhysicsServer3D
+
+#endif // TEST_PHYSICS_SERVER_3D_H
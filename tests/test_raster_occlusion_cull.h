@@ -0,0 +1,140 @@
+/*************************************************************************/
+/*  test_raster_occlusion_cull.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RASTER_OCCLUSION_CULL_H
+#define TEST_RASTER_OCCLUSION_CULL_H
+
+#include "core/math/camera_matrix.h"
+#include "servers/rendering/raster_occlusion_cull.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRasterOcclusionCull {
+
+// A 4x4 quad, 10 meters in front of a camera at the origin looking down -Z.
+// It covers the 20% of the screen around the center.
+struct OccluderScene {
+	RasterOcclusionCull *occlusion_cull = nullptr;
+	RID occluder;
+	RID scenario = RID::from_uint64(1);
+	RID instance = RID::from_uint64(2);
+	RID buffer = RID::from_uint64(3);
+
+	Transform3D cam_transform;
+	CameraMatrix cam_projection;
+
+	bool is_occluded(const AABB &p_aabb) const {
+		const real_t bounds[6] = { p_aabb.position.x, p_aabb.position.y, p_aabb.position.z, p_aabb.position.x + p_aabb.size.x, p_aabb.position.y + p_aabb.size.y, p_aabb.position.z + p_aabb.size.z };
+		return occlusion_cull->buffer_get_ptr(buffer)->is_occluded(bounds, cam_transform.origin, cam_transform.affine_inverse(), cam_projection, cam_projection.get_z_near());
+	}
+
+	void update(const CameraMatrix &p_cam_projection, bool p_cam_orthogonal) {
+		cam_projection = p_cam_projection;
+		occlusion_cull->buffer_update(buffer, cam_transform, cam_projection, p_cam_orthogonal);
+	}
+
+	OccluderScene() {
+		occlusion_cull = memnew(RasterOcclusionCull);
+
+		PackedVector3Array vertices;
+		vertices.push_back(Vector3(-2, -2, 0));
+		vertices.push_back(Vector3(2, -2, 0));
+		vertices.push_back(Vector3(2, 2, 0));
+		vertices.push_back(Vector3(-2, 2, 0));
+		PackedInt32Array indices;
+		indices.push_back(0);
+		indices.push_back(1);
+		indices.push_back(2);
+		indices.push_back(0);
+		indices.push_back(2);
+		indices.push_back(3);
+
+		occluder = occlusion_cull->occluder_allocate();
+		occlusion_cull->occluder_initialize(occluder);
+		occlusion_cull->occluder_set_mesh(occluder, vertices, indices);
+
+		occlusion_cull->add_scenario(scenario);
+		occlusion_cull->scenario_set_instance(scenario, instance, occluder, Transform3D(Basis(), Vector3(0, 0, -10)), true);
+
+		// Not a multiple of the tile size, so the last tiles are partial.
+		occlusion_cull->add_buffer(buffer);
+		occlusion_cull->buffer_set_scenario(buffer, scenario);
+		occlusion_cull->buffer_set_size(buffer, Vector2i(70, 70));
+	}
+
+	~OccluderScene() {
+		occlusion_cull->remove_buffer(buffer);
+		occlusion_cull->scenario_remove_instance(scenario, instance);
+		occlusion_cull->remove_scenario(scenario);
+		occlusion_cull->free_occluder(occluder);
+		memdelete(occlusion_cull);
+	}
+};
+
+static void check_occlusion(const OccluderScene &p_scene) {
+	CHECK_MESSAGE(p_scene.is_occluded(AABB(Vector3(-1, -1, -15), Vector3(2, 2, 1))), "A box behind the occluder should be occluded.");
+	CHECK_MESSAGE(p_scene.is_occluded(AABB(Vector3(0.25, -1.25, -30), Vector3(1, 1, 1))), "A box far behind the occluder should be occluded.");
+
+	CHECK_FALSE_MESSAGE(p_scene.is_occluded(AABB(Vector3(-0.5, -0.5, -6), Vector3(1, 1, 1))), "A box in front of the occluder should be visible.");
+	CHECK_FALSE_MESSAGE(p_scene.is_occluded(AABB(Vector3(6, -1, -15), Vector3(2, 2, 1))), "A box beside the occluder should be visible.");
+	CHECK_FALSE_MESSAGE(p_scene.is_occluded(AABB(Vector3(-1, 5, -15), Vector3(2, 2, 1))), "A box above the occluder should be visible.");
+	CHECK_FALSE_MESSAGE(p_scene.is_occluded(AABB(Vector3(0, -1, -15), Vector3(6, 2, 1))), "A box straddling the right edge of the occluder should be visible.");
+	CHECK_FALSE_MESSAGE(p_scene.is_occluded(AABB(Vector3(-1, -6, -15), Vector3(2, 6, 1))), "A box straddling the bottom edge of the occluder should be visible.");
+}
+
+TEST_CASE("[RasterOcclusionCull] Rasterized occluders hide the boxes behind them") {
+	OccluderScene scene;
+
+	SUBCASE("Perspective") {
+		CameraMatrix projection;
+		projection.set_perspective(90, 1, 0.1, 100);
+		scene.update(projection, false);
+		check_occlusion(scene);
+	}
+
+	SUBCASE("Orthogonal") {
+		CameraMatrix projection;
+		projection.set_orthogonal(20, 1, 0.1, 100);
+		scene.update(projection, true);
+		check_occlusion(scene);
+	}
+
+	SUBCASE("Disabled occluder") {
+		CameraMatrix projection;
+		projection.set_perspective(90, 1, 0.1, 100);
+		scene.occlusion_cull->scenario_set_instance(scene.scenario, scene.instance, scene.occluder, Transform3D(Basis(), Vector3(0, 0, -10)), false);
+		scene.update(projection, false);
+		CHECK_FALSE(scene.is_occluded(AABB(Vector3(-1, -1, -15), Vector3(2, 2, 1))));
+	}
+}
+
+} // namespace TestRasterOcclusionCull
+
+#endif // TEST_RASTER_OCCLUSION_CULL_H
@@ -0,0 +1,268 @@
+/*************************************************************************/
+/*  test_renderer_scene_cull.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RENDERER_SCENE_CULL_H
+#define TEST_RENDERER_SCENE_CULL_H
+
+#include "core/math/random_pcg.h"
+#include "servers/rendering/rasterizer_dummy.h"
+#include "servers/rendering/renderer_scene_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererSceneCull {
+
+// The dummy storage has no bases with bounds, so instances would never be indexed.
+// This one keeps the AABB of visibility notifiers, which are indexed like any volume.
+class NotifierStorage : public RasterizerStorageDummy {
+	mutable RID_Owner<AABB> notifier_owner;
+
+public:
+	RID visibility_notifier_allocate() override { return notifier_owner.make_rid(AABB()); }
+	void visibility_notifier_set_aabb(RID p_notifier, const AABB &p_aabb) override {
+		AABB *aabb = notifier_owner.getornull(p_notifier);
+		ERR_FAIL_COND(!aabb);
+		*aabb = p_aabb;
+	}
+	AABB visibility_notifier_get_aabb(RID p_notifier) const override {
+		const AABB *aabb = notifier_owner.getornull(p_notifier);
+		ERR_FAIL_COND_V(!aabb, AABB());
+		return *aabb;
+	}
+
+	RS::InstanceType get_base_type(RID p_rid) const override {
+		return notifier_owner.owns(p_rid) ? RS::INSTANCE_VISIBLITY_NOTIFIER : RasterizerStorageDummy::get_base_type(p_rid);
+	}
+	bool free(RID p_rid) override {
+		if (notifier_owner.owns(p_rid)) {
+			notifier_owner.free(p_rid);
+			return true;
+		}
+		return RasterizerStorageDummy::free(p_rid);
+	}
+};
+
+// Replaces the storage of the rendering server for the lifetime of the scene.
+struct NotifierScene {
+	RendererStorage *previous_storage = nullptr;
+	NotifierStorage storage;
+	RID notifier;
+
+	NotifierScene() {
+		previous_storage = RSG::storage;
+		RSG::storage = &storage;
+
+		notifier = RS::get_singleton()->visibility_notifier_create();
+		RS::get_singleton()->visibility_notifier_set_aabb(notifier, AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)));
+	}
+
+	~NotifierScene() {
+		storage.free(notifier);
+		RSG::storage = previous_storage;
+	}
+};
+
+// Instances of the notifier in their own scenario. The object ID of instance `i` is `i + 1`.
+struct InstanceScenario {
+	RID scenario;
+	Vector<RID> instances;
+
+	InstanceScenario(RID p_notifier, int p_count) {
+		scenario = RS::get_singleton()->scenario_create();
+		for (int i = 0; i < p_count; i++) {
+			RID instance = RS::get_singleton()->instance_create();
+			RS::get_singleton()->instance_set_base(instance, p_notifier);
+			RS::get_singleton()->instance_set_scenario(instance, scenario);
+			RS::get_singleton()->instance_attach_object_instance_id(instance, ObjectID(uint64_t(i + 1)));
+			instances.push_back(instance);
+		}
+	}
+
+	// The dummy storage claims every RID in RenderingServer::free(), so the scene is freed directly.
+	~InstanceScenario() {
+		for (int i = 0; i < instances.size(); i++) {
+			RSG::scene->free(instances[i]);
+		}
+		RSG::scene->free(scenario);
+	}
+
+	String cull(const AABB &p_aabb) const {
+		Vector<ObjectID> result = RS::get_singleton()->instances_cull_aabb(p_aabb, scenario);
+		LocalVector<uint64_t> ids;
+		for (int i = 0; i < result.size(); i++) {
+			ids.push_back(uint64_t(result[i]));
+		}
+		ids.sort();
+		String text;
+		for (uint32_t i = 0; i < ids.size(); i++) {
+			text += itos(ids[i]) + " ";
+		}
+		return text;
+	}
+};
+
+static Transform3D get_random_transform(RandomPCG &p_rng) {
+	Basis basis(Vector3(p_rng.random(-1.0, 1.0), p_rng.random(-1.0, 1.0), p_rng.random(-1.0, 1.0)).normalized(), p_rng.random(-Math_PI, Math_PI));
+	basis.scale(Vector3(1, 1, 1) * p_rng.random(0.5, 2.0));
+	return Transform3D(basis, Vector3(p_rng.random(-50.0, 50.0), p_rng.random(-50.0, 50.0), p_rng.random(-50.0, 50.0)));
+}
+
+TEST_CASE("[SceneTree][RenderingServer] Batched instance updates match single instance updates") {
+	NotifierScene scene;
+	RandomPCG rng(7);
+
+	// More than the default threaded_cull_minimum_instances, so the bounds are computed in parallel.
+	const int instance_count = 1200;
+	InstanceScenario single(scene.notifier, instance_count);
+	InstanceScenario batched(scene.notifier, instance_count);
+
+	LocalVector<Transform3D> transforms;
+	for (int i = 0; i < instance_count; i++) {
+		transforms.push_back(get_random_transform(rng));
+	}
+
+	for (int step = 0; step < 10; step++) {
+		for (int i = 0; i < instance_count; i++) {
+			// Most instances move a little, a few jump elsewhere and the rest stay still.
+			if ((i + step) % 5 == 0) {
+				continue;
+			} else if ((i + step) % 13 == 0) {
+				transforms[i] = get_random_transform(rng);
+			} else {
+				transforms[i].origin += Vector3(rng.random(-1.0, 1.0), rng.random(-1.0, 1.0), rng.random(-1.0, 1.0));
+			}
+
+			RS::get_singleton()->instance_set_transform(single.instances[i], transforms[i]);
+			// Updating a blend shape weight updates the instance right away, on its own.
+			RS::get_singleton()->instance_set_blend_shape_weight(single.instances[i], 0, 0.0);
+
+			RS::get_singleton()->instance_set_transform(batched.instances[i], transforms[i]);
+		}
+
+		// The first query updates all the batched instances at once.
+		for (int i = 0; i < 20; i++) {
+			const AABB query(Vector3(rng.random(-60.0, 60.0), rng.random(-60.0, 60.0), rng.random(-60.0, 60.0)), Vector3(rng.random(1.0, 30.0), rng.random(1.0, 30.0), rng.random(1.0, 30.0)));
+			const String batched_result = batched.cull(query);
+			CHECK_MESSAGE(batched_result == single.cull(query), vformat("Query %d after %d steps should find the same instances with both update paths.", i, step + 1));
+
+			// The indexed bounds may be quantized, so they can be larger but never miss an instance.
+			for (int j = 0; j < instance_count; j++) {
+				if (query.intersects(transforms[j].xform(AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1))))) {
+					const bool found = (" " + batched_result).find(" " + itos(j + 1) + " ") != -1;
+					CHECK_MESSAGE(found, vformat("Query %d after %d steps should find instance %d.", i, step + 1, j + 1));
+				}
+			}
+		}
+	}
+}
+
+static Transform3D get_instance_transform(RID p_instance) {
+	return static_cast<RendererSceneCull *>(RSG::scene)->instance_owner.getornull(p_instance)->transform;
+}
+
+TEST_CASE("[SceneTree][RenderingServer] Batched instance transforms match instance_set_transform") {
+	NotifierScene scene;
+	RandomPCG rng(11);
+
+	const int instance_count = 50;
+	InstanceScenario single(scene.notifier, instance_count);
+	InstanceScenario batched(scene.notifier, instance_count);
+	InstanceScenario buffered(scene.notifier, instance_count);
+
+	LocalVector<Transform3D> transforms;
+	for (int i = 0; i < instance_count; i++) {
+		transforms.push_back(get_random_transform(rng));
+	}
+
+	SUBCASE("Transforms are set the same way") {
+		Vector<Transform3D> batch;
+		Array buffer_instances;
+		Vector<float> buffer;
+		buffer.resize(instance_count * 12);
+		for (int i = 0; i < instance_count; i++) {
+			RS::get_singleton()->instance_set_transform(single.instances[i], transforms[i]);
+
+			batch.push_back(transforms[i]);
+
+			// Same layout as the 3D transforms of a multimesh buffer: the rows of the basis, each followed by the origin.
+			buffer_instances.push_back(buffered.instances[i]);
+			for (int row = 0; row < 3; row++) {
+				buffer.write[i * 12 + row * 4 + 0] = transforms[i].basis.elements[row][0];
+				buffer.write[i * 12 + row * 4 + 1] = transforms[i].basis.elements[row][1];
+				buffer.write[i * 12 + row * 4 + 2] = transforms[i].basis.elements[row][2];
+				buffer.write[i * 12 + row * 4 + 3] = transforms[i].origin[row];
+			}
+		}
+		RS::get_singleton()->instances_set_transforms(batched.instances, batch);
+		RS::get_singleton()->call(SNAME("instances_set_transforms"), buffer_instances, buffer);
+
+		for (int i = 0; i < instance_count; i++) {
+			CHECK_MESSAGE(get_instance_transform(single.instances[i]).is_equal_approx(transforms[i]), vformat("Instance %d should have the transform set by instance_set_transform().", i));
+			CHECK_MESSAGE(get_instance_transform(batched.instances[i]).is_equal_approx(transforms[i]), vformat("Instance %d should have the transform set by instances_set_transforms().", i));
+			CHECK_MESSAGE(get_instance_transform(buffered.instances[i]).is_equal_approx(transforms[i]), vformat("Instance %d should have the transform set by the buffer binding.", i));
+		}
+
+		for (int i = 0; i < 10; i++) {
+			const AABB query(Vector3(rng.random(-60.0, 60.0), rng.random(-60.0, 60.0), rng.random(-60.0, 60.0)), Vector3(rng.random(5.0, 40.0), rng.random(5.0, 40.0), rng.random(5.0, 40.0)));
+			const String expected = single.cull(query);
+			CHECK_MESSAGE(batched.cull(query) == expected, vformat("Query %d should find the same instances after instances_set_transforms().", i));
+			CHECK_MESSAGE(buffered.cull(query) == expected, vformat("Query %d should find the same instances after the buffer binding.", i));
+		}
+	}
+
+#ifdef DEBUG_ENABLED
+	SUBCASE("Non-finite transforms are rejected") {
+		RS::get_singleton()->instances_set_transforms(single.instances, Vector<Transform3D>(transforms));
+
+		Transform3D nan_transform = transforms[1];
+		nan_transform.origin.x = NAN;
+		Vector<Transform3D> batch;
+		batch.push_back(get_random_transform(rng));
+		batch.push_back(nan_transform);
+		Vector<RID> batch_instances;
+		batch_instances.push_back(single.instances[0]);
+		batch_instances.push_back(single.instances[1]);
+
+		ERR_PRINT_OFF;
+		RS::get_singleton()->instances_set_transforms(batch_instances, batch);
+		RS::get_singleton()->instance_set_transform(single.instances[2], nan_transform);
+		ERR_PRINT_ON;
+
+		CHECK_MESSAGE(get_instance_transform(single.instances[0]).is_equal_approx(batch[0]), "The finite transforms of the batch should still be set.");
+		CHECK_MESSAGE(get_instance_transform(single.instances[1]).is_equal_approx(transforms[1]), "instances_set_transforms() should keep the previous transform.");
+		CHECK_MESSAGE(get_instance_transform(single.instances[2]).is_equal_approx(transforms[2]), "instance_set_transform() should keep the previous transform.");
+	}
+#endif
+}
+
+} // namespace TestRendererSceneCull
+
+#endif // TEST_RENDERER_SCENE_CULL_H
@@ -109,6 +109,105 @@ TEST_CASE("[Resource] Saving and loading") {
 			loaded_child_resource_text->get_name() == "I'm a child resource",
 			"The loaded child resource name should be equal to the expected value.");
 }
+
+// Saves a diamond-shaped graph of text resources: "top" uses "first" and
+// "second", which both use "shared". Each one is its own file, so each is
+// loaded by its own threaded load task.
+static String save_resource_graph(const String &p_prefix) {
+	const String dir = OS::get_singleton()->get_cache_path();
+
+	Ref<Resource> shared = memnew(Resource);
+	shared->set_name("shared");
+	const String shared_path = dir.plus_file(p_prefix + "_shared.tres");
+	ResourceSaver::save(shared_path, shared);
+	// Saved with its path set, so the others reference it as an external resource.
+	shared->set_path(shared_path);
+
+	Ref<Resource> top = memnew(Resource);
+	top->set_name("top");
+	const char *names[] = { "first", "second" };
+	for (int i = 0; i < 2; i++) {
+		Ref<Resource> resource = memnew(Resource);
+		resource->set_name(names[i]);
+		resource->set_meta("dependency", shared);
+		const String path = dir.plus_file(p_prefix + "_" + names[i] + ".tres");
+		ResourceSaver::save(path, resource);
+		resource->set_path(path);
+		top->set_meta(names[i], resource);
+	}
+
+	const String top_path = dir.plus_file(p_prefix + "_top.tres");
+	ResourceSaver::save(top_path, top);
+	// Everything is freed when returning, so nothing is left in the cache.
+	return top_path;
+}
+
+TEST_CASE("[Resource] Threaded loading of a dependency graph") {
+	const String top_path = save_resource_graph("resource_graph");
+	const String dir = top_path.get_base_dir();
+	const String shared_path = dir.plus_file("resource_graph_shared.tres");
+	REQUIRE_FALSE(ResourceCache::has(top_path));
+	REQUIRE_FALSE(ResourceCache::has(shared_path));
+
+	SUBCASE("Every resource of the graph is loaded once") {
+		REQUIRE(ResourceLoader::load_threaded_request(top_path, "", true) == OK);
+		// Requesting a path that is already being loaded shares the same load.
+		REQUIRE(ResourceLoader::load_threaded_request(top_path, "", true) == OK);
+
+		const Ref<Resource> top = ResourceLoader::load_threaded_get(top_path);
+		const Ref<Resource> top_again = ResourceLoader::load_threaded_get(top_path);
+		REQUIRE(top.is_valid());
+		CHECK_MESSAGE(top == top_again, "Both requests should get the same resource.");
+		CHECK(top->get_path() == top_path);
+
+		const Ref<Resource> first = top->get_meta("first");
+		const Ref<Resource> second = top->get_meta("second");
+		REQUIRE(first.is_valid());
+		REQUIRE(second.is_valid());
+		CHECK(first->get_name() == "first");
+		CHECK(second->get_name() == "second");
+
+		const Ref<Resource> shared = first->get_meta("dependency");
+		REQUIRE(shared.is_valid());
+		CHECK(shared->get_name() == "shared");
+		CHECK_MESSAGE(second->get_meta("dependency") == Variant(shared), "Resources used twice in the graph should be loaded once.");
+		CHECK(ResourceCache::get(shared_path) == shared.ptr());
+
+		CHECK_MESSAGE(ResourceLoader::load_threaded_get_status(top_path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE, "The load should be released after getting it once per request.");
+		CHECK_MESSAGE(ResourceLoader::load_threaded_get_status(shared_path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE, "The requests made for the dependencies should be released too.");
+	}
+
+	SUBCASE("A dependency already being loaded is shared with the graph") {
+		REQUIRE(ResourceLoader::load_threaded_request(shared_path, "", true) == OK);
+		REQUIRE(ResourceLoader::load_threaded_request(top_path, "", true) == OK);
+
+		const Ref<Resource> top = ResourceLoader::load_threaded_get(top_path);
+		const Ref<Resource> shared = ResourceLoader::load_threaded_get(shared_path);
+		REQUIRE(top.is_valid());
+		REQUIRE(shared.is_valid());
+		CHECK(Ref<Resource>(top->get_meta("first"))->get_meta("dependency") == Variant(shared));
+		CHECK(Ref<Resource>(top->get_meta("second"))->get_meta("dependency") == Variant(shared));
+		CHECK(ResourceLoader::load_threaded_get_status(shared_path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE);
+	}
+
+	SUBCASE("Dependencies are loaded with the cache mode of the request") {
+		const Ref<Resource> cached_shared = ResourceLoader::load(shared_path);
+		REQUIRE(cached_shared.is_valid());
+
+		REQUIRE(ResourceLoader::load_threaded_request(top_path, "", true, ResourceFormatLoader::CACHE_MODE_IGNORE) == OK);
+		const Ref<Resource> top = ResourceLoader::load_threaded_get(top_path);
+		REQUIRE(top.is_valid());
+		CHECK(top->get_path().is_empty());
+		CHECK_FALSE(ResourceCache::has(top_path));
+
+		const Ref<Resource> shared = Ref<Resource>(top->get_meta("first"))->get_meta("dependency");
+		REQUIRE(shared.is_valid());
+		CHECK_MESSAGE(shared != cached_shared, "The cached dependency should not be used when ignoring the cache.");
+		CHECK(shared->get_name() == "shared");
+		CHECK(Ref<Resource>(top->get_meta("second"))->get_meta("dependency") == Variant(shared));
+		CHECK(ResourceCache::get(shared_path) == cached_shared.ptr());
+	}
+}
 } // namespace TestResource
 
 #endif // TEST_RESOURCE
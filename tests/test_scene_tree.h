@@ -0,0 +1,194 @@
+/*************************************************************************/
+/*  test_scene_tree.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SCENE_TREE_H
+#define TEST_SCENE_TREE_H
+
+#include "core/os/thread.h"
+#include "core/templates/safe_refcount.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+// Declared in global namespace because of GDCLASS macro warning (Windows):
+// "Unqualified friend declaration referring to type outside of the nearest enclosing namespace
+// is a Microsoft extension; add a nested name specifier".
+class _TestProcessThreadNode : public Node {
+	GDCLASS(_TestProcessThreadNode, Node);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what != NOTIFICATION_PHYSICS_PROCESS) {
+			return;
+		}
+
+		processed_order = order->increment();
+		processed_thread = Thread::get_caller_id();
+		child_count_while_processing = get_child_count();
+
+		if (add_child_deferred) {
+			call_deferred(SNAME("add_child"), memnew(Node));
+		}
+	}
+
+public:
+	SafeNumeric<uint32_t> *order = nullptr;
+	uint32_t processed_order = 0;
+	Thread::ID processed_thread = 0;
+	int child_count_while_processing = -1;
+	bool add_child_deferred = false;
+};
+
+namespace TestSceneTree {
+
+static _TestProcessThreadNode *create_process_node(Node *p_parent, SafeNumeric<uint32_t> *p_order, Node::ProcessThreadGroup p_group = Node::PROCESS_THREAD_GROUP_INHERIT, int p_priority = 0) {
+	_TestProcessThreadNode *node = memnew(_TestProcessThreadNode);
+	node->order = p_order;
+	node->set_process_thread_group(p_group);
+	node->set_process_priority(p_priority);
+	node->set_physics_process(true);
+	p_parent->add_child(node);
+	return node;
+}
+
+TEST_CASE("[SceneTree] Process thread groups") {
+	SceneTree *tree = SceneTree::get_singleton();
+	SafeNumeric<uint32_t> order;
+
+	const int group_count = 4;
+	const int nodes_per_group = 8;
+	LocalVector<_TestProcessThreadNode *> groups[group_count];
+	for (int i = 0; i < group_count; i++) {
+		_TestProcessThreadNode *group_root = create_process_node(tree->get_root(), &order, Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+		groups[i].push_back(group_root);
+		for (int j = 1; j < nodes_per_group; j++) {
+			groups[i].push_back(create_process_node(groups[i][j - 1], &order));
+		}
+	}
+	_TestProcessThreadNode *main_node = create_process_node(tree->get_root(), &order);
+	_TestProcessThreadNode *main_child = create_process_node(groups[0][0], &order, Node::PROCESS_THREAD_GROUP_MAIN_THREAD);
+
+	tree->physics_process(1.0 / 60.0);
+
+	CHECK(order.get() == group_count * nodes_per_group + 2);
+
+	for (int i = 0; i < group_count; i++) {
+		for (int j = 0; j < nodes_per_group; j++) {
+			CHECK(groups[i][j]->is_processing_in_sub_thread());
+			CHECK_MESSAGE(groups[i][j]->processed_thread == groups[i][0]->processed_thread, "A group should process on a single thread.");
+			if (j > 0) {
+				CHECK_MESSAGE(groups[i][j]->processed_order > groups[i][j - 1]->processed_order, "A group should process in tree order.");
+			}
+		}
+	}
+
+	CHECK_FALSE(main_node->is_processing_in_sub_thread());
+	CHECK_FALSE(main_child->is_processing_in_sub_thread());
+	CHECK(main_node->processed_thread == Thread::get_main_id());
+	CHECK(main_child->processed_thread == Thread::get_main_id());
+
+	SUBCASE("Leaving a group") {
+		groups[1][0]->set_process_thread_group(Node::PROCESS_THREAD_GROUP_INHERIT);
+		for (int j = 0; j < nodes_per_group; j++) {
+			CHECK_FALSE(groups[1][j]->is_processing_in_sub_thread());
+		}
+
+		tree->physics_process(1.0 / 60.0);
+		for (int j = 0; j < nodes_per_group; j++) {
+			CHECK(groups[1][j]->processed_thread == Thread::get_main_id());
+		}
+	}
+
+	for (int i = 0; i < group_count; i++) {
+		memdelete(groups[i][0]);
+	}
+	memdelete(main_node);
+}
+
+TEST_CASE("[SceneTree] Process thread groups keep the process priority order") {
+	SceneTree *tree = SceneTree::get_singleton();
+	SafeNumeric<uint32_t> order;
+
+	_TestProcessThreadNode *main_first = create_process_node(tree->get_root(), &order, Node::PROCESS_THREAD_GROUP_MAIN_THREAD, -1);
+	_TestProcessThreadNode *group_a = create_process_node(tree->get_root(), &order, Node::PROCESS_THREAD_GROUP_SUB_THREAD, 0);
+	_TestProcessThreadNode *group_b = create_process_node(tree->get_root(), &order, Node::PROCESS_THREAD_GROUP_SUB_THREAD, 0);
+	_TestProcessThreadNode *main_same = create_process_node(tree->get_root(), &order, Node::PROCESS_THREAD_GROUP_MAIN_THREAD, 0);
+	_TestProcessThreadNode *main_after = create_process_node(tree->get_root(), &order, Node::PROCESS_THREAD_GROUP_MAIN_THREAD, 1);
+	_TestProcessThreadNode *group_late = create_process_node(group_a, &order, Node::PROCESS_THREAD_GROUP_INHERIT, 2);
+
+	tree->physics_process(1.0 / 60.0);
+
+	CHECK(main_first->processed_order < group_a->processed_order);
+	CHECK(main_first->processed_order < group_b->processed_order);
+	CHECK_MESSAGE(main_same->processed_order > group_a->processed_order, "Main thread nodes should process after the groups with the same priority.");
+	CHECK_MESSAGE(main_same->processed_order > group_b->processed_order, "Main thread nodes should process after the groups with the same priority.");
+	CHECK(main_after->processed_order > main_same->processed_order);
+	CHECK_MESSAGE(group_late->processed_order > main_after->processed_order, "Sub-thread nodes with a higher priority should process after main thread nodes with a lower one.");
+	CHECK(group_late->is_processing_in_sub_thread());
+
+	memdelete(main_first);
+	memdelete(group_a);
+	memdelete(group_b);
+	memdelete(main_same);
+	memdelete(main_after);
+}
+
+TEST_CASE("[SceneTree] Deferred calls from process thread groups") {
+	SceneTree *tree = SceneTree::get_singleton();
+	SafeNumeric<uint32_t> order;
+
+	LocalVector<_TestProcessThreadNode *> nodes;
+	for (int i = 0; i < 8; i++) {
+		_TestProcessThreadNode *node = create_process_node(tree->get_root(), &order, Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+		node->add_child_deferred = true;
+		nodes.push_back(node);
+	}
+
+	tree->physics_process(1.0 / 60.0);
+
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		CHECK_MESSAGE(nodes[i]->child_count_while_processing == 0, "The deferred call should not run while the group processes.");
+		// add_child() fails on other threads for nodes inside the tree, so this also checks the call ran on the main thread.
+		CHECK_MESSAGE(nodes[i]->get_child_count() == 1, "The deferred call should run once all groups have processed.");
+		nodes[i]->add_child_deferred = false;
+	}
+
+	tree->physics_process(1.0 / 60.0);
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		CHECK(nodes[i]->child_count_while_processing == 1);
+		CHECK(nodes[i]->get_child_count() == 1);
+		memdelete(nodes[i]);
+	}
+}
+
+} // namespace TestSceneTree
+
+#endif // TEST_SCENE_TREE_H
@@ -0,0 +1,154 @@
+/*************************************************************************/
+/*  test_string_name.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/os/worker_thread_pool.h"
+#include "core/string/string_name.h"
+#include "core/templates/safe_refcount.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	StringName from_cstring("test_string_name_interning");
+	StringName from_string(String("test_string_name_interning"));
+	StringName from_static = _scs_create("test_string_name_interning");
+
+	CHECK(from_cstring == from_string);
+	CHECK(from_cstring == from_static);
+	CHECK(from_cstring.data_unique_pointer() == from_string.data_unique_pointer());
+	CHECK(StringName::search("test_string_name_interning") == from_cstring);
+	CHECK(StringName::search(String("test_string_name_interning")) == from_cstring);
+
+	CHECK(StringName("test_string_name_other") != from_cstring);
+	CHECK_MESSAGE(!StringName::search("test_string_name_not_interned"), "Searching should not intern the name.");
+	CHECK(StringName(String()) == StringName());
+}
+
+class Interner {
+public:
+	Vector<String> names;
+	Vector<StringName> interned;
+	SafeNumeric<uint32_t> mismatches;
+
+	void intern(uint32_t p_index, int p_rounds) {
+		for (int i = 0; i < p_rounds; i++) {
+			int idx = (p_index * 7 + i) % names.size();
+			StringName a = names[idx];
+			StringName b = StringName::search(names[idx]);
+			if (a != interned[idx] || b != interned[idx]) {
+				mismatches.increment();
+			}
+		}
+	}
+
+	void intern_new(uint32_t p_index, int p_rounds) {
+		for (int i = 0; i < p_rounds; i++) {
+			// Created and released concurrently, so entries get added and removed while other threads look them up.
+			StringName a = "test_string_name_transient_" + itos((p_index + i) % 512);
+			StringName b = "test_string_name_transient_" + itos((p_index + i) % 512);
+			if (a != b) {
+				mismatches.increment();
+			}
+		}
+	}
+};
+
+TEST_CASE("[StringName] Concurrent interning") {
+	Interner interner;
+	interner.mismatches.set(0);
+	for (int i = 0; i < 4096; i++) {
+		interner.names.push_back("test_string_name_concurrent_" + itos(i));
+		interner.interned.push_back(interner.names[i]);
+	}
+
+	WorkerThreadPool::get_singleton()->do_work(64, &interner, &Interner::intern, 1000);
+	CHECK_MESSAGE(interner.mismatches.get() == 0, "Concurrent lookups should always find the interned names.");
+
+	WorkerThreadPool::get_singleton()->do_work(64, &interner, &Interner::intern_new, 1000);
+	CHECK_MESSAGE(interner.mismatches.get() == 0, "Names created concurrently should be the same StringName.");
+}
+
+// Measures intern table contention: every thread repeatedly creates StringNames from Strings,
+// mostly names that already exist. Run with `--test --no-skip --test-case="*Benchmark*"`.
+struct ContentionBenchmark {
+	Vector<String> names;
+	int rounds = 0;
+
+	static void thread_func(void *p_userdata) {
+		ContentionBenchmark *benchmark = (ContentionBenchmark *)p_userdata;
+		const int count = benchmark->names.size();
+		for (int i = 0; i < benchmark->rounds; i++) {
+			StringName sn = benchmark->names[i % count];
+			if (i % 16 == 0) {
+				// Some names are short lived, which exercises the write path.
+				StringName transient = benchmark->names[i % count] + "_transient";
+			}
+		}
+	}
+};
+
+TEST_CASE("[StringName][Benchmark] Intern table contention" * doctest::skip()) {
+	ContentionBenchmark benchmark;
+	benchmark.rounds = 1000000;
+	Vector<StringName> keep;
+	for (int i = 0; i < 2048; i++) {
+		benchmark.names.push_back("test_string_name_benchmark_" + itos(i));
+		keep.push_back(benchmark.names[i]);
+	}
+
+	const int max_threads = MAX(OS::get_singleton()->get_processor_count(), 1);
+	for (int thread_count = 1; thread_count <= max_threads; thread_count *= 2) {
+		Vector<Thread *> threads;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < thread_count; i++) {
+			Thread *thread = memnew(Thread);
+			thread->start(&ContentionBenchmark::thread_func, &benchmark);
+			threads.push_back(thread);
+		}
+		for (int i = 0; i < thread_count; i++) {
+			threads[i]->wait_to_finish();
+			memdelete(threads[i]);
+		}
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		double ns_per_op = double(elapsed) * 1000.0 / double(benchmark.rounds);
+		MESSAGE(vformat("%d thread(s): %d usec, %.1f ns per StringName per thread.", thread_count, elapsed, ns_per_op));
+	}
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
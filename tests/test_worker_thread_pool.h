@@ -0,0 +1,158 @@
+/*************************************************************************/
+/*  test_worker_thread_pool.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_WORKER_THREAD_POOL_H
+#define TEST_WORKER_THREAD_POOL_H
+
+#include "core/os/worker_thread_pool.h"
+#include "core/templates/safe_refcount.h"
+
+#include "tests/test_macros.h"
+
+namespace TestWorkerThreadPool {
+
+class Counter {
+public:
+	SafeNumeric<uint64_t> sum;
+	SafeNumeric<uint32_t> order;
+	uint32_t first_order = 0;
+	uint32_t second_order = 0;
+
+	void add(uint32_t p_index, uint32_t p_multiplier) {
+		sum.add(uint64_t(p_index) * p_multiplier);
+	}
+
+	void nested(uint32_t p_index, uint32_t p_elements) {
+		WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(this, &Counter::add, 1u, p_elements);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	}
+
+	void first(int p_unused) {
+		first_order = order.postincrement();
+	}
+
+	void second(int p_unused) {
+		second_order = order.postincrement();
+	}
+};
+
+TEST_CASE("[WorkerThreadPool] Group task processes every element once") {
+	Counter counter;
+	counter.sum.set(0);
+
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&counter, &Counter::add, 2u, 1000);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	CHECK_MESSAGE(counter.sum.get() == 999000, "Every index should be processed exactly once.");
+
+	counter.sum.set(0);
+	WorkerThreadPool::get_singleton()->do_work(10, &counter, &Counter::add, 1u);
+	CHECK(counter.sum.get() == 45);
+
+	group = WorkerThreadPool::get_singleton()->add_template_group_task(&counter, &Counter::add, 1u, 0);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	CHECK_MESSAGE(counter.sum.get() == 45, "Empty groups should complete without running anything.");
+}
+
+TEST_CASE("[WorkerThreadPool] Nested group tasks") {
+	Counter counter;
+	counter.sum.set(0);
+
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&counter, &Counter::nested, 100u, 32);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	CHECK_MESSAGE(counter.sum.get() == 32 * 4950, "Group tasks added and waited for from inside a task should complete.");
+}
+
+TEST_CASE("[WorkerThreadPool] Task dependencies") {
+	for (int i = 0; i < 50; i++) {
+		Counter counter;
+		counter.order.set(0);
+
+		WorkerThreadPool::TaskID first = WorkerThreadPool::get_singleton()->add_template_task(&counter, &Counter::first, 0);
+		Vector<WorkerThreadPool::TaskID> dependencies;
+		dependencies.push_back(first);
+		WorkerThreadPool::TaskID second = WorkerThreadPool::get_singleton()->add_template_task(&counter, &Counter::second, 0, dependencies);
+
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(second);
+		CHECK(WorkerThreadPool::get_singleton()->is_task_completed(first));
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(first);
+
+		CHECK(counter.first_order == 0);
+		CHECK(counter.second_order == 1);
+	}
+}
+
+class PoolCounter {
+public:
+	WorkerThreadPool *pool = nullptr;
+	SafeNumeric<uint64_t> sum;
+
+	void add(uint32_t p_index, uint32_t p_multiplier) {
+		sum.add(uint64_t(p_index) * p_multiplier);
+	}
+
+	void nested(uint32_t p_index, uint32_t p_elements) {
+		pool->do_work(p_elements, this, &PoolCounter::add, 1u);
+	}
+};
+
+TEST_CASE("[WorkerThreadPool] Pools without threads run the work on the waiting thread") {
+	// Never initialized, like the pool of a build without threads.
+	WorkerThreadPool pool;
+	CHECK_MESSAGE(WorkerThreadPool::get_singleton() != &pool, "Other pools should not replace the singleton.");
+	CHECK_MESSAGE(pool.get_thread_count() == 1, "Work split per thread should still have one part.");
+	CHECK(pool.get_thread_index() == -1);
+
+	PoolCounter counter;
+	counter.pool = &pool;
+	counter.sum.set(0);
+	pool.do_work(pool.get_thread_count(), &counter, &PoolCounter::add, 5u);
+	CHECK(counter.sum.get() == 0);
+	pool.do_work(100, &counter, &PoolCounter::add, 1u);
+	CHECK(counter.sum.get() == 4950);
+
+	counter.sum.set(0);
+	pool.do_work(8, &counter, &PoolCounter::nested, 10u);
+	CHECK_MESSAGE(counter.sum.get() == 8 * 45, "Nested groups should complete without workers.");
+
+	Counter ordered;
+	ordered.order.set(0);
+	WorkerThreadPool::TaskID first = pool.add_template_task(&ordered, &Counter::first, 0);
+	Vector<WorkerThreadPool::TaskID> dependencies;
+	dependencies.push_back(first);
+	WorkerThreadPool::TaskID second = pool.add_template_task(&ordered, &Counter::second, 0, dependencies);
+	pool.wait_for_task_completion(second);
+	pool.wait_for_task_completion(first);
+	CHECK(ordered.first_order == 0);
+	CHECK(ordered.second_order == 1);
+}
+
+} // namespace TestWorkerThreadPool
+
+#endif // TEST_WORKER_THREAD_POOL_H
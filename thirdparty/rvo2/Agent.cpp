@@ -188,6 +188,10 @@ void Agent::computeNewVelocity(float timeStep) {
         orcaPlanes_.push_back(plane);
     }
 
+    solveNewVelocity();
+}
+
+void Agent::solveNewVelocity() {
     const size_t planeFail = linearProgram3(orcaPlanes_, maxSpeed_, prefVelocity_, false, newVelocity_);
 
     if (planeFail < orcaPlanes_.size()) {
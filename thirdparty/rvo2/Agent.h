@@ -52,6 +52,7 @@
 // - The compute velocity function now need the timeStep.
 // - Moved the `Plane` class here.
 // - Added a new parameter `ignore_y_` in the `Agent`. This parameter is used to control a godot feature that allows to avoid collisions by moving on the horizontal plane.
+// - Added `solveNewVelocity` to compute the new velocity from ORCA planes built outside of the agent.
 namespace RVO {
 /**
      * \brief   Defines a plane.
@@ -91,6 +92,11 @@ public:
 		 */
     void computeNewVelocity(float timeStep);
 
+    /**
+		 * \brief   Computes the new velocity of this agent from the ORCA planes already in orcaPlanes_.
+		 */
+    void solveNewVelocity();
+
     /**
 		 * \brief   Inserts an agent neighbor into the set of neighbors of this agent.
 		 * \param   agent    A pointer to the agent to be inserted.